@@ -0,0 +1,218 @@
+/**
+ * @file arena.c
+ * @brief Allocate memory blocks which are released all at once, at the
+ *        end of their lifetime
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "arena.h"
+#include "log_recorder.h"
+#include <string.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/** Chunk of memory, the blocks follow the header */
+typedef struct arena_chunk
+{
+  struct arena_chunk *next;
+  /** Size of the chunk in bytes, header included */
+  Uint32 size;
+  /** Number of bytes used, header included */
+  Uint32 used;
+} arena_chunk;
+
+/** Blocks of the same lifetime */
+typedef struct arena
+{
+  /** Name of the lifetime, used in the messages */
+  const char *name;
+  /** Chunks of memory, the current one first */
+  arena_chunk *chunks;
+  /** Number of blocks allocated since the last reset */
+  Uint32 numof_blocks;
+  /** Number of bytes allocated since the last reset */
+  Uint32 size;
+  /** Maximum number of bytes allocated between two resets */
+  Uint32 maxreached_size;
+#ifdef HAVE_PTHREAD_H
+  /** The loaders and the prefetch thread allocate concurrently */
+  pthread_mutex_t mutex;
+#endif
+} arena;
+
+static arena arenas[ARENAS_NUMOF] = {
+#ifdef HAVE_PTHREAD_H
+  {"process", NULL, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER},
+  {"level", NULL, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER}
+#else
+  {"process", NULL, 0, 0, 0},
+  {"level", NULL, 0, 0, 0}
+#endif
+};
+
+/**
+ * Return a size rounded up to the alignment of the blocks
+ * @param size A size in bytes
+ * @return The size aligned
+ */
+static Uint32
+arena_align (Uint32 size)
+{
+  return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+/**
+ * Allocate a zeroed memory block which lives until its arena is reset
+ * @param lifetime ARENA_PROCESS or ARENA_LEVEL
+ * @param size Size in bytes
+ * @return Pointer to the block, or NULL if an error occurred
+ */
+char *
+arena_alloc (Uint32 lifetime, Uint32 size)
+{
+  char *addr = NULL;
+  Uint32 header, chunk_size;
+  arena_chunk *chunk;
+  arena *pool = &arenas[lifetime];
+  header = arena_align (sizeof (arena_chunk));
+  size = arena_align (size);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&pool->mutex);
+#endif
+  /* the blocks are taken in the current chunk, the chunks which follow
+   * are reused after a reset */
+  for (chunk = pool->chunks; chunk != NULL; chunk = chunk->next)
+    {
+      if (chunk->used + size <= chunk->size)
+        {
+          break;
+        }
+    }
+  if (chunk == NULL)
+    {
+      chunk_size = header + size;
+      if (chunk_size < ARENA_CHUNK_SIZE)
+        {
+          chunk_size = ARENA_CHUNK_SIZE;
+        }
+      chunk = (arena_chunk *) memory_allocation (chunk_size);
+      if (chunk == NULL)
+        {
+          LOG_ERR ("not enough memory to allocate %i bytes in the %s arena",
+                   size, pool->name);
+#ifdef HAVE_PTHREAD_H
+          pthread_mutex_unlock (&pool->mutex);
+#endif
+          return NULL;
+        }
+      chunk->size = chunk_size;
+      chunk->used = header;
+      chunk->next = pool->chunks;
+      pool->chunks = chunk;
+    }
+  addr = (char *) chunk + chunk->used;
+  chunk->used += size;
+  pool->numof_blocks++;
+  pool->size += size;
+  if (pool->size > pool->maxreached_size)
+    {
+      pool->maxreached_size = pool->size;
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&pool->mutex);
+#endif
+  return addr;
+}
+
+/**
+ * Duplicate a string in an arena
+ * @param lifetime ARENA_PROCESS or ARENA_LEVEL
+ * @param str The string to duplicate
+ * @return Pointer to the new string, or NULL if an error occurred
+ */
+char *
+arena_string_duplicate (Uint32 lifetime, const char *str)
+{
+  Uint32 size = strlen (str) + 1;
+  char *dest = arena_alloc (lifetime, size);
+  if (dest != NULL)
+    {
+      memcpy (dest, str, size);
+    }
+  return dest;
+}
+
+/**
+ * Release all the blocks of an arena, its chunks are kept and
+ * cleared for the next blocks
+ * @param lifetime ARENA_PROCESS or ARENA_LEVEL
+ */
+void
+arena_reset (Uint32 lifetime)
+{
+  Uint32 header;
+  arena_chunk *chunk;
+  arena *pool = &arenas[lifetime];
+  header = arena_align (sizeof (arena_chunk));
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&pool->mutex);
+#endif
+  for (chunk = pool->chunks; chunk != NULL; chunk = chunk->next)
+    {
+      memset ((char *) chunk + header, 0, chunk->used - header);
+      chunk->used = header;
+    }
+  pool->numof_blocks = 0;
+  pool->size = 0;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&pool->mutex);
+#endif
+}
+
+/**
+ * Release the chunks of all the arenas
+ */
+void
+arenas_free (void)
+{
+  Uint32 i;
+  arena_chunk *chunk;
+  arena *pool;
+  for (i = 0; i < ARENAS_NUMOF; i++)
+    {
+      pool = &arenas[i];
+      LOG_INF ("%s arena: %i blocks; %i bytes; maximum reached: %i bytes",
+               pool->name, pool->numof_blocks, pool->size,
+               pool->maxreached_size);
+      while (pool->chunks != NULL)
+        {
+          chunk = pool->chunks;
+          pool->chunks = chunk->next;
+          free_memory ((char *) chunk);
+        }
+      pool->numof_blocks = 0;
+      pool->size = 0;
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file arena.h
+ * @brief Allocate memory blocks which are released all at once, at the
+ *        end of their lifetime
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __ARENA__
+#define __ARENA__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Alignment of the blocks in bytes */
+#define ARENA_ALIGN 16
+/** Minimum size of the chunks allocated by an arena */
+#define ARENA_CHUNK_SIZE 65536
+
+  /** Lifetimes of the memory blocks */
+  typedef enum
+  {
+    /** Tables allocated once by the loaders, released at the exit */
+    ARENA_PROCESS,
+    /** Level files, released when the next level begins */
+    ARENA_LEVEL,
+    ARENAS_NUMOF
+  }
+  ARENAS_ENUM;
+
+  char *arena_alloc (Uint32 lifetime, Uint32 size);
+  char *arena_string_duplicate (Uint32 lifetime, const char *str);
+  void arena_reset (Uint32 lifetime);
+  void arenas_free (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
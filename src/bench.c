@@ -0,0 +1,430 @@
+/**
+ * @file bench.c
+ * @brief Measure the frame rate and the time spent in each phase
+ *        of the main loop
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "bench.h"
+#include "images.h"
+#include "display.h"
+#include "electrical_shock.h"
+#include "enemies.h"
+#include "gfx_wrapper.h"
+#ifndef USE_ASSEMBLER_ROUTINES
+#include "gfxroutines.h"
+#endif
+#ifdef USE_SCALE2X
+#include "scalebit.h"
+#include "dirty_rects.h"
+#include "present_thread.h"
+#endif
+#include "log_recorder.h"
+
+/** Names of the phases, used in the report */
+static const char *bench_phase_names[BENCH_PHASES_NUMOF] = {
+  "update_frame",
+  "handle_events",
+  "update_window",
+  "sound_handle"
+};
+
+/** Cumulative time spent in each phase in microseconds */
+static Uint64 bench_phase_total[BENCH_PHASES_NUMOF];
+/** Longest time spent in each phase in microseconds */
+static Uint64 bench_phase_max[BENCH_PHASES_NUMOF];
+/** Time of the beginning of the benchmark */
+static Uint64 bench_time_begin;
+
+/**
+ * Reset the counters, called just before entering the main loop
+ */
+void
+bench_init (void)
+{
+  Uint32 i;
+  for (i = 0; i < BENCH_PHASES_NUMOF; i++)
+    {
+      bench_phase_total[i] = 0;
+      bench_phase_max[i] = 0;
+    }
+  bench_time_begin = get_ticks_usec ();
+}
+
+/**
+ * Add the time spent in a phase of the main loop
+ * @param phase Phase which just finished
+ * @param start Time at which the phase started, in microseconds
+ * @return Current time, used as the start of the next phase
+ */
+Uint64
+bench_phase_add (BENCH_PHASES phase, Uint64 start)
+{
+  Uint64 now = get_ticks_usec ();
+  Uint64 elapsed = now - start;
+  bench_phase_total[phase] += elapsed;
+  if (elapsed > bench_phase_max[phase])
+    {
+      bench_phase_max[phase] = elapsed;
+    }
+  return now;
+}
+
+/**
+ * Display the result of the benchmark on the standard output
+ */
+void
+bench_print (void)
+{
+  Uint32 i;
+  double duration, average, percent;
+  Uint64 total = get_ticks_usec () - bench_time_begin;
+  if (loops_counter == 0 || total == 0)
+    {
+      return;
+    }
+  duration = (double) total / 1000000.0;
+  fprintf (stdout, "frames         : %u\n", loops_counter);
+  fprintf (stdout, "running time   : %.3f s\n", duration);
+  fprintf (stdout, "frames/s       : %.1f\n", loops_counter / duration);
+  fprintf (stdout, "%-15s %12s %12s %8s\n", "phase", "avg (us)",
+           "max (us)", "%");
+  for (i = 0; i < BENCH_PHASES_NUMOF; i++)
+    {
+      average = (double) bench_phase_total[i] / loops_counter;
+      percent = 100.0 * bench_phase_total[i] / total;
+      fprintf (stdout, "%-15s %12.1f %12u %8.1f\n", bench_phase_names[i],
+               average, (Uint32) bench_phase_max[i], percent);
+    }
+  fprintf (stdout, "peak memory    : %u KiB\n", get_peak_memory_kb ());
+#if defined (USE_MALLOC_WRAPPER)
+  fprintf (stdout, "peak allocated : %u bytes\n", mem_maxreached_size);
+#endif
+}
+
+/**
+ * Draw every image of the enemies with each routine which copies the
+ * runs of pixels of the sprites, and display the time spent. The
+ * checksum of the offscreen must be the same for all the routines.
+ * At 8 and 24 bits per pixel the sprites are always copied with
+ * memcpy(), the other routines are only listed
+ * @param passes Number of times every image is drawn
+ */
+void
+bench_sprites (Uint32 passes)
+{
+  Sint32 kernel, numof_kernels;
+  Uint32 i, pass, numof_draws, checksum, size;
+  Uint64 start, elapsed;
+  const char *name;
+  unsigned char *pixel;
+  image *img;
+  image *images = &enemi[0][0];
+  Uint32 numof_images = sizeof (enemi) / sizeof (image);
+#ifdef USE_ASSEMBLER_ROUTINES
+  numof_kernels = 1;
+#else
+  Sint32 previous = sprite_copy_get ();
+  numof_kernels = SPRITE_COPY_NUMOF;
+#endif
+  size = offscreen_width * offscreen_height * bytes_per_pixel;
+  fprintf (stdout, "%-10s %12s %12s %10s\n", "routine", "time (ms)",
+           "ns/sprite", "checksum");
+  for (kernel = 0; kernel < numof_kernels; kernel++)
+    {
+#ifdef USE_ASSEMBLER_ROUTINES
+      name = "assembler";
+#else
+      if (!sprite_copy_set (kernel))
+        {
+          continue;
+        }
+      name = sprite_copy_name (kernel);
+      /* only the 16 and 32-bit sprites are drawn by these routines */
+      if (kernel != SPRITE_COPY_MEMCPY && bytes_per_pixel != 2
+          && bytes_per_pixel != 4)
+        {
+          fprintf (stdout, "%-10s not used at %u bits per pixel\n", name,
+                   bytes_per_pixel * 8);
+          continue;
+        }
+#endif
+      memset (game_offscreen, 0, size);
+      numof_draws = 0;
+      start = get_ticks_usec ();
+      for (pass = 0; pass < passes; pass++)
+        {
+          for (i = 0; i < numof_images; i++)
+            {
+              img = &images[i];
+              if (img->img == NULL || (img->nbr_data_comp >> 2) == 0)
+                {
+                  continue;
+                }
+              draw_sprite (img, offscreen_clipsize, offscreen_clipsize);
+              numof_draws++;
+            }
+        }
+      elapsed = get_ticks_usec () - start;
+      checksum = 0;
+      pixel = (unsigned char *) game_offscreen;
+      for (i = 0; i < size; i++)
+        {
+          checksum = (checksum ^ pixel[i]) * 16777619;
+        }
+      fprintf (stdout, "%-10s %12.3f %12.1f %10x\n", name,
+               (double) elapsed / 1000.0,
+               numof_draws > 0 ? (double) elapsed * 1000.0 / numof_draws :
+               0.0, checksum);
+    }
+#ifndef USE_ASSEMBLER_ROUTINES
+  sprite_copy_set (previous);
+#endif
+}
+
+#ifdef USE_SCALE2X
+/**
+ * Scale the visible area of the last frame with each implementation
+ * of the Scale2x and Scale3x effects and compare the results with the
+ * C implementation, at 16 and 32 bits per pixel
+ * @param passes Number of times each bitmap is scaled
+ */
+void
+bench_scale (Uint32 passes)
+{
+  Uint32 factor, pixel, kernel, previous, pass, x, y, width, height,
+    src_slice, dst_slice, size, color;
+  Uint64 start, elapsed;
+  Uint32 *src32;
+  char *src, *dst, *reference;
+  bool is_same;
+  /* the thread must not scale the last frame while the kernels
+   * and the areas are compared */
+  present_thread_wait ();
+  if (bytes_per_pixel != 4)
+    {
+      return;
+    }
+  width = offscreen_width_visible;
+  height = offscreen_height_visible;
+  size = width * height * 4 * 4 * 4;
+  src = memory_allocation (width * height * 4);
+  dst = memory_allocation (size);
+  reference = memory_allocation (size);
+  if (src == NULL || dst == NULL || reference == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes", size);
+      if (src != NULL)
+        {
+          free_memory (src);
+        }
+      if (dst != NULL)
+        {
+          free_memory (dst);
+        }
+      if (reference != NULL)
+        {
+          free_memory (reference);
+        }
+      return;
+    }
+  previous = scale_kernel_get ();
+  fprintf (stdout, "%-6s %-6s %-10s %12s %12s %10s\n", "scale", "bits",
+           "routine", "time (ms)", "us/frame", "result");
+  for (pixel = 2; pixel <= 4; pixel += 2)
+    {
+      /* visible area of the game offscreen, converted to RGB565 if
+       * needed */
+      for (y = 0; y < height; y++)
+        {
+          src32 = (Uint32 *) (game_offscreen +
+                              (offscreen_clipsize + y) * offscreen_pitch +
+                              offscreen_clipsize * 4);
+          for (x = 0; x < width; x++)
+            {
+              color = src32[x];
+              if (pixel == 4)
+                {
+                  ((Uint32 *) src)[y * width + x] = color;
+                }
+              else
+                {
+                  ((Uint16 *) src)[y * width + x] =
+                    (Uint16) (((color >> 8) & 0xf800) |
+                              ((color >> 5) & 0x07e0) |
+                              ((color >> 3) & 0x001f));
+                }
+            }
+        }
+      src_slice = width * pixel;
+      for (factor = 2; factor <= 4; factor++)
+        {
+          dst_slice = src_slice * factor;
+          for (kernel = 0; kernel < SCALE_KERNEL_NUMOF; kernel++)
+            {
+              if (scale_kernel_set (kernel) != 0)
+                {
+                  continue;
+                }
+              memset (dst, 0, size);
+              start = get_ticks_usec ();
+              for (pass = 0; pass < passes; pass++)
+                {
+                  scale (factor, dst, dst_slice, src, src_slice, pixel,
+                         width, height);
+                }
+              elapsed = get_ticks_usec () - start;
+              if (kernel == SCALE_KERNEL_DEF)
+                {
+                  memcpy (reference, dst, size);
+                }
+              is_same = memcmp (reference, dst, size) == 0;
+              fprintf (stdout, "%-6u %-6u %-10s %12.3f %12.1f %10s\n",
+                       factor, pixel * 8, scale_kernel_name (kernel),
+                       (double) elapsed / 1000.0,
+                       (double) elapsed / passes,
+                       is_same ? "ok" : "MISMATCH");
+            }
+        }
+    }
+  scale_kernel_set (previous);
+  free_memory (src);
+  free_memory (dst);
+  free_memory (reference);
+}
+/**
+ * Modify areas of copies of the score and the option panels, scale
+ * these areas over the panels already scaled, the way the modified
+ * areas are drawn into the window, and compare the results with the
+ * modified panels scaled in one go
+ */
+void
+bench_scale_areas (void)
+{
+  Uint32 factor, panel, width, height, pitch, dst_slice, size, i;
+  Sint32 x, y;
+  char *pixels, *copy, *dst, *reference;
+  dirty_rect rect;
+  bool is_same;
+  size = score_offscreen_width * score_offscreen_height;
+  if (size < OPTIONS_WIDTH * OPTIONS_HEIGHT)
+    {
+      size = OPTIONS_WIDTH * OPTIONS_HEIGHT;
+    }
+  copy = memory_allocation (size * bytes_per_pixel);
+  size *= 4 * 4 * window_bytes_per_pixel;
+  dst = memory_allocation (size);
+  reference = memory_allocation (size);
+  if (copy == NULL || dst == NULL || reference == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes", size);
+      if (copy != NULL)
+        {
+          free_memory (copy);
+        }
+      if (dst != NULL)
+        {
+          free_memory (dst);
+        }
+      if (reference != NULL)
+        {
+          free_memory (reference);
+        }
+      return;
+    }
+  fprintf (stdout, "%-6s %-8s %10s\n", "scale", "panel", "areas");
+  for (factor = 2; factor <= 4; factor++)
+    {
+      for (panel = 0; panel < DIRTY_PANELS_NUMOF; panel++)
+        {
+          if (panel == DIRTY_SCORE_PANEL)
+            {
+              pixels = scores_offscreen;
+              width = score_offscreen_width;
+              height = score_offscreen_height;
+              pitch = score_offscreen_pitch;
+            }
+          else
+            {
+              pixels = options_offscreen;
+              width = OPTIONS_WIDTH;
+              height = OPTIONS_HEIGHT;
+              pitch = OPTIONS_WIDTH * bytes_per_pixel;
+            }
+          dst_slice = width * factor * window_bytes_per_pixel;
+          memcpy (copy, pixels, height * pitch);
+          memset (dst, 0, size);
+          display_scale_game (factor, dst, dst_slice, copy, pitch, width,
+                              height);
+
+          /* odd sizes, so that the areas are not aligned with the
+           * panel nor with each other, one in two is modified */
+          rect.panel = panel;
+          rect.pitch = pitch;
+          for (y = 0; y < (Sint32) height; y += 5)
+            {
+              for (x = (y / 5) % 2 * 7; x < (Sint32) width; x += 14)
+                {
+                  /* at least DIRTY_RECT_MIN_SIZE pixels, as given by
+                   * dirty_rects_add() */
+                  rect.x = x;
+                  rect.y = y;
+                  rect.w = 7;
+                  rect.h = 5;
+                  if (x + rect.w > (Sint32) width)
+                    {
+                      rect.w = DIRTY_RECT_MIN_SIZE;
+                      rect.x = (Sint32) width - rect.w;
+                    }
+                  if (y + rect.h > (Sint32) height)
+                    {
+                      rect.h = DIRTY_RECT_MIN_SIZE;
+                      rect.y = (Sint32) height - rect.h;
+                    }
+                  rect.screen_x = rect.x;
+                  rect.screen_y = rect.y;
+                  rect.pixels =
+                    copy + rect.y * pitch + rect.x * bytes_per_pixel;
+                  for (i = 0; i < (Uint32) rect.h; i++)
+                    {
+                      memset (rect.pixels + i * pitch, (x + y) & 0xff,
+                              rect.w * bytes_per_pixel);
+                    }
+                  display_scale_dirty_rect (factor, &rect, dst, dst_slice);
+                }
+            }
+          memset (reference, 0, size);
+          display_scale_game (factor, reference, dst_slice, copy, pitch,
+                              width, height);
+          is_same = memcmp (reference, dst, size) == 0;
+          fprintf (stdout, "%-6u %-8s %10s\n", factor,
+                   panel == DIRTY_SCORE_PANEL ? "score" : "options",
+                   is_same ? "ok" : "MISMATCH");
+        }
+    }
+  free_memory (copy);
+  free_memory (dst);
+  free_memory (reference);
+}
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file bench.h
+ * @brief Measure the frame rate and the time spent in each phase
+ *        of the main loop
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __BENCH__
+#define __BENCH__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /** Phases of one iteration of the main loop */
+  typedef enum
+  {
+    BENCH_UPDATE_FRAME,
+    BENCH_HANDLE_EVENTS,
+    BENCH_UPDATE_WINDOW,
+    BENCH_SOUND,
+    BENCH_PHASES_NUMOF
+  } BENCH_PHASES;
+
+  void bench_init (void);
+  Uint64 bench_phase_add (BENCH_PHASES phase, Uint64 start);
+  void bench_print (void);
+  void bench_sprites (Uint32 passes);
+#ifdef USE_SCALE2X
+  void bench_scale (Uint32 passes);
+  void bench_scale_areas (void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
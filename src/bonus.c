@@ -28,6 +28,8 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
+#include "game_rand.h"
 #include "images.h"
 #include "config_file.h"
 #include "display.h"
@@ -41,6 +43,7 @@
 #include "menu_sections.h"
 #include "lonely_foes.h"
 #include "options_panel.h"
+#include "pool.h"
 #include "shots.h"
 #include "satellite_protections.h"
 #include "shockwave.h"
@@ -97,8 +100,8 @@ gem_str;
 
 /** Data structure of the gems */
 static gem_str *gems = NULL;
-static gem_str *gem_first = NULL;
-static gem_str *gem_last = NULL;
+/** Free list and chained list of the gems */
+static pool_struct gems_pool;
 static Sint32 num_of_gems = 0;
 
 static void bonus_new (float pos_x, float pos_y);
@@ -130,14 +133,21 @@ bonus_once_init (void)
   if (gems == NULL)
     {
       gems =
-        (gem_str *) memory_allocation (MAX_NUMOF_GEMS_ON_SCREEN *
-                                       sizeof (gem_str));
+        (gem_str *) arena_alloc (ARENA_PROCESS, MAX_NUMOF_GEMS_ON_SCREEN *
+                                 sizeof (gem_str));
       if (gems == NULL)
         {
           LOG_ERR ("not enough memory to allocate 'gems' structure");
           return FALSE;
         }
     }
+  if (!pool_init
+      (&gems_pool, "gem", (char *) gems, sizeof (gem_str),
+       MAX_NUMOF_GEMS_ON_SCREEN, offsetof (gem_str, next),
+       offsetof (gem_str, previous)))
+    {
+      return FALSE;
+    }
   return 1;
 }
 
@@ -202,8 +212,7 @@ bonus_init (void)
       gem = &gems[i];
       gem->is_enabled = FALSE;
     }
-  gem_first = NULL;
-  gem_last = NULL;
+  pool_reset (&gems_pool);
 }
 
 /**
@@ -214,11 +223,8 @@ bonus_free (void)
 {
   images_free (&bonus[0][0], GEM_NUMOF_TYPES, GEM_NUMOF_IMAGES,
                GEM_NUMOF_IMAGES);
-  if (gems != NULL)
-    {
-      free_memory ((char *) gems);
-      gems = NULL;
-    }
+  pool_free (&gems_pool);
+  gems = NULL;
 }
 
 /*
@@ -229,7 +235,7 @@ bonus_disable_all (void)
 {
   gem_str *gem;
   Sint32 i, n;
-  gem = gem_first;
+  gem = (gem_str *) gems_pool.first;
   if (gem == NULL)
     {
       return;
@@ -249,7 +255,7 @@ bonus_handle (void)
 {
   gem_str *gem;
   Sint32 i, n;
-  gem = gem_first;
+  gem = (gem_str *) gems_pool.first;
   if (gem == NULL)
     {
       return;
@@ -351,6 +357,19 @@ bonus_collision (const gem_str * const gem)
   gemx = (Sint32) gem->xcoord + gem_img->collisions_coords[0][XCOORD];
   gemy = (Sint32) gem->ycoord + gem_img->collisions_coords[0][YCOORD];
 
+  /* reject the gem if the bounding boxes do not overlap */
+  collisionx = (Sint32) ship->spr.xcoord;
+  collisiony = (Sint32) ship->spr.ycoord;
+  if (collisionx + ship_img->points_left >=
+      gemx + gem_img->collisions_sizes[0][IMAGE_WIDTH]
+      || collisionx + ship_img->points_right <= gemx
+      || collisiony + ship_img->points_top >=
+      gemy + gem_img->collisions_sizes[0][IMAGE_HEIGHT]
+      || collisiony + ship_img->points_bottom <= gemy)
+    {
+      return FALSE;
+    }
+
   /* for each collision point of the spaceship */
   for (i = 0; i < ship_img->numof_collisions_points; i++)
     {
@@ -375,7 +394,7 @@ bonus_collision (const gem_str * const gem)
               {
                 ship->gems_count++;
                 option_change = TRUE;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
                 sound_play (SOUND_GREEN_GEM);
 #endif
               }
@@ -388,7 +407,7 @@ bonus_collision (const gem_str * const gem)
               {
                 ship->gems_count += 2;
                 option_change = TRUE;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
                 sound_play (SOUND_RED_GEM);
 #endif
               }
@@ -400,7 +419,7 @@ bonus_collision (const gem_str * const gem)
             case BONUS_ADD_SATELLITE:
               {
                 satellite_add ();
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
                 sound_play (SOUND_YELLOW_GEM);
 #endif
               }
@@ -415,7 +434,7 @@ bonus_collision (const gem_str * const gem)
                 if (ship->spr.energy_level < ship->spr.pow_of_dest)
                   {
                     option_boxes[1].close_option = FALSE;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
                     sound_play (SOUND_PURPLE_GEM);
 #endif
                   }
@@ -520,13 +539,13 @@ bonus_new (float pos_x, float pos_y)
 
   /* get a bonus or penality value according to the difficulty */
   if (num_level == 0)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 35)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 35)));
   if (num_level == 1)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 40)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 40)));
   if (num_level == 2)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 45)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 45)));
   if (num_level >= 3)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 50)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 50)));
   btype = bonus_get (btype);
   switch (btype)
     {
@@ -680,13 +699,13 @@ bonus_meteor_new (float pos_x, float pos_y)
 
   /* get a bonus or penality value according to the difficulty */
   if (num_level == 0)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 30)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 30)));
   if (num_level == 1)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 40)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 40)));
   if (num_level == 2)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 50)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 50)));
   if (num_level >= 3)
-    btype = (((Sint32) rand () % ((ship->type << 2) + 60)));
+    btype = (((Sint32) game_rand () % ((ship->type << 2) + 60)));
   btype = bonus_meteor_get (btype);
 
   switch (btype)
@@ -785,7 +804,7 @@ bonus_meteor_get (Sint32 value)
         {
           btype = BONUS_INC_ENERGY;
         }
-      else if (value == 40 && !(rand () % 3))
+      else if (value == 40 && !(game_rand () % 3))
         {
           btype = BONUS_SCR_MULTIPLIER;
         }
@@ -800,23 +819,24 @@ bonus_meteor_get (Sint32 value)
         {
           btype = BONUS_INC_BY_1;
         }
-      if (value == 5 && (rand () % 2))
+      if (value == 5 && (game_rand () % 2))
         {
           btype = BONUS_INC_BY_2;
         }
-      else if (value == 6 && (rand () % 2))
+      else if (value == 6 && (game_rand () % 2))
         {
           btype = BONUS_ADD_SATELLITE;
         }
-      else if ((value == 7 || value == 35 || value == 50) && (rand () % 2))
+      else if ((value == 7 || value == 35 || value == 50)
+               && (game_rand () % 2))
         {
           btype = BONUS_INC_ENERGY;
         }
-      else if (value == 40 && !(rand () % 6))
+      else if (value == 40 && !(game_rand () % 6))
         {
           btype = BONUS_SCR_MULTIPLIER;
         }
-      else if (!(rand () % 6))
+      else if (!(game_rand () % 6))
         {
           btype = PENALITY_LONELY_FOE;
         }
@@ -825,58 +845,6 @@ bonus_meteor_get (Sint32 value)
   return btype;
 }
 
-/**
- * Check validty of bonus.chained list
- */
-#ifdef UNDER_DEVELOPMENT
-static void
-bonus_check_chained_list (void)
-{
-  Sint32 i;
-  gem_str *gem;
-  Sint32 count = 0;
-  for (i = 0; i < MAX_NUMOF_GEMS_ON_SCREEN; i++)
-    {
-      gem = &gems[i];
-      if (gem->is_enabled)
-        {
-          count++;
-        }
-    }
-  if (count != num_of_gems)
-    {
-      LOG_ERR ("Counting of the enabled elements failed!"
-               "count=%i, num_of_gems=%i", count, num_of_gems);
-    }
-  count = 0;
-  gem = gem_first;
-  do
-    {
-      count++;
-      gem = gem->next;
-    }
-  while (gem != NULL && count <= (MAX_NUMOF_GEMS_ON_SCREEN + 1));
-  if (count != num_of_gems)
-    {
-      LOG_ERR ("Counting of the next elements failed!"
-               "count=%i, num_of_gems=%i", count, num_of_gems);
-    }
-  count = 0;
-  gem = gem_last;
-  do
-    {
-      count++;
-      gem = gem->previous;
-    }
-  while (gem != NULL && count <= (MAX_NUMOF_GEMS_ON_SCREEN + 1));
-  if (count != num_of_gems)
-    {
-      LOG_ERR ("Counting of the previous elements failed!"
-               "count=%i, num_of_gems=%i", count, num_of_gems);
-    }
-}
-#endif
-
 /** 
  * Return a free gem element 
  * @return Pointer to a gem structure, NULL if not gem available 
@@ -884,37 +852,15 @@ bonus_check_chained_list (void)
 static gem_str *
 bonus_get_gem (void)
 {
-  Sint32 i;
-  gem_str *gem;
-  for (i = 0; i < MAX_NUMOF_GEMS_ON_SCREEN; i++)
+  gem_str *gem = (gem_str *) pool_get (&gems_pool);
+  if (gem == NULL)
     {
-      gem = &gems[i];
-      if (gem->is_enabled)
-        {
-          continue;
-        }
-      gem->is_enabled = TRUE;
-      gem->next = NULL;
-      if (num_of_gems == 0)
-        {
-          gem_first = gem;
-          gem_last = gem;
-          gem_last->previous = NULL;
-        }
-      else
-        {
-          gem_last->next = gem;
-          gem->previous = gem_last;
-          gem_last = gem;
-        }
-      num_of_gems++;
-#ifdef UNDER_DEVELOPMENT
-      bonus_check_chained_list ();
-#endif
-      return gem;
+      LOG_ERR ("no more element gem is available");
+      return NULL;
     }
-  LOG_ERR ("no more element gem is available");
-  return NULL;
+  gem->is_enabled = TRUE;
+  num_of_gems = gems_pool.numof_enabled;
+  return gem;
 }
 
 /** 
@@ -924,21 +870,6 @@ static void
 bonus_del_gem (gem_str * gem)
 {
   gem->is_enabled = FALSE;
-  num_of_gems--;
-  if (gem_first == gem)
-    {
-      gem_first = gem->next;
-    }
-  if (gem_last == gem)
-    {
-      gem_last = gem->previous;
-    }
-  if (gem->previous != NULL)
-    {
-      gem->previous->next = gem->next;
-    }
-  if (gem->next != NULL)
-    {
-      gem->next->previous = gem->previous;
-    }
+  pool_release (&gems_pool, (char *) gem);
+  num_of_gems = gems_pool.numof_enabled;
 }
@@ -28,7 +28,7 @@
 #include "powermanga.h"
 #include "tools.h"
 #include "config_file.h"
-#include "lispreader.h"
+#include "game_rand.h"
 #include "log_recorder.h"
 
 #define CONFIG_DIR_NAME "tlk-games"
@@ -44,6 +44,76 @@ static char *configname = NULL;
 static bool configfile_check_dir ();
 static void configfile_reset_values ();
 
+/** Types of the values of the configuration keys */
+typedef enum
+{
+  /** #t or #f */
+  CONFIG_BOOL,
+  /** One or more integers */
+  CONFIG_INT,
+  /** "en", "fr" or "it" */
+  CONFIG_LANG
+} CONFIG_TYPES;
+
+/** Key of the configuration file, and where its values are stored */
+typedef struct config_key
+{
+  const char *name;
+  /** CONFIG_BOOL, CONFIG_INT or CONFIG_LANG */
+  Uint32 type;
+  /** Offset of the first value in the config_file structure */
+  size_t offset;
+  /** Number of values, they follow each other in the structure */
+  Uint32 numof;
+} config_key;
+
+/** Keys read from the configuration file */
+static const config_key config_keys[] = {
+  {"lang", CONFIG_LANG, offsetof (config_file, lang), 1},
+  {"fullscreen", CONFIG_BOOL, offsetof (config_file, fullscreen), 1},
+  {"nosound", CONFIG_BOOL, offsetof (config_file, nosound), 1},
+  {"nosync", CONFIG_BOOL, offsetof (config_file, nosync), 1},
+  {"texture", CONFIG_BOOL, offsetof (config_file, texture), 1},
+  {"present_thread", CONFIG_BOOL, offsetof (config_file, present_thread), 1},
+  {"palettized", CONFIG_BOOL, offsetof (config_file, palettized), 1},
+  {"sprite_packs", CONFIG_BOOL, offsetof (config_file, sprite_packs), 1},
+  {"verbose", CONFIG_INT, offsetof (config_file, verbose), 1},
+  {"scale_x", CONFIG_INT, offsetof (config_file, scale_x), 1},
+  {"resolution", CONFIG_INT, offsetof (config_file, resolution), 1},
+  {"threads", CONFIG_INT, offsetof (config_file, threads), 1},
+  {"joy_config", CONFIG_INT, offsetof (config_file, joy_x_axis), 5}
+};
+#define CONFIG_KEYS_NUMOF (sizeof (config_keys) / sizeof (config_key))
+
+/** Tokens of the configuration file */
+typedef enum
+{
+  CONFIG_TOKEN_OPEN_PAREN,
+  CONFIG_TOKEN_CLOSE_PAREN,
+  CONFIG_TOKEN_TRUE,
+  CONFIG_TOKEN_FALSE,
+  CONFIG_TOKEN_INTEGER,
+  CONFIG_TOKEN_STRING,
+  CONFIG_TOKEN_SYMBOL,
+  CONFIG_TOKEN_EOF,
+  CONFIG_TOKEN_ERROR
+} CONFIG_TOKENS;
+
+/** Configuration file being scanned, the tokens point into its data */
+typedef struct config_scanner
+{
+  /** Next character to read */
+  const char *cur;
+  /** End of the data */
+  const char *end;
+  /** First character of the last token */
+  const char *token;
+  /** Length of the last token */
+  Uint32 length;
+  /** Value of the last integer token */
+  Sint32 integer;
+} config_scanner;
+
 /** 
  * Reset all configuration values
  */
@@ -52,6 +122,10 @@ configfile_reset_values ()
 {
   power_conf->fullscreen = TRUE;
   power_conf->nosound = FALSE;
+  power_conf->texture = FALSE;
+  power_conf->present_thread = FALSE;
+  power_conf->palettized = FALSE;
+  power_conf->sprite_packs = TRUE;
   power_conf->resolution = 640;
   power_conf->verbose = 0;
   power_conf->difficulty = 1;
@@ -81,6 +155,19 @@ configfile_reset_values ()
     }
 #endif
   power_conf->extract_to_png = FALSE;
+  power_conf->bench_frames = 0;
+  power_conf->bench_sprites = 0;
+  power_conf->threads = 0;
+  power_conf->seed = GAME_RAND_DEFAULT_SEED;
+  power_conf->record_file = NULL;
+  power_conf->replay_file = NULL;
+#ifdef USE_PROFILER
+  power_conf->profile_file = NULL;
+#endif
+#ifdef USE_SOFTMIXER
+  power_conf->sound_output = NULL;
+  power_conf->sound_null = FALSE;
+#endif
   power_conf->joy_x_axis = 0;
   power_conf->joy_y_axis = 1;
   power_conf->joy_fire = 0;
@@ -96,13 +183,18 @@ configfile_print (void)
 {
   LOG_INF ("fullscreen: %i; nosound: %i; resolution: %i; "
            "verbose: %i; difficulty: %i; lang: %s; scale_x: %i"
-           "; joy_config %i %i %i %i %i; nosync: %i",
+           "; joy_config %i %i %i %i %i; nosync: %i; threads: %i"
+           "; texture: %i; present_thread: %i; palettized: %i"
+           "; sprite_packs: %i",
            power_conf->fullscreen, power_conf->nosound,
            power_conf->resolution, power_conf->verbose,
            power_conf->difficulty, lang_to_text[power_conf->lang],
            power_conf->scale_x, power_conf->joy_x_axis,
            power_conf->joy_y_axis, power_conf->joy_fire,
-           power_conf->joy_option, power_conf->joy_start, power_conf->nosync);
+           power_conf->joy_option, power_conf->joy_start, power_conf->nosync,
+           power_conf->threads, power_conf->texture,
+           power_conf->present_thread, power_conf->palettized,
+           power_conf->sprite_packs);
 }
 
 /** 
@@ -189,6 +281,305 @@ configfile_check_dir (void)
   return TRUE;
 }
 
+/**
+ * Read the next token of the configuration file, without copying it
+ * @param scan The configuration file being scanned
+ * @return CONFIG_TOKEN_OPEN_PAREN, CONFIG_TOKEN_CLOSE_PAREN, ...
+ */
+static Uint32
+config_next_token (config_scanner * scan)
+{
+  const char *cur = scan->cur;
+  const char *end = scan->end;
+  Uint32 token;
+  bool have_digits = FALSE, have_nondigits = FALSE;
+  Sint32 value = 0;
+
+  /* skip the blanks and the comments */
+  while (cur < end)
+    {
+      if (*cur == ';')
+        {
+          while (cur < end && *cur != '\n')
+            {
+              cur++;
+            }
+        }
+      else if (isspace ((unsigned char) *cur))
+        {
+          cur++;
+        }
+      else
+        {
+          break;
+        }
+    }
+  scan->token = cur;
+  scan->length = 0;
+  if (cur >= end)
+    {
+      scan->cur = cur;
+      return CONFIG_TOKEN_EOF;
+    }
+  switch (*cur)
+    {
+    case '(':
+      scan->cur = cur + 1;
+      return CONFIG_TOKEN_OPEN_PAREN;
+    case ')':
+      scan->cur = cur + 1;
+      return CONFIG_TOKEN_CLOSE_PAREN;
+    case '"':
+      /* the token is the string between the quotes */
+      scan->token = ++cur;
+      while (cur < end && *cur != '"')
+        {
+          if (*cur == '\\')
+            {
+              cur++;
+            }
+          cur++;
+        }
+      if (cur >= end)
+        {
+          scan->cur = end;
+          return CONFIG_TOKEN_ERROR;
+        }
+      scan->length = cur - scan->token;
+      scan->cur = cur + 1;
+      return CONFIG_TOKEN_STRING;
+    case '#':
+      if (cur + 1 < end && (cur[1] == 't' || cur[1] == 'f'))
+        {
+          scan->cur = cur + 2;
+          return cur[1] == 't' ? CONFIG_TOKEN_TRUE : CONFIG_TOKEN_FALSE;
+        }
+      scan->cur = end;
+      return CONFIG_TOKEN_ERROR;
+    }
+
+  /* integer or symbol, up to a blank or a delimiter */
+  token = CONFIG_TOKEN_SYMBOL;
+  while (cur < end && !isspace ((unsigned char) *cur)
+         && strchr ("\"();", *cur) == NULL)
+    {
+      if (isdigit ((unsigned char) *cur))
+        {
+          have_digits = TRUE;
+          value = value * 10 + (*cur - '0');
+        }
+      else if (*cur != '-' || cur != scan->token)
+        {
+          have_nondigits = TRUE;
+        }
+      cur++;
+    }
+  if (have_digits && !have_nondigits)
+    {
+      token = CONFIG_TOKEN_INTEGER;
+      scan->integer = *scan->token == '-' ? -value : value;
+    }
+  scan->length = cur - scan->token;
+  scan->cur = cur;
+  return token;
+}
+
+/**
+ * Skip the end of a list, up to its closing parenthesis
+ * @param scan The configuration file being scanned
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+config_skip_list (config_scanner * scan)
+{
+  Uint32 depth = 1;
+  while (depth > 0)
+    {
+      switch (config_next_token (scan))
+        {
+        case CONFIG_TOKEN_OPEN_PAREN:
+          depth++;
+          break;
+        case CONFIG_TOKEN_CLOSE_PAREN:
+          depth--;
+          break;
+        case CONFIG_TOKEN_EOF:
+        case CONFIG_TOKEN_ERROR:
+          return FALSE;
+        }
+    }
+  return TRUE;
+}
+
+/**
+ * Read the values of a key of the configuration file, the opening
+ * parenthesis and the name of the key were read
+ * @param scan The configuration file being scanned
+ * @param key The key, or NULL if its values are ignored
+ * @param conf The configuration which receives the values
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+config_read_values (config_scanner * scan, const config_key * key,
+                    config_file * conf)
+{
+  Uint32 i, token;
+  Uint32 numof = key != NULL ? key->numof : 0;
+  char *value = key != NULL ? (char *) conf + key->offset : NULL;
+  for (i = 0;; i++)
+    {
+      token = config_next_token (scan);
+      switch (token)
+        {
+        case CONFIG_TOKEN_CLOSE_PAREN:
+          return TRUE;
+        case CONFIG_TOKEN_OPEN_PAREN:
+          if (!config_skip_list (scan))
+            {
+              return FALSE;
+            }
+          break;
+        case CONFIG_TOKEN_EOF:
+        case CONFIG_TOKEN_ERROR:
+          return FALSE;
+        }
+      if (i >= numof)
+        {
+          continue;
+        }
+      switch (key->type)
+        {
+        case CONFIG_BOOL:
+          if (token == CONFIG_TOKEN_TRUE || token == CONFIG_TOKEN_FALSE)
+            {
+              *(bool *) value = token == CONFIG_TOKEN_TRUE;
+              continue;
+            }
+          break;
+        case CONFIG_INT:
+          if (token == CONFIG_TOKEN_INTEGER)
+            {
+              ((Sint32 *) value)[i] = scan->integer;
+              continue;
+            }
+          break;
+        case CONFIG_LANG:
+          if (token == CONFIG_TOKEN_STRING)
+            {
+              *(Sint32 *) value = EN_LANG;
+              if (scan->length == 2 && strncmp (scan->token, "fr", 2) == 0)
+                {
+                  *(Sint32 *) value = FR_LANG;
+                }
+              else if (scan->length == 2
+                       && strncmp (scan->token, "it", 2) == 0)
+                {
+                  *(Sint32 *) value = IT_LANG;
+                }
+              continue;
+            }
+          break;
+        }
+      /* the values which follow a wrong value are ignored */
+      LOG_ERR ("unexpected value for the key '%s'", key->name);
+      numof = 0;
+    }
+}
+
+/**
+ * Read the configuration file in a single pass. The file is a list
+ * "(powermanga-config (key value ...) ...)", the values of the keys
+ * are stored according to the table of the keys, the other keys are
+ * ignored
+ * @param filename The filename specified by path
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+configfile_read (const char *filename)
+{
+  Uint32 i, filesize, token;
+  Uint32 seen = 0;
+  char *filedata;
+  const config_key *key;
+  config_scanner scan;
+  config_file conf;
+  filedata = load_absolute_file (filename, &filesize);
+  if (filedata == NULL)
+    {
+      return FALSE;
+    }
+  scan.cur = filedata;
+  scan.end = filedata + filesize;
+  if (config_next_token (&scan) != CONFIG_TOKEN_OPEN_PAREN
+      || config_next_token (&scan) != CONFIG_TOKEN_SYMBOL
+      || scan.length != strlen ("powermanga-config")
+      || strncmp (scan.token, "powermanga-config", scan.length) != 0)
+    {
+      LOG_ERR ("%s is not a configuration file!", filename);
+      free_memory (filedata);
+      return FALSE;
+    }
+
+  /* the values are kept only if the whole file is read */
+  conf = *power_conf;
+  conf.lang = EN_LANG;
+  for (;;)
+    {
+      switch (config_next_token (&scan))
+        {
+        case CONFIG_TOKEN_CLOSE_PAREN:
+          *power_conf = conf;
+          free_memory (filedata);
+          return TRUE;
+        case CONFIG_TOKEN_OPEN_PAREN:
+          break;
+        default:
+          LOG_ERR ("%s: syntax error at offset %i", filename,
+                   (Sint32) (scan.token - filedata));
+          free_memory (filedata);
+          return FALSE;
+        }
+      /* search the key, only its first occurrence is read */
+      token = config_next_token (&scan);
+      if (token == CONFIG_TOKEN_CLOSE_PAREN)
+        {
+          continue;
+        }
+      key = NULL;
+      if (token == CONFIG_TOKEN_SYMBOL)
+        {
+          for (i = 0; i < CONFIG_KEYS_NUMOF; i++)
+            {
+              if (strlen (config_keys[i].name) == scan.length
+                  && strncmp (config_keys[i].name, scan.token,
+                              scan.length) == 0)
+                {
+                  if (!(seen & (1 << i)))
+                    {
+                      key = &config_keys[i];
+                      seen |= 1 << i;
+                    }
+                  break;
+                }
+            }
+        }
+      else if ((token == CONFIG_TOKEN_OPEN_PAREN
+                && !config_skip_list (&scan)) || token == CONFIG_TOKEN_EOF)
+        {
+          token = CONFIG_TOKEN_ERROR;
+        }
+      /* an entry which does not begin by a key is ignored */
+      if (token == CONFIG_TOKEN_ERROR
+          || !config_read_values (&scan, key, &conf))
+        {
+          LOG_ERR ("%s: syntax error at offset %i", filename,
+                   (Sint32) (scan.token - filedata));
+          free_memory (filedata);
+          return FALSE;
+        }
+    }
+}
+
 /**
  * Load configuration file from "~/.tlkgames/powermanga.conf"
  * @return TRUE if it completed successfully or FALSE otherwise
@@ -199,8 +590,6 @@ configfile_load (void)
 #if !defined(_WIN32_WCE)
   Uint32 length;
 #endif
-  lisp_object_t *root_obj, *lst, *sub;
-  char *str;
   /* allocate config structure */
   if (power_conf == NULL)
     {
@@ -214,6 +603,12 @@ configfile_load (void)
   configfile_reset_values ();
   if (!configfile_check_dir ())
     {
+      /* neither configuration file nor sprite packs */
+      if (config_dir != NULL)
+        {
+          free_memory (config_dir);
+          config_dir = NULL;
+        }
       return TRUE;
     }
 
@@ -238,73 +633,14 @@ configfile_load (void)
     }
   sprintf (configname, "%s/%s", config_dir, config_file_name);
   LOG_INF ("configuration filename: %s", configname);
-  root_obj = lisp_read_file (configname);
-  if (root_obj == NULL)
+  if (!configfile_read (configname))
     {
-      LOG_ERR ("lisp_read_file(%s) failed!", configname);
       return TRUE;
     }
-  if (root_obj->type == LISP_TYPE_EOF
-      || root_obj->type == LISP_TYPE_PARSE_ERROR)
-    {
-      LOG_ERR ("lisp_read_file(%s) failed!", configname);
-      lisp_free (root_obj);
-      return TRUE;
-    }
-  if (strcmp (lisp_symbol (lisp_car (root_obj)), "powermanga-config") != 0)
-    {
-      LOG_ERR ("lisp_read_file(%s) failed!", configname);
-      lisp_free (root_obj);
-      return TRUE;
-    }
-  lst = lisp_cdr (root_obj);
-  if (!lisp_read_string (lst, "lang", &str))
-    {
-      power_conf->lang = EN_LANG;
-    }
-  else
-    {
-      if (strcmp (str, "fr") == 0)
-        {
-          power_conf->lang = FR_LANG;
-        }
-      else if (strcmp (str, "it") == 0)
-        {
-          power_conf->lang = IT_LANG;
-        }
-      else
-        {
-          power_conf->lang = EN_LANG;
-        }
-    }
-  if (!lisp_read_bool (lst, "fullscreen", &power_conf->fullscreen))
-    {
-      power_conf->fullscreen = TRUE;
-    }
-  if (!lisp_read_bool (lst, "nosound", &power_conf->nosound))
-    {
-      power_conf->nosound = FALSE;
-    }
-  if (!lisp_read_bool (lst, "nosync", &power_conf->nosync))
-    {
-      power_conf->nosync = FALSE;
-    }
-  if (!lisp_read_int (lst, "verbose", &power_conf->verbose))
-    {
-      power_conf->verbose = 0;
-    }
-  if (!lisp_read_int (lst, "scale_x", &power_conf->scale_x))
-    {
-      power_conf->scale_x = 2;
-    }
   if (power_conf->scale_x < 1 || power_conf->scale_x > 4)
     {
       power_conf->scale_x = 2;
     }
-  if (!lisp_read_int (lst, "resolution", &power_conf->resolution))
-    {
-      power_conf->resolution = 640;
-    }
   if (power_conf->resolution != 320 && power_conf->resolution != 640)
     {
       power_conf->resolution = 640;
@@ -313,32 +649,28 @@ configfile_load (void)
     {
       power_conf->resolution = 640;
     }
-  sub = search_for (lst, "joy_config");
-  if (sub)
-    sub = lisp_car_int (sub, &power_conf->joy_x_axis);
-  if (sub)
-    sub = lisp_car_int (sub, &power_conf->joy_y_axis);
-  if (sub)
-    sub = lisp_car_int (sub, &power_conf->joy_fire);
-  if (sub)
-    sub = lisp_car_int (sub, &power_conf->joy_option);
-  if (sub)
-    sub = lisp_car_int (sub, &power_conf->joy_start);
-  lisp_free (root_obj);
-
+  if (power_conf->threads < 0)
+    {
+      power_conf->threads = 0;
+    }
 configfile_print();
 
   return TRUE;
 }
 
 /** 
- * Save config file "~/.tlkgames/powermanga.conf"
+ * Save config file "~/.tlkgames/powermanga.conf". It is written under
+ * a temporary name then renamed, an interrupted save never leaves
+ * a truncated configuration file
  */
 void
 configfile_save (void)
 {
   FILE *config;
-  if (power_conf->extract_to_png)
+  char *tmpname;
+  bool failed;
+  if (power_conf->extract_to_png || power_conf->bench_frames > 0
+      || power_conf->bench_sprites > 0 || power_conf->replay_file != NULL)
     {
       return;
     }
@@ -347,9 +679,17 @@ configfile_save (void)
       LOG_ERR ("config filename is not defined");
       return;
     }
-  config = fopen_data (configname, "w");
+  tmpname = memory_allocation (strlen (configname) + 5);
+  if (tmpname == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate the temporary filename");
+      return;
+    }
+  sprintf (tmpname, "%s.tmp", configname);
+  config = fopen_data (tmpname, "w");
   if (config == NULL)
     {
+      free_memory (tmpname);
       return;
     }
   fprintf (config, "(powermanga-config\n");
@@ -358,6 +698,13 @@ configfile_save (void)
            power_conf->fullscreen ? "#t" : "#f");
   fprintf (config, "\t(nosound %s)\n", power_conf->nosound ? "#t" : "#f");
   fprintf (config, "\t(nosync %s)\n", power_conf->nosync ? "#t" : "#f");
+  fprintf (config, "\t(texture %s)\n", power_conf->texture ? "#t" : "#f");
+  fprintf (config, "\t(present_thread %s)\n",
+           power_conf->present_thread ? "#t" : "#f");
+  fprintf (config, "\t(palettized %s)\n",
+           power_conf->palettized ? "#t" : "#f");
+  fprintf (config, "\t(sprite_packs %s)\n",
+           power_conf->sprite_packs ? "#t" : "#f");
 
   fprintf (config, "\n\t;; window size (320 or 640):\n");
   fprintf (config, "\t(resolution  %d)\n", power_conf->resolution);
@@ -365,6 +712,10 @@ configfile_save (void)
   fprintf (config, "\n\t;; scale_x (1, 2, 3 or 4):\n");
   fprintf (config, "\t(scale_x   %d)\n", power_conf->scale_x);
 
+  fprintf (config,
+           "\n\t;; threads used to scale the screen (0 = one per processor):\n");
+  fprintf (config, "\t(threads   %d)\n", power_conf->threads);
+
   fprintf (config,
            "\n\t;; joy_config x_axis y_axis fire_button option_button start_button):\n");
   fprintf (config, "\t(joy_config %d %d %d %d %d)\n", power_conf->joy_x_axis,
@@ -378,20 +729,27 @@ configfile_save (void)
   fprintf (config, "\n\t;; difficulty 0 (easy), 1 (normal) or 2 (hard)\n");
   fprintf (config, "\t(difficulty   %d)\n", power_conf->difficulty);
 
-  fprintf (config, "\n\t;; langage en or fr\n");
-  fprintf (config, "\t(lang      ");
-  switch (power_conf->lang)
-    {
-    case FR_LANG:
-      fprintf (config, "\"fr\")\n");
-      break;
-    default:
-      fprintf (config, "\"en\")\n");
-      break;
-    }
+  fprintf (config, "\n\t;; langage en, fr or it\n");
+  fprintf (config, "\t(lang      \"%s\")\n", lang_to_text[power_conf->lang]);
   fprintf (config, ")\n");
 
-  fclose (config);
+  failed = ferror (config) != 0;
+  if (fclose (config) != 0 || failed)
+    {
+      LOG_ERR ("can't write %s", tmpname);
+      remove (tmpname);
+      free_memory (tmpname);
+      return;
+    }
+#ifdef WIN32
+  remove (configname);
+#endif
+  if (rename (tmpname, configname) != 0)
+    {
+      LOG_ERR ("rename(%s) failed", tmpname);
+      remove (tmpname);
+    }
+  free_memory (tmpname);
 }
 
 /**
@@ -453,6 +811,26 @@ configfile_scan_arguments (Sint32 arg_count, char **arg_values)
           fprintf (stdout, "--window       windowed mode\n");
           fprintf (stdout, "--fullscreen   fullscreen mode\n");
 #endif
+#ifdef POWERMANGA_SDL2
+          fprintf (stdout, "--texture      scale the frames with the SDL2"
+                   " renderer\n");
+          fprintf (stdout, "--surface      scale the frames with the CPU\n");
+#endif
+          fprintf (stdout, "--present-thread\n"
+                   "               scale a frame while the next one is"
+                   " drawn\n");
+          fprintf (stdout, "--no-present-thread\n"
+                   "               scale the frames with the main thread\n");
+          fprintf (stdout, "--palettized   draw the game with 256 colors and"
+                   " expand them\n"
+                   "               when the frames are scaled\n");
+          fprintf (stdout, "--no-palettized\n"
+                   "               draw the game with the colors of the"
+                   " screen\n");
+          fprintf (stdout, "--sprite-packs map the sprites already converted"
+                   " for the display\n");
+          fprintf (stdout, "--no-sprite-packs\n"
+                   "               convert the sprites at each start\n");
           fprintf (stdout,
 #if defined(POWERMANGA_LOG_ENABLED)
                    "-q             \n"
@@ -462,8 +840,34 @@ configfile_scan_arguments (Sint32 arg_count, char **arg_values)
                    "--nosound      disable sound and musics\n"
                    "--sound        enable sound and musics\n"
                    "--nosync       disable timer\n"
+                   "--bench N      run N frames without timer nor sound,\n"
+                   "               then print the frame rate and exit\n"
+                   "--bench-sprites N\n"
+                   "               draw N times every enemy sprite with each\n"
+                   "               sprite routine, then print the timings\n"
+                   "--threads N    load the assets and scale the screen with N\n"
+                   "               threads, 0 to use one thread per processor\n"
+                   "--record FILE  record the inputs of each frame to FILE\n"
+                   "--replay FILE  replay the inputs recorded in FILE\n"
+                   "               without timer, then exit\n"
+                   "--seed N       seed of the random number generator\n"
                    "--easy         easy bonuses\n"
-                   "--hard         hard bonuses\n"
+                   "--hard         hard bonuses\n");
+#ifdef USE_PROFILER
+          fprintf (stdout,
+                   "--profile FILE write the timings of the last frames to\n"
+                   "               FILE on exit, CSV if FILE ends with .csv,\n"
+                   "               Chrome trace JSON otherwise\n");
+#endif
+#ifdef USE_SOFTMIXER
+          fprintf (stdout,
+                   "--sound-output FILE\n"
+                   "               enable the sounds and write them mixed\n"
+                   "               to the WAV FILE, also with --bench\n"
+                   "--sound-null   enable the sounds and discard them once\n"
+                   "               mixed, also with --bench\n");
+#endif
+          fprintf (stdout,
                    "--------------------------------------------------------------\n"
                    "keys recognized during the game:\n"
                    "[Ctrl] + [S]   enable/disable the music\n"
@@ -476,6 +880,10 @@ configfile_scan_arguments (Sint32 arg_count, char **arg_values)
 #ifdef POWERMANGA_SDL
           fprintf (stdout,
                    "F              switch between full screen and windowed mode\n");
+#endif
+#ifdef USE_PROFILER
+          fprintf (stdout,
+                   "[F12]          write the timings of the last frames\n");
 #endif
           return FALSE;
 
@@ -504,6 +912,54 @@ configfile_scan_arguments (Sint32 arg_count, char **arg_values)
           continue;
         }
 
+      /* upload the frames into a texture scaled by the renderer */
+      if (!strcmp (arg_values[i], "--texture"))
+        {
+          power_conf->texture = TRUE;
+          continue;
+        }
+      if (!strcmp (arg_values[i], "--surface"))
+        {
+          power_conf->texture = FALSE;
+          continue;
+        }
+
+      /* scale the frames with a thread */
+      if (!strcmp (arg_values[i], "--present-thread"))
+        {
+          power_conf->present_thread = TRUE;
+          continue;
+        }
+      if (!strcmp (arg_values[i], "--no-present-thread"))
+        {
+          power_conf->present_thread = FALSE;
+          continue;
+        }
+
+      /* draw the game with 8-bit indexes */
+      if (!strcmp (arg_values[i], "--palettized"))
+        {
+          power_conf->palettized = TRUE;
+          continue;
+        }
+      if (!strcmp (arg_values[i], "--no-palettized"))
+        {
+          power_conf->palettized = FALSE;
+          continue;
+        }
+
+      /* map the converted sprites */
+      if (!strcmp (arg_values[i], "--sprite-packs"))
+        {
+          power_conf->sprite_packs = TRUE;
+          continue;
+        }
+      if (!strcmp (arg_values[i], "--no-sprite-packs"))
+        {
+          power_conf->sprite_packs = FALSE;
+          continue;
+        }
+
       /* resolution, low-res or high-res */
       if (!strcmp (arg_values[i], "--320"))
         {
@@ -599,6 +1055,124 @@ configfile_scan_arguments (Sint32 arg_count, char **arg_values)
           continue;
         }
 
+      /* benchmark: run a fixed number of frames as fast as possible */
+      if (!strcmp (arg_values[i], "--bench"))
+        {
+          if (i + 1 >= arg_count
+              || sscanf (arg_values[++i], "%d",
+                         &power_conf->bench_frames) != 1
+              || power_conf->bench_frames < 1)
+            {
+              LOG_ERR ("--bench expects a number of frames greater than 0");
+              return FALSE;
+            }
+          power_conf->nosync = TRUE;
+          power_conf->nosound = TRUE;
+          continue;
+        }
+
+      /* benchmark of the routines which draw the sprites */
+      if (!strcmp (arg_values[i], "--bench-sprites"))
+        {
+          if (i + 1 >= arg_count
+              || sscanf (arg_values[++i], "%d",
+                         &power_conf->bench_sprites) != 1
+              || power_conf->bench_sprites < 1)
+            {
+              LOG_ERR ("--bench-sprites expects a number of passes "
+                       "greater than 0");
+              return FALSE;
+            }
+          power_conf->nosound = TRUE;
+          continue;
+        }
+
+      /* number of threads used to scale the screen */
+      if (!strcmp (arg_values[i], "--threads"))
+        {
+          if (i + 1 >= arg_count
+              || sscanf (arg_values[++i], "%d", &power_conf->threads) != 1
+              || power_conf->threads < 0)
+            {
+              LOG_ERR ("--threads expects a number of threads greater "
+                       "than or equal to 0");
+              return FALSE;
+            }
+          continue;
+        }
+
+      /* record the inputs of each frame */
+      if (!strcmp (arg_values[i], "--record"))
+        {
+          if (i + 1 >= arg_count)
+            {
+              LOG_ERR ("--record expects a filename");
+              return FALSE;
+            }
+          power_conf->record_file = arg_values[++i];
+          continue;
+        }
+
+      /* replay the recorded inputs as fast as possible */
+      if (!strcmp (arg_values[i], "--replay"))
+        {
+          if (i + 1 >= arg_count)
+            {
+              LOG_ERR ("--replay expects a filename");
+              return FALSE;
+            }
+          power_conf->replay_file = arg_values[++i];
+          power_conf->nosync = TRUE;
+          continue;
+        }
+
+#ifdef USE_PROFILER
+      /* write the timings of the last frames on exit */
+      if (!strcmp (arg_values[i], "--profile"))
+        {
+          if (i + 1 >= arg_count)
+            {
+              LOG_ERR ("--profile expects a filename");
+              return FALSE;
+            }
+          power_conf->profile_file = arg_values[++i];
+          continue;
+        }
+#endif
+
+#ifdef USE_SOFTMIXER
+      /* write the mixed sounds to a WAV file */
+      if (!strcmp (arg_values[i], "--sound-output"))
+        {
+          if (i + 1 >= arg_count)
+            {
+              LOG_ERR ("--sound-output expects a filename");
+              return FALSE;
+            }
+          power_conf->sound_output = arg_values[++i];
+          continue;
+        }
+
+      /* mix the sounds without output */
+      if (!strcmp (arg_values[i], "--sound-null"))
+        {
+          power_conf->sound_null = TRUE;
+          continue;
+        }
+#endif
+
+      /* seed of the pseudo-random number generator */
+      if (!strcmp (arg_values[i], "--seed"))
+        {
+          if (i + 1 >= arg_count
+              || sscanf (arg_values[++i], "%d", &power_conf->seed) != 1)
+            {
+              LOG_ERR ("--seed expects a number");
+              return FALSE;
+            }
+          continue;
+        }
+
       /* difficulty: easy or hard (normal bu default) */
       if (!strcmp (arg_values[i], "--easy"))
         {
@@ -611,6 +1185,19 @@ configfile_scan_arguments (Sint32 arg_count, char **arg_values)
           continue;
         }
     }
+  if (power_conf->record_file != NULL && power_conf->replay_file != NULL)
+    {
+      LOG_ERR ("--record and --replay can not be used together");
+      return FALSE;
+    }
+#ifdef USE_SOFTMIXER
+  /* whatever the order of the arguments, the sounds mixed by request
+   * are enabled, even by --bench */
+  if (power_conf->sound_output != NULL || power_conf->sound_null)
+    {
+      power_conf->nosound = FALSE;
+    }
+#endif
   return TRUE;
 }
 
@@ -623,3 +1210,13 @@ configfile_get_lang (void)
 {
   return lang_to_text[power_conf->lang];
 }
+
+/**
+ * Return the configuration directory
+ * @return The directory, or NULL if it couldn't be created
+ */
+const char *
+configfile_get_dir (void)
+{
+  return config_dir;
+}
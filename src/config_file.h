@@ -48,6 +48,18 @@ extern "C"
     bool nosound;
     /** TRUE if disable timer */
     bool nosync;
+    /** TRUE if the frames are uploaded into a SDL2 texture which is
+     * scaled by the renderer */
+    bool texture;
+    /** TRUE if the frames are scaled by a thread while the next one
+     * is drawn */
+    bool present_thread;
+    /** TRUE if the game is drawn with 8-bit indexes which are
+     * expanded when the frames are scaled */
+    bool palettized;
+    /** TRUE if the sprites already converted for the display are
+     * mapped from the packs of the configuration directory */
+    bool sprite_packs;
     /** 1, 2, 3 or 4 */
     Sint32 scale_x;
     /** 320 or 640 */
@@ -66,6 +78,32 @@ extern "C"
     Sint32 lang;
     /** True if extract sprites to PNG format */
     bool extract_to_png;
+    /** Number of frames to run in benchmark mode, 0 if disabled */
+    Sint32 bench_frames;
+    /** Number of passes of the sprites benchmark, 0 if disabled */
+    Sint32 bench_sprites;
+    /** Number of threads used to scale the screen, 0 = one per
+     * processor */
+    Sint32 threads;
+    /** Seed of the pseudo-random number generator of the game */
+    Sint32 seed;
+    /** File where the inputs of each frame are recorded, or NULL */
+    const char *record_file;
+    /** File from which the inputs of each frame are replayed, or NULL */
+    const char *replay_file;
+#ifdef USE_PROFILER
+    /** File where the timings of the last frames are written
+     * on exit, or NULL */
+    const char *profile_file;
+#endif
+#ifdef USE_SOFTMIXER
+    /** WAV file where the mixed sounds are written, or NULL to
+     * discard them */
+    const char *sound_output;
+    /** TRUE if the sounds are mixed then discarded, even by the
+     * benchmark */
+    bool sound_null;
+#endif
   } config_file;
   extern config_file *power_conf;
   void configfile_print (void);
@@ -74,6 +112,7 @@ extern "C"
   void configfile_free (void);
   bool configfile_scan_arguments (Sint32 arg_count, char **arg_values);
   const char *configfile_get_lang (void);
+  const char *configfile_get_dir (void);
 
 #ifdef __cplusplus
 }
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "congratulations.h"
 #include "display.h"
@@ -126,7 +127,7 @@ congratulations_initialize (void)
       return;
     }
 
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   /* play congratulations music */
   sound_music_play (MUSIC_CONGRATULATIONS);
 #endif
@@ -210,7 +211,7 @@ congratulations_play (void)
           if (congrat_angle_pos_x <= 32)
             {
               congrat_angle_pos_x = 32;
-              is_left_movement = rand () % 2 ? TRUE : FALSE;
+              is_left_movement = game_rand () % 2 ? TRUE : FALSE;
             }
         }
       else
@@ -219,7 +220,7 @@ congratulations_play (void)
           if (congrat_angle_pos_x >= 32)
             {
               congrat_angle_pos_x = 32;
-              is_left_movement = rand () % 2 ? TRUE : FALSE;
+              is_left_movement = game_rand () % 2 ? TRUE : FALSE;
             }
         }
     }
@@ -277,7 +278,7 @@ congratulations_new_enemy (void)
   congrat_enemy_count = 300;
   /* string which display enemy name */
   text_enemy_name_init (all_enemies_names[current_enemy_index]);
-  is_left_movement = rand () % 2 ? TRUE : FALSE;
+  is_left_movement = game_rand () % 2 ? TRUE : FALSE;
   if (is_left_movement)
     {
       congrat_angle_pos_x = 64;
@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
 #include "images.h"
 #include "curve_phase.h"
 #include "display.h"
@@ -38,6 +39,7 @@
 #include "gfx_wrapper.h"
 #include "grid_phase.h"
 #include "guardians.h"
+#include "prefetch.h"
 #include "spaceship.h"
 
 /** Maximum number of bezier curves loaded at startup */
@@ -46,6 +48,8 @@ const Sint32 CURVES_BEZIER_NUMOF = 122;
 curve *initial_curve = NULL;
 /** Current curve phase level data structure */
 curve_level courbe;
+/** Curve level file of the next level, loaded in advance */
+static char *curve_next_file = NULL;
 #ifdef DEVELOPPEMENT
 /* curve editor: current curve number */
 static Sint16 curv_number = 0;
@@ -72,7 +76,8 @@ curve_once_init (void)
   if (initial_curve == NULL)
     {
       initial_curve =
-        (curve *) memory_allocation (CURVES_BEZIER_NUMOF * sizeof (curve));
+        (curve *) arena_alloc (ARENA_PROCESS,
+                               CURVES_BEZIER_NUMOF * sizeof (curve));
       if (initial_curve == NULL)
         {
           LOG_ERR ("'initial_curve' out of memory");
@@ -88,16 +93,12 @@ curve_once_init (void)
 }
 
 /**
- * Release memory used for the curve 
+ * Forget the memory used for the curve, released with the process arena
  */
 void
 curve_free (void)
 {
-  if (initial_curve != NULL)
-    {
-      free_memory ((char *) initial_curve);
-      initial_curve = NULL;
-    }
+  initial_curve = NULL;
 }
 
 /**
@@ -582,13 +583,23 @@ curve_load_level (Sint32 level_num)
   Sint16 *dest;
   Sint32 i;
 
-  /* load the file of the level curve */
+  /* load the file of the level curve, unless it was loaded in advance */
   if (level_num > MAX_NUM_OF_LEVELS || level_num < 0)
     {
       level_num = 0;
     }
-  level_data =
-    loadfile_num ("data/levels/curves_phase/curves_%02d.bin", level_num);
+  if (prefetch_take (PREFETCH_CURVES, level_num))
+    {
+      level_data = curve_next_file;
+      curve_next_file = NULL;
+    }
+  else
+    {
+      level_data =
+        arena_loadfile_num (ARENA_LEVEL,
+                            "data/levels/curves_phase/curves_%02d.bin",
+                            level_num);
+    }
   if (level_data == NULL)
     {
       return FALSE;
@@ -628,10 +639,34 @@ curve_load_level (Sint32 level_num)
     {
       *(dest++) = little_endian_to_short (source++);
     }
-  free_memory (level_data);
   return TRUE;
 }
 
+/**
+ * Load the curve level file of the next level, called by the thread
+ * of prefetch.c
+ * @param level_num level number from 0 to 41
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+curve_prefetch (Sint32 level_num)
+{
+  curve_next_file =
+    arena_loadfile_num (ARENA_LEVEL,
+                        "data/levels/curves_phase/curves_%02d.bin", level_num);
+  return curve_next_file != NULL;
+}
+
+/**
+ * Forget the curve level file of the next level which was not used,
+ * it is released with the level arena
+ */
+void
+curve_prefetch_discard (void)
+{
+  curve_next_file = NULL;
+}
+
 /**
  * Initialize and enable a curve phase
  */
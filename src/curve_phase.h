@@ -36,6 +36,8 @@ extern "C"
   bool curve_once_init (void);
   void curve_free (void);
   bool curve_load_level (Sint32 leveln);
+  bool curve_prefetch (Sint32 level_num);
+  void curve_prefetch_discard (void);
   void curve_enable_level (void);
   void curve_phase (void);
   void curve_finished (void);
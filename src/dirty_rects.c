@@ -0,0 +1,239 @@
+/**
+ * @file dirty_rects.c
+ * @brief Areas of the score and option panels modified since the
+ *        last display of the window
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "display.h"
+#include "dirty_rects.h"
+
+/** Modified rectangles of each panel since the last display */
+static dirty_rects_list dirty_rects;
+
+/**
+ * Calculate the smallest rectangle which contains two rectangles
+ * @param dest Pointer to the result
+ * @param r1 First rectangle
+ * @param r2 Second rectangle
+ */
+static void
+dirty_rects_union (dirty_rect * dest, const dirty_rect * r1,
+                   const dirty_rect * r2)
+{
+  Sint32 x1 = r1->x < r2->x ? r1->x : r2->x;
+  Sint32 y1 = r1->y < r2->y ? r1->y : r2->y;
+  Sint32 x2 = r1->x + r1->w > r2->x + r2->w ? r1->x + r1->w : r2->x + r2->w;
+  Sint32 y2 = r1->y + r1->h > r2->y + r2->h ? r1->y + r1->h : r2->y + r2->h;
+  dest->x = x1;
+  dest->y = y1;
+  dest->w = x2 - x1;
+  dest->h = y2 - y1;
+}
+
+/**
+ * Register a modified area of a panel, which will be copied to the
+ * screen by the next display of the window. A rectangle which
+ * overlaps or touches an already registered one is merged with it
+ * @param panel DIRTY_SCORE_PANEL or DIRTY_OPTIONS_PANEL
+ * @param xcoord X-coordinate in the offscreen of the panel
+ * @param ycoord Y-coordinate in the offscreen of the panel
+ * @param width Width of the area in pixels
+ * @param height Height of the area in pixels
+ */
+void
+dirty_rects_add (Uint32 panel, Sint32 xcoord, Sint32 ycoord, Sint32 width,
+                 Sint32 height)
+{
+  Uint32 i, best;
+  Sint32 panel_width, panel_height, area, best_area;
+  dirty_rect rect, merged;
+  dirty_rect *rects;
+  if (panel == DIRTY_SCORE_PANEL)
+    {
+      panel_width = score_offscreen_width;
+      panel_height = score_offscreen_height;
+    }
+  else
+    {
+      panel_width = OPTIONS_WIDTH;
+      panel_height = OPTIONS_HEIGHT;
+    }
+
+  /* clip the area to the panel */
+  rect.x = xcoord < 0 ? 0 : xcoord;
+  rect.y = ycoord < 0 ? 0 : ycoord;
+  rect.w =
+    (xcoord + width > panel_width ? panel_width : xcoord + width) - rect.x;
+  rect.h =
+    (ycoord + height > panel_height ? panel_height : ycoord + height) -
+    rect.y;
+  if (rect.w <= 0 || rect.h <= 0)
+    {
+      return;
+    }
+  if (rect.w < DIRTY_RECT_MIN_SIZE)
+    {
+      rect.w = DIRTY_RECT_MIN_SIZE;
+      if (rect.x + rect.w > panel_width)
+        {
+          rect.x = panel_width - rect.w;
+        }
+    }
+  if (rect.h < DIRTY_RECT_MIN_SIZE)
+    {
+      rect.h = DIRTY_RECT_MIN_SIZE;
+      if (rect.y + rect.h > panel_height)
+        {
+          rect.y = panel_height - rect.h;
+        }
+    }
+
+  /* merge with the rectangles which cost less to copy together */
+  rects = dirty_rects.rects[panel];
+  i = 0;
+  while (i < dirty_rects.numof[panel])
+    {
+      dirty_rects_union (&merged, &rect, &rects[i]);
+      if (merged.w * merged.h <=
+          rect.w * rect.h + rects[i].w * rects[i].h)
+        {
+          rect = merged;
+          rects[i] = rects[--dirty_rects.numof[panel]];
+          i = 0;
+          continue;
+        }
+      i++;
+    }
+
+  if (dirty_rects.numof[panel] < DIRTY_RECTS_MAXOF)
+    {
+      rects[dirty_rects.numof[panel]++] = rect;
+      return;
+    }
+
+  /* list full: grow the rectangle which needs the smallest increase */
+  best = 0;
+  best_area = 0;
+  for (i = 0; i < DIRTY_RECTS_MAXOF; i++)
+    {
+      dirty_rects_union (&merged, &rect, &rects[i]);
+      area = merged.w * merged.h - rects[i].w * rects[i].h;
+      if (i == 0 || area < best_area)
+        {
+          best = i;
+          best_area = area;
+        }
+    }
+  dirty_rects_union (&rects[best], &rect, &rects[best]);
+}
+
+/**
+ * Copy all the modified areas of the panels to the screen, then
+ * empty the lists
+ * @param copy Function of the display which copies one rectangle
+ * @param data Data given to the function
+ */
+void
+dirty_rects_flush (dirty_rects_copy_func copy, void *data)
+{
+  dirty_rects_list_flush (&dirty_rects, scores_offscreen, options_offscreen,
+                          copy, data);
+}
+
+/**
+ * Forget the modified areas, when the whole panels are copied
+ * to the screen
+ */
+void
+dirty_rects_reset (void)
+{
+  Uint32 panel;
+  for (panel = 0; panel < DIRTY_PANELS_NUMOF; panel++)
+    {
+      dirty_rects.numof[panel] = 0;
+    }
+}
+
+/**
+ * Move the modified areas into a list, used to display them later
+ * from copies of the panels
+ * @param list Pointer to the list which receives the rectangles
+ */
+void
+dirty_rects_take (dirty_rects_list * list)
+{
+  Uint32 i, panel;
+  for (panel = 0; panel < DIRTY_PANELS_NUMOF; panel++)
+    {
+      for (i = 0; i < dirty_rects.numof[panel]; i++)
+        {
+          list->rects[panel][i] = dirty_rects.rects[panel][i];
+        }
+      list->numof[panel] = dirty_rects.numof[panel];
+    }
+  dirty_rects_reset ();
+}
+
+/**
+ * Copy the modified areas of a list to the screen, then empty it
+ * @param list The list of rectangles
+ * @param scores Pixels of the score panel
+ * @param options Pixels of the option panel
+ * @param copy Function of the display which copies one rectangle
+ * @param data Data given to the function
+ */
+void
+dirty_rects_list_flush (dirty_rects_list * list, char *scores,
+                        char *options, dirty_rects_copy_func copy,
+                        void *data)
+{
+  Uint32 i, panel;
+  dirty_rect *rect;
+  for (panel = 0; panel < DIRTY_PANELS_NUMOF; panel++)
+    {
+      for (i = 0; i < list->numof[panel]; i++)
+        {
+          rect = &list->rects[panel][i];
+          rect->panel = panel;
+          if (panel == DIRTY_SCORE_PANEL)
+            {
+              rect->screen_x = rect->x;
+              rect->screen_y = rect->y;
+              rect->pitch = score_offscreen_pitch;
+              rect->pixels = scores;
+            }
+          else
+            {
+              rect->screen_x = offscreen_width_visible + rect->x;
+              rect->screen_y = score_offscreen_height + rect->y;
+              rect->pitch = OPTIONS_WIDTH * bytes_per_pixel;
+              rect->pixels = options;
+            }
+          rect->pixels += rect->y * rect->pitch + rect->x * bytes_per_pixel;
+          copy (rect, data);
+        }
+      list->numof[panel] = 0;
+    }
+}
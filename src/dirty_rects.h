@@ -0,0 +1,97 @@
+/**
+ * @file dirty_rects.h
+ * @brief Areas of the score and option panels modified since the
+ *        last display of the window
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __DIRTY_RECTS__
+#define __DIRTY_RECTS__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Maximum number of rectangles per panel, beyond the rectangles are
+ * merged together */
+#define DIRTY_RECTS_MAXOF 32
+/** Minimum width and height of a rectangle, scale4x needs 4 lines */
+#define DIRTY_RECT_MIN_SIZE 4
+
+  typedef enum
+  {
+    /** Top score panel: 320x16 */
+    DIRTY_SCORE_PANEL,
+    /** Right option panel: 64x184 */
+    DIRTY_OPTIONS_PANEL,
+    DIRTY_PANELS_NUMOF
+  }
+  DIRTY_PANELS_ENUM;
+
+  typedef struct dirty_rect
+  {
+    /** DIRTY_SCORE_PANEL or DIRTY_OPTIONS_PANEL */
+    Uint32 panel;
+    /** Coordinates and size in the offscreen of the panel */
+    Sint32 x;
+    Sint32 y;
+    Sint32 w;
+    Sint32 h;
+    /** Coordinates in the 320x200 screen */
+    Sint32 screen_x;
+    Sint32 screen_y;
+    /** First pixel of the rectangle in the offscreen of the panel */
+    char *pixels;
+    /** Size of a line of the offscreen of the panel in bytes */
+    Uint32 pitch;
+  }
+  dirty_rect;
+
+  /** Modified rectangles of both panels */
+  typedef struct dirty_rects_list
+  {
+    dirty_rect rects[DIRTY_PANELS_NUMOF][DIRTY_RECTS_MAXOF];
+    Uint32 numof[DIRTY_PANELS_NUMOF];
+  }
+  dirty_rects_list;
+
+  /**
+   * Function which copies a modified area of a panel to the screen
+   * @param rect The rectangle to copy
+   * @param data Data given to dirty_rects_flush()
+   */
+  typedef void (*dirty_rects_copy_func) (dirty_rect * rect, void *data);
+
+  void dirty_rects_add (Uint32 panel, Sint32 xcoord, Sint32 ycoord,
+                        Sint32 width, Sint32 height);
+  void dirty_rects_flush (dirty_rects_copy_func copy, void *data);
+  void dirty_rects_reset (void);
+  void dirty_rects_take (dirty_rects_list * list);
+  void dirty_rects_list_flush (dirty_rects_list * list, char *scores,
+                               char *options, dirty_rects_copy_func copy,
+                               void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
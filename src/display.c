@@ -31,6 +31,11 @@
 #include "config_file.h"
 #include "display.h"
 #include "log_recorder.h"
+#ifdef USE_SCALE2X
+#include "dirty_rects.h"
+#include "scalebit.h"
+#include "workers.h"
+#endif
 
 /** Width of the main window */
 const Sint32 DISPLAY_WIDTH = 320;
@@ -70,6 +75,9 @@ Sint32 screen_pixel_size = 1;
 Uint32 bytes_per_pixel = 0;
 /** Depth of the screen 8, 15, 16, 24 or 32 */
 Uint32 bits_per_pixel = 0;
+/** Number of bytes per pixel of the window, greater than
+ * bytes_per_pixel if the game is drawn with 8-bit indexes */
+Uint32 window_bytes_per_pixel = 0;
 /*
  * color palettes
  */
@@ -129,6 +137,55 @@ Uint32 window_height = 0;
 /** TRUE = update display option panel and bareline's score */
 bool update_all = TRUE;
 
+#ifdef USE_SCALE2X
+/** Minimum number of source rows of a band scaled by a thread */
+#define SCALE_BAND_MIN_ROWS 16
+/** Pixels around a modified area of a panel which depend on it, and
+ * which are read to scale them: Scale4x is two Scale2x passes. Also
+ * keeps the scaled areas at least 4 rows high, as Scale4x requires */
+#define SCALE_AREA_MARGIN 2
+/** Parameters of the scaling shared between the threads */
+typedef struct scale_task_struct
+{
+  Uint32 factor;
+  char *dst;
+  Uint32 dst_slice;
+  const char *src;
+  Uint32 src_slice;
+  Uint32 pixel;
+  Uint32 width;
+  Uint32 height;
+  /** Number of source rows of a band, except maybe the last one */
+  Uint32 band_rows;
+  /** Scale4x buffers of the bands */
+  char *mid;
+  Uint32 mid_slice;
+  /** Size of the Scale4x buffer of a band in bytes */
+  Uint32 mid_size;
+  /** Palette which expands the 8-bit indexes of the source to the
+   * format of the window, NULL if the source is already in this format */
+  void *palette;
+  /** Expanded source rows of the bands */
+  char *rows;
+  Uint32 rows_slice;
+  /** Size of the expanded source rows of a band in bytes */
+  Uint32 rows_size;
+} scale_task_struct;
+static scale_task_struct scale_task;
+/** Scale4x buffers of the bands */
+static char *scale_mids = NULL;
+/** Size of the Scale4x buffers in bytes */
+static Uint32 scale_mids_size = 0;
+/** Expanded source rows of the bands in the palettized mode */
+static char *scale_rows_buffer = NULL;
+/** Size of the expanded source rows in bytes */
+static Uint32 scale_rows_buffer_size = 0;
+/** Modified area of a panel scaled with its margin */
+static char *scale_area = NULL;
+/** Size of the scaled area in bytes */
+static Uint32 scale_area_size = 0;
+#endif
+
 /** 
  * Initialize SDL or X11 display
  * @return TRUE if it completed successfully or FALSE otherwise
@@ -189,6 +246,11 @@ display_initialize (void)
         }
     }
 
+#ifdef USE_SCALE2X
+  /* fastest Scale2x and Scale3x routines supported by the CPU */
+  scale_kernel_init ();
+  LOG_INF ("%s scale routines used", scale_kernel_name (scale_kernel_get ()));
+#endif
   if (power_conf->scale_x > 1)
     {
       screen_pixel_size = power_conf->scale_x;
@@ -221,6 +283,389 @@ display_release (void)
       free_memory ((char *) keys_down);
       keys_down = NULL;
     }
+#ifdef USE_SCALE2X
+  if (scale_mids != NULL)
+    {
+      free_memory (scale_mids);
+      scale_mids = NULL;
+      scale_mids_size = 0;
+    }
+  if (scale_rows_buffer != NULL)
+    {
+      free_memory (scale_rows_buffer);
+      scale_rows_buffer = NULL;
+      scale_rows_buffer_size = 0;
+    }
+  if (scale_area != NULL)
+    {
+      free_memory (scale_area);
+      scale_area = NULL;
+      scale_area_size = 0;
+    }
+#endif
+}
+
+#ifdef USE_SCALE2X
+/**
+ * Scale one band of rows, called by a thread. In the palettized mode
+ * the source rows of the band and of its neighbour rows are first
+ * expanded with the palette, then scaled while they are in the cache
+ * @param data Pointer to the scaling parameters
+ * @param job Index of the band
+ */
+static void
+display_scale_band (void *data, Uint32 job)
+{
+  scale_task_struct *task = (scale_task_struct *) data;
+  Uint32 first = job * task->band_rows;
+  Uint32 count = task->band_rows;
+  Uint32 y, lo, hi;
+  char *rows;
+  if (first + count > task->height)
+    {
+      count = task->height - first;
+    }
+  if (task->palette == NULL)
+    {
+      scale_rows (task->factor, task->dst, task->dst_slice,
+                  task->mid + job * task->mid_size, task->mid_slice,
+                  task->src, task->src_slice, task->pixel, task->width,
+                  task->height, first, count);
+      return;
+    }
+
+  /* Scale4x needs two neighbour rows on each side */
+  lo = first > 2 ? first - 2 : 0;
+  hi = first + count + 2 < task->height ? first + count + 2 : task->height;
+  rows = task->rows + job * task->rows_size;
+  for (y = lo; y < hi; y++)
+    {
+      if (task->pixel == 2)
+        {
+          conv8_16 ((char *) task->src + y * task->src_slice,
+                    rows + (y - lo) * task->rows_slice,
+                    (Uint16 *) task->palette, task->width);
+        }
+      else
+        {
+          conv8_32 ((char *) task->src + y * task->src_slice,
+                    rows + (y - lo) * task->rows_slice,
+                    (Uint32 *) task->palette, task->width);
+        }
+    }
+  scale_rows (task->factor, task->dst + task->factor * lo * task->dst_slice,
+              task->dst_slice, task->mid + job * task->mid_size,
+              task->mid_slice, rows, task->rows_slice, task->pixel,
+              task->width, hi - lo, first - lo, count);
+}
+
+/**
+ * Grow a buffer of the scaling if needed
+ * @param buffer Pointer to the buffer
+ * @param buffer_size Pointer to the size of the buffer in bytes
+ * @param size Size needed in bytes
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+display_scale_buffer (char **buffer, Uint32 * buffer_size, Uint32 size)
+{
+  if (size <= *buffer_size)
+    {
+      return TRUE;
+    }
+  if (*buffer != NULL)
+    {
+      free_memory (*buffer);
+    }
+  *buffer = memory_allocation (size);
+  if (*buffer == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes", size);
+      *buffer_size = 0;
+      return FALSE;
+    }
+  *buffer_size = size;
+  return TRUE;
+}
+
+/**
+ * Split the rows into bands and allocate the Scale4x buffers
+ * @param numof_bands Maximum number of bands
+ * @return Number of bands, 0 if the buffers can not be allocated
+ */
+static Uint32
+display_scale_bands (Uint32 numof_bands)
+{
+  Uint32 factor = scale_task.factor;
+  Uint32 height = scale_task.height;
+  scale_task.band_rows = (height + numof_bands - 1) / numof_bands;
+  numof_bands = (height + scale_task.band_rows - 1) / scale_task.band_rows;
+  scale_task.mid_slice =
+    (2 * scale_task.pixel * scale_task.width + 0x7) & ~0x7;
+  scale_task.mid_size = 0;
+  if (factor == 4)
+    {
+      /* each band needs the Scale2x rows of its two neighbour rows */
+      scale_task.mid_size =
+        2 * (scale_task.band_rows + 2) * scale_task.mid_slice;
+      if (!display_scale_buffer (&scale_mids, &scale_mids_size,
+                                 numof_bands * scale_task.mid_size))
+        {
+          return 0;
+        }
+    }
+  scale_task.mid = scale_mids;
+  return numof_bands;
+}
+
+/**
+ * Apply the Scale2x, Scale3x or Scale4x effect on a bitmap, the rows
+ * are split into bands which are scaled concurrently by the threads
+ * @param factor Scale factor: 2, 3 or 4
+ * @param dst Pointer at the first pixel of the destination bitmap
+ * @param dst_slice Size in bytes of a destination bitmap row
+ * @param src Pointer at the first pixel of the source bitmap
+ * @param src_slice Size in bytes of a source bitmap row
+ * @param pixel Bytes per pixel of the source and destination bitmap
+ * @param width Horizontal size in pixels of the source bitmap
+ * @param height Vertical size in pixels of the source bitmap
+ */
+void
+display_scale (Uint32 factor, char *dst, Uint32 dst_slice,
+               const char *src, Uint32 src_slice, Uint32 pixel,
+               Uint32 width, Uint32 height)
+{
+  Uint32 numof_bands;
+  numof_bands = workers_count ();
+  if (numof_bands > height / SCALE_BAND_MIN_ROWS)
+    {
+      numof_bands = height / SCALE_BAND_MIN_ROWS;
+    }
+  if (numof_bands < 2 || (factor != 2 && factor != 3 && factor != 4))
+    {
+      scale (factor, dst, dst_slice, src, src_slice, pixel, width, height);
+      return;
+    }
+  scale_task.factor = factor;
+  scale_task.dst = dst;
+  scale_task.dst_slice = dst_slice;
+  scale_task.src = src;
+  scale_task.src_slice = src_slice;
+  scale_task.pixel = pixel;
+  scale_task.width = width;
+  scale_task.height = height;
+  scale_task.palette = NULL;
+  numof_bands = display_scale_bands (numof_bands);
+  if (numof_bands == 0)
+    {
+      scale (factor, dst, dst_slice, src, src_slice, pixel, width, height);
+      return;
+    }
+  workers_run (display_scale_band, &scale_task, numof_bands);
+}
+
+/**
+ * Apply the Scale2x, Scale3x or Scale4x effect on a bitmap of 8-bit
+ * indexes, expanded to the format of the window with a palette.
+ * Used by the palettized mode
+ * @param factor Scale factor: 2, 3 or 4
+ * @param dst Pointer at the first pixel of the destination bitmap
+ * @param dst_slice Size in bytes of a destination bitmap row
+ * @param src Pointer at the first index of the source bitmap
+ * @param src_slice Size in bytes of a source bitmap row
+ * @param width Horizontal size in pixels of the source bitmap
+ * @param height Vertical size in pixels of the source bitmap
+ * @param palette 16-bit or 32-bit palette in the format of the window,
+ *                NULL to use the palette of the game
+ */
+void
+display_scale_indexes (Uint32 factor, char *dst, Uint32 dst_slice,
+                       const char *src, Uint32 src_slice, Uint32 width,
+                       Uint32 height, void *palette)
+{
+  Uint32 numof_bands;
+  numof_bands = workers_count ();
+  if (numof_bands > height / SCALE_BAND_MIN_ROWS)
+    {
+      numof_bands = height / SCALE_BAND_MIN_ROWS;
+    }
+  if (numof_bands < 1)
+    {
+      numof_bands = 1;
+    }
+  scale_task.factor = factor;
+  scale_task.dst = dst;
+  scale_task.dst_slice = dst_slice;
+  scale_task.src = src;
+  scale_task.src_slice = src_slice;
+  scale_task.pixel = window_bytes_per_pixel;
+  scale_task.width = width;
+  scale_task.height = height;
+  scale_task.palette = palette;
+  if (palette == NULL)
+    {
+      scale_task.palette =
+        window_bytes_per_pixel == 2 ? (void *) pal16 : (void *) pal32;
+    }
+  numof_bands = display_scale_bands (numof_bands);
+  if (numof_bands == 0)
+    {
+      return;
+    }
+  scale_task.rows_slice = (width * window_bytes_per_pixel + 0x7) & ~0x7;
+  scale_task.rows_size = (scale_task.band_rows + 4) * scale_task.rows_slice;
+  if (!display_scale_buffer (&scale_rows_buffer, &scale_rows_buffer_size,
+                             numof_bands * scale_task.rows_size))
+    {
+      return;
+    }
+  scale_task.rows = scale_rows_buffer;
+  if (numof_bands == 1)
+    {
+      display_scale_band (&scale_task, 0);
+      return;
+    }
+  workers_run (display_scale_band, &scale_task, numof_bands);
+}
+
+/**
+ * Scale a bitmap of the game into the window, its 8-bit indexes are
+ * expanded in the palettized mode
+ * @param factor Scale factor: 2, 3 or 4
+ * @param dst Pointer at the first pixel of the destination bitmap
+ * @param dst_slice Size in bytes of a destination bitmap row
+ * @param src Pointer at the first pixel of the source bitmap
+ * @param src_slice Size in bytes of a source bitmap row
+ * @param width Horizontal size in pixels of the source bitmap
+ * @param height Vertical size in pixels of the source bitmap
+ */
+void
+display_scale_game (Uint32 factor, char *dst, Uint32 dst_slice,
+                    const char *src, Uint32 src_slice, Uint32 width,
+                    Uint32 height)
+{
+  if (bytes_per_pixel < window_bytes_per_pixel)
+    {
+      display_scale_indexes (factor, dst, dst_slice, src, src_slice, width,
+                             height, NULL);
+    }
+  else
+    {
+      display_scale (factor, dst, dst_slice, src, src_slice,
+                     bytes_per_pixel, width, height);
+    }
+}
+
+/**
+ * Clamp a range of pixels of a panel, grown by the margin of the
+ * scale effects
+ * @param start Pointer to the first pixel of the range
+ * @param end Pointer to the pixel after the range
+ * @param size Width or height of the panel
+ */
+static void
+display_scale_grow (Sint32 * start, Sint32 * end, Sint32 size)
+{
+  *start = *start > SCALE_AREA_MARGIN ? *start - SCALE_AREA_MARGIN : 0;
+  *end = *end + SCALE_AREA_MARGIN < size ? *end + SCALE_AREA_MARGIN : size;
+}
+
+/**
+ * Scale a modified area of a panel into the window. The effects read
+ * the neighbour pixels, clamped at the edges of the bitmap, so a
+ * modified pixel also changes the scaled pixels of its neighbours:
+ * the area copied into the window is the modified one with a margin,
+ * and it is scaled from the panel with a second margin around it,
+ * so that its pixels are the same as when the whole panel is scaled
+ * @param factor Scale factor: 2, 3 or 4
+ * @param rect Area of the score or the option panel
+ * @param dst Pointer at the first pixel of the 320x200 screen in the
+ *        window
+ * @param dst_slice Size in bytes of a window row
+ */
+void
+display_scale_dirty_rect (Uint32 factor, dirty_rect * rect, char *dst,
+                          Uint32 dst_slice)
+{
+  Sint32 y, panel_width, panel_height, left, top, right, bottom,
+    area_left, area_top, area_right, area_bottom;
+  Uint32 area_slice, row_size;
+  const char *panel;
+  char *area;
+  if (rect->panel == DIRTY_SCORE_PANEL)
+    {
+      panel_width = score_offscreen_width;
+      panel_height = score_offscreen_height;
+    }
+  else
+    {
+      panel_width = OPTIONS_WIDTH;
+      panel_height = OPTIONS_HEIGHT;
+    }
+  panel = rect->pixels - rect->y * rect->pitch - rect->x * bytes_per_pixel;
+
+  /* pixels changed by the modified area */
+  area_left = rect->x;
+  area_right = rect->x + rect->w;
+  display_scale_grow (&area_left, &area_right, panel_width);
+  area_top = rect->y;
+  area_bottom = rect->y + rect->h;
+  display_scale_grow (&area_top, &area_bottom, panel_height);
+
+  /* pixels read to scale them */
+  left = area_left;
+  right = area_right;
+  display_scale_grow (&left, &right, panel_width);
+  top = area_top;
+  bottom = area_bottom;
+  display_scale_grow (&top, &bottom, panel_height);
+
+  area_slice = (right - left) * factor * window_bytes_per_pixel;
+  if (!display_scale_buffer (&scale_area, &scale_area_size,
+                             area_slice * (bottom - top) * factor))
+    {
+      return;
+    }
+  display_scale_game (factor, scale_area, area_slice,
+                      panel + top * rect->pitch + left * bytes_per_pixel,
+                      rect->pitch, right - left, bottom - top);
+
+  /* copy the changed pixels without the second margin */
+  area = scale_area + (area_top - top) * factor * area_slice +
+    (area_left - left) * factor * window_bytes_per_pixel;
+  dst += ((rect->screen_y - rect->y + area_top) * dst_slice +
+          (rect->screen_x - rect->x + area_left) * window_bytes_per_pixel) *
+    factor;
+  row_size = (area_right - area_left) * factor * window_bytes_per_pixel;
+  for (y = 0; y < (area_bottom - area_top) * (Sint32) factor; y++)
+    {
+      memcpy (dst + y * dst_slice, area + y * area_slice, row_size);
+    }
+}
+#endif
+
+/**
+ * Select the depth of the offscreens of the game, once the depth of
+ * the window is known. In the palettized mode the game is drawn with
+ * 8-bit indexes which are expanded when the frame is scaled
+ * @param palettized TRUE if the display can expand the indexes
+ */
+void
+display_select_depth (bool palettized)
+{
+  window_bytes_per_pixel = bytes_per_pixel;
+#ifdef USE_SCALE2X
+  if (palettized && power_conf->palettized && vmode == 2
+      && (bytes_per_pixel == 2 || bytes_per_pixel == 4)
+      && power_conf->scale_x >= 2
+      && power_conf->scale_x <= 4)
+    {
+      bytes_per_pixel = 1;
+      LOG_INF ("the game is drawn with 8-bit indexes");
+    }
+#else
+  (void) palettized;
+#endif
 }
 
 /**
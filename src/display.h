@@ -130,6 +130,21 @@ extern "C"
 #endif
 #endif
   void clear_keymap (void);
+  void display_select_depth (bool palettized);
+#ifdef USE_SCALE2X
+  struct dirty_rect;
+  void display_scale (Uint32 factor, char *dst, Uint32 dst_slice,
+                      const char *src, Uint32 src_slice, Uint32 pixel,
+                      Uint32 width, Uint32 height);
+  void display_scale_indexes (Uint32 factor, char *dst, Uint32 dst_slice,
+                              const char *src, Uint32 src_slice,
+                              Uint32 width, Uint32 height, void *palette);
+  void display_scale_game (Uint32 factor, char *dst, Uint32 dst_slice,
+                           const char *src, Uint32 src_slice, Uint32 width,
+                           Uint32 height);
+  void display_scale_dirty_rect (Uint32 factor, struct dirty_rect *rect,
+                                 char *dst, Uint32 dst_slice);
+#endif
 
 #ifdef SHAREWARE_VERSION
   void show_page_order (int num, char *lang, int cpt);
@@ -181,6 +196,7 @@ extern "C"
 
   extern Uint32 bytes_per_pixel;
   extern Uint32 bits_per_pixel;
+  extern Uint32 window_bytes_per_pixel;
   extern unsigned char *palette_24;
   extern Uint32 *pal32;
   extern Uint16 *pal16;
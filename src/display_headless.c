@@ -0,0 +1,415 @@
+/**
+ * @file display_headless.c
+ * @brief Offscreen-only display used to measure the game without a window
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "assembler.h"
+#include "images.h"
+#include "config_file.h"
+#include "display.h"
+#include "dirty_rects.h"
+#include "log_recorder.h"
+#include "menu.h"
+#include "movie.h"
+#include "present_thread.h"
+#include "sprites_string.h"
+#ifdef USE_SCALE2X
+#include "scalebit.h"
+#endif
+#ifdef POWERMANGA_HEADLESS
+#include <X11/keysym.h>
+
+/** Pixels of the window, which receive the scaled frames */
+static char *window_offscreen = NULL;
+
+static void autopilot (void);
+#ifdef USE_SCALE2X
+static void scale_frame (present_frame * frame);
+#endif
+
+/**
+ * Initialize the headless display, 32-bit offscreens are always used
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+display_init (void)
+{
+  switch (vmode)
+    {
+    case 0:
+      window_width = display_width;
+      window_height = display_height;
+      break;
+    case 1:
+      window_width = display_width * 2;
+      window_height = display_height * 2;
+      break;
+    case 2:
+      window_width = display_width * power_conf->scale_x;
+      window_height = display_height * power_conf->scale_x;
+      break;
+    }
+  bytes_per_pixel = 4;
+  bits_per_pixel = 32;
+  display_select_depth (TRUE);
+  LOG_INF ("headless display: %ix%i; depth: %i",
+           window_width, window_height, bits_per_pixel);
+  return TRUE;
+}
+
+/**
+ * Destroy off screen for start and end movies
+ */
+void
+destroy_movie_offscreen (void)
+{
+  if (movie_offscreen != NULL)
+    {
+      free_memory (movie_offscreen);
+      movie_offscreen = NULL;
+    }
+}
+
+/**
+ * Create off screen surface for the start and end movies
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+create_movie_offscreen (void)
+{
+  movie_offscreen =
+    memory_allocation (display_width * display_height * bytes_per_pixel);
+  if (movie_offscreen == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate 'movie_offscreen'");
+      return FALSE;
+    }
+  return TRUE;
+}
+
+/**
+ * Create the offscreens of the game
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+create_offscreens (void)
+{
+  game_offscreen =
+    memory_allocation (offscreen_width * offscreen_height * bytes_per_pixel);
+  if (game_offscreen == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate 'game_offscreen'");
+      return FALSE;
+    }
+  offscreen_pitch = offscreen_width * bytes_per_pixel;
+  options_offscreen =
+    memory_allocation (OPTIONS_WIDTH * OPTIONS_HEIGHT * bytes_per_pixel);
+  if (options_offscreen == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate 'options_offscreen'");
+      return FALSE;
+    }
+  scores_offscreen =
+    memory_allocation (score_offscreen_width * score_offscreen_height *
+                       bytes_per_pixel);
+  if (scores_offscreen == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate 'scores_offscreen'");
+      return FALSE;
+    }
+  score_offscreen_pitch = score_offscreen_width * bytes_per_pixel;
+#ifdef USE_SCALE2X
+  /* scale the frames like the SDL displays, to measure it */
+  if (vmode == 2)
+    {
+      window_offscreen =
+        memory_allocation (window_width * window_height *
+                           window_bytes_per_pixel);
+      if (window_offscreen == NULL)
+        {
+          LOG_ERR ("not enough memory to allocate 'window_offscreen'");
+          return FALSE;
+        }
+      if (power_conf->present_thread)
+        {
+          present_thread_init (scale_frame);
+        }
+    }
+#endif
+  return TRUE;
+}
+
+/**
+ * Create the 32-bit palette
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+create_palettes (void)
+{
+  Uint32 i;
+  unsigned char *_pPal;
+  unsigned char *_p;
+  if (pal32 == NULL)
+    {
+      pal32 = (Uint32 *) memory_allocation (256 * 4);
+      if (pal32 == NULL)
+        {
+          LOG_ERR ("not enough memory to allocate 1024 bytes!");
+          return FALSE;
+        }
+    }
+  _p = (unsigned char *) pal32;
+  _pPal = palette_24;
+  for (i = 0; i < 256; i++)
+    {
+      _p[0] = _pPal[2];
+      _p[1] = _pPal[1];
+      _p[2] = _pPal[0];
+      _p[3] = 0;
+      _p += 4;
+      _pPal += 3;
+    }
+  return TRUE;
+}
+
+/**
+ * Handle events, there are none: the keys are driven by a fixed
+ * autopilot so that two runs execute the same frames, or by the
+ * replay file
+ */
+void
+display_handle_events (void)
+{
+  if (power_conf->replay_file == NULL)
+    {
+      autopilot ();
+    }
+}
+
+/**
+ * Nothing is presented, only acknowledge the refresh requests
+ * so that the game state is the same as with a real display
+ */
+void
+display_update_window (void)
+{
+#ifdef USE_SCALE2X
+  present_frame frame;
+#endif
+  if (movie_offscreen != NULL)
+    {
+      update_all = TRUE;
+      present_thread_wait ();
+      return;
+    }
+#ifdef USE_SCALE2X
+  if (window_offscreen != NULL)
+    {
+      if (present_thread_enabled ())
+        {
+          present_thread_wait ();
+          present_thread_start ();
+        }
+      else
+        {
+          present_frame_current (&frame);
+          scale_frame (&frame);
+        }
+      return;
+    }
+#endif
+  update_all = FALSE;
+  dirty_rects_reset ();
+}
+
+#ifdef USE_SCALE2X
+/**
+ * Scale a modified area of a panel into the window
+ * @param rect Area of the score or the option panel
+ * @param data Unused
+ */
+static void
+scale_dirty_rect (dirty_rect * rect, void *data)
+{
+  (void) data;
+  display_scale_dirty_rect (power_conf->scale_x, rect, window_offscreen,
+                            window_width * window_bytes_per_pixel);
+}
+
+/**
+ * Increase the size of the offscreens of a frame into the window.
+ * Called by the main thread or by the presentation thread
+ * @param frame The offscreens and the modified areas of the panels
+ */
+static void
+scale_frame (present_frame * frame)
+{
+  char *src;
+  Sint32 scalex = power_conf->scale_x;
+  Sint32 pitch = window_width * window_bytes_per_pixel;
+  src = frame->game_offscreen + (offscreen_clipsize * offscreen_pitch) +
+    (offscreen_clipsize * bytes_per_pixel);
+  display_scale_game (scalex,
+                      window_offscreen +
+                      (pitch * score_offscreen_height * scalex), pitch, src,
+                      offscreen_pitch, offscreen_width_visible,
+                      offscreen_height_visible);
+  if (frame->update_all)
+    {
+      display_scale_game (scalex, window_offscreen, pitch,
+                          frame->scores_offscreen, score_offscreen_pitch,
+                          score_offscreen_width, score_offscreen_height);
+      display_scale_game (scalex,
+                          window_offscreen +
+                          (offscreen_width_visible * window_bytes_per_pixel *
+                           scalex) + (pitch * score_offscreen_height * scalex),
+                          pitch, frame->options_offscreen,
+                          OPTIONS_WIDTH * bytes_per_pixel, OPTIONS_WIDTH,
+                          OPTIONS_HEIGHT);
+    }
+  else
+    {
+      dirty_rects_list_flush (&frame->dirty, frame->scores_offscreen,
+                              frame->options_offscreen, scale_dirty_rect,
+                              NULL);
+    }
+}
+#endif
+
+/**
+ * Release the offscreens and the palettes
+ */
+void
+display_free (void)
+{
+  present_thread_free ();
+  destroy_movie_offscreen ();
+  if (window_offscreen != NULL)
+    {
+      free_memory (window_offscreen);
+      window_offscreen = NULL;
+    }
+  if (game_offscreen != NULL)
+    {
+      free_memory (game_offscreen);
+      game_offscreen = NULL;
+    }
+  if (options_offscreen != NULL)
+    {
+      free_memory (options_offscreen);
+      options_offscreen = NULL;
+    }
+  if (scores_offscreen != NULL)
+    {
+      free_memory (scores_offscreen);
+      scores_offscreen = NULL;
+    }
+  if (pal16 != NULL)
+    {
+      free_memory ((char *) pal16);
+      pal16 = NULL;
+    }
+  if (pal32 != NULL)
+    {
+      free_memory ((char *) pal32);
+      pal32 = NULL;
+    }
+}
+
+/**
+ * Clear the main offscreen
+ */
+void
+display_clear_offscreen (void)
+{
+  clear_offscreen (game_offscreen +
+                   (offscreen_clipsize * offscreen_pitch) +
+                   (offscreen_clipsize * bytes_per_pixel),
+                   (offscreen_width_visible * bytes_per_pixel) >> 2,
+                   offscreen_height_visible,
+                   (offscreen_width -
+                    offscreen_width_visible) * bytes_per_pixel);
+}
+
+/**
+ * Simulate a player: skip the movies, start a game from the menu,
+ * keep firing while moving left and right, and validate the high
+ * score and the game over with the [Return] key
+ */
+static void
+autopilot (void)
+{
+  Uint32 i;
+  Uint32 frame = loops_counter;
+  for (i = 0; i < MAX_OF_KEYS_DOWN; i++)
+    {
+      keys_down[i] = FALSE;
+    }
+  fire_button_down = FALSE;
+  if (key_code_down != 0)
+    {
+      sprites_string_key_up (key_code_down, key_code_down);
+      key_code_down = 0;
+    }
+
+  /* one frame out of two, a key is pressed */
+  if (frame & 1)
+    {
+      if (movie_offscreen != NULL)
+        {
+          key_code_down = XK_space;
+        }
+      else if (gameover_enable && menu_status == MENU_OFF
+               && (frame & 15) == 1)
+        {
+          key_code_down = XK_Return;
+        }
+      if (key_code_down != 0)
+        {
+          sprites_string_key_down (key_code_down, key_code_down);
+        }
+    }
+  if (menu_status == MENU_ON)
+    {
+      keys_down[K_RETURN] = (frame & 15) == 0 ? TRUE : FALSE;
+      return;
+    }
+  if (movie_offscreen != NULL || gameover_enable)
+    {
+      return;
+    }
+  keys_down[K_CTRL] = (frame & 31) < 4 ? TRUE : FALSE;
+  keys_down[K_SPACE] = TRUE;
+  fire_button_down = TRUE;
+  if (frame & 64)
+    {
+      keys_down[K_LEFT] = TRUE;
+    }
+  else
+    {
+      keys_down[K_RIGHT] = TRUE;
+    }
+}
+#endif
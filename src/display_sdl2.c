@@ -31,12 +31,14 @@
 #include "images.h"
 #include "config_file.h"
 #include "display.h"
+#include "dirty_rects.h"
 #include "electrical_shock.h"
 #include "energy_gauge.h"
 #include "menu_sections.h"
 #include "movie.h"
 #include "log_recorder.h"
 #include "options_panel.h"
+#include "present_thread.h"
 #include "gfx_wrapper.h"
 #ifdef USE_SCALE2X
 #include "scalebit.h"
@@ -108,6 +110,9 @@ bool psp_buttons[PSP_NUM_BUTTONS];
 static SDL_Window *main_window = NULL;
 /* SDL2 renderer */
 static SDL_Renderer *main_renderer = NULL;
+/** 320x200: streaming texture scaled by the renderer, NULL if the
+ * frames are scaled by the CPU into the window surface */
+static SDL_Texture *main_texture = NULL;
 
 /* SDL surfaces */
 #define MAX_OF_SURFACES 100
@@ -141,10 +146,15 @@ Sint32 vmode2 = 0;
 #endif
 
 static void display_movie (void);
+static bool init_texture_mode (void);
+static void display_texture (void);
+static void texture_present (void);
 static void display_320x200 (void);
 static void display_640x400 (void);
 #ifdef USE_SCALE2X
+static void scale_frame (present_frame * frame);
 static void display_scale_x (void);
+static void display_present (void);
 #endif
 static SDL_Surface *create_surface (Uint32 width, Uint32 height);
 static void get_rgb_mask (Uint32 * rmask, Uint32 * gmask, Uint32 * bmask);
@@ -260,6 +270,9 @@ init_video_mode (void)
 #endif
   Uint32 flag = 0;
 
+  /* the window can be destroyed, wait for the frame being scaled */
+  present_thread_wait ();
+
   /* 640x480 instead of 640x400 on win32 only */
   if ((vmode) && (vmode2) && power_conf->scale_x == 2)
     {
@@ -326,20 +339,6 @@ init_video_mode (void)
 	  return FALSE;
     }
       
-  public_surface = SDL_GetWindowSurface(main_window);
-  if (public_surface == NULL)
-    {
-      LOG_ERR ("SDL_GetWindowSurface() return %s", SDL_GetError ());
-      return FALSE;
-    }
-	
-  main_renderer = SDL_CreateSoftwareRenderer(public_surface);
-  if (main_renderer == NULL) 
-    {
-	  LOG_ERR("SDL_CreateSoftwareRenderer() return %s", SDL_GetError());
-	  return FALSE;
-    }
-	
   SDL_DisplayMode dm;
   int r = SDL_GetWindowDisplayMode(main_window, &dm);
   if (r != 0)
@@ -355,15 +354,40 @@ init_video_mode (void)
   
   LOG_INF ("depth of screen: %i; bytes per pixel: %i;",
            bits_per_pixel, bytes_per_pixel);
+  display_select_depth (!power_conf->texture);
+
+  if (power_conf->texture && init_texture_mode ())
+    {
+      /* clear screen */
+      SDL_SetRenderDrawColor (main_renderer, 0, 0, 0, 255);
+      SDL_RenderClear (main_renderer);
+      SDL_RenderPresent (main_renderer);
+    }
+  else
+    {
+      public_surface = SDL_GetWindowSurface(main_window);
+      if (public_surface == NULL)
+        {
+          LOG_ERR ("SDL_GetWindowSurface() return %s", SDL_GetError ());
+          return FALSE;
+        }
+
+      main_renderer = SDL_CreateSoftwareRenderer(public_surface);
+      if (main_renderer == NULL) 
+        {
+          LOG_ERR("SDL_CreateSoftwareRenderer() return %s", SDL_GetError());
+          return FALSE;
+        }
+
+      /* clear screen */  
+      SDL_FillRect(public_surface, NULL, 0);
+      SDL_UpdateWindowSurface(main_window);
+    }
   	
   LOG_INF ("SDL_SetVideoMode() successful window_width: %i;"
            " window_height: %i; bits_per_pixel: %i; Rmask",
            width, height, bits_per_pixel);
 
-  /* clear screen */  
-  SDL_FillRect(public_surface, NULL, 0);
-  SDL_UpdateWindowSurface(main_window);
-
 #ifdef POWERMANGA_GP2X
   /* The native resolution is 320x200, so we scale up to 320x240
    * when updating the screen */
@@ -389,6 +413,73 @@ init_video_mode (void)
   return TRUE;
 }
 
+/**
+ * Create the renderer of the window and the streaming texture which
+ * receives the score panel, the playfield and the option panel.
+ * The renderer scales the texture to the window, the software renderer
+ * is used if no accelerated one is available
+ * @return TRUE if it completed successfully or FALSE if the frames
+ *         must be scaled by the CPU
+ */
+static bool
+init_texture_mode (void)
+{
+  Uint32 format;
+  SDL_RendererInfo info;
+  switch (bytes_per_pixel)
+    {
+      /* pixels of pal16, see create_palettes() */
+    case 2:
+      format = bits_per_pixel == 15 ?
+        SDL_PIXELFORMAT_RGB555 : SDL_PIXELFORMAT_RGB565;
+      break;
+      /* pixels of pal32, see create_palettes() */
+    case 4:
+#if defined(__EMSCRIPTEN__)
+      format = SDL_PIXELFORMAT_ABGR8888;
+#elif SDL_BYTEORDER == SDL_BIG_ENDIAN
+      format = SDL_PIXELFORMAT_RGB888;
+#else
+      format = power_conf->scale_x >= 2 ?
+        SDL_PIXELFORMAT_RGB888 : SDL_PIXELFORMAT_BGR888;
+#endif
+      break;
+    default:
+      LOG_WARN ("texture unsupported with %i bytes per pixel",
+                bytes_per_pixel);
+      return FALSE;
+    }
+  /* keep the pixels sharp */
+  SDL_SetHint (SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+  main_renderer = SDL_CreateRenderer (main_window, -1, 0);
+  if (main_renderer == NULL)
+    {
+      LOG_ERR ("SDL_CreateRenderer() return %s", SDL_GetError ());
+      return FALSE;
+    }
+  /* keep the ratio of the screen */
+  if (SDL_RenderSetLogicalSize (main_renderer, display_width,
+                                display_height) < 0)
+    {
+      LOG_ERR ("SDL_RenderSetLogicalSize() return %s", SDL_GetError ());
+    }
+  main_texture =
+    SDL_CreateTexture (main_renderer, format, SDL_TEXTUREACCESS_STREAMING,
+                       display_width, display_height);
+  if (main_texture == NULL)
+    {
+      LOG_ERR ("SDL_CreateTexture() return %s", SDL_GetError ());
+      SDL_DestroyRenderer (main_renderer);
+      main_renderer = NULL;
+      return FALSE;
+    }
+  if (SDL_GetRendererInfo (main_renderer, &info) == 0)
+    {
+      LOG_INF ("renderer: %s", info.name);
+    }
+  return TRUE;
+}
+
 /**
  * Destroy off screen surface for start and end movies
  */
@@ -459,6 +550,13 @@ create_offscreens (void)
     }
   scores_offscreen = (char *) score_surface->pixels;
   score_offscreen_pitch = score_offscreen_width * bytes_per_pixel;
+#ifdef USE_SCALE2X
+  /* scale the frames while the next one is drawn */
+  if (vmode == 2 && main_texture == NULL && power_conf->present_thread)
+    {
+      present_thread_init (scale_frame);
+    }
+#endif
   return TRUE;
 }
 
@@ -474,7 +572,7 @@ create_palettes (void)
   unsigned char *src;
 
   /* 8-bit displays support 256 colors */
-  if (bytes_per_pixel == 1)
+  if (window_bytes_per_pixel == 1)
     {
       if (sdl_color_palette == NULL)
         {
@@ -499,7 +597,7 @@ create_palettes (void)
   else
     /* 16-bit depth with 65336 colors */
     {
-      if (bytes_per_pixel == 2)
+      if (window_bytes_per_pixel == 2)
         {
           if (pal16 == NULL)
             {
@@ -522,7 +620,7 @@ create_palettes (void)
       else
         /* 24-bit or 32-bit depth */
         {
-          if (bytes_per_pixel > 2)
+          if (window_bytes_per_pixel > 2)
             {
               if (pal32 == NULL)
                 {
@@ -1064,8 +1162,17 @@ display_handle_events (void)
             {
             case SDL_BUTTON_LEFT:
               mouse_b = 1;
-              mouse_x = event.button.x / screen_pixel_size;
-              mouse_y = event.button.y / screen_pixel_size;
+              /* the renderer gives the coordinates in the texture */
+              if (main_texture != NULL)
+                {
+                  mouse_x = event.button.x;
+                  mouse_y = event.button.y;
+                }
+              else
+                {
+                  mouse_x = event.button.x / screen_pixel_size;
+                  mouse_y = event.button.y / screen_pixel_size;
+                }
               LOG_INF ("mouse_x = %i mouse_y = %i", mouse_x, mouse_y);
               break;
             }
@@ -1337,8 +1444,13 @@ display_update_window (void)
   if (movie_surface != NULL)
     {
       update_all = TRUE;
+      present_thread_wait ();
       display_movie ();
     }
+  else if (main_texture != NULL)
+    {
+      display_texture ();
+    }
   else
     {
       switch (vmode)
@@ -1353,7 +1465,14 @@ display_update_window (void)
           break;
         case 2:
 #ifdef USE_SCALE2X
-          display_scale_x ();
+          if (present_thread_enabled ())
+            {
+              display_present ();
+            }
+          else
+            {
+              display_scale_x ();
+            }
 #endif
           break;
         }
@@ -1420,6 +1539,17 @@ display_movie (void)
   SDL_UnlockSurface (movie_surface);
 #endif
 
+  if (main_texture != NULL)
+    {
+      if (SDL_UpdateTexture (main_texture, NULL, movie_offscreen,
+                             display_width * bytes_per_pixel) < 0)
+        {
+          LOG_ERR ("SDL_UpdateTexture() return %s", SDL_GetError ());
+        }
+      texture_present ();
+      return;
+    }
+
   /* 320x200 mode */
   switch (vmode)
     {
@@ -1480,10 +1610,26 @@ display_movie (void)
       SDL_LockSurface (public_surface);
 #endif
 #ifdef USE_SCALE2X
-      scale (power_conf->scale_x, public_surface->pixels,
-             public_surface->pitch, movie_offscreen,
-             display_width * bytes_per_pixel, bytes_per_pixel, display_width,
-             display_height);
+      if (bytes_per_pixel < window_bytes_per_pixel)
+        {
+          /* palettized mode: expand with the palette of the movie */
+          display_scale_indexes (power_conf->scale_x,
+                                 (char *) public_surface->pixels,
+                                 public_surface->pitch, movie_offscreen,
+                                 display_width, display_width,
+                                 display_height,
+                                 window_bytes_per_pixel == 2 ?
+                                 (void *) pal16PlayAnim :
+                                 (void *) pal32PlayAnim);
+        }
+      else
+        {
+          display_scale (power_conf->scale_x,
+                         (char *) public_surface->pixels,
+                         public_surface->pitch, movie_offscreen,
+                         display_width * bytes_per_pixel, bytes_per_pixel,
+                         display_width, display_height);
+        }
 #endif
 #ifdef __EMSCRIPTEN__
       SDL_UnlockSurface (public_surface);
@@ -1493,6 +1639,38 @@ display_movie (void)
     }
 }
 
+/**
+ * Copy a modified area of a panel to the 320x200 window
+ * @param rect Area of the score or the option panel
+ * @param data Unused
+ */
+static void
+blit_dirty_rect (dirty_rect * rect, void *data)
+{
+  SDL_Rect rdest;
+  SDL_Rect rsour;
+  SDL_Surface *surface;
+  (void) data;
+  if (rect->panel == DIRTY_SCORE_PANEL)
+    {
+      surface = score_surface;
+    }
+  else
+    {
+      surface = options_surface;
+    }
+  rsour.x = (Sint16) rect->x;
+  rsour.y = (Sint16) rect->y;
+  rsour.w = (Uint16) rect->w;
+  rsour.h = (Uint16) rect->h;
+  get_rect (&rdest, (Sint16) rect->screen_x, (Sint16) rect->screen_y,
+            (Sint16) rect->w, (Sint16) rect->h);
+  if (SDL_BlitSurface (surface, &rsour, public_surface, &rdest) < 0)
+    {
+      LOG_ERR ("SDL_BlitSurface() return %s", SDL_GetError ());
+    }
+}
+
 /**
  * Display window in 320*200, orignal size of the game
  */
@@ -1501,7 +1679,6 @@ display_320x200 (void)
 {
   SDL_Rect rdest;
   SDL_Rect rsour;
-  Sint32 optx, opty;
   rsour.x = (Sint16) offscreen_clipsize;
   rsour.y = (Sint16) offscreen_clipsize;
   rsour.w = (Uint16) offscreen_width_visible;
@@ -1536,129 +1713,46 @@ display_320x200 (void)
           LOG_ERR ("SDL_BlitSurface(score_surface) return %s",
                    SDL_GetError ());
         }
-      opt_refresh_index = -1;
+      dirty_rects_reset ();
       update_all = FALSE;
     }
   else
     {
-      /* display options from option panel */
-      while (opt_refresh_index >= 0)
-        {
-          optx = options_refresh[opt_refresh_index].coord_x;
-          opty = options_refresh[opt_refresh_index--].coord_y;
-          rsour.x = (Sint16) optx;
-          rsour.y = (Sint16) opty;
-          rsour.w = 28;
-          rsour.h = 28;
-          get_rect (&rdest, (Sint16) (offscreen_width_visible + optx),
-                    (Sint16) (16 + opty), 28, 28);
-          if (SDL_BlitSurface
-              (options_surface, &rsour, public_surface, &rdest) < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(options_surface) return %s",
-                       SDL_GetError ());
-            }
-        }
-      if (score_x2_refresh || !update_all)
-        {
-          rsour.x = 41;
-          rsour.y = 171;
-          rsour.w = 14;
-          rsour.h = 8;
-          get_rect (&rdest, 297, 187, 14, 8);
-          if (SDL_BlitSurface
-              (options_surface, &rsour, public_surface, &rdest) < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(options_surface) return %s",
-                       SDL_GetError ());
-            }
-          score_x2_refresh = FALSE;
-        }
-      if (score_x4_refresh || !update_all)
-        {
-          rsour.x = 41;
-          rsour.y = 5;
-          rsour.w = 14;
-          rsour.h = 8;
-          get_rect (&rdest, 297, 21, 14, 8);
-          if (SDL_BlitSurface
-              (options_surface, &rsour, public_surface, &rdest) < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(options_surface) return %s",
-                       SDL_GetError ());
-            }
-          score_x4_refresh = FALSE;
-        }
-
-      /* display player's energy */
-      if (energy_gauge_spaceship_is_update)
-        {
-          rsour.x = 210;
-          rsour.y = 3;
-          rsour.w = 100;
-          rsour.h = 9;
-          get_rect (&rdest, 210, 3, 100, 9);
-          optx =
-            SDL_BlitSurface (score_surface, &rsour, public_surface, &rdest);
-          if (SDL_BlitSurface (score_surface, &rsour, public_surface, &rdest)
-              < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(score_surface) return %s",
-                       SDL_GetError ());
-            }
-          energy_gauge_spaceship_is_update = FALSE;
-        }
-
-      /* display big-boss's energy */
-      if (energy_gauge_guard_is_update)
-        {
-          rsour.x = 10;
-          rsour.y = 3;
-          rsour.w = 45;
-          rsour.h = 9;
-          get_rect (&rdest, 10, 3, 45, 9);
-          if (SDL_BlitSurface (score_surface, &rsour, public_surface, &rdest)
-              < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(score_surface) return %s",
-                       SDL_GetError ());
-            }
-          energy_gauge_guard_is_update = FALSE;
-        }
-
-      /* display score number */
-      if (is_player_score_displayed)
-        {
-          rsour.x = 68;
-          rsour.y = 0;
-          rsour.w = 128;
-          rsour.h = 16;
-          get_rect (&rdest, 68, 0, 128, 16);
-          if (SDL_BlitSurface (score_surface, &rsour, public_surface, &rdest)
-              < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(score_surface) return %s",
-                       SDL_GetError ());
-            }
-          is_player_score_displayed = FALSE;
-        }
+      /* display the modified areas of the panels */
+      dirty_rects_flush (blit_dirty_rect, NULL);
     }
   SDL_UpdateWindowSurface(main_window);
 }
 
+#ifdef USE_SCALE2X
 /**
- * Increase the size of the offscreens,
- * use scale2x effect developed by Andrea Mazzoleni
+ * Scale a modified area of a panel into the window
+ * @param rect Area of the score or the option panel
+ * @param data Pointer to the top left pixel of the 320x200 screen
+ */
+static void
+scale_dirty_rect (dirty_rect * rect, void *data)
+{
+  display_scale_dirty_rect (power_conf->scale_x, rect, (char *) data,
+                            public_surface->pitch);
+}
+
+#endif
+
+/**
+ * Increase the size of the offscreens of a frame into the window,
+ * use scale2x effect developed by Andrea Mazzoleni. Called by the
+ * main thread or by the presentation thread
+ * @param frame The offscreens and the modified areas of the panels
  */
 #ifdef USE_SCALE2X
 static void
-display_scale_x (void)
+scale_frame (present_frame * frame)
 {
   char *src;
   Sint32 scalex = power_conf->scale_x;
   char *pixels = (char *) public_surface->pixels;
   Sint32 pitch = public_surface->pitch;
-  Sint32 optx, opty;
   if (vmode2)
     {
       pixels += 20 * scalex * pitch;
@@ -1669,103 +1763,188 @@ display_scale_x (void)
 #endif
 
   /* scale main screen */
-  src = game_offscreen + (offscreen_clipsize * offscreen_pitch) +
+  src = frame->game_offscreen + (offscreen_clipsize * offscreen_pitch) +
     (offscreen_clipsize * bytes_per_pixel);
-  scale (scalex, pixels + (pitch * score_offscreen_height * scalex), pitch,
-         src, 512 * bytes_per_pixel, bytes_per_pixel, offscreen_width_visible,
-         offscreen_height_visible);
+  display_scale_game (scalex,
+                      pixels + (pitch * score_offscreen_height * scalex),
+                      pitch, src, 512 * bytes_per_pixel,
+                      offscreen_width_visible, offscreen_height_visible);
 
-  if (update_all)
+  if (frame->update_all)
     {
       /* display score panel */
-      scale (scalex, pixels, pitch, scores_offscreen, score_offscreen_pitch,
-             bytes_per_pixel, score_offscreen_width, score_offscreen_height);
+      display_scale_game (scalex, pixels, pitch, frame->scores_offscreen,
+                          score_offscreen_pitch, score_offscreen_width,
+                          score_offscreen_height);
       /* display option panel */
-      scale (scalex,
-             pixels + (offscreen_width_visible * bytes_per_pixel * scalex) +
-             (pitch * score_offscreen_height * scalex), pitch,
-             options_offscreen, OPTIONS_WIDTH * bytes_per_pixel,
-             bytes_per_pixel, OPTIONS_WIDTH, OPTIONS_HEIGHT);
-      opt_refresh_index = -1;
+      display_scale_game (scalex,
+                          pixels +
+                          (offscreen_width_visible * window_bytes_per_pixel *
+                           scalex) + (pitch * score_offscreen_height * scalex),
+                          pitch, frame->options_offscreen,
+                          OPTIONS_WIDTH * bytes_per_pixel, OPTIONS_WIDTH,
+                          OPTIONS_HEIGHT);
     }
   else
     {
-      /* display player score */
-      if (is_player_score_displayed)
-        {
-          is_player_score_displayed = FALSE;
-          scale (scalex, pixels + (68 * bytes_per_pixel * scalex), pitch,
-                 scores_offscreen + (68 * bytes_per_pixel),
-                 score_offscreen_pitch, bytes_per_pixel, 128, 16);
-        }
-      if (score_x2_refresh)
-        {
-          score_x2_refresh = FALSE;
-          scale (scalex,
-                 pixels +
-                 ((offscreen_width_visible + 41) * bytes_per_pixel * scalex) +
-                 (score_offscreen_height + 171) * pitch * scalex, pitch,
-                 options_offscreen + (41 * bytes_per_pixel) +
-                 (171 * OPTIONS_WIDTH * bytes_per_pixel),
-                 OPTIONS_WIDTH * bytes_per_pixel, bytes_per_pixel, 14, 8);
-        }
-      if (score_x4_refresh)
-        {
-          score_x4_refresh = FALSE;
-          scale (scalex,
-                 pixels +
-                 ((offscreen_width_visible + 41) * bytes_per_pixel * scalex) +
-                 (score_offscreen_height + 5) * pitch * scalex, pitch,
-                 options_offscreen + (41 * bytes_per_pixel) +
-                 (5 * OPTIONS_WIDTH * bytes_per_pixel),
-                 OPTIONS_WIDTH * bytes_per_pixel, bytes_per_pixel, 14, 8);
-        }
-      while (opt_refresh_index >= 0)
-        {
-          optx = options_refresh[opt_refresh_index].coord_x;
-          opty = options_refresh[opt_refresh_index--].coord_y;
-          scale (scalex,
-                 pixels + (offscreen_width_visible +
-                           optx) * bytes_per_pixel * scalex +
-                 (score_offscreen_height + opty) * pitch * scalex, pitch,
-                 options_offscreen + (optx * bytes_per_pixel) +
-                 (opty * OPTIONS_WIDTH * bytes_per_pixel),
-                 OPTIONS_WIDTH * bytes_per_pixel, bytes_per_pixel, 28, 28);
-        }
-
-      /* display player's ernergy */
-      if (energy_gauge_spaceship_is_update)
-        {
-          energy_gauge_spaceship_is_update = FALSE;
-          scale (scalex,
-                 pixels + 210 * bytes_per_pixel * scalex + 3 * pitch * scalex,
-                 pitch,
-                 scores_offscreen + 210 * bytes_per_pixel +
-                 3 * score_offscreen_pitch, score_offscreen_pitch,
-                 bytes_per_pixel, 100, 9);
-        }
-
-      /* display guardian's energy */
-      if (energy_gauge_guard_is_update)
-        {
-          energy_gauge_guard_is_update = FALSE;
-          scale (scalex,
-                 pixels + 10 * bytes_per_pixel * scalex + 3 * pitch * scalex,
-                 pitch,
-                 scores_offscreen + 10 * bytes_per_pixel +
-                 3 * score_offscreen_pitch, score_offscreen_pitch,
-                 bytes_per_pixel, 45, 9);
-        }
+      /* display the modified areas of the panels */
+      dirty_rects_list_flush (&frame->dirty, frame->scores_offscreen,
+                              frame->options_offscreen, scale_dirty_rect,
+                              pixels);
     }
 
 #ifdef __EMSCRIPTEN__
   SDL_UnlockSurface (public_surface);
 #endif
+}
 
+/**
+ * Scale the current frame and update the window
+ */
+static void
+display_scale_x (void)
+{
+  present_frame frame;
+  present_frame_current (&frame);
+  scale_frame (&frame);
   SDL_UpdateWindowSurface(main_window);
 }
+
+/**
+ * Update the window with the frame scaled by the thread, then give
+ * it the current frame. SDL_UpdateWindowSurface() must be called by
+ * the main thread
+ */
+static void
+display_present (void)
+{
+  if (present_thread_wait ())
+    {
+      SDL_UpdateWindowSurface(main_window);
+    }
+  present_thread_start ();
+}
 #endif
 
+/**
+ * Copy a rectangle of an offscreen into the texture
+ * @param x X coordinate in the texture
+ * @param y Y coordinate in the texture
+ * @param w Width of the rectangle
+ * @param h Height of the rectangle
+ * @param pixels Pointer to the first pixel of the rectangle
+ * @param pitch Size of a line of the offscreen in bytes
+ */
+static void
+texture_update (Sint16 x, Sint16 y, Sint16 w, Sint16 h, char *pixels,
+                Sint32 pitch)
+{
+  SDL_Rect rect;
+  get_rect (&rect, x, y, w, h);
+  if (SDL_UpdateTexture (main_texture, &rect, pixels, pitch) < 0)
+    {
+      LOG_ERR ("SDL_UpdateTexture() return %s", SDL_GetError ());
+    }
+}
+
+/**
+ * Draw the texture scaled to the window
+ */
+static void
+texture_present (void)
+{
+  if (SDL_RenderClear (main_renderer) < 0)
+    {
+      LOG_ERR ("SDL_RenderClear() return %s", SDL_GetError ());
+    }
+  if (SDL_RenderCopy (main_renderer, main_texture, NULL, NULL) < 0)
+    {
+      LOG_ERR ("SDL_RenderCopy() return %s", SDL_GetError ());
+    }
+  SDL_RenderPresent (main_renderer);
+}
+
+/**
+ * Copy a modified area of a panel into the texture
+ * @param rect Area of the score or the option panel
+ * @param data Unused
+ */
+static void
+texture_dirty_rect (dirty_rect * rect, void *data)
+{
+  (void) data;
+  texture_update ((Sint16) rect->screen_x, (Sint16) rect->screen_y,
+                  (Sint16) rect->w, (Sint16) rect->h, rect->pixels,
+                  rect->pitch);
+}
+
+/**
+ * Upload the visible area of the playfield and the modified areas of
+ * the score and option panels into the texture, the renderer scales
+ * it to the window
+ */
+static void
+display_texture (void)
+{
+  /* playfield */
+  texture_update (0, (Sint16) score_offscreen_height,
+                  (Sint16) offscreen_width_visible,
+                  (Sint16) offscreen_height_visible,
+                  game_offscreen + (offscreen_clipsize * offscreen_pitch) +
+                  (offscreen_clipsize * bytes_per_pixel), offscreen_pitch);
+
+  if (update_all)
+    {
+      texture_update (0, 0, (Sint16) score_offscreen_width,
+                      (Sint16) score_offscreen_height, scores_offscreen,
+                      score_offscreen_pitch);
+      texture_update ((Sint16) offscreen_width_visible,
+                      (Sint16) score_offscreen_height, OPTIONS_WIDTH,
+                      OPTIONS_HEIGHT, options_offscreen,
+                      OPTIONS_WIDTH * bytes_per_pixel);
+      dirty_rects_reset ();
+      update_all = FALSE;
+    }
+  else
+    {
+      /* upload the modified areas of the panels */
+      dirty_rects_flush (texture_dirty_rect, NULL);
+    }
+  texture_present ();
+}
+
+/**
+ * Copy a modified area of a panel to the 640x400 window, double pixels
+ * horizontally, interlaced with empty line vertically
+ * @param rect Area of the score or the option panel
+ * @param data Pointer to the first line of the screen into the window
+ */
+static void
+copy2X_dirty_rect (dirty_rect * rect, void *data)
+{
+  SDL_Rect rdest;
+  SDL_Rect rsour;
+  Sint32 starty = *(Sint32 *) data;
+  copy2X (rect->pixels,
+          scalex_offscreen + (rect->screen_x * bytes_per_pixel * 2) +
+          (rect->screen_y * window_width * bytes_per_pixel * 2), rect->w,
+          rect->h, rect->pitch - rect->w * bytes_per_pixel,
+          (window_width * bytes_per_pixel * 2) -
+          rect->w * bytes_per_pixel * 2);
+  rsour.x = (Sint16) (rect->screen_x * 2);
+  rsour.y = (Sint16) (rect->screen_y * 2);
+  rsour.w = (Uint16) (rect->w * 2);
+  rsour.h = (Uint16) (rect->h * 2);
+  rdest.x = rsour.x;
+  rdest.y = (Sint16) (rsour.y + starty);
+  rdest.w = rsour.w;
+  rdest.h = rsour.h;
+  if (SDL_BlitSurface (scalex_surface, &rsour, public_surface, &rdest) < 0)
+    {
+      LOG_ERR ("SDL_BlitSurface(scalex_surface) return %s", SDL_GetError ());
+    }
+}
+
 /**
  * Display window in 640*400. Double pixels horizontally, interlaced
  *     with empty line vertically. Playfield: 512x440;
@@ -1774,7 +1953,7 @@ display_scale_x (void)
 static void
 display_640x400 (void)
 {
-  Sint32 v, starty, optx, opty;
+  Sint32 v, starty;
   SDL_Rect rdest;
   SDL_Rect rsour;
   char *src =
@@ -1818,186 +1997,8 @@ display_640x400 (void)
                    SDL_GetError ());
         }
 
-      /* display score number */
-      if (is_player_score_displayed)
-        {
-          is_player_score_displayed = FALSE;
-          copy2X (scores_offscreen + (68 * bytes_per_pixel),
-                  scalex_offscreen + (68 * bytes_per_pixel * 2), 128, 16,
-                  score_offscreen_pitch - 128 * bytes_per_pixel,
-                  (window_width * 2 * bytes_per_pixel) -
-                  128 * bytes_per_pixel * 2);
-          rsour.x = 68 * 2;
-          rsour.y = 0;
-          rsour.w = 128 * 2;
-          rsour.h = 16 * 2;
-          rdest.x = 68 * 2;
-          rdest.y = (Sint16) starty;
-          rdest.w = 128 * 2;
-          rdest.h = 16 * 2;
-          v =
-            SDL_BlitSurface (scalex_surface, &rsour, public_surface, &rdest);
-          if (v < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(scalex_surface) return %s",
-                       SDL_GetError ());
-            }
-        }
-
-      if (score_x2_refresh || !update_all)
-        {
-          copy2X (options_offscreen + (41 * bytes_per_pixel) +
-                  (171 * OPTIONS_WIDTH * bytes_per_pixel),
-                  scalex_offscreen +
-                  ((offscreen_width_visible + 41) * bytes_per_pixel * 2) +
-                  ((score_offscreen_height +
-                    171) * window_width * bytes_per_pixel * 2), 14, 8,
-                  OPTIONS_WIDTH * bytes_per_pixel - 14 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  14 * bytes_per_pixel * 2);
-          rsour.x = (Sint16) ((offscreen_width_visible + 41) * 2);
-          rsour.y = (Sint16) ((score_offscreen_height + 171) * 2);
-          rsour.w = 14 * 2;
-          rsour.h = 8 * 2;
-
-          rdest.x = (Sint16) ((offscreen_width_visible + 41) * 2);
-          rdest.y = (Sint16) ((score_offscreen_height + 171) * 2 + starty);
-
-          rdest.w = 14 * 2;
-          rdest.h = 8 * 2;
-          v =
-            SDL_BlitSurface (scalex_surface, &rsour, public_surface, &rdest);
-          if (v < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(scalex_surface) return %s",
-                       SDL_GetError ());
-            }
-          score_x2_refresh = FALSE;
-        }
-
-      if (score_x4_refresh || !update_all)
-        {
-          copy2X (options_offscreen + (41 * bytes_per_pixel) +
-                  (5 * OPTIONS_WIDTH * bytes_per_pixel),
-                  scalex_offscreen +
-                  ((offscreen_width_visible + 41) * bytes_per_pixel * 2) +
-                  ((score_offscreen_height +
-                    5) * window_width * bytes_per_pixel * 2), 14, 8,
-                  OPTIONS_WIDTH * bytes_per_pixel - 14 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  14 * bytes_per_pixel * 2);
-          rsour.x = (Sint16) ((offscreen_width_visible + 41) * 2);
-          rsour.y = (Sint16) ((score_offscreen_height + 5) * 2);
-          rsour.w = 14 * 2;
-          rsour.h = 8 * 2;
-
-          rdest.x = (Sint16) ((offscreen_width_visible + 41) * 2);
-          rdest.y = (Sint16) ((score_offscreen_height + 5) * 2 + starty);
-
-          rdest.w = 14 * 2;
-          rdest.h = 8 * 2;
-          v =
-            SDL_BlitSurface (scalex_surface, &rsour, public_surface, &rdest);
-          if (v < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(scalex_surface) return %s",
-                       SDL_GetError ());
-            }
-          score_x4_refresh = FALSE;
-        }
-
-      /* display options from option panel */
-      while (opt_refresh_index >= 0)
-        {
-          optx = options_refresh[opt_refresh_index].coord_x;
-          opty = options_refresh[opt_refresh_index--].coord_y;
-          copy2X (options_offscreen + (optx * bytes_per_pixel) +
-                  (opty * OPTIONS_WIDTH * bytes_per_pixel),
-                  scalex_offscreen +
-                  ((offscreen_width_visible + optx) * bytes_per_pixel * 2) +
-                  ((score_offscreen_height +
-                    opty) * window_width * bytes_per_pixel * 2), 28, 28,
-                  OPTIONS_WIDTH * bytes_per_pixel - 28 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  28 * bytes_per_pixel * 2);
-          rsour.x = (Sint16) ((offscreen_width_visible + optx) * 2);
-          rsour.y = (Sint16) ((score_offscreen_height + opty) * 2);
-          rsour.w = 28 * 2;
-          rsour.h = 28 * 2;
-
-          rdest.x = (Sint16) ((offscreen_width_visible + optx) * 2);
-          rdest.y = (Sint16) ((score_offscreen_height + opty) * 2 + starty);
-
-          rdest.w = 28 * 2;
-          rdest.h = 28 * 2;
-          v =
-            SDL_BlitSurface (scalex_surface, &rsour, public_surface, &rdest);
-          if (v < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(scalex_surface) return %s",
-                       SDL_GetError ());
-            }
-        }
-
-      /* display player's ernergy */
-      if (energy_gauge_spaceship_is_update)
-        {
-          energy_gauge_spaceship_is_update = FALSE;
-          copy2X (scores_offscreen + (210 * bytes_per_pixel) +
-                  (3 * score_offscreen_pitch),
-                  scalex_offscreen + (210 * bytes_per_pixel * 2) +
-                  (3 * window_width * bytes_per_pixel * 2), 100, 9,
-                  score_offscreen_pitch - 100 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  100 * bytes_per_pixel * 2);
-          rsour.x = 210 * 2;
-          rsour.y = 3 * 2;
-          rsour.w = 100 * 2;
-          rsour.h = 9 * 2;
-
-          rdest.x = 210 * 2;
-          rdest.y = 3 * 2 + (Sint16) starty;
-
-          rdest.w = 100 * 2;
-          rdest.h = 9 * 2;
-          v =
-            SDL_BlitSurface (scalex_surface, &rsour, public_surface, &rdest);
-          if (v < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(scalex_surface) return %s",
-                       SDL_GetError ());
-            }
-        }
-
-      /* display guardian's energy */
-      if (energy_gauge_guard_is_update)
-        {
-          energy_gauge_guard_is_update = FALSE;
-          copy2X (scores_offscreen + (10 * bytes_per_pixel) +
-                  (3 * score_offscreen_pitch),
-                  scalex_offscreen + (10 * bytes_per_pixel * 2) +
-                  (3 * window_width * bytes_per_pixel * 2), 45, 9,
-                  score_offscreen_pitch - 45 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  45 * bytes_per_pixel * 2);
-          rsour.x = 10 * 2;
-          rsour.y = 3 * 2;
-          rsour.w = 45 * 2;
-          rsour.h = 9 * 2;
-          rdest.x = 10 * 2;
-          rdest.y = 3 * 2 + (Sint16) starty;
-          rdest.w = 45 * 2;
-          rdest.h = 9 * 2;
-          v =
-            SDL_BlitSurface (scalex_surface, &rsour, public_surface, &rdest);
-          if (v < 0)
-            {
-              LOG_ERR ("SDL_BlitSurface(scalex_surface) return %s",
-                       SDL_GetError ());
-            }
-        }
-
-
+      /* display the modified areas of the panels */
+      dirty_rects_flush (copy2X_dirty_rect, &starty);
     }
   else
     {
@@ -2027,7 +2028,7 @@ display_640x400 (void)
                    SDL_GetError ());
         }
       update_all = FALSE;
-      opt_refresh_index = -1;
+      dirty_rects_reset ();
     }
 
 #ifdef __EMSCRIPTEN__
@@ -2114,6 +2115,7 @@ display_close_joysticks (void)
 void
 display_free (void)
 {
+  present_thread_free ();
   free_surfaces ();
   game_offscreen = NULL;
   game_surface = NULL;
@@ -2126,6 +2128,11 @@ display_free (void)
 #ifdef USE_SDL_JOYSTICK
   display_close_joysticks ();
 #endif
+  if (main_texture != NULL)
+    {
+      SDL_DestroyTexture (main_texture);
+      main_texture = NULL;
+    }
   SDL_DestroyRenderer(main_renderer);
   main_renderer = NULL;
   SDL_DestroyWindow(main_window);
@@ -2165,6 +2172,18 @@ display_clear_offscreen (void)
   real_black_color = SDL_MapRGBA (public_surface->format, 0, 0, 0, 0xff);
 #endif
 
+  /* the offscreen can be the second one of the presentation thread */
+  if (present_thread_enabled ())
+    {
+      clear_offscreen (game_offscreen +
+                       (offscreen_clipsize * offscreen_pitch) +
+                       (offscreen_clipsize * bytes_per_pixel),
+                       (offscreen_width_visible * bytes_per_pixel) >> 2,
+                       offscreen_height_visible,
+                       (offscreen_width -
+                        offscreen_width_visible) * bytes_per_pixel);
+      return;
+    }
   if (SDL_FillRect (game_surface, &rect, real_black_color) < 0)
     {
       LOG_ERR ("SDL_FillRect(game_surface) return %s", SDL_GetError ());
@@ -2180,7 +2199,7 @@ display_clear_offscreen (void)
 static SDL_Surface *
 create_surface (Uint32 width, Uint32 height)
 {
-  Uint32 i, rmask, gmask, bmask;
+  Uint32 i, rmask, gmask, bmask, depth;
   SDL_Surface *surface;
   Sint32 index = -1;
   for (i = 0; i < MAX_OF_SURFACES; i++)
@@ -2197,15 +2216,21 @@ create_surface (Uint32 width, Uint32 height)
       return NULL;
     }
   get_rgb_mask (&rmask, &gmask, &bmask);
+  depth = bits_per_pixel;
+  if (bytes_per_pixel < window_bytes_per_pixel)
+    {
+      /* palettized mode: 8-bit indexes */
+      depth = 8;
+      rmask = gmask = bmask = 0;
+    }
   surface =
-    SDL_CreateRGBSurface (0, width, height, bits_per_pixel,
-                          rmask, gmask, bmask, 0);
+    SDL_CreateRGBSurface (0, width, height, depth, rmask, gmask, bmask, 0);
   if (surface == NULL)
     {
       LOG_ERR ("SDL_CreateRGBSurface() return %s", SDL_GetError ());
       return NULL;
     }
-  if (bytes_per_pixel == 1)
+  if (bytes_per_pixel == 1 && sdl_color_palette != NULL)
 	  SDL_SetPaletteColors(surface->format->palette, sdl_color_palette, 0, 256);
 
   surfaces_list[index] = surface;
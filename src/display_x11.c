@@ -31,6 +31,7 @@
 #include "images.h"
 #include "config_file.h"
 #include "display.h"
+#include "dirty_rects.h"
 #include "electrical_shock.h"
 #include "energy_gauge.h"
 #include "log_recorder.h"
@@ -234,6 +235,8 @@ display_init (void)
       bytes_per_pixel = 4;
       break;
     }
+  /* the palettized mode is not supported */
+  display_select_depth (FALSE);
   displayw = DisplayWidth (x11_display, dfscreen);
   displayh = DisplayHeight (x11_display, dfscreen);
   LOG_INF ("depth of screen: %i; bytes per pixel:%i; "
@@ -638,6 +641,26 @@ display_update_window (void)
     }
 }
 
+/**
+ * Copy a modified area of a panel to the screen in DGA 320*200,
+ * the area is widened to copy 32-bit words
+ * @param rect Area of the score or the option panel
+ * @param data Pointer to the top left pixel of the screen
+ */
+static void
+dga320x200_dirty_rect (dirty_rect * rect, void *data)
+{
+  Sint32 left = rect->x & 3;
+  Sint32 width = (rect->w + left + 3) & ~3;
+  copie4octets (rect->pixels - left * bytes_per_pixel,
+                (char *) data + (rect->screen_x - left) * bytes_per_pixel +
+                rect->screen_y * dga_viewport_width * bytes_per_pixel,
+                width / 4 * bytes_per_pixel, rect->h,
+                rect->pitch - width * bytes_per_pixel,
+                dga_viewport_width * bytes_per_pixel -
+                width * bytes_per_pixel);
+}
+
 /**
  * Draw in DGA
  */
@@ -645,7 +668,6 @@ void
 dga320x200 ()
 {
   Sint32 _iOffset;
-  Sint32 optx, opty;
   char *_pSource;
   char *_pDestination, *_pDestination2;
   _pSource =
@@ -665,91 +687,8 @@ dga320x200 ()
                 (offscreen_width_visible * bytes_per_pixel));
   if (!update_all)
     {
-      if (is_player_score_displayed)
-        {
-          is_player_score_displayed = FALSE;
-          copie4octets (scores_offscreen + (68 * bytes_per_pixel),
-                        _pDestination + (68 * bytes_per_pixel),
-                        128 / 4 * bytes_per_pixel, 16,
-                        score_offscreen_pitch - 128 * bytes_per_pixel,
-                        (dga_viewport_width * bytes_per_pixel) -
-                        128 * bytes_per_pixel);
-        }
-      /* display X2 score multiplier */
-      if (score_x2_refresh || !update_all)
-        {
-          copie4octets (options_offscreen + (41 * bytes_per_pixel) +
-                        (171 * OPTIONS_WIDTH * bytes_per_pixel),
-                        _pDestination +
-                        ((offscreen_width_visible + 41) * bytes_per_pixel) +
-                        ((score_offscreen_height +
-                          171) * dga_viewport_width * bytes_per_pixel),
-                        16 / 4 * bytes_per_pixel, 8,
-                        OPTIONS_WIDTH * bytes_per_pixel -
-                        16 * bytes_per_pixel,
-                        (dga_viewport_width * bytes_per_pixel) -
-                        16 * bytes_per_pixel);
-          score_x2_refresh = FALSE;
-        }
-      /* display X4 score multiplier */
-      if (score_x4_refresh || !update_all)
-        {
-          copie4octets (options_offscreen + (41 * bytes_per_pixel) +
-                        (5 * OPTIONS_WIDTH * bytes_per_pixel),
-                        _pDestination +
-                        ((offscreen_width_visible + 41) * bytes_per_pixel) +
-                        ((score_offscreen_height +
-                          5) * dga_viewport_width * bytes_per_pixel),
-                        16 / 4 * bytes_per_pixel, 8,
-                        OPTIONS_WIDTH * bytes_per_pixel -
-                        16 * bytes_per_pixel,
-                        (dga_viewport_width * bytes_per_pixel) -
-                        16 * bytes_per_pixel);
-          score_x4_refresh = FALSE;
-        }
-      /* display option boxes on the left option panel */
-      while (opt_refresh_index >= 0)
-        {
-          optx = options_refresh[opt_refresh_index].coord_x;
-          opty = options_refresh[opt_refresh_index--].coord_y;
-
-          copie4octets (options_offscreen + (optx * bytes_per_pixel) +
-                        (opty * OPTIONS_WIDTH * bytes_per_pixel),
-                        _pDestination +
-                        ((offscreen_width_visible + optx) * bytes_per_pixel) +
-                        ((score_offscreen_height +
-                          opty) * dga_viewport_width * bytes_per_pixel),
-                        28 / 4 * bytes_per_pixel, 28,
-                        (OPTIONS_WIDTH - 28) * bytes_per_pixel,
-                        dga_viewport_width * bytes_per_pixel -
-                        (28 * bytes_per_pixel));
-        }
-      /* display player's energy */
-      if (energy_gauge_spaceship_is_update)
-        {
-          energy_gauge_spaceship_is_update = 0;
-          copie4octets (scores_offscreen + (210 * bytes_per_pixel) +
-                        (3 * score_offscreen_pitch),
-                        _pDestination + (210 * bytes_per_pixel) +
-                        (3 * dga_viewport_width * bytes_per_pixel),
-                        100 / 4 * bytes_per_pixel, 9,
-                        score_offscreen_pitch - 100 * bytes_per_pixel,
-                        (dga_viewport_width * bytes_per_pixel) -
-                        100 * bytes_per_pixel);
-        }
-      /* display big-boss's energy */
-      if (energy_gauge_guard_is_update)
-        {
-          energy_gauge_guard_is_update = FALSE;
-          copie4octets (scores_offscreen + (10 * bytes_per_pixel) +
-                        (3 * score_offscreen_pitch),
-                        _pDestination + (10 * bytes_per_pixel) +
-                        (3 * dga_viewport_width * bytes_per_pixel),
-                        48 / 4 * bytes_per_pixel, 9,
-                        score_offscreen_pitch - 48 * bytes_per_pixel,
-                        (dga_viewport_width * bytes_per_pixel) -
-                        48 * bytes_per_pixel);
-        }
+      /* display the modified areas of the panels */
+      dirty_rects_flush (dga320x200_dirty_rect, _pDestination);
     }
   else
     {
@@ -766,17 +705,32 @@ dga320x200 ()
                     dga_viewport_width * bytes_per_pixel -
                     (OPTIONS_WIDTH * bytes_per_pixel));
       update_all = false;
-      opt_refresh_index = -1;
+      dirty_rects_reset ();
     }
 }
 
+/**
+ * Copy a modified area of a panel to the screen in DGA 640*400
+ * @param rect Area of the score or the option panel
+ * @param data Pointer to the top left pixel of the screen
+ */
+static void
+dga640x400_dirty_rect (dirty_rect * rect, void *data)
+{
+  copy2X (rect->pixels,
+          (char *) data + (rect->screen_x * bytes_per_pixel * 2) +
+          (rect->screen_y * dga_viewport_width * bytes_per_pixel * 2),
+          rect->w, rect->h, rect->pitch - rect->w * bytes_per_pixel,
+          (dga_viewport_width * bytes_per_pixel * 2) -
+          rect->w * bytes_per_pixel * 2);
+}
+
 /**
  * Display in DGA mode 640*400
  */
 void
 dga640x400 ()
 {
-  Sint32 optx, opty;
   char *_pSource;
   char *_pDestination, *_pDestination2;
 
@@ -801,83 +755,8 @@ dga640x400 ()
             (offscreen_width_visible * 2 * bytes_per_pixel));
     if (!update_all)
       {
-        if (is_player_score_displayed)
-          {
-            is_player_score_displayed = FALSE;
-            copy2X (scores_offscreen + (68 * bytes_per_pixel),
-                    _pDestination + (68 * bytes_per_pixel * 2), 128, 16,
-                    score_offscreen_pitch - 128 * bytes_per_pixel,
-                    (dga_viewport_width * 2 * bytes_per_pixel) -
-                    128 * bytes_per_pixel * 2);
-          }
-        /* display X2 score multiplier */
-        if (score_x2_refresh || !update_all)
-          {
-            copy2X (options_offscreen + (41 * bytes_per_pixel) +
-                    (171 * OPTIONS_WIDTH * bytes_per_pixel),
-                    _pDestination +
-                    ((offscreen_width_visible + 41) * bytes_per_pixel * 2) +
-                    ((score_offscreen_height +
-                      171) * dga_viewport_width * bytes_per_pixel * 2), 14, 8,
-                    OPTIONS_WIDTH * bytes_per_pixel - 14 * bytes_per_pixel,
-                    (dga_viewport_width * bytes_per_pixel * 2) -
-                    14 * bytes_per_pixel * 2);
-            score_x2_refresh = FALSE;
-          }
-        /* display X4 score multiplier */
-        if (score_x4_refresh || !update_all)
-          {
-            copy2X (options_offscreen + (41 * bytes_per_pixel) +
-                    (5 * OPTIONS_WIDTH * bytes_per_pixel),
-                    _pDestination +
-                    ((offscreen_width_visible + 41) * bytes_per_pixel * 2) +
-                    ((score_offscreen_height +
-                      5) * dga_viewport_width * bytes_per_pixel * 2), 14, 8,
-                    OPTIONS_WIDTH * bytes_per_pixel - 14 * bytes_per_pixel,
-                    (dga_viewport_width * bytes_per_pixel * 2) -
-                    14 * bytes_per_pixel * 2);
-            score_x4_refresh = FALSE;
-          }
-        /* display options from option panel */
-        while (opt_refresh_index >= 0)
-          {
-            optx = options_refresh[opt_refresh_index].coord_x;
-            opty = options_refresh[opt_refresh_index--].coord_y;
-            copy2X (options_offscreen + (optx * bytes_per_pixel) +
-                    (opty * OPTIONS_WIDTH * bytes_per_pixel),
-                    _pDestination +
-                    ((offscreen_width_visible + optx) * bytes_per_pixel * 2) +
-                    ((score_offscreen_height +
-                      opty) * dga_viewport_width * bytes_per_pixel * 2), 28,
-                    28,
-                    OPTIONS_WIDTH * bytes_per_pixel - 28 * bytes_per_pixel,
-                    (dga_viewport_width * bytes_per_pixel * 2) -
-                    28 * bytes_per_pixel * 2);
-          }
-        /* display player's energy */
-        if (energy_gauge_spaceship_is_update)
-          {
-            energy_gauge_spaceship_is_update = 0;
-            copy2X (scores_offscreen + (210 * bytes_per_pixel) +
-                    (3 * score_offscreen_pitch),
-                    _pDestination + (210 * bytes_per_pixel * 2) +
-                    (3 * dga_viewport_width * bytes_per_pixel * 2), 100, 9,
-                    score_offscreen_pitch - 100 * bytes_per_pixel,
-                    (dga_viewport_width * bytes_per_pixel * 2) -
-                    100 * bytes_per_pixel * 2);
-          }
-        /* display big-boss's energy */
-        if (energy_gauge_guard_is_update)
-          {
-            energy_gauge_guard_is_update = FALSE;
-            copy2X (scores_offscreen + (10 * bytes_per_pixel) +
-                    (3 * score_offscreen_pitch),
-                    _pDestination + (10 * bytes_per_pixel * 2) +
-                    (3 * dga_viewport_width * bytes_per_pixel * 2), 45, 9,
-                    score_offscreen_pitch - 45 * bytes_per_pixel,
-                    (dga_viewport_width * bytes_per_pixel * 2) -
-                    45 * bytes_per_pixel * 2);
-          }
+        /* display the modified areas of the panels */
+        dirty_rects_flush (dga640x400_dirty_rect, _pDestination);
       }
     else
       {
@@ -893,7 +772,7 @@ dga640x400 ()
                 dga_viewport_width * bytes_per_pixel * 2 -
                 (OPTIONS_WIDTH * 2 * bytes_per_pixel));
         update_all = false;
-        opt_refresh_index = -1;
+        dirty_rects_reset ();
       }
   }
 }
@@ -990,10 +869,10 @@ display_movie (void)
           /* scale2x */
         case 2:
           {
-            scale (power_conf->scale_x, scalex_offscreen,
-                   window_width * bytes_per_pixel, movie_offscreen,
-                   display_width * bytes_per_pixel, bytes_per_pixel,
-                   display_width, display_height);
+            display_scale (power_conf->scale_x, scalex_offscreen,
+                           window_width * bytes_per_pixel, movie_offscreen,
+                           display_width * bytes_per_pixel, bytes_per_pixel,
+                           display_width, display_height);
             XPutImage (x11_display, main_window_id, graphic_contexts,
                        scalex_ximage, 0, 0, 0, 0, window_width,
                        window_height);
@@ -1003,13 +882,35 @@ display_movie (void)
     }
 }
 
+/**
+ * Copy a modified area of a panel to the 320*200 window
+ * @param rect Area of the score or the option panel
+ * @param data Unused
+ */
+static void
+put_dirty_rect (dirty_rect * rect, void *data)
+{
+  XImage *ximage;
+  (void) data;
+  if (rect->panel == DIRTY_SCORE_PANEL)
+    {
+      ximage = scores_ximage;
+    }
+  else
+    {
+      ximage = options_ximage;
+    }
+  XPutImage (x11_display, main_window_id, graphic_contexts, ximage,
+             rect->x, rect->y, rect->screen_x, rect->screen_y, rect->w,
+             rect->h);
+}
+
 /**
  * Display window in 320*200
  */
 void
 display_320x200 ()
 {
-  Sint32 optx, opty;
   XPutImage (x11_display, main_window_id, graphic_contexts, game_ximage,
              offscreen_clipsize, offscreen_clipsize, 0, 16,
              offscreen_width_visible, offscreen_height_visible);
@@ -1022,57 +923,37 @@ display_320x200 ()
       XPutImage (x11_display, main_window_id, graphic_contexts,
                  scores_ximage, 0, 0, 0, 0, score_offscreen_width,
                  score_offscreen_height);
-      opt_refresh_index = -1;
+      dirty_rects_reset ();
       update_all = false;
     }
   else
     {
-
-      /* display options from option panel */
-      while (opt_refresh_index >= 0)
-        {
-          optx = options_refresh[opt_refresh_index].coord_x;
-          opty = options_refresh[opt_refresh_index--].coord_y;
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     options_ximage, optx, opty,
-                     offscreen_width_visible + optx, 16 + opty, 28, 28);
-        }
-      if (score_x2_refresh)
-        {
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     options_ximage, 41, 171, 297, 187, 14, 8);
-          score_x2_refresh = FALSE;
-        }
-      if (score_x4_refresh)
-        {
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     options_ximage, 41, 5, 297, 21, 14, 8);
-          score_x4_refresh = FALSE;
-        }
-      /* display player's energy */
-      if (energy_gauge_spaceship_is_update)
-        {
-          energy_gauge_spaceship_is_update = 0;
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scores_ximage, 210, 3, 210, 3, 100, 9);
-        }
-      /* display guardian's energy */
-      if (energy_gauge_guard_is_update)
-        {
-          energy_gauge_guard_is_update = FALSE;
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scores_ximage, 10, 3, 10, 3, 45, 9);
-        }
-      /* display score number */
-      if (is_player_score_displayed)
-        {
-          is_player_score_displayed = FALSE;
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scores_ximage, 68, 0, 68, 0, 128, 16);
-        }
+      /* display the modified areas of the panels */
+      dirty_rects_flush (put_dirty_rect, NULL);
     }
 }
 
+/**
+ * Scale a modified area of a panel and copy it to the window
+ * @param rect Area of the score or the option panel
+ * @param data Unused
+ */
+static void
+scalex_dirty_rect (dirty_rect * rect, void *data)
+{
+  Sint32 pitch = window_width * bytes_per_pixel;
+  Sint32 scalex = power_conf->scale_x;
+  (void) data;
+  scale (scalex,
+         scalex_offscreen + rect->screen_x * bytes_per_pixel * scalex +
+         rect->screen_y * pitch * scalex, pitch, rect->pixels, rect->pitch,
+         bytes_per_pixel, rect->w, rect->h);
+  XPutImage (x11_display, main_window_id, graphic_contexts, scalex_ximage,
+             rect->screen_x * scalex, rect->screen_y * scalex,
+             rect->screen_x * scalex, rect->screen_y * scalex,
+             rect->w * scalex, rect->h * scalex);
+}
+
 /**
  * Increase the size of the bitmaps guessing the missing pixels
  */
@@ -1080,7 +961,6 @@ static void
 display_scalex (void)
 {
   char *src;
-  Sint32 optx, opty;
   Sint32 pitch = window_width * bytes_per_pixel;
   Sint32 scalex = power_conf->scale_x;
   char *pixels = scalex_offscreen;
@@ -1088,9 +968,10 @@ display_scalex (void)
   /* scale main screen */
   src = game_offscreen + (offscreen_clipsize * offscreen_pitch) +
     (offscreen_clipsize * bytes_per_pixel);
-  scale (scalex, pixels + (pitch * score_offscreen_height * scalex), pitch,
-         src, offscreen_width * bytes_per_pixel, bytes_per_pixel,
-         offscreen_width_visible, offscreen_height_visible);
+  display_scale (scalex, pixels + (pitch * score_offscreen_height * scalex),
+                 pitch, src, offscreen_width * bytes_per_pixel,
+                 bytes_per_pixel, offscreen_width_visible,
+                 offscreen_height_visible);
 
   /* whole screen will be redisplayed? */
   if (update_all)
@@ -1110,7 +991,7 @@ display_scalex (void)
                  /* offset destination the top left edge of the image */
                  0, 0, window_width, window_height);
       update_all = false;
-      opt_refresh_index = -1;
+      dirty_rects_reset ();
     }
   else
     {
@@ -1119,102 +1000,32 @@ display_scalex (void)
                  score_offscreen_height * scalex,
                  offscreen_width_visible * scalex,
                  offscreen_height_visible * scalex);
-      /* display player score */
-      if (is_player_score_displayed)
-        {
-          is_player_score_displayed = FALSE;
-          scale (scalex, pixels + (68 * bytes_per_pixel * scalex), pitch,
-                 scores_offscreen + (68 * bytes_per_pixel),
-                 score_offscreen_pitch, bytes_per_pixel, 128, 16);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, 68 * scalex, 0, 68 * scalex, 0,
-                     128 * scalex, 16 * scalex);
-        }
-      if (score_x2_refresh)
-        {
-          score_x2_refresh = FALSE;
-          scale (scalex,
-                 pixels +
-                 ((offscreen_width_visible + 41) * bytes_per_pixel * scalex) +
-                 (score_offscreen_height + 171) * pitch * scalex, pitch,
-                 options_offscreen + (41 * bytes_per_pixel) +
-                 (171 * OPTIONS_WIDTH * bytes_per_pixel),
-                 OPTIONS_WIDTH * bytes_per_pixel, bytes_per_pixel, 14, 8);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, (offscreen_width_visible + 41) * scalex,
-                     (score_offscreen_height + 171) * scalex,
-                     (offscreen_width_visible + 41) * scalex,
-                     (score_offscreen_height + 171) * scalex, 14 * scalex,
-                     8 * scalex);
-        }
-      if (score_x4_refresh)
-        {
-          score_x4_refresh = FALSE;
-          scale (scalex,
-                 pixels +
-                 ((offscreen_width_visible + 41) * bytes_per_pixel * scalex) +
-                 (score_offscreen_height + 5) * pitch * scalex, pitch,
-                 options_offscreen + (41 * bytes_per_pixel) +
-                 (5 * OPTIONS_WIDTH * bytes_per_pixel),
-                 OPTIONS_WIDTH * bytes_per_pixel, bytes_per_pixel, 14, 8);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, (offscreen_width_visible + 41) * scalex,
-                     (score_offscreen_height + 5) * scalex,
-                     (offscreen_width_visible + 41) * scalex,
-                     (score_offscreen_height + 5) * scalex, 14 * scalex,
-                     8 * scalex);
-        }
-      while (opt_refresh_index >= 0)
-        {
-          optx = options_refresh[opt_refresh_index].coord_x;
-          opty = options_refresh[opt_refresh_index--].coord_y;
-          scale (scalex,
-                 pixels + (offscreen_width_visible +
-                           optx) * bytes_per_pixel * scalex +
-                 (score_offscreen_height + opty) * pitch * scalex, pitch,
-                 options_offscreen + (optx * bytes_per_pixel) +
-                 (opty * OPTIONS_WIDTH * bytes_per_pixel),
-                 OPTIONS_WIDTH * bytes_per_pixel, bytes_per_pixel, 28, 28);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, (offscreen_width_visible + optx) * scalex,
-                     (score_offscreen_height + opty) * scalex,
-                     (offscreen_width_visible + optx) * scalex,
-                     (score_offscreen_height + opty) * scalex, 28 * scalex,
-                     28 * scalex);
-        }
-
-      /* display player's ernergy */
-      if (energy_gauge_spaceship_is_update)
-        {
-          energy_gauge_spaceship_is_update = 0;
-          scale (scalex,
-                 pixels + 210 * bytes_per_pixel * scalex + 3 * pitch * scalex,
-                 pitch,
-                 scores_offscreen + 210 * bytes_per_pixel +
-                 3 * score_offscreen_pitch, score_offscreen_pitch,
-                 bytes_per_pixel, 100, 9);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, 210 * scalex, 3 * scalex, 210 * scalex,
-                     3 * scalex, 100 * scalex, 9 * scalex);
-        }
-
-      /* display guardian's energy */
-      if (energy_gauge_guard_is_update)
-        {
-          energy_gauge_guard_is_update = FALSE;
-          scale (scalex,
-                 pixels + 10 * bytes_per_pixel * scalex + 3 * pitch * scalex,
-                 pitch,
-                 scores_offscreen + 10 * bytes_per_pixel +
-                 3 * score_offscreen_pitch, score_offscreen_pitch,
-                 bytes_per_pixel, 45, 9);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, 10 * scalex, 3 * scalex, 10 * scalex,
-                     3 * scalex, 45 * scalex, 9 * scalex);
-        }
+      /* display the modified areas of the panels */
+      dirty_rects_flush (scalex_dirty_rect, NULL);
     }
 }
 
+/**
+ * Copy a modified area of a panel to the 640*400 window, double pixels
+ * horizontally, interlaced with empty line vertically
+ * @param rect Area of the score or the option panel
+ * @param data Unused
+ */
+static void
+copy2X_dirty_rect (dirty_rect * rect, void *data)
+{
+  (void) data;
+  copy2X (rect->pixels,
+          scalex_offscreen + (rect->screen_x * bytes_per_pixel * 2) +
+          (rect->screen_y * window_width * bytes_per_pixel * 2), rect->w,
+          rect->h, rect->pitch - rect->w * bytes_per_pixel,
+          (window_width * bytes_per_pixel * 2) -
+          rect->w * bytes_per_pixel * 2);
+  XPutImage (x11_display, main_window_id, graphic_contexts, scalex_ximage,
+             rect->screen_x * 2, rect->screen_y * 2, rect->screen_x * 2,
+             rect->screen_y * 2, rect->w * 2, rect->h * 2);
+}
+
 /**
  * Display window in 640*400
  * playfield 512x440 ; score panel 320x16 ; option panel 64x184
@@ -1223,7 +1034,6 @@ display_scalex (void)
 static void
 display_640x400 (void)
 {
-  Sint32 optx, opty;
   char *_pSource =
     game_offscreen + (offscreen_clipsize * offscreen_pitch) +
     (offscreen_clipsize * bytes_per_pixel);
@@ -1250,7 +1060,7 @@ display_640x400 (void)
       XPutImage (x11_display, main_window_id, graphic_contexts, scalex_ximage,
                  0, 0, 0, 0, window_width, window_height);
       update_all = false;
-      opt_refresh_index = -1;
+      dirty_rects_reset ();
     }
   else
     {
@@ -1258,110 +1068,8 @@ display_640x400 (void)
                  scalex_ximage, 0, 32, 0, 32,
                  offscreen_width_visible * 2, offscreen_height_visible * 2);
 
-      /* display player score */
-      if (is_player_score_displayed)
-        {
-          is_player_score_displayed = FALSE;
-          copy2X (scores_offscreen + (68 * bytes_per_pixel),
-                  scalex_offscreen + (68 * bytes_per_pixel * 2), 128, 16,
-                  score_offscreen_pitch - 128 * bytes_per_pixel,
-                  (window_width * 2 * bytes_per_pixel) -
-                  128 * bytes_per_pixel * 2);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, 68 * 2, 0, 68 * 2, 0, 128 * 2, 16 * 2);
-        }
-      if (score_x2_refresh)
-        {
-          copy2X (options_offscreen + (41 * bytes_per_pixel) +
-                  (171 * OPTIONS_WIDTH * bytes_per_pixel),
-                  scalex_offscreen +
-                  ((offscreen_width_visible + 41) * bytes_per_pixel * 2) +
-                  ((score_offscreen_height +
-                    171) * window_width * bytes_per_pixel * 2), 14, 8,
-                  OPTIONS_WIDTH * bytes_per_pixel - 14 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  14 * bytes_per_pixel * 2);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, (offscreen_width_visible + 41) * 2,
-                     (score_offscreen_height + 171) * 2,
-                     (offscreen_width_visible + 41) * 2,
-                     (score_offscreen_height + 171) * 2, 14 * 2, 8 * 2);
-          score_x2_refresh = FALSE;
-        }
-
-      if (score_x4_refresh)
-        {
-          copy2X (options_offscreen + (41 * bytes_per_pixel) +
-                  (5 * OPTIONS_WIDTH * bytes_per_pixel),
-                  scalex_offscreen +
-                  ((offscreen_width_visible + 41) * bytes_per_pixel * 2) +
-                  ((score_offscreen_height +
-                    5) * window_width * bytes_per_pixel * 2), 14, 8,
-                  OPTIONS_WIDTH * bytes_per_pixel - 14 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  14 * bytes_per_pixel * 2);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, (offscreen_width_visible + 41) * 2,
-                     (score_offscreen_height + 5) * 2,
-                     (offscreen_width_visible + 41) * 2,
-                     (score_offscreen_height + 5) * 2, 14 * 2, 8 * 2);
-          score_x4_refresh = FALSE;
-        }
-
-      /* display options from option panel */
-      while (opt_refresh_index >= 0)
-        {
-          optx = options_refresh[opt_refresh_index].coord_x;
-          opty = options_refresh[opt_refresh_index--].coord_y;
-
-          copy2X (options_offscreen + (optx * bytes_per_pixel) +
-                  (opty * OPTIONS_WIDTH * bytes_per_pixel),
-                  scalex_offscreen +
-                  ((offscreen_width_visible + optx) * bytes_per_pixel * 2) +
-                  ((score_offscreen_height +
-                    opty) * window_width * bytes_per_pixel * 2), 28, 28,
-                  OPTIONS_WIDTH * bytes_per_pixel - 28 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  28 * bytes_per_pixel * 2);
-
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, (offscreen_width_visible + optx) * 2,
-                     (score_offscreen_height + opty) * 2,
-                     (offscreen_width_visible + optx) * 2,
-                     (score_offscreen_height + opty) * 2, 28 * 2, 28 * 2);
-        }
-
-      /* display player's ernergy */
-      if (energy_gauge_spaceship_is_update)
-        {
-          energy_gauge_spaceship_is_update = 0;
-          copy2X (scores_offscreen + (210 * bytes_per_pixel) +
-                  (3 * score_offscreen_pitch),
-                  scalex_offscreen + (210 * bytes_per_pixel * 2) +
-                  (3 * window_width * bytes_per_pixel * 2), 100, 9,
-                  score_offscreen_pitch - 100 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  100 * bytes_per_pixel * 2);
-
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, 210 * 2, 3 * 2, 210 * 2, 3 * 2, 100 * 2,
-                     9 * 2);
-        }
-      /* display guardian's energy */
-      if (energy_gauge_guard_is_update)
-        {
-          energy_gauge_guard_is_update = FALSE;
-          copy2X (scores_offscreen + (10 * bytes_per_pixel) +
-                  (3 * score_offscreen_pitch),
-                  scalex_offscreen + (10 * bytes_per_pixel * 2) +
-                  (3 * window_width * bytes_per_pixel * 2), 45, 9,
-                  score_offscreen_pitch - 45 * bytes_per_pixel,
-                  (window_width * bytes_per_pixel * 2) -
-                  45 * bytes_per_pixel * 2);
-          XPutImage (x11_display, main_window_id, graphic_contexts,
-                     scalex_ximage, 10 * 2, 3 * 2, 10 * 2, 3 * 2, 45 * 2,
-                     9 * 2);
-        }
+      /* display the modified areas of the panels */
+      dirty_rects_flush (copy2X_dirty_rect, NULL);
     }
 }
 
@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "display.h"
 #include "energy_gauge.h"
@@ -103,9 +104,9 @@ electrical_shock (void)
       eclair1.col2 = color_eclair[1];
       if (electrical_delay_count == 0)
         {
-          eclair1.r1 = (Sint32) rand () * (Sint32) rand ();
-          eclair1.r2 = (Sint32) rand () * (Sint32) rand ();
-          eclair1.r3 = (Sint32) rand () * (Sint32) rand ();
+          eclair1.r1 = (Sint32) game_rand_next ();
+          eclair1.r2 = (Sint32) game_rand_next ();
+          eclair1.r3 = (Sint32) game_rand_next ();
           /* decrease enemy's damage */
           spr->energy_level--;
           /* guardian enemy (big-boss)? */
@@ -27,6 +27,8 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
+#include "sprite_pack.h"
 #include "images.h"
 #include "curve_phase.h"
 #include "display.h"
@@ -46,6 +48,7 @@
 #include "meteors_phase.h"
 #include "lonely_foes.h"
 #include "options_panel.h"
+#include "pool.h"
 #include "satellite_protections.h"
 #include "shockwave.h"
 #include "spaceship.h"
@@ -57,12 +60,29 @@ image enemi[ENEMIES_MAX_SMALL_TYPES + ENEMIES_MAX_BLOODSUCKER_TYPES +
             LONELY_FOES_MAX_OF + ENEMIES_MAX_SPECIAL_TYPES][IMAGES_MAXOF];
 /* data structure of the enemies vessels */
 enemy *enemies = NULL;
-static enemy *enemy_first = NULL;
-static enemy *enemy_last = NULL;
+/** Free list and chained list of the enemies vessels */
+static pool_struct enemies_pool;
 /** Num of colors used in the fade-out effect */
 #define NUMOF_DEAD_COLORS 11
 /** Colors used in the fade-out effect (gradual disappearance of an enemy) */
 static unsigned char enemy_dead_colors[NUMOF_DEAD_COLORS + 1];
+/** Size of a cell of the enemies grid: 32 pixels */
+#define ENEMIES_CELL_SHIFT 5
+/** Number of columns of the enemies grid */
+static Sint32 enemies_cells_width = 0;
+/** Number of rows of the enemies grid */
+static Sint32 enemies_cells_height = 0;
+/** Index of the first enemy of each cell in 'enemies_cells_list', the
+ * enemies of the cell n are stored up to enemies_cells_start[n + 1] */
+static Uint32 *enemies_cells_start = NULL;
+/** Enemies sorted by cell, an enemy is stored in all the cells
+ * covered by its collision zones */
+static enemy **enemies_cells_list = NULL;
+/** Number of elements allocated for 'enemies_cells_list' */
+static Uint32 enemies_cells_list_size = 0;
+/** First column, first row, last column and last row covered by
+ * each enemy, indexed by enemy's id */
+static Sint32 enemies_cells_bounds[MAX_OF_ENEMIES][4];
 
 static bool enemies_load (void);
 static bool enemy_curve (enemy * foe);
@@ -88,13 +108,43 @@ enemies_once_init (void)
   /* allocate enemies data structure */
   if (enemies == NULL)
     {
-      enemies = (enemy *) memory_allocation (MAX_OF_ENEMIES * sizeof (enemy));
+      enemies =
+        (enemy *) arena_alloc (ARENA_PROCESS, MAX_OF_ENEMIES * sizeof (enemy));
       if (enemies == NULL)
         {
           LOG_ERR ("not enough memory to allocate 'enemies'");
           return FALSE;
         }
     }
+  if (!pool_init
+      (&enemies_pool, "enemy", (char *) enemies, sizeof (enemy),
+       MAX_OF_ENEMIES, offsetof (enemy, next), offsetof (enemy, previous)))
+    {
+      return FALSE;
+    }
+
+  /* allocate the grid of cells used to find the enemies close to a point */
+  enemies_cells_width =
+    (offscreen_width + (1 << ENEMIES_CELL_SHIFT) - 1) >> ENEMIES_CELL_SHIFT;
+  enemies_cells_height =
+    (offscreen_height + (1 << ENEMIES_CELL_SHIFT) - 1) >> ENEMIES_CELL_SHIFT;
+  enemies_cells_start =
+    (Uint32 *) arena_alloc (ARENA_PROCESS, (enemies_cells_width *
+                                            enemies_cells_height + 1) *
+                            sizeof (Uint32));
+  if (enemies_cells_start == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate 'enemies_cells_start'");
+      return FALSE;
+    }
+  enemies_cells_list_size = MAX_OF_ENEMIES * 4;
+  enemies_cells_list =
+    (enemy **) memory_allocation (enemies_cells_list_size * sizeof (enemy *));
+  if (enemies_cells_list == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate 'enemies_cells_list'");
+      return FALSE;
+    }
 
   /* colors if a ship's dead */
   enemy_dead_colors[0] = search_color (250, 250, 0);
@@ -128,43 +178,33 @@ enemies_once_init (void)
 static bool
 enemies_load (void)
 {
-  char *addr;
+  bool result;
   image *img;
-  char *filedata = load_file ("graphics/sprites/all_enemies.spr");
-  if (filedata == NULL)
+  sprites_file file;
+  if (!sprites_file_open
+      (&file, "graphics/sprites/all_enemies.spr", SPRITE_PACK_IMAGES))
     {
       return FALSE;
     }
-  addr = filedata;
   /* load 21 small enemies of 40 images each (grid phase) */
   img = &enemi[0][0];
-  addr =
-    images_read (img, ENEMIES_MAX_SMALL_TYPES, IMAGES_MAXOF, addr,
-                 IMAGES_MAXOF);
-  if (addr == NULL)
-    {
-      return FALSE;
-    }
+  result =
+    sprites_file_read_images (&file, img, ENEMIES_MAX_SMALL_TYPES,
+                              IMAGES_MAXOF, IMAGES_MAXOF);
   /* load 21 bloodsuckers of 8 images each (grid phase) */
   img = img + (ENEMIES_MAX_SMALL_TYPES * IMAGES_MAXOF);
-  addr =
-    images_read (img, ENEMIES_MAX_BLOODSUCKER_TYPES,
-                 BLOODSUCKER_NUM_OF_IMAGES, addr, IMAGES_MAXOF);
-  if (addr == NULL)
-    {
-      return FALSE;
-    }
+  result = result
+    && sprites_file_read_images (&file, img, ENEMIES_MAX_BLOODSUCKER_TYPES,
+                                 BLOODSUCKER_NUM_OF_IMAGES, IMAGES_MAXOF);
   /* load 40 lonely foes + 8 special objects of 32 images each */
   img = img + (ENEMIES_MAX_BLOODSUCKER_TYPES * IMAGES_MAXOF);
-  addr =
-    images_read (img, LONELY_FOES_MAX_OF + ENEMIES_MAX_SPECIAL_TYPES,
-                 ENEMIES_SPECIAL_NUM_OF_IMAGES, addr, IMAGES_MAXOF);
-  if (addr == NULL)
-    {
-      return FALSE;
-    }
-  free_memory (filedata);
-  return TRUE;
+  result = result
+    && sprites_file_read_images (&file, img,
+                                 LONELY_FOES_MAX_OF +
+                                 ENEMIES_MAX_SPECIAL_TYPES,
+                                 ENEMIES_SPECIAL_NUM_OF_IMAGES, IMAGES_MAXOF);
+  sprites_file_close (&file);
+  return result;
 }
 
 /**
@@ -274,11 +314,15 @@ enemies_free (void)
   images_free (img, LONELY_FOES_MAX_OF + ENEMIES_MAX_SPECIAL_TYPES,
                ENEMIES_SPECIAL_NUM_OF_IMAGES, IMAGES_MAXOF);
 
-  if (enemies != NULL)
+  pool_free (&enemies_pool);
+  enemies = NULL;
+  enemies_cells_start = NULL;
+  if (enemies_cells_list != NULL)
     {
-      free_memory ((char *) enemies);
-      enemies = NULL;
+      free_memory ((char *) enemies_cells_list);
+      enemies_cells_list = NULL;
     }
+  enemies_cells_list_size = 0;
 }
 
 /**
@@ -305,8 +349,7 @@ enemies_init (void)
       foe->change_dir = 0;
       foe->id = i;
     }
-  enemy_first = NULL;
-  enemy_last = NULL;
+  pool_reset (&enemies_pool);
   num_of_enemies = 0;
 }
 
@@ -1745,106 +1788,176 @@ enemy_dead_fadeout (enemy * foe)
   return FALSE;
 }
 
-/**
- * Check validty of enemies chained list
+/** 
+ * Return a free enemy element 
+ * @return Pointer to a enemy structure, NULL if not enemy available 
  */
-#ifdef UNDER_DEVELOPMENT
-static void
-enemy_check_chained_list (void)
+enemy *
+enemy_get (void)
 {
-  Uint32 i;
-  enemy *foe;
-  Sint32 count = 0;
-  for (i = 0; i < MAX_OF_ENEMIES; i++)
-    {
-      foe = &enemies[i];
-      if (foe->is_enabled)
-        {
-          count++;
-        }
-    }
-  if (count != num_of_enemies)
-    {
-      LOG_ERR ("Counting of the enabled elements failed!"
-               "count=%i, num_of_enemies=%i", count, num_of_enemies);
-    }
-  count = 0;
-  foe = enemy_first;
-  do
-    {
-      count++;
-      foe = foe->next;
-    }
-  while (foe != NULL && count <= (MAX_OF_ENEMIES + 1));
-  if (count != num_of_enemies)
-    {
-      LOG_ERR ("Counting of the next elements failed!"
-               "count=%i, num_of_enemies=%i", count, num_of_enemies);
-    }
-  count = 0;
-  foe = enemy_last;
-  do
-    {
-      count++;
-      foe = foe->previous;
-    }
-  while (foe != NULL && count <= (MAX_OF_ENEMIES + 1));
-  if (count != num_of_enemies)
+  enemy *foe = (enemy *) pool_get (&enemies_pool);
+  if (foe == NULL)
     {
-      LOG_ERR ("Counting of the previous elements failed!"
-               "count=%i, num_of_enemies=%i", count, num_of_enemies);
+      LOG_ERR ("no more element enemy is available");
+      return NULL;
     }
+  foe->is_enabled = TRUE;
+  num_of_enemies = enemies_pool.numof_enabled;
+  return foe;
 }
-#endif
 
 /** 
- * Return a free enemy element 
- * @return Pointer to a enemy structure, NULL if not enemy available 
+ * Return a first enemy element 
+ * @return Pointer to a enemy structure 
  */
 enemy *
-enemy_get (void)
+enemy_get_first (void)
 {
-  Uint32 i;
+  return (enemy *) enemies_pool.first;
+}
+
+/**
+ * Compute the cells of the grid covered by the collision zones
+ * of an enemy
+ * @param foe Pointer to a enemy structure
+ * @param bounds First column, first row, last column and last row
+ * @return Number of cells covered by the enemy
+ */
+static Uint32
+enemy_cells_bounds (enemy * foe, Sint32 * bounds)
+{
+  Sint32 x1, y1, x2, y2;
+  image *img = foe->spr.img[foe->spr.current_image];
+  x1 = img->zones_left;
+  y1 = img->zones_top;
+  x2 = img->zones_right;
+  y2 = img->zones_bottom;
+  /* same rounding as the collision tests */
+  x1 += (Sint32) foe->spr.xcoord;
+  x2 += (Sint32) foe->spr.xcoord;
+  y1 += (Sint32) foe->spr.ycoord;
+  y2 += (Sint32) foe->spr.ycoord;
+  if (x2 <= 0 || y2 <= 0 || x1 >= offscreen_width || y1 >= offscreen_height
+      || x1 >= x2 || y1 >= y2)
+    {
+      return 0;
+    }
+  bounds[0] = x1 < 0 ? 0 : x1 >> ENEMIES_CELL_SHIFT;
+  bounds[1] = y1 < 0 ? 0 : y1 >> ENEMIES_CELL_SHIFT;
+  bounds[2] = (x2 - 1) >> ENEMIES_CELL_SHIFT;
+  if (bounds[2] >= enemies_cells_width)
+    {
+      bounds[2] = enemies_cells_width - 1;
+    }
+  bounds[3] = (y2 - 1) >> ENEMIES_CELL_SHIFT;
+  if (bounds[3] >= enemies_cells_height)
+    {
+      bounds[3] = enemies_cells_height - 1;
+    }
+  return (Uint32) ((bounds[2] - bounds[0] + 1) * (bounds[3] - bounds[1] + 1));
+}
+
+/**
+ * Rebuild the grid of cells from the list of enemies, must be called
+ * once per frame before enemies_cells_get()
+ */
+void
+enemies_cells_update (void)
+{
+  Sint32 col, row;
+  Uint32 i, cell, total;
+  Uint32 numof_cells = enemies_cells_width * enemies_cells_height;
+  Sint32 *bounds;
   enemy *foe;
-  for (i = 0; i < MAX_OF_ENEMIES; i++)
+  for (i = 0; i <= numof_cells; i++)
     {
-      foe = &enemies[i];
-      if (foe->is_enabled)
+      enemies_cells_start[i] = 0;
+    }
+
+  /* count the enemies of each cell */
+  total = 0;
+  for (foe = enemy_get_first (); foe != NULL; foe = foe->next)
+    {
+      bounds = enemies_cells_bounds[foe->id];
+      if (enemy_cells_bounds (foe, bounds) == 0)
         {
+          /* empty range of cells */
+          bounds[0] = 1;
+          bounds[2] = 0;
           continue;
         }
-      foe->is_enabled = TRUE;
-      foe->next = NULL;
-      if (num_of_enemies == 0)
+      for (row = bounds[1]; row <= bounds[3]; row++)
         {
-          enemy_first = foe;
-          enemy_last = foe;
-          enemy_last->previous = NULL;
+          for (col = bounds[0]; col <= bounds[2]; col++)
+            {
+              enemies_cells_start[row * enemies_cells_width + col]++;
+              total++;
+            }
         }
-      else
+    }
+  if (total > enemies_cells_list_size)
+    {
+      free_memory ((char *) enemies_cells_list);
+      enemies_cells_list_size = total * 2;
+      enemies_cells_list =
+        (enemy **) memory_allocation (enemies_cells_list_size *
+                                      sizeof (enemy *));
+      if (enemies_cells_list == NULL)
         {
-          enemy_last->next = foe;
-          foe->previous = enemy_last;
-          enemy_last = foe;
+          LOG_ERR ("not enough memory to allocate 'enemies_cells_list'");
+          enemies_cells_list_size = 0;
+          for (i = 0; i <= numof_cells; i++)
+            {
+              enemies_cells_start[i] = 0;
+            }
+          return;
+        }
+    }
+
+  /* end index of each cell */
+  for (i = 1; i < numof_cells; i++)
+    {
+      enemies_cells_start[i] += enemies_cells_start[i - 1];
+    }
+  enemies_cells_start[numof_cells] = total;
+
+  /* fill the cells from the last enemy to keep the order of the list,
+   * each end index become the start index of its cell */
+  for (foe = (enemy *) enemies_pool.last; foe != NULL; foe = foe->previous)
+    {
+      bounds = enemies_cells_bounds[foe->id];
+      for (row = bounds[1]; row <= bounds[3]; row++)
+        {
+          for (col = bounds[0]; col <= bounds[2]; col++)
+            {
+              cell = row * enemies_cells_width + col;
+              enemies_cells_list[--enemies_cells_start[cell]] = foe;
+            }
         }
-      num_of_enemies++;
-#ifdef UNDER_DEVELOPMENT
-      enemy_check_chained_list ();
-#endif
-      return foe;
     }
-  LOG_ERR ("no more element enemy is available");
-  return NULL;
 }
 
-/** 
- * Return a first enemy element 
- * @return Pointer to a enemy structure 
+/**
+ * Return the enemies whose collision zones can contain a point
+ * @param xcoord X coordinate of the point in the offscreen
+ * @param ycoord Y coordinate of the point in the offscreen
+ * @param numof Returns the number of enemies
+ * @return Pointer to the first enemy of the cell
  */
-enemy *
-enemy_get_first (void)
+enemy **
+enemies_cells_get (Sint32 xcoord, Sint32 ycoord, Uint32 * numof)
 {
-  return enemy_first;
+  Uint32 cell;
+  if (xcoord < 0 || ycoord < 0 || xcoord >= offscreen_width
+      || ycoord >= offscreen_height)
+    {
+      *numof = 0;
+      return NULL;
+    }
+  cell = (ycoord >> ENEMIES_CELL_SHIFT) * enemies_cells_width +
+    (xcoord >> ENEMIES_CELL_SHIFT);
+  *numof = enemies_cells_start[cell + 1] - enemies_cells_start[cell];
+  return &enemies_cells_list[enemies_cells_start[cell]];
 }
 
 /** 
@@ -1855,23 +1968,8 @@ void
 enemy_delete (enemy * foe)
 {
   foe->is_enabled = FALSE;
-  num_of_enemies--;
-  if (enemy_first == foe)
-    {
-      enemy_first = foe->next;
-    }
-  if (enemy_last == foe)
-    {
-      enemy_last = foe->previous;
-    }
-  if (foe->previous != NULL)
-    {
-      foe->previous->next = foe->next;
-    }
-  if (foe->next != NULL)
-    {
-      foe->next->previous = foe->previous;
-    }
+  pool_release (&enemies_pool, (char *) foe);
+  num_of_enemies = enemies_pool.numof_enabled;
 }
 
 /**
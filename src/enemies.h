@@ -156,6 +156,8 @@ extern "C"
   void enemy_set_fadeout (enemy * foe);
   enemy *enemy_get (void);
   enemy *enemy_get_first (void);
+  void enemies_cells_update (void);
+  enemy **enemies_cells_get (Sint32 xcoord, Sint32 ycoord, Uint32 * numof);
   void enemy_draw (enemy * foe);
   void enemy_guns_collisions (enemy * foe);
   void enemy_satellites_collisions (enemy * foe);
@@ -42,6 +42,7 @@
 #include "images.h"
 #include "spaceship.h"
 
+/** TRUE if the energy gauges must be drawn again into the score panel */
 bool energy_gauge_spaceship_is_update = TRUE;
 bool energy_gauge_guard_is_update = TRUE;
 static image gauge_red;
@@ -143,6 +144,7 @@ energy_gauge_spaceship_update (void)
   draw_energy_gauge (GAUGE_SPACESHIP_WIDTH * pixel_size,
                      ship->spr.energy_level, 210 * pixel_size,
                      (ship->type * 20 + 20) * pixel_size);
+  energy_gauge_spaceship_is_update = FALSE;
 }
 
 /**
@@ -168,6 +170,7 @@ energy_gauge_guardian_update (void)
     {
       draw_energy_gauge (45, 0, 10, 45);
     }
+  energy_gauge_guard_is_update = FALSE;
 }
 
 /**
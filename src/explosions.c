@@ -27,6 +27,8 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
+#include "game_rand.h"
 #include "images.h"
 #include "display.h"
 #include "electrical_shock.h"
@@ -35,6 +37,7 @@
 #include "explosions.h"
 #include "shots.h"
 #include "gfx_wrapper.h"
+#include "pool.h"
 #include "sdl_mixer.h"
 #include "spaceship.h"
 #include "starfield.h"
@@ -73,8 +76,8 @@ typedef struct explosion_struct
 static image eclat[FRAGMENTS_NUMOF_TYPES][FRAGMENTS_NUMOF_IMAGES];
 static image explo[EXPLOSIONS_NUMOF_TYPES][EXPLOSIONS_NUMOF_IMAGES];
 static explosion_struct *explosions = NULL;
-static explosion_struct *explosion_first = NULL;
-static explosion_struct *explosion_last = NULL;
+/** Free list and chained list of the explosions */
+static pool_struct explosions_pool;
 static Sint32 num_of_explosions = 0;
 static explosion_struct *explosion_get (void);
 static void explosion_del (explosion_struct *);
@@ -109,8 +112,8 @@ explosions_once_init (void)
   if (explosions == NULL)
     {
       explosions =
-        (explosion_struct *) memory_allocation (MAX_OF_EXPLOSIONS *
-                                                sizeof (explosion_struct));
+        (explosion_struct *) arena_alloc (ARENA_PROCESS, MAX_OF_EXPLOSIONS *
+                                          sizeof (explosion_struct));
       if (explosions == NULL)
         {
           LOG_ERR ("not enough memory to allocate 'explosions'");
@@ -122,6 +125,15 @@ explosions_once_init (void)
       blast = &explosions[i];
       blast->is_enabled = FALSE;
     }
+  if (!pool_init
+      (&explosions_pool, "explosion", (char *) explosions,
+       sizeof (explosion_struct), MAX_OF_EXPLOSIONS,
+       offsetof (explosion_struct, next),
+       offsetof (explosion_struct, previous)))
+    {
+      return FALSE;
+    }
+  num_of_explosions = 0;
   return TRUE;
 }
 
@@ -202,11 +214,8 @@ explosions_free (void)
                EXPLOSIONS_NUMOF_IMAGES);
   images_free (&eclat[0][0], FRAGMENTS_NUMOF_TYPES, FRAGMENTS_NUMOF_IMAGES,
                FRAGMENTS_NUMOF_IMAGES);
-  if (explosions != NULL)
-    {
-      free_memory ((char *) explosions);
-      explosions = NULL;
-    }
+  pool_free (&explosions_pool);
+  explosions = NULL;
 }
 
 /** 
@@ -217,7 +226,7 @@ explosions_handle ()
 {
   Sint32 i;
   explosion_struct *blast;
-  blast = explosion_first;
+  blast = (explosion_struct *) explosions_pool.first;
   if (blast == NULL)
     {
       return;
@@ -337,8 +346,9 @@ explosion_add (float coordx, float coordy, float speed, Sint32 type,
       /* set x and y coordinates */
       blast->xcoord = coordx - 8;
       blast->ycoord = coordy - 8;
-#ifdef USE_SDLMIXER
-      sound_play (SOUND_MEDIUM_EXPLOSION_1 + (global_counter & 3));
+#ifdef USE_SOUND
+      sound_play_at (SOUND_MEDIUM_EXPLOSION_1 + (global_counter & 3),
+                     (Sint32) coordx);
 #endif
       break;
 
@@ -354,8 +364,9 @@ explosion_add (float coordx, float coordy, float speed, Sint32 type,
       /* set x and y coordinates */
       blast->xcoord = coordx - 16;
       blast->ycoord = coordy - 16;
-#ifdef USE_SDLMIXER
-      sound_play (SOUND_BIG_EXPLOSION_1 + (global_counter & 3));
+#ifdef USE_SOUND
+      sound_play_at (SOUND_BIG_EXPLOSION_1 + (global_counter & 3),
+                     (Sint32) coordx);
 #endif
       break;
 
@@ -371,8 +382,9 @@ explosion_add (float coordx, float coordy, float speed, Sint32 type,
       /* set x and y coordinates */
       blast->xcoord = coordx - 4;
       blast->ycoord = coordy - 4;
-#ifdef USE_SDLMIXER
-      sound_play (SOUND_SMALL_EXPLOSION_1 + (global_counter & 3));
+#ifdef USE_SOUND
+      sound_play_at (SOUND_SMALL_EXPLOSION_1 + (global_counter & 3),
+                     (Sint32) coordx);
 #endif
       break;
 
@@ -426,10 +438,11 @@ explosion_guardian_add (float coordx, float coordy)
   blast->img_angle = 8;
   /* delay before begin explosion animation */
   blast->countdown = 0;
-#ifdef USE_SDLMIXER
-  if (!(rand () % 8))
+#ifdef USE_SOUND
+  if (!(game_rand () % 8))
     {
-      sound_play (SOUND_SMALL_EXPLOSION_1 + (global_counter & 3));
+      sound_play_at (SOUND_SMALL_EXPLOSION_1 + (global_counter & 3),
+                     (Sint32) coordx);
     }
 #endif
 }
@@ -463,7 +476,7 @@ explosions_fragments_add (float coordx, float coordy, float speed,
       /* counter of delay between two images */
       blast->anim_count = 0;
       /* select a explosion fragment image at random */
-      num_eclat = rand () % FRAGMENTS_NUMOF_TYPES;
+      num_eclat = game_rand () % FRAGMENTS_NUMOF_TYPES;
       for (j = 0; j < FRAGMENTS_NUMOF_IMAGES; j++)
         {
           blast->img[j] = (image *) & eclat[num_eclat][j];
@@ -473,64 +486,12 @@ explosions_fragments_add (float coordx, float coordy, float speed,
       blast->ycoord = coordy;
       /* set speed of the displacement */
       blast->speed = speed;
-      blast->img_angle = (Sint16) (rand () % 32);
+      blast->img_angle = (Sint16) (game_rand () % 32);
       /* delay before begin explosion animation */
       blast->countdown = delay;
     }
 }
 
-/**
- * Check validty of explosions chained list
- */
-#ifdef UNDER_DEVELOPMENT
-static void
-explosion_check_chained_list (void)
-{
-  Uint32 i;
-  explosion_struct *blast;
-  Sint32 count = 0;
-  for (i = 0; i < MAX_OF_EXPLOSIONS; i++)
-    {
-      blast = &explosions[i];
-      if (blast->is_enabled)
-        {
-          count++;
-        }
-    }
-  if (count != num_of_explosions)
-    {
-      LOG_ERR ("Counting of the enabled elements failed!"
-               "count=%i, num_of_explosions=%i", count, num_of_explosions);
-    }
-  count = 0;
-  blast = explosion_first;
-  do
-    {
-      count++;
-      blast = blast->next;
-    }
-  while (blast != NULL && count <= (MAX_OF_EXPLOSIONS + 1));
-  if (count != num_of_explosions)
-    {
-      LOG_ERR ("Counting of the next elements failed!"
-               "count=%i, num_of_explosions=%i", count, num_of_explosions);
-    }
-  count = 0;
-  blast = explosion_last;
-  do
-    {
-      count++;
-      blast = blast->previous;
-    }
-  while (blast != NULL && count <= (MAX_OF_EXPLOSIONS + 1));
-  if (count != num_of_explosions)
-    {
-      LOG_ERR ("Counting of the previous elements failed!"
-               "count=%i, num_of_explosions=%i", count, num_of_explosions);
-    }
-}
-#endif
-
 /** 
  * Return a free explosion element 
  * @return Pointer to a explosion structure 
@@ -538,39 +499,18 @@ explosion_check_chained_list (void)
 static explosion_struct *
 explosion_get (void)
 {
-  Uint32 i;
-  explosion_struct *blast;
-  for (i = 0; i < MAX_OF_EXPLOSIONS; i++)
+  explosion_struct *blast =
+    (explosion_struct *) pool_get (&explosions_pool);
+  if (blast == NULL)
     {
-      blast = &explosions[i];
-      if (blast->is_enabled)
-        {
-          continue;
-        }
-      blast->is_enabled = TRUE;
-      blast->next = NULL;
-      if (num_of_explosions == 0)
-        {
-          explosion_first = blast;
-          explosion_last = blast;
-          explosion_last->previous = NULL;
-        }
-      else
-        {
-          explosion_last->next = blast;
-          blast->previous = explosion_last;
-          explosion_last = blast;
-        }
-      num_of_explosions++;
 #ifdef UNDER_DEVELOPMENT
-      explosion_check_chained_list ();
+      LOG_ERR ("no more element explosion is available");
 #endif
-      return blast;
+      return NULL;
     }
-#ifdef UNDER_DEVELOPMENT
-  LOG_ERR ("no more element explosion is available");
-#endif
-  return NULL;
+  blast->is_enabled = TRUE;
+  num_of_explosions = explosions_pool.numof_enabled;
+  return blast;
 }
 
 /** 
@@ -581,23 +521,8 @@ void
 explosion_del (explosion_struct * blast)
 {
   blast->is_enabled = FALSE;
-  num_of_explosions--;
-  if (explosion_first == blast)
-    {
-      explosion_first = blast->next;
-    }
-  if (explosion_last == blast)
-    {
-      explosion_last = blast->previous;
-    }
-  if (blast->previous != NULL)
-    {
-      blast->previous->next = blast->next;
-    }
-  if (blast->next != NULL)
-    {
-      blast->next->previous = blast->previous;
-    }
+  pool_release (&explosions_pool, (char *) blast);
+  num_of_explosions = explosions_pool.numof_enabled;
 }
 
 /**
@@ -684,112 +609,112 @@ explosions_add_serie (enemy * foe)
        */
     case -1:
       explosion_add ((float) coordx, (float) coordy, 0.3f, EXPLOSION_BIG, 0);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)), 0.3f,
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)), 0.3f,
                      EXPLOSION_MEDIUM, 20);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 30);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 40);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 50);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 30);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 40);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 50);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 60);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 70);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 80);
       break;
       /* enemy is lower than 32 width and height pixels */
     case 0:
       explosion_add ((float) coordx, (float) coordy, 0.3f, EXPLOSION_BIG, 0);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 10);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 20);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 30);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 40);
       break;
       /* enemy is higher than 32 width pixels */
     case 2:
-      explosion_add ((float) (coordx + (rand () % width_big)),
+      explosion_add ((float) (coordx + (game_rand () % width_big)),
                      (float) coordy, 0.3f, EXPLOSION_BIG, 0);
-      explosion_add ((float) coordx + (rand () % width_big),
+      explosion_add ((float) coordx + (game_rand () % width_big),
                      (float) coordy, 0.3f, EXPLOSION_BIG, 10);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 20);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 30);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 40);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 50);
       break;
       /* enemy is higher than 32 height pixels */
     case 4:
       explosion_add ((float) coordx,
-                     (float) (coordy + (rand () % height_big)),
+                     (float) (coordy + (game_rand () % height_big)),
                      0.3f, EXPLOSION_BIG, 0);
       explosion_add ((float) coordx,
-                     (float) coordy + (rand () % height_big),
+                     (float) coordy + (game_rand () % height_big),
                      0.3f, EXPLOSION_BIG, 10);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 20);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 30);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 40);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 50);
       break;
       /* enemy is higher than 32 width and height pixels */
     case 6:
-      explosion_add ((float) (coordx + (rand () % width_big)),
-                     (float) (coordy + (rand () % height_big)),
+      explosion_add ((float) (coordx + (game_rand () % width_big)),
+                     (float) (coordy + (game_rand () % height_big)),
                      0.3f, EXPLOSION_BIG, 0);
-      explosion_add ((float) (coordx + (rand () % width_big)),
-                     (float) (coordy + (rand () % height_big)),
+      explosion_add ((float) (coordx + (game_rand () % width_big)),
+                     (float) (coordy + (game_rand () % height_big)),
                      0.3f, EXPLOSION_BIG, 10);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 20);
-      explosion_add ((float) (coordx + (rand () % width_normal)),
-                     (float) (coordy + (rand () % height_normal)),
+      explosion_add ((float) (coordx + (game_rand () % width_normal)),
+                     (float) (coordy + (game_rand () % height_normal)),
                      0.3f, EXPLOSION_MEDIUM, 30);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 40);
-      explosion_add ((float) (coordx + (rand () % width_small)),
-                     (float) (coordy + (rand () % height_small)),
+      explosion_add ((float) (coordx + (game_rand () % width_small)),
+                     (float) (coordy + (game_rand () % height_small)),
                      0.3f, EXPLOSION_SMALL, 50);
       break;
     }
@@ -222,7 +222,7 @@ guns_init (void)
 void
 guns_handle (void)
 {
-  Sint32 i, k, l;
+  Sint32 i, k;
   gun_struct *egun;
   shot_struct *bullet;
   image *egun_img;
@@ -285,61 +285,56 @@ guns_handle (void)
                       /* animated sprite (flicker shot) */
                       bullet->is_blinking = TRUE;
                       /* indicate that is friend sprite */
-                      bullet->spr.type = FRIEND;
+                      bullet->type = FRIEND;
                       /* fixed trajectory */
-                      bullet->spr.trajectory = 0;
+                      bullet->trajectory = 0;
                       /* set number of images of the sprite */
-                      bullet->spr.numof_images = 32;
+                      bullet->numof_images = 32;
 
                       /* initialize power of the shot */
                       switch (ship->type)
                         {
                         case SPACESHIP_TYPE_1:
-                          bullet->spr.pow_of_dest = 2;
+                          bullet->pow_of_dest = 2;
                           break;
                         case SPACESHIP_TYPE_2:
-                          bullet->spr.pow_of_dest = 3;
+                          bullet->pow_of_dest = 3;
                           break;
                         case SPACESHIP_TYPE_3:
-                          bullet->spr.pow_of_dest = 4;
+                          bullet->pow_of_dest = 4;
                           break;
                         case SPACESHIP_TYPE_4:
-                          bullet->spr.pow_of_dest = 3;
+                          bullet->pow_of_dest = 3;
                           break;
                         case SPACESHIP_TYPE_5:
-                          bullet->spr.pow_of_dest = 4;
+                          bullet->pow_of_dest = 4;
                           break;
                         }
                       /* set addresses of the sprites images buffer */
-                      for (l = 0; l < bullet->spr.numof_images; l++)
-                        {
-                          /* shot 2 force 1 */
-                          bullet->spr.img[l] = (image *) & fire[V1TN1][l];
-                        }
-                      /* set energy level of the sprite */
-                      bullet->spr.energy_level = bullet->spr.pow_of_dest;
+                      /* shot 2 force 1 */
+                      bullet->img = &fire[V1TN1][0];
                       /* set current image index */
-                      bullet->spr.current_image = 0;
+                      bullet->current_image = 0;
                       /* set value of delay between two images */
-                      bullet->spr.anim_speed = 4;
+                      bullet->anim_speed = 4;
                       /* set delay counter between two images */
-                      bullet->spr.anim_count = 0;
+                      bullet->anim_count = 0;
                       bullet->img_angle = egun_img->cannons_angles[k];
                       bullet->img_old_angle = bullet->img_angle;
                       /* set x and y coordinates */
-                      bullet->spr.xcoord =
+                      shots_xcoord[bullet->index] =
                         (float) (egun->xcoord +
                                  egun_img->cannons_coords[k][XCOORD] -
-                                 bullet->spr.img[bullet->img_angle]->x_gc);
-                      bullet->spr.ycoord =
+                                 bullet->img[bullet->img_angle].x_gc);
+                      shots_ycoord[bullet->index] =
                         (float) (egun->ycoord +
                                  egun_img->cannons_coords[k][YCOORD] -
-                                 bullet->spr.img[bullet->img_angle]->y_gc);
+                                 bullet->img[bullet->img_angle].y_gc);
                       bullet->timelife = 400;
                       /* set angle of the projectile */
                       bullet->angle = PI_BY_16 * bullet->img_angle;
                       /* set speed of the displacement */
-                      bullet->spr.speed = 9.0;
+                      shot_linear_speed_set (bullet, 9.0f);
                     }
                 }
             }
@@ -780,7 +775,7 @@ guns_shot_collisions (Sint32 x1, Sint32 y1, shot_struct * bullet)
             {
               /* decrease energy level of gun */
               egun->energy_level =
-                (Sint16) (egun->energy_level - bullet->spr.pow_of_dest);
+                (Sint16) (egun->energy_level - bullet->pow_of_dest);
               /* check if gun is destroyed */
               if (egun->energy_level <= 0)
                 {
@@ -791,7 +786,8 @@ guns_shot_collisions (Sint32 x1, Sint32 y1, shot_struct * bullet)
                   /* gun not destroyed, display white mask */
                   egun->is_white_mask_displayed = TRUE;
                 }
-              explosion_add (bullet->spr.xcoord, bullet->spr.ycoord, 0.35f,
+              explosion_add (shots_xcoord[bullet->index],
+                             shots_ycoord[bullet->index], 0.35f,
                              EXPLOSION_SMALL, 0);
               return TRUE;
             }
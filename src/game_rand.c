@@ -0,0 +1,69 @@
+/**
+ * @file game_rand.c
+ * @brief Pseudo-random number generator of the game
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "game_rand.h"
+
+/** State of the xorshift64* generator, never 0 */
+static Uint64 game_rand_state = 0x9e3779b97f4a7c15ULL;
+
+/**
+ * Restart the sequence of pseudo-random numbers, the same seed
+ * always gives the same sequence on every platform
+ * @param seed Any value
+ */
+void
+game_rand_seed (Uint32 seed)
+{
+  /* spread the seed over the 64 bits, the state must not be 0 */
+  game_rand_state = ((Uint64) seed + 1) * 0x9e3779b97f4a7c15ULL;
+  if (game_rand_state == 0)
+    {
+      game_rand_state = 0x9e3779b97f4a7c15ULL;
+    }
+}
+
+/**
+ * Return the next 32-bit pseudo-random number
+ * @return A value between 0 and 0xffffffff
+ */
+Uint32
+game_rand_next (void)
+{
+  game_rand_state ^= game_rand_state >> 12;
+  game_rand_state ^= game_rand_state << 25;
+  game_rand_state ^= game_rand_state >> 27;
+  return (Uint32) ((game_rand_state * 0x2545f4914f6cdd1dULL) >> 32);
+}
+
+/**
+ * Return the next pseudo-random number, replaces libc rand()
+ * @return A value between 0 and GAME_RAND_MAX
+ */
+Sint32
+game_rand (void)
+{
+  return (Sint32) (game_rand_next () >> 1);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file game_rand.h
+ * @brief Pseudo-random number generator of the game
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __GAME_RAND__
+#define __GAME_RAND__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Largest value returned by game_rand() */
+#define GAME_RAND_MAX 0x7fffffff
+/** Seed used when none is given, the game always started with
+ * srand (1) */
+#define GAME_RAND_DEFAULT_SEED 1
+
+  void game_rand_seed (Uint32 seed);
+  Uint32 game_rand_next (void);
+  Sint32 game_rand (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -31,6 +31,7 @@
 #include "assembler.h"
 #include "images.h"
 #include "display.h"
+#include "dirty_rects.h"
 #include "electrical_shock.h"
 #include "enemies.h"
 #include "explosions.h"
@@ -88,6 +89,10 @@ draw_sprite_mask (Uint32 color, image * img, Uint32 xcoord, Uint32 ycoord)
 {
   Uint32 size;
   char *dest, *repeats;
+  if (!offscreen_draw_enable)
+    {
+      return;
+    }
   dest =
     game_offscreen + (ycoord * offscreen_width + xcoord) * bytes_per_pixel;
   repeats = img->compress;
@@ -120,6 +125,10 @@ draw_sprite (image * img, Uint32 xcoord, Uint32 ycoord)
 {
   Uint32 size;
   char *source, *dest, *repeats;
+  if (!offscreen_draw_enable)
+    {
+      return;
+    }
   source = img->img;
   dest =
     game_offscreen + (ycoord * offscreen_pitch + xcoord * bytes_per_pixel);
@@ -153,6 +162,10 @@ draw_bitmap (bitmap * bmp, Uint32 xcoord, Uint32 ycoord)
 {
   Uint32 size;
   char *source, *dest, *repeats;
+  if (!offscreen_draw_enable)
+    {
+      return;
+    }
   source = bmp->img;
   dest =
     game_offscreen + (ycoord * offscreen_width + xcoord) * bytes_per_pixel;
@@ -180,9 +193,12 @@ draw_bitmap (bitmap * bmp, Uint32 xcoord, Uint32 ycoord)
  * @param bmp Pointer to a 'bitmap' structure
  * @param xcoord X-coordinate in the score panel offscreen
  * @param ycoord Y-coordinate in the score panel offscreen
+ * @param width Width of the bitmap, the area to refresh on the screen
+ * @param height Height of the bitmap, the area to refresh on the screen
  */
 void
-draw_bitmap_in_score (bitmap * bmp, Uint32 xcoord, Uint32 ycoord)
+draw_bitmap_in_score (bitmap * bmp, Uint32 xcoord, Uint32 ycoord,
+                      Uint32 width, Uint32 height)
 {
   Uint32 size;
   char *source, *dest, *repeats;
@@ -207,6 +223,8 @@ draw_bitmap_in_score (bitmap * bmp, Uint32 xcoord, Uint32 ycoord)
       put_sprite_32 (source, dest, repeats, size);
       break;
     }
+  dirty_rects_add (DIRTY_SCORE_PANEL, (Sint32) xcoord, (Sint32) ycoord,
+                   (Sint32) width, (Sint32) height);
 }
 
 /** 
@@ -214,9 +232,12 @@ draw_bitmap_in_score (bitmap * bmp, Uint32 xcoord, Uint32 ycoord)
  * @param bmp Pointer to a 'bitmap' structure
  * @param xcoord X-coordinate in the option panel offscreen
  * @param ycoord Y-coordinate in the option panel offscreen
+ * @param width Width of the bitmap, the area to refresh on the screen
+ * @param height Height of the bitmap, the area to refresh on the screen
  */
 void
-draw_bitmap_in_options (bitmap * bmp, Uint32 xcoord, Uint32 ycoord)
+draw_bitmap_in_options (bitmap * bmp, Uint32 xcoord, Uint32 ycoord,
+                        Uint32 width, Uint32 height)
 {
   Uint32 size;
   char *source, *dest, *repeats;
@@ -240,6 +261,8 @@ draw_bitmap_in_options (bitmap * bmp, Uint32 xcoord, Uint32 ycoord)
       put_sprite_32 (source, dest, repeats, size);
       break;
     }
+  dirty_rects_add (DIRTY_OPTIONS_PANEL, (Sint32) xcoord, (Sint32) ycoord,
+                   (Sint32) width, (Sint32) height);
 }
 
 /** 
@@ -274,6 +297,8 @@ draw_image_in_score (image * img, Uint32 xcoord, Uint32 ycoord)
       put_sprite_32 (source, dest, repeats, size);
       break;
     }
+  dirty_rects_add (DIRTY_SCORE_PANEL, (Sint32) xcoord, (Sint32) ycoord,
+                   img->w, img->h);
 }
 
 /**
@@ -327,6 +352,12 @@ draw_image_in_score_repeat (image * img, Uint32 xcoord, Uint32 ycoord,
         }
       break;
     }
+  if (repeat_count > 0)
+    {
+      dirty_rects_add (DIRTY_SCORE_PANEL, (Sint32) xcoord, (Sint32) ycoord,
+                       (Sint32) ((repeat_count - 1) * pixel_size) + img->w,
+                       img->h);
+    }
 }
 
 /**
@@ -338,6 +369,10 @@ draw_image_in_score_repeat (image * img, Uint32 xcoord, Uint32 ycoord,
 void
 draw_electrical_shock (char *oscreen, Eclair * shock, Sint32 numof_iterations)
 {
+  if (oscreen == game_offscreen && !offscreen_draw_enable)
+    {
+      return;
+    }
   switch (bytes_per_pixel)
     {
     case 1:
@@ -372,6 +407,10 @@ void
 draw_empty_rectangle (char *oscreen, Sint32 xcoord, Sint32 ycoord,
                       Sint32 color, Sint32 width, Sint32 height)
 {
+  if (oscreen == game_offscreen && !offscreen_draw_enable)
+    {
+      return;
+    }
   switch (bytes_per_pixel)
     {
     case 1:
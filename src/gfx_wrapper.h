@@ -45,11 +45,13 @@ extern "C"
   void draw_empty_rectangle (char *oscreen, Sint32 xcoord, Sint32 ycoord,
                              Sint32 color, Sint32 width, Sint32 height);
   void draw_bitmap_char (unsigned char *dst, unsigned char *src);
-  void draw_bitmap_in_options (bitmap * bmp, Uint32 xcoord, Uint32 ycoord);
+  void draw_bitmap_in_options (bitmap * bmp, Uint32 xcoord, Uint32 ycoord,
+                               Uint32 width, Uint32 height);
   void draw_image_in_score (image * img, Uint32 xcoord, Uint32 ycoord);
   void draw_image_in_score_repeat (image * img, Uint32 xcoord, Uint32 ycoord,
                                    Uint32 width);
-  void draw_bitmap_in_score (bitmap * bmp, Uint32 xcoord, Uint32 ycoord);
+  void draw_bitmap_in_score (bitmap * bmp, Uint32 xcoord, Uint32 ycoord,
+                             Uint32 width, Uint32 height);
   void copy2X_512x440 (char *src, char *dest, Uint32);
   void copy2X (char *src, char *dest, Uint32 width, Uint32 height,
                Uint32 _iOffset, Uint32 _iOffset2);
@@ -26,24 +26,150 @@
  */
 #include "config.h"
 #include "powermanga.h"
+#include "tools.h"
 #include "electrical_shock.h"
 #include "log_recorder.h"
 #include "images.h"
 #include "display.h"
+#include "gfxroutines.h"
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPRITE_COPY_HAVE_SSE2
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SPRITE_COPY_HAVE_AVX2
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SPRITE_COPY_HAVE_NEON
+#endif
+
+/** Function which draws a compressed sprite */
+typedef void (*put_sprite_func) (char *, char *, char *, Uint32);
+static void put_sprite_16_memcpy (char *src, char *dest, char *repeats_table,
+                                  Uint32 size);
+static void put_sprite_32_memcpy (char *src, char *dest, char *repeats_table,
+                                  Uint32 size);
+/** Routines used by put_sprite_16() and put_sprite_32() */
+static put_sprite_func put_sprite_16_run = put_sprite_16_memcpy;
+static put_sprite_func put_sprite_32_run = put_sprite_32_memcpy;
+/** Copier of the runs currently used */
+static Sint32 sprite_copy_current = SPRITE_COPY_MEMCPY;
+#ifdef SPRITE_COPY_HAVE_AVX2
+/** TRUE if conv8_16() and conv8_32() expand the indexes with the
+ * AVX2 gather */
+static bool conv8_32_gather = FALSE;
+#endif
 
 void
 _type_routine_gfx (Sint32 * addr)
 {
+  Sint32 kernel;
   *addr = 20;
+  /* select the fastest copier of the runs of the sprites */
+  for (kernel = SPRITE_COPY_NUMOF - 1; kernel > SPRITE_COPY_MEMCPY; kernel--)
+    {
+      if (sprite_copy_set (kernel))
+        {
+          break;
+        }
+    }
+  if (kernel == SPRITE_COPY_MEMCPY)
+    {
+      sprite_copy_set (kernel);
+    }
+  LOG_INF ("sprite runs copied by '%s'", sprite_copy_name (kernel));
+#ifdef SPRITE_COPY_HAVE_AVX2
+  conv8_32_gather = __builtin_cpu_supports ("avx2") ? TRUE : FALSE;
+#endif
 }
 
 /* To test these functions: the intro animation */
 
+#ifdef SPRITE_COPY_HAVE_AVX2
+/**
+ * Expand 16 indexes at a time with the AVX2 gather instruction. The
+ * gather reads 32-bit values, it uses a copy of the palette widened
+ * to 32 bits, which is worth it only for large sizes
+ * @return Number of indexes expanded
+ */
+__attribute__ ((target ("avx2")))
+static Uint32
+conv8_16_avx2 (const unsigned char *s, Uint16 * d, const Uint16 * cpal16,
+               Uint32 size)
+{
+  Uint32 i;
+  Uint32 cpal32[256];
+  __m256i low, high;
+  for (i = 0; i < 256; i++)
+    {
+      cpal32[i] = cpal16[i];
+    }
+  for (i = 0; i + 16 <= size; i += 16)
+    {
+      low =
+        _mm256_i32gather_epi32 ((const int *) cpal32,
+                                _mm256_cvtepu8_epi32 (_mm_loadl_epi64
+                                                      ((const __m128i *) (s +
+                                                                          i))),
+                                4);
+      high =
+        _mm256_i32gather_epi32 ((const int *) cpal32,
+                                _mm256_cvtepu8_epi32 (_mm_loadl_epi64
+                                                      ((const __m128i *) (s +
+                                                                          i +
+                                                                          8))),
+                                4);
+      /* the pack interleaves the 128-bit lanes of both vectors */
+      _mm256_storeu_si256 ((__m256i *) (d + i),
+                           _mm256_permute4x64_epi64 (_mm256_packus_epi32
+                                                     (low, high), 0xd8));
+    }
+  return i;
+}
+#endif
+
+/**
+ * Expand 8-bit indexes to 16-bit pixels, used by the movies and by the
+ * palettized mode at each frame
+ * @param src 8-bit indexes
+ * @param dest 16-bit pixels
+ * @param cpal16 16-bit palette of 256 colors
+ * @param size Number of pixels
+ */
 void
 conv8_16 (char *src, char *dest, Uint16 * cpal16, Uint32 size)
 {
   Uint16 *d = (Uint16 *) dest;
   unsigned char *s = (unsigned char *) src;
+  Uint32 done;
+#ifdef SPRITE_COPY_HAVE_AVX2
+  /* a whole frame of the movies, not a line of the palettized mode */
+  if (conv8_32_gather && size >= 4096)
+    {
+      done = conv8_16_avx2 (s, d, cpal16, size);
+      s += done;
+      d += done;
+      size -= done;
+    }
+#endif
+  /* 8 indexes per iteration, in the order of the memory whatever
+   * the byte order */
+  while (size >= 8)
+    {
+      d[0] = cpal16[s[0]];
+      d[1] = cpal16[s[1]];
+      d[2] = cpal16[s[2]];
+      d[3] = cpal16[s[3]];
+      d[4] = cpal16[s[4]];
+      d[5] = cpal16[s[5]];
+      d[6] = cpal16[s[6]];
+      d[7] = cpal16[s[7]];
+      s += 8;
+      d += 8;
+      size -= 8;
+    }
   while (size--)
     {
       *d++ = cpal16[*s++];
@@ -66,11 +192,69 @@ conv8_24 (char *src, char *dest, Uint32 * cpal24, Uint32 size)
     }
 }
 
+#ifdef SPRITE_COPY_HAVE_AVX2
+/**
+ * Expand 8 indexes at a time with the AVX2 gather instruction
+ * @return Number of indexes expanded
+ */
+__attribute__ ((target ("avx2")))
+static Uint32
+conv8_32_avx2 (const unsigned char *s, Uint32 * d, const Uint32 * cpal32,
+               Uint32 size)
+{
+  Uint32 i;
+  __m256i indexes;
+  for (i = 0; i + 8 <= size; i += 8)
+    {
+      indexes =
+        _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((const __m128i *) (s + i)));
+      _mm256_storeu_si256 ((__m256i *) (d + i),
+                           _mm256_i32gather_epi32 ((const int *) cpal32,
+                                                   indexes, 4));
+    }
+  return i;
+}
+#endif
+
+/**
+ * Expand 8-bit indexes to 32-bit pixels, used by the movies, by the
+ * loading of the sprites and by the palettized mode at each frame
+ * @param src 8-bit indexes
+ * @param dest 32-bit pixels
+ * @param cpal32 32-bit palette of 256 colors
+ * @param size Number of pixels
+ */
 void
 conv8_32 (char *src, char *dest, Uint32 * cpal32, Uint32 size)
 {
   Uint32 *d = (Uint32 *) dest;
   unsigned char *s = (unsigned char *) src;
+  Uint32 done;
+#ifdef SPRITE_COPY_HAVE_AVX2
+  if (conv8_32_gather)
+    {
+      done = conv8_32_avx2 (s, d, cpal32, size);
+      s += done;
+      d += done;
+      size -= done;
+    }
+#endif
+  /* 8 indexes per iteration, in the order of the memory whatever
+   * the byte order */
+  while (size >= 8)
+    {
+      d[0] = cpal32[s[0]];
+      d[1] = cpal32[s[1]];
+      d[2] = cpal32[s[2]];
+      d[3] = cpal32[s[3]];
+      d[4] = cpal32[s[4]];
+      d[5] = cpal32[s[5]];
+      d[6] = cpal32[s[6]];
+      d[7] = cpal32[s[7]];
+      s += 8;
+      d += 8;
+      size -= 8;
+    }
   while (size--)
     {
       *d++ = cpal32[*s++];
@@ -371,8 +555,8 @@ put_sprite_8 (char *src, char *dest, char *repeats_table, Uint32 size)
   while (size > 0);
 }
 
-void
-put_sprite_16 (char *src, char *dest, char *repeats_table, Uint32 size)
+static void
+put_sprite_16_memcpy (char *src, char *dest, char *repeats_table, Uint32 size)
 {
   Uint16 z;
   Uint32 *s2, *p2;
@@ -440,8 +624,8 @@ put_sprite_24 (char *src, char *dest, char *repeats_table, Uint32 size)
 /**
  *
  */
-void
-put_sprite_32 (char *src, char *dest, char *repeats_table, Uint32 size)
+static void
+put_sprite_32_memcpy (char *src, char *dest, char *repeats_table, Uint32 size)
 {
   register Uint16 z;
   Uint32 *s = (Uint32 *) src;
@@ -467,6 +651,264 @@ put_sprite_32 (char *src, char *dest, char *repeats_table, Uint32 size)
 }
 
 
+/*
+ * The runs of pixels of the sprites are often only a few pixels wide,
+ * so the copiers below avoid the call to memcpy() and copy a run with
+ * a few overlapping unaligned loads and stores
+ */
+
+/**
+ * Copy a run of less than 16 bytes, the size is a multiple of 2
+ */
+static inline void
+sprite_copy_small (char *dest, const char *src, Uint32 size)
+{
+  Uint64 q0, q1;
+  Uint32 d0, d1;
+  Uint16 w;
+  if (size >= 8)
+    {
+      memcpy (&q0, src, 8);
+      memcpy (&q1, src + size - 8, 8);
+      memcpy (dest, &q0, 8);
+      memcpy (dest + size - 8, &q1, 8);
+    }
+  else if (size >= 4)
+    {
+      memcpy (&d0, src, 4);
+      memcpy (&d1, src + size - 4, 4);
+      memcpy (dest, &d0, 4);
+      memcpy (dest + size - 4, &d1, 4);
+    }
+  else if (size >= 2)
+    {
+      memcpy (&w, src, 2);
+      memcpy (dest, &w, 2);
+    }
+}
+
+/**
+ * Generate the routines which draw a sprite in 16-bit and 32-bit
+ * depth with a copier of runs
+ * @param NAME Suffix of the routines
+ * @param COPY Copier called with the destination, the source and
+ *             the size of the run in bytes
+ * @param ATTR Attributes of the routines
+ */
+#define PUT_SPRITE_RUNS(NAME, COPY, ATTR) \
+ATTR static void \
+put_sprite_16_##NAME (char *src, char *dest, char *repeats_table, \
+                      Uint32 size) \
+{ \
+  Uint32 n; \
+  _compress *t = (_compress *) repeats_table; \
+  while (size--) \
+    { \
+      dest += t->offset; \
+      n = ((Uint32) t->r1 << 2) + ((Uint32) t->r2 << 1); \
+      COPY (dest, src, n); \
+      dest += n; \
+      src += n; \
+      t++; \
+    } \
+} \
+ATTR static void \
+put_sprite_32_##NAME (char *src, char *dest, char *repeats_table, \
+                      Uint32 size) \
+{ \
+  Uint32 n; \
+  _compress *t = (_compress *) repeats_table; \
+  while (size--) \
+    { \
+      dest += t->offset; \
+      n = ((Uint32) t->r1 + t->r2) << 2; \
+      COPY (dest, src, n); \
+      dest += n; \
+      src += n; \
+      t++; \
+    } \
+}
+
+#ifdef SPRITE_COPY_HAVE_SSE2
+/**
+ * Copy a run with SSE2 16-byte loads and stores
+ */
+static inline void
+sprite_copy_sse2 (char *dest, const char *src, Uint32 size)
+{
+  Uint32 i;
+  if (size < 16)
+    {
+      sprite_copy_small (dest, src, size);
+      return;
+    }
+  for (i = 0; i + 16 < size; i += 16)
+    {
+      _mm_storeu_si128 ((__m128i *) (dest + i),
+                        _mm_loadu_si128 ((const __m128i *) (src + i)));
+    }
+  _mm_storeu_si128 ((__m128i *) (dest + size - 16),
+                    _mm_loadu_si128 ((const __m128i *) (src + size - 16)));
+}
+
+PUT_SPRITE_RUNS (sse2, sprite_copy_sse2,)
+#endif
+#ifdef SPRITE_COPY_HAVE_AVX2
+/**
+ * Copy a run with AVX2 32-byte loads and stores
+ */
+__attribute__ ((target ("avx2")))
+static inline void
+sprite_copy_avx2 (char *dest, const char *src, Uint32 size)
+{
+  Uint32 i;
+  if (size < 16)
+    {
+      sprite_copy_small (dest, src, size);
+      return;
+    }
+  if (size <= 32)
+    {
+      _mm_storeu_si128 ((__m128i *) dest,
+                        _mm_loadu_si128 ((const __m128i *) src));
+      _mm_storeu_si128 ((__m128i *) (dest + size - 16),
+                        _mm_loadu_si128 ((const __m128i *) (src + size -
+                                                            16)));
+      return;
+    }
+  for (i = 0; i + 32 < size; i += 32)
+    {
+      _mm256_storeu_si256 ((__m256i *) (dest + i),
+                           _mm256_loadu_si256 ((const __m256i *) (src + i)));
+    }
+  _mm256_storeu_si256 ((__m256i *) (dest + size - 32),
+                       _mm256_loadu_si256 ((const __m256i *) (src + size -
+                                                              32)));
+}
+
+PUT_SPRITE_RUNS (avx2, sprite_copy_avx2, __attribute__ ((target ("avx2"))))
+#endif
+#ifdef SPRITE_COPY_HAVE_NEON
+/**
+ * Copy a run with NEON 16-byte loads and stores
+ */
+static inline void
+sprite_copy_neon (char *dest, const char *src, Uint32 size)
+{
+  Uint32 i;
+  if (size < 16)
+    {
+      sprite_copy_small (dest, src, size);
+      return;
+    }
+  for (i = 0; i + 16 < size; i += 16)
+    {
+      vst1q_u8 ((uint8_t *) (dest + i),
+                vld1q_u8 ((const uint8_t *) (src + i)));
+    }
+  vst1q_u8 ((uint8_t *) (dest + size - 16),
+            vld1q_u8 ((const uint8_t *) (src + size - 16)));
+}
+
+PUT_SPRITE_RUNS (neon, sprite_copy_neon,)
+#endif
+
+/**
+ * Select the copier of the runs used to draw the sprites
+ * @param kernel SPRITE_COPY_MEMCPY, SPRITE_COPY_SSE2, SPRITE_COPY_AVX2
+ *               or SPRITE_COPY_NEON
+ * @return TRUE if the copier is supported by the processor
+ */
+bool
+sprite_copy_set (Sint32 kernel)
+{
+  put_sprite_func run16 = NULL, run32 = NULL;
+  switch (kernel)
+    {
+    case SPRITE_COPY_MEMCPY:
+      run16 = put_sprite_16_memcpy;
+      run32 = put_sprite_32_memcpy;
+      break;
+#ifdef SPRITE_COPY_HAVE_SSE2
+    case SPRITE_COPY_SSE2:
+      run16 = put_sprite_16_sse2;
+      run32 = put_sprite_32_sse2;
+      break;
+#endif
+#ifdef SPRITE_COPY_HAVE_AVX2
+    case SPRITE_COPY_AVX2:
+      if (__builtin_cpu_supports ("avx2"))
+        {
+          run16 = put_sprite_16_avx2;
+          run32 = put_sprite_32_avx2;
+        }
+      break;
+#endif
+#ifdef SPRITE_COPY_HAVE_NEON
+    case SPRITE_COPY_NEON:
+      run16 = put_sprite_16_neon;
+      run32 = put_sprite_32_neon;
+      break;
+#endif
+    }
+  if (run16 == NULL)
+    {
+      return FALSE;
+    }
+  put_sprite_16_run = run16;
+  put_sprite_32_run = run32;
+  sprite_copy_current = kernel;
+  return TRUE;
+}
+
+/**
+ * Return the copier of the runs currently used
+ * @return SPRITE_COPY_MEMCPY, SPRITE_COPY_SSE2, SPRITE_COPY_AVX2
+ *         or SPRITE_COPY_NEON
+ */
+Sint32
+sprite_copy_get (void)
+{
+  return sprite_copy_current;
+}
+
+/**
+ * Return the name of a copier of the runs
+ * @param kernel SPRITE_COPY_MEMCPY, SPRITE_COPY_SSE2, SPRITE_COPY_AVX2
+ *               or SPRITE_COPY_NEON
+ * @return Name of the copier
+ */
+const char *
+sprite_copy_name (Sint32 kernel)
+{
+  static const char *names[SPRITE_COPY_NUMOF] = {
+    "memcpy", "sse2", "avx2", "neon"
+  };
+  if (kernel < 0 || kernel >= SPRITE_COPY_NUMOF)
+    {
+      return "?";
+    }
+  return names[kernel];
+}
+
+/**
+ * Draw a sprite in a 16-bit offscreen with the selected copier
+ */
+void
+put_sprite_16 (char *src, char *dest, char *repeats_table, Uint32 size)
+{
+  put_sprite_16_run (src, dest, repeats_table, size);
+}
+
+/**
+ * Draw a sprite in a 32-bit offscreen with the selected copier
+ */
+void
+put_sprite_32 (char *src, char *dest, char *repeats_table, Uint32 size)
+{
+  put_sprite_32_run (src, dest, repeats_table, size);
+}
+
 /* To test these functions: when an enemy gets killed */
 
 #define PUTCOLOR(TYPE) \
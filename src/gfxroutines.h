@@ -32,7 +32,20 @@ extern "C"
 #endif
 
 
+  /** Copiers of the runs of pixels used to draw the sprites */
+  typedef enum
+  {
+    SPRITE_COPY_MEMCPY,
+    SPRITE_COPY_SSE2,
+    SPRITE_COPY_AVX2,
+    SPRITE_COPY_NEON,
+    SPRITE_COPY_NUMOF
+  } SPRITE_COPY_ENUM;
+
   void _type_routine_gfx (Sint32 * adresse);
+  bool sprite_copy_set (Sint32 kernel);
+  Sint32 sprite_copy_get (void);
+  const char *sprite_copy_name (Sint32 kernel);
   void conv8_16 (char *, char *, unsigned short *, Uint32);
   void conv8_24 (char *, char *, Uint32 *, Uint32);
   void conv8_32 (char *, char *, Uint32 *, Uint32);
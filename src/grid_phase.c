@@ -27,6 +27,8 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
+#include "game_rand.h"
 #include "images.h"
 #include "curve_phase.h"
 #include "display.h"
@@ -35,10 +37,13 @@
 #include "grid_phase.h"
 #include "guardians.h"
 #include "meteors_phase.h"
+#include "prefetch.h"
 #include "spaceship.h"
 
 /** Frid level data structure */
 grid_struct grid;
+/** Grid level file of the next level, loaded in advance */
+static char *grid_next_file = NULL;
 
 /**
  * Handle grid phase
@@ -134,14 +139,23 @@ grid_load (Sint32 num_grid)
   Sint16 *dest;
   Sint32 i;
   char *source;
-  meteors_images_free ();
   if (num_grid > MAX_NUM_OF_LEVELS || num_grid < 0)
     {
       num_grid = 0;
     }
 
-  /* load grid level file */
-  source = loadfile_num ("data/levels/grids_phase/grid_%02d.bin", num_grid);
+  /* load grid level file, unless it was loaded in advance */
+  if (prefetch_take (PREFETCH_GRID, num_grid))
+    {
+      source = grid_next_file;
+      grid_next_file = NULL;
+    }
+  else
+    {
+      source =
+        arena_loadfile_num (ARENA_LEVEL,
+                            "data/levels/grids_phase/grid_%02d.bin", num_grid);
+    }
   if (source == NULL)
     {
       return FALSE;
@@ -173,10 +187,34 @@ grid_load (Sint32 num_grid)
     {
       *(dest++) = little_endian_to_short (ptr16++);
     }
-  free_memory (source);
   return TRUE;
 }
 
+/**
+ * Load the grid level file of the next level, called by the thread
+ * of prefetch.c
+ * @param num_grid Grid level number from 0 to 41
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+grid_prefetch (Sint32 num_grid)
+{
+  grid_next_file =
+    arena_loadfile_num (ARENA_LEVEL, "data/levels/grids_phase/grid_%02d.bin",
+                        num_grid);
+  return grid_next_file != NULL;
+}
+
+/**
+ * Forget the grid level file of the next level which was not used,
+ * it is released with the level arena
+ */
+void
+grid_prefetch_discard (void)
+{
+  grid_next_file = NULL;
+}
+
 /**
  * Initialize grid phase
  */
@@ -231,7 +269,7 @@ grid_start (void)
               foe->spr.numof_images = 8;
 
               /* set current image of the enemy sprite */
-              foe->spr.current_image = (Sint16) (rand () % 8);
+              foe->spr.current_image = (Sint16) (game_rand () % 8);
               /* delay before next image: speed of the animation */
               foe->spr.anim_speed = 10;
               /* counter delay before next image */
@@ -267,7 +305,7 @@ grid_start (void)
   /* grid phase disable */
   grid.is_enable = FALSE;
   /* set movement toward right or left */
-  grid.right_movement = rand () % 2 ? TRUE : FALSE;
+  grid.right_movement = game_rand () % 2 ? TRUE : FALSE;
   if (grid.right_movement)
     {
       grid.speed_x = grid.vit_dep_x;
@@ -41,6 +41,8 @@ void Grid_Edit (void);
 */
 
   bool grid_load (Sint32 num_grid);
+  bool grid_prefetch (Sint32 num_grid);
+  void grid_prefetch_discard (void);
   void grid_start (void);
   void grid_handle (void);
   void grid_finished (void);
@@ -28,6 +28,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "config_file.h"
 #include "congratulations.h"
@@ -50,6 +51,7 @@
 #include "meteors_phase.h"
 #include "lonely_foes.h"
 #include "options_panel.h"
+#include "prefetch.h"
 #include "satellite_protections.h"
 #include "sdl_mixer.h"
 #include "spaceship.h"
@@ -58,6 +60,8 @@
 
 /** Data structure for the sprites images of the guardian */
 image gardi[GUARDIAN_MAX_OF_ANIMS][ENEMIES_SPECIAL_NUM_OF_IMAGES];
+/** Sprites images of the next guardian, loaded in advance */
+static image gardi_next[GUARDIAN_MAX_OF_ANIMS][ENEMIES_SPECIAL_NUM_OF_IMAGES];
 const Sint32 clip_gard10 = 16;
 guardian_struct *guardian;
 
@@ -88,23 +92,8 @@ guardians_once_init (void)
 static void
 guardian_images_free (void)
 {
-  Uint32 i, j;
-  for (i = 0; i < GUARDIAN_MAX_OF_ANIMS; i++)
-    {
-      for (j = 0; j < ENEMIES_SPECIAL_NUM_OF_IMAGES; j++)
-        {
-          if (gardi[i][j].img != NULL)
-            {
-              free_memory (gardi[i][j].img);
-              gardi[i][j].img = NULL;
-            }
-          if (gardi[i][j].compress != NULL)
-            {
-              free_memory (gardi[i][j].compress);
-              gardi[i][j].compress = NULL;
-            }
-        }
-    }
+  images_free (&gardi[0][0], GUARDIAN_MAX_OF_ANIMS,
+               ENEMIES_SPECIAL_NUM_OF_IMAGES, ENEMIES_SPECIAL_NUM_OF_IMAGES);
 }
 
 /**
@@ -756,7 +745,7 @@ guardian_fire (enemy * guard, Sint16 power, float speed)
       shot_guardian_add (guard, cannon_num, power, speed);
       numof_bullets++;
     }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_GUARDIAN_FIRE_1);
 #endif
   return numof_bullets;
@@ -856,7 +845,7 @@ guardian_add_missiles (enemy * guard, Uint32 inc, Sint32 max_counter,
             guard->spr.ycoord +
             guard->spr.img[guard->spr.current_image]->
             cannons_coords[i][YCOORD] - foe->spr.img[foe->img_angle]->y_gc;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
           if (img_angle == 16)
             {
               sound_play (SOUND_GUARDIAN_FIRE_2);
@@ -928,7 +917,7 @@ guardian_add_lonely_foe (Sint32 max_counter, Sint32 foe_num)
       return;
     }
   lonely_foe_add (foe_num);
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_GUARDIAN_FIRE_2);
 #endif
   guardian->lonely_foe_delay = 0;
@@ -969,7 +958,7 @@ guardian_add_soukee (enemy * guard, Sint32 inc, Sint32 max_counter)
       foe->angle_tir = HALF_PI;
       foe->img_old_angle = foe->img_angle;
       foe->agilite = 0.018f;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
       sound_play (SOUND_GUARDIAN_FIRE_2);
 #endif
     }
@@ -1003,7 +992,7 @@ guardian_add_shuriky (enemy * guard, Sint32 max_counter)
   foe->spr.ycoord =
     guard->spr.ycoord + guard->spr.img[guard->spr.current_image]->y_gc -
     foe->spr.img[0]->h / 2;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_GUARDIAN_FIRE_3);
 #endif
 }
@@ -1058,7 +1047,7 @@ guardian_add_quibouly (enemy * guard, Sint32 max_counter)
     {
       return;
     }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_GUARDIAN_FIRE_2);
 #endif
   foe->spr.xcoord =
@@ -1103,7 +1092,7 @@ guardian_add_tournadee (Sint32 max_counter)
     }
   foe->spr.ycoord
     = (float) (offscreen_starty + 32 + offscreen_height_visible);
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_GUARDIAN_FIRE_2);
 #endif
 }
@@ -1128,12 +1117,12 @@ guardian_add_sapouch (Uint32 numof, Sint32 max_counter, bool is_left)
     }
   guardian->sapouch_delay = 0;
   ycoord = (float) (offscreen_starty - 64);
-  speed = 2.5f + (float) (((long) rand () % (100))) / 100.0f;
+  speed = 2.5f + (float) (((long) game_rand () % (100))) / 100.0f;
   for (i = 0; i < numof; i++)
     {
       foe =
         guardian_add_foe (SAPOUCH, 10, SAPOUCH + (ship->type << 1) + 10, 0, 4,
-                          50 + (Sint32) ((long) rand () % (50)), speed);
+                          50 + (Sint32) ((long) game_rand () % (50)), speed);
       if (foe == NULL)
         {
           return;
@@ -1151,7 +1140,7 @@ guardian_add_sapouch (Uint32 numof, Sint32 max_counter, bool is_left)
       foe->spr.ycoord = ycoord - foe->spr.img[0]->h;
       foe->retournement = FALSE;
       foe->change_dir = FALSE;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
       sound_play (SOUND_GUARDIAN_FIRE_2);
 #endif
       is_left = is_left ? FALSE : TRUE;
@@ -1177,7 +1166,7 @@ guardian_add_perturbians (Uint32 numof, Sint32 max_counter, bool is_left)
       return;
     }
   guardian->perturbians_delay = 0;
-  fire_rate = 200 + (Sint32) ((long) rand () % (50));
+  fire_rate = 200 + (Sint32) ((long) game_rand () % (50));
   power = (Sint32) ((ship->type << 1) + PERTURBIANS - 40);
   for (i = 0; i < numof; i++)
     {
@@ -1201,7 +1190,7 @@ guardian_add_perturbians (Uint32 numof, Sint32 max_counter, bool is_left)
                      - foe->spr.img[0]->w);
         }
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
       sound_play (SOUND_GUARDIAN_FIRE_2);
 #endif
       is_left = is_left ? FALSE : TRUE;
@@ -1233,7 +1222,7 @@ guardian_add_saakamin (enemy * guard, Sint32 max_counter, Uint32 numof)
         {
           return;
         }
-      foe->num_courbe = (Sint16) (rand () % 121);
+      foe->num_courbe = (Sint16) (game_rand () % 121);
       foe->pos_vaiss[POS_CURVE] = 0;
       foe->spr.xcoord =
         (guard->spr.xcoord +
@@ -2631,26 +2620,26 @@ guardian_draw (enemy * guard)
     {
       draw_sprite (guard->spr.img[guard->spr.current_image],
                    (Uint32) guard->spr.xcoord, (Uint32) guard->spr.ycoord);
-      if (rand () % 2
-          && rand () % (ve_spr.max_energy_level + 1) >
+      if (game_rand () % 2
+          && game_rand () % (ve_spr.max_energy_level + 1) >
           ve_spr.energy_level + (ve_spr.max_energy_level >> 3))
         {
           zon_col =
-            (Sint16) (rand () %
+            (Sint16) (game_rand () %
                       ((Sint32) ve_spr.img[ve_spr.current_image]->
                        numof_collisions_zones));
           x_expl =
             (float) (ve_spr.xcoord +
                      ve_spr.img[ve_spr.current_image]->
                      collisions_coords[zon_col][XCOORD] +
-                     rand () %
+                     game_rand () %
                      ((Sint32) ve_spr.img[ve_spr.current_image]->
                       collisions_sizes[zon_col][XCOORD] + 1));
           y_expl =
             (float) (ve_spr.ycoord +
                      ve_spr.img[ve_spr.current_image]->
                      collisions_coords[zon_col][YCOORD] +
-                     rand () %
+                     game_rand () %
                      ((Sint32) ve_spr.img[ve_spr.current_image]->
                       collisions_sizes[zon_col][YCOORD] + 1));
           explosion_guardian_add (x_expl, y_expl);
@@ -2761,17 +2750,15 @@ guardian_handle (enemy * guard)
 }
 
 /**
- * Loading guardian's sprites images in memory 
+ * Load the sprites images of a guardian
  * @param guardian_num number of the guardian 1 to 14
+ * @param images Images of the current or of the next guardian
  * @return TRUE if successful
  */
-bool
-guardian_load (Sint32 guardian_num)
+static bool
+guardian_images_load (Sint32 guardian_num, image * images)
 {
   Uint32 num_of_sprites;
-  LOG_INF ("Load guardian %i", guardian_num);
-  guardian_images_free ();
-
   switch (guardian_num)
     {
     case 2:
@@ -2789,16 +2776,96 @@ guardian_load (Sint32 guardian_num)
       num_of_sprites = 1;
       break;
     }
-  if (!image_load_num
-      ("graphics/sprites/guardians/guardian_%02d.spr",
-       guardian_num - 1, &gardi[0][0], num_of_sprites,
-       ENEMIES_SPECIAL_NUM_OF_IMAGES))
+  return image_load_num ("graphics/sprites/guardians/guardian_%02d.spr",
+                         guardian_num - 1, images, num_of_sprites,
+                         ENEMIES_SPECIAL_NUM_OF_IMAGES);
+}
+
+/**
+ * Loading guardian's sprites images in memory 
+ * @param guardian_num number of the guardian 1 to 14
+ * @return TRUE if successful
+ */
+bool
+guardian_load (Sint32 guardian_num)
+{
+  LOG_INF ("Load guardian %i", guardian_num);
+  guardian_images_free ();
+  if (prefetch_take (PREFETCH_GUARDIAN, guardian_num))
+    {
+      memcpy (gardi, gardi_next, sizeof (gardi));
+      memset (gardi_next, 0, sizeof (gardi_next));
+    }
+  else if (!guardian_images_load (guardian_num, &gardi[0][0]))
     {
       return FALSE;
     }
+  /* the last guardians follow each other */
+  if (guardian_num >= 11 && guardian_num < 14)
+    {
+      prefetch_request (PREFETCH_GUARDIAN, guardian_num + 1);
+    }
   return TRUE;
 }
 
+/**
+ * Load the sprites images of the next guardian, called by the thread
+ * of prefetch.c
+ * @param guardian_num number of the guardian 1 to 14
+ * @return TRUE if successful
+ */
+bool
+guardian_prefetch (Sint32 guardian_num)
+{
+  return guardian_images_load (guardian_num, &gardi_next[0][0]);
+}
+
+/**
+ * Release the sprites images of the next guardian which were not used
+ */
+void
+guardian_prefetch_discard (void)
+{
+  images_free (&gardi_next[0][0], GUARDIAN_MAX_OF_ANIMS,
+               ENEMIES_SPECIAL_NUM_OF_IMAGES, ENEMIES_SPECIAL_NUM_OF_IMAGES);
+}
+
+/**
+ * Return the guardian loaded at the beginning of a level, it appears
+ * at the end of the fourth level
+ * @param level Level number from 0 to 41
+ * @return Number of the guardian from 2 to 11, or 0 if no guardian
+ *         is loaded
+ */
+Sint32
+guardian_of_level (Sint32 level)
+{
+  switch (level)
+    {
+    case 4:
+      return 2;
+    case 8:
+      return 3;
+    case 12:
+      return 4;
+    case 16:
+      return 5;
+    case 20:
+      return 6;
+    case 24:
+      return 7;
+    case 28:
+      return 8;
+    case 32:
+      return 9;
+    case 36:
+      return 10;
+    case 40:
+      return 11;
+    }
+  return 0;
+}
+
 /**
  * Convert guardians from data image to PNG file
  * @return TRUE if successful
@@ -2879,7 +2946,7 @@ guardians_extract (void)
 bool
 guardian_finished (void)
 {
-  Uint32 guard_num = 0;
+  Sint32 guard_num;
   bool is_finished;
   if (guardian->number == 0)
     {
@@ -2938,39 +3005,7 @@ guardian_finished (void)
             }
 
           /* load guardian files in advance */
-          switch (num_level)
-            {
-            case 4:
-              guard_num = 2;
-              break;
-            case 8:
-              guard_num = 3;
-              break;
-            case 12:
-              guard_num = 4;
-              break;
-            case 16:
-              guard_num = 5;
-              break;
-            case 20:
-              guard_num = 6;
-              break;
-            case 24:
-              guard_num = 7;
-              break;
-            case 28:
-              guard_num = 8;
-              break;
-            case 32:
-              guard_num = 9;
-              break;
-            case 36:
-              guard_num = 10;
-              break;
-            case 40:
-              guard_num = 11;
-              break;
-            }
+          guard_num = guardian_of_level (num_level);
           if (guard_num > 0)
             {
               if (!guardian_load (guard_num))
@@ -2995,6 +3030,8 @@ guardian_finished (void)
             }
           /* enable the curve level file loaded previously */
           curve_enable_level ();
+          /* the data of the next level are loaded during this one */
+          prefetch_level (num_level + 1);
           courbe.activity = TRUE;
           grid.is_enable = FALSE;
           meteor_activity = FALSE;
@@ -110,6 +110,9 @@ extern "C"
   void guardian_handle (enemy * guard);
   bool guardian_new (Uint32 guard_num);
   bool guardian_load (Sint32 guardian_num);
+  bool guardian_prefetch (Sint32 guardian_num);
+  void guardian_prefetch_discard (void);
+  Sint32 guardian_of_level (Sint32 level);
 #ifdef PNG_EXPORT_ENABLE
   bool guardians_extract (void);
 #endif
@@ -29,6 +29,7 @@
 #include "powermanga.h"
 #include "tools.h"
 #include "display.h"
+#include "sprite_pack.h"
 #include "images.h"
 #include "log_recorder.h"
 #ifdef PNG_EXPORT_ENABLE
@@ -36,10 +37,8 @@
 #include <png.h>
 #endif
 
-static char *bitmap_read (bitmap * bmp, Uint32 num_of_obj,
-                          Uint32 num_of_images, char *addr,
-                          Uint32 max_of_anims);
 static char *image_extract (image * img, const char *filename);
+static void image_collisions_bounds (image * img);
 static char *bitmap_extract (bitmap * bmp, char *filedata);
 static char *read_pixels (Uint32 numofpixels, char *source,
                           char *destination);
@@ -57,21 +56,17 @@ bool
 image_load (const char *fname, image * img, Uint32 num_of_sprites,
             Uint32 num_of_anims)
 {
-  char *data;
-  char *file = load_file (fname);
-  if (file == NULL)
+  bool result;
+  sprites_file file;
+  if (!sprites_file_open (&file, fname, SPRITE_PACK_IMAGES))
     {
       return FALSE;
     }
-  data = file;
-  data = images_read (img, num_of_sprites, num_of_anims, data, num_of_anims);
-  if (data == NULL)
-    {
-      free_memory (file);
-      return FALSE;
-    }
-  free_memory (file);
-  return TRUE;
+  result =
+    sprites_file_read_images (&file, img, num_of_sprites, num_of_anims,
+                              num_of_anims);
+  sprites_file_close (&file);
+  return result;
 }
 
 /** 
@@ -87,19 +82,19 @@ bool
 image_load_num (const char *fname, Sint32 num, image * img,
                 Uint32 num_of_sprites, Uint32 num_of_anims)
 {
-  char *data;
-  char *file = loadfile_num (fname, num);
-  if (file == NULL)
-    {
-      return FALSE;
-    }
-  data = images_read (img, num_of_sprites, num_of_anims, file, num_of_anims);
-  free_memory (file);
-  if (data == NULL)
+  bool result;
+  Uint32 length = strlen (fname) + 12;
+  char *filename = memory_allocation (length);
+  if (filename == NULL)
     {
+      LOG_ERR ("filename: \"%s\"; num: %i; "
+               "not enough memory to allocate %i bytes", fname, num, length);
       return FALSE;
     }
-  return TRUE;
+  sprintf (filename, fname, num);
+  result = image_load (filename, img, num_of_sprites, num_of_anims);
+  free_memory (filename);
+  return result;
 }
 
 /** 
@@ -109,49 +104,311 @@ bool
 bitmap_load (const char *fname, bitmap * fonte, Uint32 num_of_obj,
              Uint32 num_of_images)
 {
-  char *addr;
-  char *file = load_file (fname);
-  if (file == NULL)
+  bool result;
+  sprites_file file;
+  if (!sprites_file_open (&file, fname, SPRITE_PACK_BITMAPS))
     {
       return FALSE;
     }
-  addr = bitmap_read (fonte, num_of_obj, num_of_images, file, num_of_images);
-  if (addr == NULL)
+  result =
+    sprites_file_read_bitmaps (&file, fonte, num_of_obj, num_of_images,
+                               num_of_images);
+  sprites_file_close (&file);
+  return result;
+}
+
+/**
+ * Open a sprite file, from its sprite pack if one is up to date,
+ * otherwise from the "*.spr" file; then the sprite pack is built
+ * from the structures read when sprites_file_close() is called
+ * @param file Pointer to the sprite file to initialize
+ * @param filename The file *.spr which should be read
+ * @param kind SPRITE_PACK_IMAGES or SPRITE_PACK_BITMAPS
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+sprites_file_open (sprites_file * file, const char *filename, Uint32 kind)
+{
+  Uint32 record_size =
+    kind == SPRITE_PACK_IMAGES ? sizeof (image) : sizeof (bitmap);
+  file->filedata = NULL;
+  file->addr = NULL;
+  file->record = 0;
+  file->builder = NULL;
+  file->numof_reads = 0;
+  file->pack = sprite_pack_open (filename, kind, record_size);
+  if (file->pack != NULL)
+    {
+      return TRUE;
+    }
+  file->filedata = load_file (filename);
+  if (file->filedata == NULL)
     {
-      free_memory (file);
       return FALSE;
     }
-  free_memory (file);
+  file->addr = file->filedata;
+  file->builder = sprite_pack_builder_new (filename, kind, record_size);
+  return TRUE;
+}
+
+/**
+ * Add a record to the sprite pack being built
+ * @param file Pointer to the sprite file
+ * @param record Copy of the 'image' or 'bitmap' structure
+ * @param pixels Pointer to the pixels field of the copy
+ * @param numof_pixels Number of pixels
+ * @param compress Pointer to the compress field of the copy
+ * @param nbr_data_comp Size of the compress table in the "*.spr" file
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+sprites_file_add (sprites_file * file, void *record, char **pixels,
+                  Sint32 numof_pixels, char **compress, Sint32 nbr_data_comp)
+{
+  return sprite_pack_add_data (file->builder, *pixels,
+                               numof_pixels * bytes_per_pixel, pixels)
+    && sprite_pack_add_data (file->builder, *compress, nbr_data_comp * 2,
+                             compress)
+    && sprite_pack_add_record (file->builder, record);
+}
+
+/**
+ * Remember the structures filled by a read, they are added to the
+ * sprite pack when the file is closed: the caller can modify them
+ * before, the sprite pack holds them as they are used
+ * @param file Pointer to the sprite file
+ * @param first Pointer to the first 'image' or 'bitmap' structure
+ * @param num_of_sprites Number different sprites
+ * @param num_of_anims Number of animations for a same sprite
+ * @param max_of_anims Maximum number of images per type of sprite
+ */
+static void
+sprites_file_add_read (sprites_file * file, void *first,
+                       Uint32 num_of_sprites, Uint32 num_of_anims,
+                       Uint32 max_of_anims)
+{
+  sprites_file_read *read;
+  if (file->builder == NULL)
+    {
+      return;
+    }
+  if (file->numof_reads >= SPRITES_FILE_MAXOF_READS)
+    {
+      LOG_ERR ("too many reads, the sprite pack is not built");
+      sprite_pack_builder_free (file->builder);
+      file->builder = NULL;
+      return;
+    }
+  read = &file->reads[file->numof_reads++];
+  read->first = first;
+  read->num_of_sprites = num_of_sprites;
+  read->num_of_anims = num_of_anims;
+  read->max_of_anims = max_of_anims;
+}
+
+/**
+ * Add all the structures read to the sprite pack being built
+ * @param file Pointer to the sprite file
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+sprites_file_add_reads (sprites_file * file)
+{
+  Uint32 n, i, j;
+  image img;
+  bitmap bmp;
+  sprites_file_read *read;
+  for (n = 0; n < file->numof_reads; n++)
+    {
+      read = &file->reads[n];
+      for (i = 0; i < read->num_of_sprites; i++)
+        {
+          for (j = 0; j < read->num_of_anims; j++)
+            {
+              if (file->builder->header.kind == SPRITE_PACK_IMAGES)
+                {
+                  img =
+                    *((image *) read->first + (i * read->max_of_anims) + j);
+                  if (!sprites_file_add
+                      (file, &img, &img.img, img.numof_pixels, &img.compress,
+                       img.nbr_data_comp))
+                    {
+                      return FALSE;
+                    }
+                }
+              else
+                {
+                  bmp =
+                    *((bitmap *) read->first + (i * read->max_of_anims) + j);
+                  if (!sprites_file_add
+                      (file, &bmp, &bmp.img, bmp.numof_pixels, &bmp.compress,
+                       bmp.nbr_data_comp))
+                    {
+                      return FALSE;
+                    }
+                }
+            }
+        }
+    }
   return TRUE;
 }
 
 /**
- * Read a sprite filedata to an 'image' structure
+ * Give up the sprite pack being built, after a read error
+ * @param file Pointer to the sprite file
+ */
+static void
+sprites_file_cancel (sprites_file * file)
+{
+  if (file->builder != NULL)
+    {
+      sprite_pack_builder_free (file->builder);
+      file->builder = NULL;
+    }
+}
+
+/**
+ * Read the next images of a sprite file into 'image' structures.
+ * The images of a sprite pack are copied as they are, only their
+ * pointers are moved into the pack
+ * @param file Pointer to the sprite file
  * @param img Pointer to destination 'image' structure 
  * @param num_of_sprites Number different sprites
  * @param num_of_anims Number of animations for a same sprite
- * @param addr Pointer to the source sprite filedata 
  * @param max_of_anims Maximum number of images per type of sprite
- * @return Pointer to source sprite filedata 
+ * @return TRUE if it completed successfully or FALSE otherwise
  */
-char *
-images_read (image * img, Uint32 num_of_sprites, Uint32 num_of_anims,
-             char *addr, Uint32 max_of_anims)
+bool
+sprites_file_read_images (sprites_file * file, image * img,
+                          Uint32 num_of_sprites, Uint32 num_of_anims,
+                          Uint32 max_of_anims)
 {
   Uint32 i, j;
+  image *dest, *source;
+  sprite_pack *pack = file->pack;
+  if (pack != NULL)
+    {
+      if (file->record + num_of_sprites * num_of_anims > pack->numof_records)
+        {
+          LOG_ERR ("the sprite pack has only %i images", pack->numof_records);
+          return FALSE;
+        }
+      source = (image *) pack->records + file->record;
+      for (i = 0; i < num_of_sprites; i++)
+        {
+          dest = img + (i * max_of_anims);
+          memcpy (dest, source, num_of_anims * sizeof (image));
+          for (j = 0; j < num_of_anims; j++)
+            {
+              dest[j].img = pack->data + (size_t) dest[j].img;
+              dest[j].compress = pack->data + (size_t) dest[j].compress;
+            }
+          source += num_of_anims;
+        }
+      file->record += num_of_sprites * num_of_anims;
+      return TRUE;
+    }
+
   for (i = 0; i < num_of_sprites; i++)
     {
       for (j = 0; j < num_of_anims; j++)
         {
-          addr = image_extract (img + (i * max_of_anims) + j, addr);
-          if (addr == NULL)
+          dest = img + (i * max_of_anims) + j;
+          file->addr = image_extract (dest, file->addr);
+          if (file->addr == NULL)
             {
               LOG_ERR ("image_extract failed!");
-              return NULL;
+              sprites_file_cancel (file);
+              return FALSE;
+            }
+        }
+    }
+  sprites_file_add_read (file, img, num_of_sprites, num_of_anims,
+                         max_of_anims);
+  return TRUE;
+}
+
+/**
+ * Read the next bitmaps of a sprite file into 'bitmap' structures
+ * @param file Pointer to the sprite file
+ * @param bmp Pointer to destination 'bitmap' structure 
+ * @param num_of_obj Number different bitmap objects
+ * @param num_of_images Number of images for a same bitmap
+ * @param max_of_anims Maximum number of images per bitmap object
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+sprites_file_read_bitmaps (sprites_file * file, bitmap * bmp,
+                           Uint32 num_of_obj, Uint32 num_of_images,
+                           Uint32 max_of_anims)
+{
+  Uint32 i, j;
+  bitmap *dest, *source;
+  sprite_pack *pack = file->pack;
+  if (pack != NULL)
+    {
+      if (file->record + num_of_obj * num_of_images > pack->numof_records)
+        {
+          LOG_ERR ("the sprite pack has only %i bitmaps",
+                   pack->numof_records);
+          return FALSE;
+        }
+      source = (bitmap *) pack->records + file->record;
+      for (i = 0; i < num_of_obj; i++)
+        {
+          dest = bmp + (i * max_of_anims);
+          memcpy (dest, source, num_of_images * sizeof (bitmap));
+          for (j = 0; j < num_of_images; j++)
+            {
+              dest[j].img = pack->data + (size_t) dest[j].img;
+              dest[j].compress = pack->data + (size_t) dest[j].compress;
             }
+          source += num_of_images;
         }
+      file->record += num_of_obj * num_of_images;
+      return TRUE;
     }
-  return addr;
+
+  for (i = 0; i < num_of_obj; i++)
+    {
+      for (j = 0; j < num_of_images; j++)
+        {
+          dest = bmp + (i * max_of_anims) + j;
+          file->addr = bitmap_extract (dest, file->addr);
+          if (file->addr == NULL)
+            {
+              LOG_ERR ("bitmap_extract() failed!");
+              sprites_file_cancel (file);
+              return FALSE;
+            }
+        }
+    }
+  sprites_file_add_read (file, bmp, num_of_obj, num_of_images, max_of_anims);
+  return TRUE;
+}
+
+/**
+ * Close a sprite file, and write its sprite pack if it was built
+ * @param file Pointer to the sprite file
+ */
+void
+sprites_file_close (sprites_file * file)
+{
+  if (file->builder != NULL)
+    {
+      if (sprites_file_add_reads (file))
+        {
+          sprite_pack_builder_write (file->builder);
+        }
+      sprite_pack_builder_free (file->builder);
+      file->builder = NULL;
+    }
+  if (file->filedata != NULL)
+    {
+      free_memory (file->filedata);
+      file->filedata = NULL;
+    }
+  file->pack = NULL;
 }
 
 /**
@@ -172,6 +429,12 @@ images_free (image * first_image, Uint32 num_of_sprites, Uint32 num_of_anims,
       for (j = 0; j < num_of_anims; j++)
         {
           img = first_image + (i * max_of_anims) + j;
+          /* the images of a sprite pack are used in place */
+          if (img->img != NULL && sprite_pack_contains (img->img))
+            {
+              img->img = NULL;
+              img->compress = NULL;
+            }
           if (img->img != NULL)
             {
               free_memory (img->img);
@@ -186,35 +449,6 @@ images_free (image * first_image, Uint32 num_of_sprites, Uint32 num_of_anims,
     }
 }
 
-/**
- * Read a bitmap filedata to an 'bitmap' structure
- * @param bmp Pointer to destination 'bitmap' structure 
- * @param num_of_obj Number different bitmap objects
- * @param num_of_images Number of images for a same bitmap
- * @param addr Pointer to the source bitmap filedata 
- * @param width Width of the bitmap in pixels
- * @return The source pointer incremented
- */
-static char *
-bitmap_read (bitmap * bmp, Uint32 num_of_obj, Uint32 num_of_images,
-             char *addr, Uint32 max_of_anims)
-{
-  Uint32 i, j;
-  for (i = 0; i < num_of_obj; i++)
-    {
-      for (j = 0; j < num_of_images; j++)
-        {
-          addr = bitmap_extract (bmp + (i * max_of_anims) + j, addr);
-          if (addr == NULL)
-            {
-              LOG_ERR ("bitmap_extract() failed!");
-              return NULL;
-            }
-        }
-    }
-  return addr;
-}
-
 /**
  * Release bitmap data 
  */
@@ -229,6 +463,12 @@ bitmap_free (bitmap * first_bitmap, Uint32 num_of_bitmap, Uint32 num_of_anims,
       for (j = 0; j < num_of_anims; j++)
         {
           bmp = first_bitmap + (i * max_of_anims) + j;
+          /* the bitmaps of a sprite pack are used in place */
+          if (bmp->img != NULL && sprite_pack_contains (bmp->img))
+            {
+              bmp->img = NULL;
+              bmp->compress = NULL;
+            }
           if (bmp->img != NULL)
             {
               free_memory (bmp->img);
@@ -252,21 +492,7 @@ bitmap_free (bitmap * first_bitmap, Uint32 num_of_bitmap, Uint32 num_of_anims,
 bool
 image_load_single (const char *filename, image * img)
 {
-  char *addr;
-  char *filedata = load_file (filename);
-  if (filedata == NULL)
-    {
-      return FALSE;
-    }
-  addr = image_extract (img, filedata);
-  if (addr == NULL)
-    {
-      LOG_ERR ("image_extract() failed!");
-      free_memory (filedata);
-      return FALSE;
-    }
-  free_memory (filedata);
-  return TRUE;
+  return image_load (filename, img, 1, 1);
 }
 
 /**
@@ -327,6 +553,7 @@ image_extract (image * img, const char *file)
     {
       *(dest++) = little_endian_to_short (ptr16++);
     }
+  image_collisions_bounds (img);
 
   /* 
    * read origins of shots (location of the cannons) and angle shots 
@@ -377,6 +604,87 @@ image_extract (image * img, const char *file)
   return ptr8;
 }
 
+/**
+ * Compute the bounding boxes of the collision points and of the
+ * collision zones, used to reject quickly the distant sprites
+ * @param img Pointer to a 'image' structure
+ */
+static void
+image_collisions_bounds (image * img)
+{
+  Sint32 i, n;
+  Sint16 x, y;
+  img->points_left = img->points_top = 0x7fff;
+  img->points_right = img->points_bottom = -0x7fff;
+  n = img->numof_collisions_points;
+  if (n > MAX_OF_COLLISION_POINTS)
+    {
+      n = MAX_OF_COLLISION_POINTS;
+    }
+  for (i = 0; i < n; i++)
+    {
+      x = img->collisions_points[i][XCOORD];
+      y = img->collisions_points[i][YCOORD];
+      if (x < img->points_left)
+        {
+          img->points_left = x;
+        }
+      if (y < img->points_top)
+        {
+          img->points_top = y;
+        }
+      if (x + 1 > img->points_right)
+        {
+          img->points_right = (Sint16) (x + 1);
+        }
+      if (y + 1 > img->points_bottom)
+        {
+          img->points_bottom = (Sint16) (y + 1);
+        }
+    }
+  if (n <= 0)
+    {
+      img->points_left = img->points_top = 0;
+      img->points_right = img->points_bottom = 0;
+    }
+
+  img->zones_left = img->zones_top = 0x7fff;
+  img->zones_right = img->zones_bottom = -0x7fff;
+  n = img->numof_collisions_zones;
+  if (n > MAX_OF_COLLISION_ZONES)
+    {
+      n = MAX_OF_COLLISION_ZONES;
+    }
+  for (i = 0; i < n; i++)
+    {
+      x = img->collisions_coords[i][XCOORD];
+      y = img->collisions_coords[i][YCOORD];
+      if (x < img->zones_left)
+        {
+          img->zones_left = x;
+        }
+      if (y < img->zones_top)
+        {
+          img->zones_top = y;
+        }
+      x = (Sint16) (x + img->collisions_sizes[i][IMAGE_WIDTH]);
+      y = (Sint16) (y + img->collisions_sizes[i][IMAGE_HEIGHT]);
+      if (x > img->zones_right)
+        {
+          img->zones_right = x;
+        }
+      if (y > img->zones_bottom)
+        {
+          img->zones_bottom = y;
+        }
+    }
+  if (n <= 0)
+    {
+      img->zones_left = img->zones_top = 0;
+      img->zones_right = img->zones_bottom = 0;
+    }
+}
+
 /** 
  * Extract a "*.spr" file data into a 'bitmap' structure 
  * @param bmp Pointer to a bitmap structure
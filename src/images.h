@@ -92,6 +92,18 @@ extern "C"
     Sint16 collisions_coords[MAX_OF_COLLISION_ZONES][2];
     /** List of the collision zones sizes (width/height) */
     Sint16 collisions_sizes[MAX_OF_COLLISION_ZONES][2];
+    /** Bounding box of the collision points (right and bottom
+     * excluded), empty if the image has no collision point */
+    Sint16 points_left;
+    Sint16 points_top;
+    Sint16 points_right;
+    Sint16 points_bottom;
+    /** Bounding box of the collision zones (right and bottom
+     * excluded), empty if the image has no collision zone */
+    Sint16 zones_left;
+    Sint16 zones_top;
+    Sint16 zones_right;
+    Sint16 zones_bottom;
     /** Number of cannons coordinates */
     Sint16 numof_cannons;
     /** Lists of the cannons coordinates */
@@ -139,6 +151,39 @@ extern "C"
     /** Speed of the sprite */
     float speed;
   } sprite;
+/** Maximum number of reads of a sprite file */
+#define SPRITES_FILE_MAXOF_READS 4
+
+  /** Structures filled by a read of a sprite file */
+  typedef struct sprites_file_read
+  {
+    /** First 'image' or 'bitmap' structure */
+    void *first;
+    Uint32 num_of_sprites;
+    Uint32 num_of_anims;
+    Uint32 max_of_anims;
+  }
+  sprites_file_read;
+
+  /** A "*.spr" file being read, from its data or from its sprite pack */
+  typedef struct sprites_file
+  {
+    /** Data of the "*.spr" file, NULL if read from the sprite pack */
+    char *filedata;
+    /** Next record in the data of the "*.spr" file */
+    char *addr;
+    /** Sprite pack of the file, NULL if there is none up to date */
+    struct sprite_pack *pack;
+    /** Index of the next record in the sprite pack */
+    Uint32 record;
+    /** Sprite pack built while the "*.spr" file is read, or NULL */
+    struct sprite_pack_builder *builder;
+    /** Reads added to the sprite pack when the file is closed */
+    sprites_file_read reads[SPRITES_FILE_MAXOF_READS];
+    Uint32 numof_reads;
+  }
+  sprites_file;
+
   bool image_load (const char *fname, image * img, Uint32 num_of_sprites,
                    Uint32 num_of_images);
   bool image_load_num (const char *fname, Sint32 num, image * img,
@@ -146,8 +191,15 @@ extern "C"
   bool image_load_single (const char *fname, image * img);
   bool bitmap_load (const char *fname, bitmap * fonte, Uint32 num_of_obj,
                     Uint32 num_of_images);
-  char *images_read (image * img, Uint32 num_of_sprites, Uint32 num_of_images,
-                     char *addr, Uint32 max_of_anims);
+  bool sprites_file_open (sprites_file * file, const char *filename,
+                          Uint32 kind);
+  bool sprites_file_read_images (sprites_file * file, image * img,
+                                 Uint32 num_of_sprites, Uint32 num_of_anims,
+                                 Uint32 max_of_anims);
+  bool sprites_file_read_bitmaps (sprites_file * file, bitmap * bmp,
+                                  Uint32 num_of_obj, Uint32 num_of_images,
+                                  Uint32 max_of_anims);
+  void sprites_file_close (sprites_file * file);
   void images_free (image * first_image, Uint32 num_of_sprites,
                     Uint32 num_of_anims, Uint32 max_of_anims);
   void bitmap_free (bitmap * first_bitmap, Uint32 num_of_bitmap,
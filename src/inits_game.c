@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
 #include "images.h"
 #include "config_file.h"
 #include "curve_phase.h"
@@ -38,23 +39,28 @@
 #include "explosions.h"
 #include "shots.h"
 #include "extra_gun.h"
+#include "game_rand.h"
 #include "guardians.h"
 #include "images.h"
+#include "input_replay.h"
 #include "log_recorder.h"
 #include "meteors_phase.h"
 #include "menu.h"
 #include "menu_sections.h"
 #include "movie.h"
 #include "options_panel.h"
+#include "prefetch.h"
 #include "satellite_protections.h"
 #include "scrolltext.h"
 #include "sdl_mixer.h"
 #include "shockwave.h"
 #include "spaceship.h"
+#include "sprite_pack.h"
 #include "sprites_string.h"
 #include "starfield.h"
 #include "text_overlay.h"
 #include "texts.h"
+#include "workers.h"
 
 #ifdef SHAREWARE_VERSION
 #include <SDL/SDL_ttf.h>
@@ -64,6 +70,102 @@
 /* logo TLK Games */
 extern bitmap logotlk[TLKLOGO_MAXOF_IMAGES];
 
+/** Loaders run by inits_game(), the ones needed by the main menu
+ * come first because they are started first */
+typedef enum
+{
+  LOAD_TEXT_OVERLAY,
+  LOAD_SPRITES_STRING,
+  LOAD_TEXTS,
+  LOAD_SINUS,
+  LOAD_TLK_LOGO,
+  LOAD_STARFIELD,
+  LOAD_SCROLLTEXT,
+  LOAD_MENU,
+  LOAD_COLORS,
+  LOAD_GUARDIANS,
+  LOAD_METEORS,
+  LOAD_BONUS,
+  LOAD_SHOTS,
+  LOAD_ENEMIES,
+  LOAD_OPTIONS,
+  LOAD_EXPLOSIONS,
+  LOAD_ENERGY_GAUGE,
+  LOAD_SPACESHIP,
+  LOAD_GUNS,
+  LOAD_CURVES,
+  LOAD_ELECTRICAL_SHOCK,
+  LOAD_SHOCKWAVE,
+  LOAD_SATELLITES,
+  LOADERS_NUMOF
+}
+LOADERS_ENUM;
+#define LOADED(loader) (1U << (loader))
+
+/**
+ * Load the TLK logo, 92 949 bytes
+ * @return TRUE if successful
+ */
+static bool
+tlk_logo_load (void)
+{
+  return bitmap_load ("graphics/bitmap/tlk_games_logo.spr", &logotlk[0], 1,
+                      TLKLOGO_MAXOF_IMAGES);
+}
+
+/**
+ * Initialize some predefined colors, search_color() needs the palette
+ * loaded by display_initialize()
+ * @return Always TRUE
+ */
+static bool
+colors_init (void)
+{
+  display_colors_init ();
+  return TRUE;
+}
+
+/** Each loader uses its own data, except the ones which depend on
+ * other loaders */
+static const workers_node loaders[LOADERS_NUMOF] = {
+  {"text_overlay_once_init()", text_overlay_once_init, 0},
+  {"sprites_string_once_init()", sprites_string_once_init, 0},
+  /* the texts are drawn with the fonts */
+  {"texts_init_once()", texts_init_once, LOADED (LOAD_SPRITES_STRING)},
+  /* allocate and precalculate sinus and cosinus curves */
+  {"alloc_precalulate_sinus()", alloc_precalulate_sinus, 0},
+  {"tlk_logo_load()", tlk_logo_load, 0},
+  {"starfield_once_init()", starfield_once_init, 0},
+  /* allocate and clear fontes list and elements */
+  {"scrolltext_once_init()", scrolltext_once_init, 0},
+  /* main menu enable */
+  {"menu_once_init()", menu_once_init, 0},
+  {"display_colors_init()", colors_init, 0},
+  {"guardians_once_init()", guardians_once_init, 0},
+  /* both release the meteors images */
+  {"meteors_once_init()", meteors_once_init, LOADED (LOAD_GUARDIANS)},
+  /* initialize bonus data structure */
+  {"bonus_once_init()", bonus_once_init, 0},
+  /* initialize shots data structure */
+  {"shots_once_init()", shots_once_init, 0},
+  /* allocate buffers and initialize structure of the enemies vessels */
+  {"enemies_once_init()", enemies_once_init, LOADED (LOAD_COLORS)},
+  {"options_once_init()", options_once_init, 0},
+  /* initialize explosions */
+  {"explosions_once_init()", explosions_once_init, 0},
+  {"energy_gauge_once_init()", energy_gauge_once_init, 0},
+  /* initialize spaceship's structure */
+  {"spaceship_once_init()", spaceship_once_init, 0},
+  /* initialize extra guns, they are removed from the spaceship */
+  {"guns_once_init()", guns_once_init, LOADED (LOAD_SPACESHIP)},
+  /* laod all bezier curves */
+  {"curve_once_init()", curve_once_init, 0},
+  {"electrical_shock_once_init()", electrical_shock_once_init,
+   LOADED (LOAD_COLORS)},
+  {"shockwave_once_init()", shockwave_once_init, LOADED (LOAD_COLORS)},
+  {"satellites_once_init()", satellites_once_init, 0}
+};
+
 /**
  * Initialization code that is only run once
  * @return TRUE if successful
@@ -71,11 +173,19 @@ extern bitmap logotlk[TLKLOGO_MAXOF_IMAGES];
 bool
 inits_game (void)
 {
+  Uint64 time_begin;
+  Uint32 opened, built;
+  /* the replay file gives the seed of the recorded game */
+  if (!input_replay_init ())
+    {
+      return FALSE;
+    }
+  game_rand_seed ((Uint32) power_conf->seed);
   if (!menu_sections_once_init ())
     {
       return FALSE;
     }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   if (!sound_once_init ())
     {
       return FALSE;
@@ -89,111 +199,20 @@ inits_game (void)
     }
   LOG_INF ("SHAREWARE_VERSION TTF_Init() successful!");
 #endif
-  /* initialize SDL or X11 display */
-  if (!display_initialize ())
-    {
-      return FALSE;
-    }
-  if (!text_overlay_once_init ())
-    {
-      return FALSE;
-    }
-  if (!sprites_string_once_init ())
-    {
-      return FALSE;
-    }
-  if (!texts_init_once ())
-    {
-      return FALSE;
-    }
-  /* allocate and precalculate sinus and cosinus curves */
-  if (!alloc_precalulate_sinus ())
-    {
-      return FALSE;
-    }
-  /* load TLK logo 92 949 bytes */
-  if (!bitmap_load
-      ("graphics/bitmap/tlk_games_logo.spr", &logotlk[0], 1,
-       TLKLOGO_MAXOF_IMAGES))
-    {
-      return FALSE;
-    }
-  if (!guardians_once_init ())
-    {
-      return FALSE;
-    }
-  if (!meteors_once_init ())
+  /* threads which share the loading of the assets and the scaling
+   * of the screen */
+  if (!workers_init (power_conf->threads))
     {
       return FALSE;
     }
-  if (!starfield_once_init ())
-    {
-      return FALSE;
-    }
-  /* allocate and clear fontes list and elements */
-  if (!scrolltext_once_init ())
-    {
-      return FALSE;
-    }
-  /* initialize bonus data structure */
-  if (!bonus_once_init ())
-    {
-      return FALSE;
-    }
-  /* initialize shots data structure */
-  if (!shots_once_init ())
-    {
-      return FALSE;
-    }
-  /* allocate buffers and initialize structure of the enemies vessels */
-  if (!enemies_once_init ())
-    {
-      return FALSE;
-    }
-  if (!options_once_init ())
-    {
-      return FALSE;
-    }
-  /* initialize explosions */
-  if (!explosions_once_init ())
-    {
-      return FALSE;
-    }
-  /* initialize extra guns */
-  if (!guns_once_init ())
-    {
-      return FALSE;
-    }
-  if (!energy_gauge_once_init ())
-    {
-      return FALSE;
-    }
-  /* initialize spaceship's structure */
-  if (!spaceship_once_init ())
-    {
-      return FALSE;
-    }
-  /* laod all bezier curves */
-  if (!curve_once_init ())
-    {
-      return FALSE;
-    }
-  /* initialize some predefined colors */
-  display_colors_init ();
-  if (!electrical_shock_once_init ())
-    {
-      return FALSE;
-    }
-  if (!shockwave_once_init ())
-    {
-      return FALSE;
-    }
-  if (!satellites_once_init ())
+  /* initialize SDL or X11 display */
+  if (!display_initialize ())
     {
       return FALSE;
     }
-  /* main menu enable */
-  if (!menu_once_init ())
+  /* the assets are loaded from here */
+  time_begin = get_ticks_usec ();
+  if (!workers_run_graph (loaders, LOADERS_NUMOF))
     {
       return FALSE;
     }
@@ -227,6 +246,20 @@ inits_game (void)
   #ifdef __EMSCRIPTEN__
   unlock_surface_scores();
   #endif
+  /* cold start when sprites were converted, warm start when they
+   * were all read from their pack */
+  sprite_packs_counters (&opened, &built);
+  LOG_INF ("%s start: assets loaded in %i ms; %i sprite files read"
+           " from the cache, %i converted and cached",
+           opened > 0 && built == 0 ? "warm" : "cold",
+           (Uint32) ((get_ticks_usec () - time_begin) / 1000), opened,
+           built);
+  /* the first level is loaded while the menu is displayed */
+  if (!prefetch_init ())
+    {
+      return FALSE;
+    }
+  prefetch_new_game ();
   return TRUE;
 }
 
@@ -279,7 +312,10 @@ release_game (void)
   bitmap_free (&logotlk[0], 1, TLKLOGO_MAXOF_IMAGES, TLKLOGO_MAXOF_IMAGES);
   /* free video ressources (xorg-x11 or SDL) */
   display_release ();
-#ifdef USE_SDLMIXER
+  input_replay_free ();
+  prefetch_free ();
+  workers_free ();
+#ifdef USE_SOUND
   sound_free ();
 #endif
   menu_sections_free ();
@@ -303,7 +339,11 @@ release_game (void)
   texts_free ();
   sprites_string_free ();
   movie_free ();
+  /* once all the images are released */
+  sprite_packs_free ();
   free_precalulate_sinus ();
   configfile_save ();
   configfile_free ();
+  /* once the tables and the files of the loaders are forgotten */
+  arenas_free ();
 }
@@ -0,0 +1,358 @@
+/**
+ * @file input_replay.c
+ * @brief Record the inputs of each frame to a file and replay them
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "config_file.h"
+#include "display.h"
+#include "game_rand.h"
+#include "input_replay.h"
+#include "log_recorder.h"
+#include "sprites_string.h"
+
+/** "PMRP" */
+#define INPUT_REPLAY_MAGIC 0x50524d50
+#define INPUT_REPLAY_VERSION 1
+/** Header: magic, version, seed and difficulty */
+#define INPUT_REPLAY_HEADER_SIZE 4
+
+/** Words of the state of the inputs during one frame */
+typedef enum
+{
+  /** Keys K_ESCAPE to K_0 */
+  INPUT_KEYS_LOW,
+  /** Keys K_A to K_PAGEDOWN, then fire, option and start buttons
+   * and the mouse buttons */
+  INPUT_KEYS_HIGH,
+  /** Mouse abscissa and ordinate, 16 bits each */
+  INPUT_MOUSE,
+  /** Last key pressed, read by the movies and the menu */
+  INPUT_KEY_CODE_DOWN,
+  /** Key code, key symbol and joystick code used to input
+   * the player's name */
+  INPUT_KEYCODE,
+  INPUT_KEYSYM,
+  INPUT_JOYCODE,
+  INPUT_STATE_SIZE
+} INPUT_STATE_ENUM;
+
+#define INPUT_FIRE_BIT (1 << 24)
+#define INPUT_OPTION_BIT (1 << 25)
+#define INPUT_START_BIT (1 << 26)
+#define INPUT_MOUSE_B_SHIFT 28
+
+/** A record of the file: number of frames followed by the state of
+ * the inputs during these frames, a record is written only when the
+ * inputs change */
+#define INPUT_REPLAY_RECORD_SIZE (1 + INPUT_STATE_SIZE)
+
+/** File being written or read, NULL if neither mode is enabled */
+static FILE *replay_file = NULL;
+/** TRUE if the inputs are read from the file */
+static bool is_replaying = FALSE;
+/** State of the inputs of the current record */
+static Uint32 current_state[INPUT_STATE_SIZE];
+/** Number of frames remaining or already seen in the current record */
+static Uint32 current_repeat = 0;
+/** Total number of frames recorded or replayed */
+static Uint32 frames_count = 0;
+
+/**
+ * Read the current state of the inputs
+ * @param state Array of INPUT_STATE_SIZE words
+ */
+static void
+input_state_get (Uint32 * state)
+{
+  Uint32 i;
+  for (i = 0; i < INPUT_STATE_SIZE; i++)
+    {
+      state[i] = 0;
+    }
+  for (i = 0; i < MAX_OF_KEYS_DOWN; i++)
+    {
+      if (keys_down[i])
+        {
+          state[INPUT_KEYS_LOW + (i >> 5)] |= (Uint32) 1 << (i & 31);
+        }
+    }
+  if (fire_button_down)
+    {
+      state[INPUT_KEYS_HIGH] |= INPUT_FIRE_BIT;
+    }
+  if (option_button_down)
+    {
+      state[INPUT_KEYS_HIGH] |= INPUT_OPTION_BIT;
+    }
+  if (start_button_down)
+    {
+      state[INPUT_KEYS_HIGH] |= INPUT_START_BIT;
+    }
+  state[INPUT_KEYS_HIGH] |= (Uint32) (mouse_b & 15) << INPUT_MOUSE_B_SHIFT;
+  state[INPUT_MOUSE] =
+    ((Uint32) mouse_x & 0xffff) | ((Uint32) mouse_y << 16);
+  state[INPUT_KEY_CODE_DOWN] = key_code_down;
+  sprites_string_get_key (&state[INPUT_KEYCODE], &state[INPUT_KEYSYM]);
+  state[INPUT_JOYCODE] = sprites_string_get_joy ();
+}
+
+/**
+ * Overwrite the inputs read by the display with a recorded state
+ * @param state Array of INPUT_STATE_SIZE words
+ */
+static void
+input_state_set (const Uint32 * state)
+{
+  Uint32 i, code, sym;
+  for (i = 0; i < MAX_OF_KEYS_DOWN; i++)
+    {
+      keys_down[i] =
+        (state[INPUT_KEYS_LOW + (i >> 5)] & ((Uint32) 1 << (i & 31))) ?
+        TRUE : FALSE;
+    }
+  fire_button_down = (state[INPUT_KEYS_HIGH] & INPUT_FIRE_BIT) ? TRUE : FALSE;
+  option_button_down =
+    (state[INPUT_KEYS_HIGH] & INPUT_OPTION_BIT) ? TRUE : FALSE;
+  start_button_down =
+    (state[INPUT_KEYS_HIGH] & INPUT_START_BIT) ? TRUE : FALSE;
+  mouse_b = (Sint32) (state[INPUT_KEYS_HIGH] >> INPUT_MOUSE_B_SHIFT);
+  mouse_x = (Sint16) (state[INPUT_MOUSE] & 0xffff);
+  mouse_y = (Sint16) (state[INPUT_MOUSE] >> 16);
+  key_code_down = state[INPUT_KEY_CODE_DOWN];
+
+  /* the input of the player's name sees only the key presses
+   * and releases */
+  sprites_string_get_key (&code, &sym);
+  if (code != state[INPUT_KEYCODE] || sym != state[INPUT_KEYSYM])
+    {
+      if (code != 0 || sym != 0)
+        {
+          sprites_string_key_up (code, sym);
+        }
+      if (state[INPUT_KEYCODE] != 0 || state[INPUT_KEYSYM] != 0)
+        {
+          sprites_string_key_down (state[INPUT_KEYCODE],
+                                   state[INPUT_KEYSYM]);
+        }
+    }
+  code = sprites_string_get_joy ();
+  if (code != state[INPUT_JOYCODE])
+    {
+      if (code != 0)
+        {
+          sprites_string_clr_joy (code);
+        }
+      if (state[INPUT_JOYCODE] != 0)
+        {
+          sprites_string_set_joy (state[INPUT_JOYCODE]);
+        }
+    }
+}
+
+/**
+ * Write the current record to the file
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+input_replay_write_record (void)
+{
+  Uint32 i;
+  Sint32 record[INPUT_REPLAY_RECORD_SIZE];
+  if (current_repeat == 0)
+    {
+      return TRUE;
+    }
+  int_to_little_endian ((Sint32) current_repeat, &record[0]);
+  for (i = 0; i < INPUT_STATE_SIZE; i++)
+    {
+      int_to_little_endian ((Sint32) current_state[i], &record[1 + i]);
+    }
+  if (fwrite (record, sizeof (record), 1, replay_file) != 1)
+    {
+      LOG_ERR ("fwrite() failed!");
+      return FALSE;
+    }
+  return TRUE;
+}
+
+/**
+ * Read the next record of the file
+ * @return TRUE if a record was read, FALSE at the end of the file
+ */
+static bool
+input_replay_read_record (void)
+{
+  Uint32 i;
+  Sint32 record[INPUT_REPLAY_RECORD_SIZE];
+  if (fread (record, sizeof (record), 1, replay_file) != 1)
+    {
+      return FALSE;
+    }
+  current_repeat = (Uint32) little_endian_to_int (&record[0]);
+  for (i = 0; i < INPUT_STATE_SIZE; i++)
+    {
+      current_state[i] = (Uint32) little_endian_to_int (&record[1 + i]);
+    }
+  return current_repeat > 0;
+}
+
+/**
+ * Open the file given with "--record" or "--replay". In replay mode
+ * the seed and the difficulty of the recorded game are restored
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+input_replay_init (void)
+{
+  Sint32 header[INPUT_REPLAY_HEADER_SIZE];
+  frames_count = 0;
+  current_repeat = 0;
+  if (power_conf->replay_file != NULL)
+    {
+      replay_file = fopen_data (power_conf->replay_file, "rb");
+      if (replay_file == NULL)
+        {
+          return FALSE;
+        }
+      if (fread (header, sizeof (header), 1, replay_file) != 1
+          || little_endian_to_int (&header[0]) != INPUT_REPLAY_MAGIC)
+        {
+          LOG_ERR ("%s is not a replay file", power_conf->replay_file);
+          return FALSE;
+        }
+      if (little_endian_to_int (&header[1]) != INPUT_REPLAY_VERSION)
+        {
+          LOG_ERR ("%s: unsupported replay version %i",
+                   power_conf->replay_file, little_endian_to_int (&header[1]));
+          return FALSE;
+        }
+      power_conf->seed = little_endian_to_int (&header[2]);
+      power_conf->difficulty = little_endian_to_int (&header[3]);
+      is_replaying = TRUE;
+      LOG_INF ("replay %s; seed: %i; difficulty: %i",
+               power_conf->replay_file, power_conf->seed,
+               power_conf->difficulty);
+      return TRUE;
+    }
+  if (power_conf->record_file != NULL)
+    {
+      replay_file = fopen_data (power_conf->record_file, "wb");
+      if (replay_file == NULL)
+        {
+          return FALSE;
+        }
+      int_to_little_endian (INPUT_REPLAY_MAGIC, &header[0]);
+      int_to_little_endian (INPUT_REPLAY_VERSION, &header[1]);
+      int_to_little_endian (power_conf->seed, &header[2]);
+      int_to_little_endian (power_conf->difficulty, &header[3]);
+      if (fwrite (header, sizeof (header), 1, replay_file) != 1)
+        {
+          LOG_ERR ("fwrite() failed!");
+          return FALSE;
+        }
+      is_replaying = FALSE;
+      LOG_INF ("record the inputs to %s", power_conf->record_file);
+    }
+  return TRUE;
+}
+
+/**
+ * Record the inputs read by the display, or replace them by the
+ * recorded ones. Called once per frame, after the events were handled
+ * and before the next update_frame()
+ */
+void
+input_replay_update (void)
+{
+  Uint32 state[INPUT_STATE_SIZE];
+  Uint32 i;
+  if (replay_file == NULL)
+    {
+      return;
+    }
+  if (is_replaying)
+    {
+      if (current_repeat == 0 && !input_replay_read_record ())
+        {
+          LOG_INF ("end of the replay after %i frames; score: %i",
+                   frames_count, player_score);
+          quit_game = TRUE;
+          return;
+        }
+      input_state_set (current_state);
+      current_repeat--;
+      frames_count++;
+      return;
+    }
+
+  /* record: a new record only when the inputs change */
+  input_state_get (state);
+  frames_count++;
+  if (current_repeat > 0)
+    {
+      for (i = 0; i < INPUT_STATE_SIZE; i++)
+        {
+          if (state[i] != current_state[i])
+            {
+              break;
+            }
+        }
+      if (i == INPUT_STATE_SIZE)
+        {
+          current_repeat++;
+          return;
+        }
+      if (!input_replay_write_record ())
+        {
+          quit_game = TRUE;
+          return;
+        }
+    }
+  for (i = 0; i < INPUT_STATE_SIZE; i++)
+    {
+      current_state[i] = state[i];
+    }
+  current_repeat = 1;
+}
+
+/**
+ * Write the last record and close the file
+ */
+void
+input_replay_free (void)
+{
+  if (replay_file == NULL)
+    {
+      return;
+    }
+  if (!is_replaying)
+    {
+      input_replay_write_record ();
+      LOG_INF ("%i frames recorded to %s; score: %i", frames_count,
+               power_conf->record_file, player_score);
+    }
+  fclose (replay_file);
+  replay_file = NULL;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file input_replay.h
+ * @brief Record the inputs of each frame to a file and replay them
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __INPUT_REPLAY__
+#define __INPUT_REPLAY__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  bool input_replay_init (void);
+  void input_replay_update (void);
+  void input_replay_free (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
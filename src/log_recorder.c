@@ -29,6 +29,9 @@
 #include "tools.h"
 #include "log_recorder.h"
 #include <time.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #if defined(POWERMANGA_LOG_ENABLED)
 #if defined(UNDER_DEVELOPMENT)
@@ -46,6 +49,11 @@ static LOG_LEVELS verbose_level = LOG_NOTHING;
 #if !defined(_WIN32_WCE)
 static struct tm *cur_time = NULL;
 #endif
+#ifdef HAVE_PTHREAD_H
+/** Protect the message buffers, the assets are loaded by several
+ * threads */
+static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 static const char *log_levels[LOG_NUMOF] = {
   "(--)",
@@ -345,7 +353,13 @@ log_message (LOG_LEVELS level, const char *filename, Sint32 line_num,
     }
   va_start (args, function);
   format = va_arg (args, const char *);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&log_mutex);
+#endif
   write_log (level, filename, line_num, function, format, args);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&log_mutex);
+#endif
   va_end (args);
 }
 #endif
@@ -28,6 +28,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "curve_phase.h"
 #include "display.h"
@@ -129,7 +130,7 @@ lonely_foe_add_gozuky (enemy * foe, Uint32 cannon_pos)
               spr->img[spr->
                        current_image]->cannons_coords[cannon_pos][YCOORD]);
   power = (Sint16) ((ship->type << 1) + 10);
-  current_image = (Sint16) (rand () % ENEMIES_SPECIAL_NUM_OF_IMAGES);
+  current_image = (Sint16) (game_rand () % ENEMIES_SPECIAL_NUM_OF_IMAGES);
   foe = lonely_foe_new (power, power, current_image, GOZUKY, 6000);
   if (foe == NULL)
     {
@@ -154,7 +155,7 @@ lonely_foe_curve_create (Sint32 type, Sint32 shot_delay)
   Sint16 curve_num;
   Sint16 current_image, power, energy;
   spaceship_struct *ship = spaceship_get ();
-  curve_num = 51 + (Sint16) (rand () % 4);
+  curve_num = 51 + (Sint16) (game_rand () % 4);
   current_image = initial_curve[curve_num].angle[0];
   power = (Sint16) ((ship->type << 1) + type - 40);
   energy = (Sint16) ((ship->type << 2) + (power << 3) / 3 + 10);
@@ -188,7 +189,7 @@ lonely_foe_add (Sint32 foe_num)
 {
   enemy *foe;
   spaceship_struct *ship = spaceship_get ();
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_LONELY_FOE);
 #endif
 
@@ -201,7 +202,7 @@ lonely_foe_add (Sint32 foe_num)
         {
           /* select a foe randomly */
           lonely_foes_count = LONELY_FOES_MAX_OF;
-          foe_num = (Sint32) (((long) rand () % lonely_foes_count));
+          foe_num = (Sint32) (((long) game_rand () % lonely_foes_count));
         }
       /* select one after the other all the foes available */
       else
@@ -219,7 +220,8 @@ lonely_foe_add (Sint32 foe_num)
       /* SUBJUGANEERS */
     case LONELY_SUBJUGANEERS:
       foe = lonely_foe_create (4, SUBJUGANEERS,
-                               60 + (Sint32) (((long) rand () % (50))), -0.5);
+                               60 + (Sint32) (((long) game_rand () % (50))),
+                               -0.5);
       if (foe == NULL)
         {
           break;
@@ -228,7 +230,7 @@ lonely_foe_add (Sint32 foe_num)
         = (float) (offscreen_startx + 64 + offscreen_width_visible);
       foe->spr.ycoord =
         offscreen_starty +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_height_visible - foe->spr.img[0]->h)));
       break;
 
@@ -241,7 +243,7 @@ lonely_foe_add (Sint32 foe_num)
         }
       foe->spr.xcoord =
         (float) (offscreen_startx +
-                 ((long) rand () %
+                 ((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -250,14 +252,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_SWORDINIANS:
       foe =
         lonely_foe_create (4, SWORDINIANS,
-                           50 + (Sint32) ((long) rand () % (50)), -0.3f);
+                           50 + (Sint32) ((long) game_rand () % (50)), -0.3f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord
         = (float) offscreen_starty + 64 + offscreen_height_visible;
@@ -272,7 +274,7 @@ lonely_foe_add (Sint32 foe_num)
         }
       foe->spr.xcoord =
         (float) (offscreen_startx +
-                 ((long) rand () %
+                 ((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -281,14 +283,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_DISGOOSTEES:
       foe =
         lonely_foe_create (4, DISGOOSTEES,
-                           50 + (Sint32) ((long) rand () % (50)), 0.6f);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -297,14 +299,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_EARTHINIANS:
       foe =
         lonely_foe_create (4, EARTHINIANS,
-                           50 + (Sint32) ((long) rand () % (50)), 0.6f);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -313,14 +315,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_BIRIANSTEES:
       foe =
         lonely_foe_create (4, BIRIANSTEES,
-                           50 + (Sint32) ((long) rand () % (50)), 0.6f);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -329,14 +331,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_BELCHOUTIES:
       foe =
         lonely_foe_create (4, BELCHOUTIES,
-                           60 + (Sint32) ((long) rand () % (50)), 0.6f);
+                           60 + (Sint32) ((long) game_rand () % (50)), 0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -344,16 +346,17 @@ lonely_foe_add (Sint32 foe_num)
       /* VIONIEES */
     case LONELY_VIONIEES:
       foe =
-        lonely_foe_create (4, VIONIEES, 50 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, VIONIEES,
+                           50 + (Sint32) ((long) game_rand () % (50)),
                            2.0f +
-                           (float) (((long) rand () % (100))) / 100.0f);
+                           (float) (((long) game_rand () % (100))) / 100.0f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 32 - foe->spr.img[0]->h);
       foe->retournement = FALSE;
@@ -363,7 +366,8 @@ lonely_foe_add (Sint32 foe_num)
       /* HOCKYS */
     case LONELY_HOCKYS:
       foe =
-        lonely_foe_create (4, HOCKYS, 50 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, HOCKYS,
+                           50 + (Sint32) ((long) game_rand () % (50)),
                            -0.4f);
       if (foe == NULL)
         {
@@ -371,7 +375,7 @@ lonely_foe_add (Sint32 foe_num)
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord
         = (float) (offscreen_starty + 64 + offscreen_height_visible);
@@ -381,14 +385,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_TODHAIRIES:
       foe =
         lonely_foe_create (4, TODHAIRIES,
-                           60 + (Sint32) ((long) rand () % (60)), 0.6f);
+                           60 + (Sint32) ((long) game_rand () % (60)), 0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -397,14 +401,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_DEFECTINIANS:
       foe =
         lonely_foe_create (4, DEFECTINIANS,
-                           60 + (Sint32) ((long) rand () % (60)), 0.6f);
+                           60 + (Sint32) ((long) game_rand () % (60)), 0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -412,13 +416,14 @@ lonely_foe_add (Sint32 foe_num)
       /* BLAVIRTHE */
     case LONELY_BLAVIRTHE:
       lonely_foe_curve_create (BLAVIRTHE,
-                               60 + (Sint32) (((long) rand () % (60))));
+                               60 + (Sint32) (((long) game_rand () % (60))));
       break;
 
       /* SOONIEES */
     case LONELY_SOONIEES:
       foe =
-        lonely_foe_create (4, SOONIEES, 60 + (Sint32) ((long) rand () % (60)),
+        lonely_foe_create (4, SOONIEES,
+                           60 + (Sint32) ((long) game_rand () % (60)),
                            0.6f);
       if (foe == NULL)
         {
@@ -426,7 +431,7 @@ lonely_foe_add (Sint32 foe_num)
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -434,16 +439,17 @@ lonely_foe_add (Sint32 foe_num)
       /* ANGOUFF */
     case LONELY_ANGOUFF:
       foe =
-        lonely_foe_create (4, ANGOUFF, 50 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, ANGOUFF,
+                           50 + (Sint32) ((long) game_rand () % (50)),
                            2.0f +
-                           (float) (((long) rand () % (100))) / 100.0f);
+                           (float) (((long) game_rand () % (100))) / 100.0f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 32 - foe->spr.img[0]->h);
       foe->retournement = FALSE;
@@ -453,7 +459,8 @@ lonely_foe_add (Sint32 foe_num)
       /* GAFFIES */
     case LONELY_GAFFIES:
       foe =
-        lonely_foe_create (6, GAFFIES, 60 + (Sint32) ((long) rand () % (60)),
+        lonely_foe_create (6, GAFFIES,
+                           60 + (Sint32) ((long) game_rand () % (60)),
                            0.2f);
       if (foe == NULL)
         {
@@ -461,7 +468,7 @@ lonely_foe_add (Sint32 foe_num)
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -470,7 +477,7 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_BITTERIANS:
       foe =
         lonely_foe_create (4, BITTERIANS,
-                           60 + (Sint32) ((long) rand () % (50)), -0.5);
+                           60 + (Sint32) ((long) game_rand () % (50)), -0.5);
       if (foe == NULL)
         {
           break;
@@ -479,28 +486,28 @@ lonely_foe_add (Sint32 foe_num)
         = (float) (offscreen_startx + 64 + offscreen_width_visible);
       foe->spr.ycoord =
         offscreen_starty +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_height_visible - foe->spr.img[0]->h)));
       break;
 
       /* BLEUERCKS */
     case LONELY_BLEUERCKS:
       lonely_foe_curve_create (BLEUERCKS,
-                               50 + (Sint32) (((long) rand () % (50))));
+                               50 + (Sint32) (((long) game_rand () % (50))));
       break;
 
       /* ARCHINIANS */
     case LONELY_ARCHINIANS:
       foe =
         lonely_foe_create (4, ARCHINIANS,
-                           60 + (Sint32) ((long) rand () % (50)), -0.2f);
+                           60 + (Sint32) ((long) game_rand () % (50)), -0.2f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord
         = (float) (offscreen_starty + 64 + offscreen_height_visible);
@@ -509,16 +516,17 @@ lonely_foe_add (Sint32 foe_num)
       /* CLOWNIES */
     case LONELY_CLOWNIES:
       foe =
-        lonely_foe_create (4, CLOWNIES, 50 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, CLOWNIES,
+                           50 + (Sint32) ((long) game_rand () % (50)),
                            2.5f +
-                           (float) (((long) rand () % (100))) / 100.0f);
+                           (float) (((long) game_rand () % (100))) / 100.0f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       foe->retournement = FALSE;
@@ -529,14 +537,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_DEMONIANS:
       foe =
         lonely_foe_create (4, DEMONIANS,
-                           50 + (Sint32) ((long) rand () % (50)), 0.5);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.5);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -544,7 +552,8 @@ lonely_foe_add (Sint32 foe_num)
       /* TOUTIES */
     case LONELY_TOUTIES:
       foe =
-        lonely_foe_create (4, TOUTIES, 60 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, TOUTIES,
+                           60 + (Sint32) ((long) game_rand () % (50)),
                            -0.35f);
       if (foe == NULL)
         {
@@ -554,7 +563,7 @@ lonely_foe_add (Sint32 foe_num)
         = (float) (offscreen_startx + 64 + offscreen_width_visible);
       foe->spr.ycoord =
         offscreen_starty +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_height_visible - foe->spr.img[0]->h)));
       break;
 
@@ -562,7 +571,7 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_FIDGETINIANS:
       foe =
         lonely_foe_create (4, FIDGETINIANS,
-                           50 + (Sint32) ((long) rand () % (50)), 0.5);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.5);
       if (foe == NULL)
         {
           break;
@@ -570,7 +579,7 @@ lonely_foe_add (Sint32 foe_num)
       foe->spr.speed = 0.5;
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -578,16 +587,17 @@ lonely_foe_add (Sint32 foe_num)
       /* EFFIES */
     case LONELY_EFFIES:
       foe =
-        lonely_foe_create (4, EFFIES, 50 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, EFFIES,
+                           50 + (Sint32) ((long) game_rand () % (50)),
                            2.5f +
-                           (float) (((long) rand () % (100))) / 100.0f);
+                           (float) (((long) game_rand () % (100))) / 100.0f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       foe->retournement = FALSE;
@@ -598,14 +608,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_DIMITINIANS:
       foe =
         lonely_foe_create (6, DIMITINIANS,
-                           50 + (Sint32) ((long) rand () % (50)), 0.3f);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.3f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       foe->sens_anim = 0;
@@ -614,7 +624,8 @@ lonely_foe_add (Sint32 foe_num)
       /* PAINIANS */
     case LONELY_PAINIANS:
       foe =
-        lonely_foe_create (4, PAINIANS, 60 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, PAINIANS,
+                           60 + (Sint32) ((long) game_rand () % (50)),
                            0.5);
       if (foe == NULL)
         {
@@ -623,7 +634,7 @@ lonely_foe_add (Sint32 foe_num)
       foe->spr.xcoord = (float) (offscreen_startx - 64 - foe->spr.img[0]->w);
       foe->spr.ycoord =
         offscreen_starty +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_height_visible - foe->spr.img[0]->h)));
       break;
 
@@ -631,14 +642,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_ENSLAVEERS:
       foe =
         lonely_foe_create (4, ENSLAVEERS,
-                           60 + (Sint32) ((long) rand () % (50)), +0.6f);
+                           60 + (Sint32) ((long) game_rand () % (50)), +0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -647,7 +658,7 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_FEABILIANS:
       foe =
         lonely_foe_create (3, FEABILIANS,
-                           60 + (Sint32) ((long) rand () % (50)), -0.5);
+                           60 + (Sint32) ((long) game_rand () % (50)), -0.5);
       if (foe == NULL)
         {
           break;
@@ -656,7 +667,7 @@ lonely_foe_add (Sint32 foe_num)
         = (float) (offscreen_startx + 64 + offscreen_width_visible);
       foe->spr.ycoord =
         offscreen_starty +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_height_visible - foe->spr.img[0]->h)));
       break;
 
@@ -664,14 +675,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_DIVERTIZERS:
       foe =
         lonely_foe_create (3, DIVERTIZERS,
-                           60 + (Sint32) ((long) rand () % (50)), +0.6f);
+                           60 + (Sint32) ((long) game_rand () % (50)), +0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) ((((long) rand () %
+        (float) ((((long) game_rand () %
                    (offscreen_width_visible - foe->spr.img[0]->w))));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -680,16 +691,17 @@ lonely_foe_add (Sint32 foe_num)
     case SAPOUCH:
     case LONELY_SAPOUCH:
       foe =
-        lonely_foe_create (4, SAPOUCH, 50 + (Sint32) ((long) rand () % (50)),
+        lonely_foe_create (4, SAPOUCH,
+                           50 + (Sint32) ((long) game_rand () % (50)),
                            2.5f +
-                           (float) (((long) rand () % (100))) / 100.0f);
+                           (float) (((long) game_rand () % (100))) / 100.0f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       foe->retournement = FALSE;
@@ -700,14 +712,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_HORRIBIANS:
       foe =
         lonely_foe_create (3, HORRIBIANS,
-                           60 + (Sint32) ((long) rand () % (50)), 0.6f);
+                           60 + (Sint32) ((long) game_rand () % (50)), 0.6f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) ((((long) rand () %
+        (float) ((((long) game_rand () %
                    (offscreen_width_visible - foe->spr.img[0]->w))));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -716,14 +728,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_CARRYONIANS:
       foe =
         lonely_foe_create (5, CARRYONIANS,
-                           60 + (Sint32) ((long) rand () % (50)), -0.2f);
+                           60 + (Sint32) ((long) game_rand () % (50)), -0.2f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord
         = (float) (offscreen_starty + 64 + offscreen_height_visible);
@@ -734,14 +746,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_DEVILIANS:
       foe =
         lonely_foe_create (5, DEVILIANS,
-                           60 + (Sint32) ((long) rand () % (50)), +0.5);
+                           60 + (Sint32) ((long) game_rand () % (50)), +0.5);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) ((((long) rand () %
+        (float) ((((long) game_rand () %
                    (offscreen_width_visible - foe->spr.img[0]->w))));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -750,14 +762,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_ROUGHLEERS:
       foe =
         lonely_foe_create (6, ROUGHLEERS,
-                           50 + (Sint32) ((long) rand () % (50)), 0.5);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.5);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -766,14 +778,14 @@ lonely_foe_add (Sint32 foe_num)
     case LONELY_ABASCUSIANS:
       foe =
         lonely_foe_create (4, ABASCUSIANS,
-                           50 + (Sint32) ((long) rand () % (50)), 0.5);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.5);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -781,27 +793,27 @@ lonely_foe_add (Sint32 foe_num)
       /* ROTIES */
     case LONELY_ROTIES:
       lonely_foe_curve_create (ROTIES,
-                               50 + (Sint32) (((long) rand () % (50))));
+                               50 + (Sint32) (((long) game_rand () % (50))));
       break;
 
       /* STENCHIES */
     case LONELY_STENCHIES:
       lonely_foe_curve_create (STENCHIES,
-                               50 + (Sint32) (((long) rand () % (50))));
+                               50 + (Sint32) (((long) game_rand () % (50))));
       break;
 
       /* PERTURBIANS */
     case LONELY_PERTURBIANS:
       foe =
         lonely_foe_create (6, PERTURBIANS,
-                           50 + (Sint32) ((long) rand () % (50)), 0.2f);
+                           50 + (Sint32) ((long) game_rand () % (50)), 0.2f);
       if (foe == NULL)
         {
           break;
         }
       foe->spr.xcoord =
         offscreen_startx +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_width_visible - foe->spr.img[0]->w)));
       foe->spr.ycoord = (float) (offscreen_starty - 64 - foe->spr.img[0]->h);
       break;
@@ -809,13 +821,14 @@ lonely_foe_add (Sint32 foe_num)
       /* MADIRIANS */
     case LONELY_MADIRIANS:
       lonely_foe_curve_create (MADIRIANS,
-                               50 + (Sint32) (((long) rand () % (50))));
+                               50 + (Sint32) (((long) game_rand () % (50))));
       break;
 
       /* BAINIES */
     case LONELY_BAINIES:
       foe =
-        lonely_foe_create (4, BAINIES, 50 + (Sint32) ((long) rand () % (40)),
+        lonely_foe_create (4, BAINIES,
+                           50 + (Sint32) ((long) game_rand () % (40)),
                            0.4f);
       if (foe == NULL)
         {
@@ -824,7 +837,7 @@ lonely_foe_add (Sint32 foe_num)
       foe->spr.xcoord = (float) (offscreen_startx - 64 - foe->spr.img[0]->w);
       foe->spr.ycoord =
         offscreen_starty +
-        (float) (((long) rand () %
+        (float) (((long) game_rand () %
                   (offscreen_height_visible - foe->spr.img[0]->h)));
       break;
 
@@ -841,7 +854,7 @@ lonely_foe_add (Sint32 foe_num)
       foe->spr.speed = 2.0;
       foe->spr.xcoord = (float) (offscreen_startx - 64 - foe->spr.img[0]->w);
       foe->spr.ycoord =
-        offscreen_starty + 48 + (float) (((long) rand () % 32));
+        offscreen_starty + 48 + (float) (((long) game_rand () % 32));
       break;
     }
 }
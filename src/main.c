@@ -26,6 +26,8 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
+#include "bench.h"
 #include "images.h"
 #include "config_file.h"
 #include "curve_phase.h"
@@ -39,11 +41,13 @@
 #include "extra_gun.h"
 #include "gfx_wrapper.h"
 #include "guardians.h"
+#include "input_replay.h"
 #include "menu.h"
 #include "meteors_phase.h"
 #include "movie.h"
 #include "log_recorder.h"
 #include "options_panel.h"
+#include "profiler.h"
 #include "scrolltext.h"
 #include "satellite_protections.h"
 #include "script_page.h"
@@ -57,23 +61,23 @@
 
 /* TRUE = leave the Powermanga game */
 bool quit_game = FALSE;
-static Sint32 pause_delay = 0;
-static Sint32 frame_diff = 0;
+/** Time not simulated yet, in microseconds */
+static Uint64 time_accumulator = 0;
+/** Time of the previous iteration of the main loop, in microseconds */
+static Uint64 time_previous = 0;
 
-#ifdef POWERMANGA_SDL
-/* game speed : 70 frames/sec (1000 <=> 1 seconde ; 1000 / 70 =~ 14) */
-static const Uint32 GAME_FRAME_RATE = 14;
-/* movie speed: 28 frames/sec */
-static const Uint32 MOVIE_FRAME_RATE = 35;
-#else
 /* game speed : 70 frames/sec (1000000 <=> 1 seconde ; 1000000 / 70 =~ 14286) */
 static const Uint32 GAME_FRAME_RATE = 14286;
 /* movie speed: 28 frames/sec */
 static const Uint32 MOVIE_FRAME_RATE = 35715;
-#endif
+/** Maximum number of frames simulated before one display, beyond
+ * the game slows down */
+#define MAX_FRAMES_PER_DISPLAY 4
 
 static bool initialize_and_run (void);
 static void main_loop (void);
+static Uint32 frames_to_simulate (void);
+static void bench_iteration (void);
 
 /**
  * Returns to the standard GP2X menu.
@@ -129,6 +133,7 @@ main (Sint32 args_count, char **arguments)
   /* load config file */
   if (!configfile_load ())
     {
+      arenas_free ();
 #if defined (USE_MALLOC_WRAPPER)
       memory_releases_all ();
 #endif
@@ -250,6 +255,12 @@ initialize_and_run (void)
     }
 #endif
 
+  if (power_conf->bench_sprites > 0)
+    {
+      bench_sprites ((Uint32) power_conf->bench_sprites);
+      return TRUE;
+    }
+
 #ifdef SHAREWARE_VERSION
   /* update counter */
   Sint32 cpt = counter_shareware_update ("PowerManga", 0, 8);
@@ -273,8 +284,23 @@ initialize_and_run (void)
 #endif
 
   fps_init ();
+  bench_init ();
   main_loop ();
   fps_print ();
+#ifdef USE_PROFILER
+  if (power_conf->profile_file != NULL)
+    {
+      profiler_export (power_conf->profile_file);
+    }
+#endif
+  if (power_conf->bench_frames > 0)
+    {
+      bench_print ();
+#ifdef USE_SCALE2X
+      bench_scale (100);
+      bench_scale_areas ();
+#endif
+    }
 
 #ifdef SHAREWARE_VERSION
   /* displaying of the third page order */
@@ -297,6 +323,52 @@ initialize_and_run (void)
   return TRUE;
 }
 
+/**
+ * Wait for the next frame and return the number of frames to simulate
+ * to catch up with the clock. When the display takes longer than one
+ * frame, several frames are simulated before the next display: the
+ * display rate drops but the game keeps its speed
+ * @return Number of frames to simulate, 0 if it is too early
+ */
+static Uint32
+frames_to_simulate (void)
+{
+  Uint32 frames, period;
+  Uint64 now = get_ticks_usec ();
+  if (movie_playing_switch != MOVIE_NOT_PLAYED)
+    {
+      period = MOVIE_FRAME_RATE;
+    }
+  else
+    {
+      period = GAME_FRAME_RATE;
+    }
+  if (time_previous == 0)
+    {
+      /* first iteration: simulate a frame at once */
+      time_previous = now;
+      time_accumulator = period;
+    }
+  time_accumulator += now - time_previous;
+  time_previous = now;
+  if (time_accumulator < period)
+    {
+      wait_usec ((Uint32) (period - time_accumulator));
+      now = get_ticks_usec ();
+      time_accumulator += now - time_previous;
+      time_previous = now;
+    }
+  frames = (Uint32) (time_accumulator / period);
+  time_accumulator -= (Uint64) frames * period;
+  if (frames > MAX_FRAMES_PER_DISPLAY)
+    {
+      /* too late, forget the time lost */
+      frames = MAX_FRAMES_PER_DISPLAY;
+      time_accumulator = 0;
+    }
+  return frames;
+}
+
 /**
  * Main lopp iteration
  * need to separate iteration from the main loop for emscripten version
@@ -304,38 +376,99 @@ initialize_and_run (void)
 void
 main_loop_iteration (void)
 {
-  loops_counter++;
-  if (!power_conf->nosync)
+  Uint32 frames;
+  if (power_conf->bench_frames > 0)
     {
-      frame_diff = get_time_difference ();
-      if (movie_playing_switch != MOVIE_NOT_PLAYED)
+      loops_counter++;
+      PROFILER_FRAME ();
+      bench_iteration ();
+      return;
+    }
+  if (power_conf->nosync)
+    {
+      frames = 1;
+    }
+  else
+    {
+      frames = frames_to_simulate ();
+      if (frames == 0)
         {
-          pause_delay =
-            wait_next_frame (MOVIE_FRAME_RATE - frame_diff + pause_delay,
-                             MOVIE_FRAME_RATE);
+          return;
         }
-      else
+    }
+
+  /* simulate the frames late, only the last one is drawn and
+   * displayed */
+  while (frames-- > 0 && !quit_game)
+    {
+      offscreen_draw_enable = frames == 0;
+      loops_counter++;
+      PROFILER_FRAME ();
+      /* handle Powermanga game */
+      PROFILER_BEGIN (PROFILER_UPDATE_FRAME);
+      if (!update_frame ())
         {
-          pause_delay =
-            wait_next_frame (GAME_FRAME_RATE - frame_diff + pause_delay,
-                             GAME_FRAME_RATE);
+          quit_game = TRUE;
         }
+      PROFILER_END (PROFILER_UPDATE_FRAME);
+      /* handle keyboard and joystick events */
+      PROFILER_BEGIN (PROFILER_HANDLE_EVENTS);
+      display_handle_events ();
+      /* record the inputs, or replace them by the recorded ones */
+      input_replay_update ();
+      PROFILER_END (PROFILER_HANDLE_EVENTS);
     }
-  /* handle Powermanga game */
+  offscreen_draw_enable = TRUE;
+
+  /* update our main window */
+  PROFILER_BEGIN (PROFILER_UPDATE_WINDOW);
+  display_update_window ();
+  PROFILER_END (PROFILER_UPDATE_WINDOW);
+  frames_displayed++;
+
+#ifdef USE_SOUND
+  /* play music and sounds */
+  PROFILER_BEGIN (PROFILER_SOUND);
+  sound_handle ();
+  PROFILER_END (PROFILER_SOUND);
+#endif
+}
+
+/**
+ * Main loop iteration in benchmark mode, time spent in each phase is
+ * measured and the game is stopped after the requested number of frames
+ */
+static void
+bench_iteration (void)
+{
+  Uint64 start = get_ticks_usec ();
+  PROFILER_BEGIN (PROFILER_UPDATE_FRAME);
   if (!update_frame ())
     {
       quit_game = TRUE;
     }
-  /* handle keyboard and joystick events */
+  PROFILER_END (PROFILER_UPDATE_FRAME);
+  start = bench_phase_add (BENCH_UPDATE_FRAME, start);
+  PROFILER_BEGIN (PROFILER_HANDLE_EVENTS);
   display_handle_events ();
-
-  /* update our main window */
+  input_replay_update ();
+  PROFILER_END (PROFILER_HANDLE_EVENTS);
+  start = bench_phase_add (BENCH_HANDLE_EVENTS, start);
+  PROFILER_BEGIN (PROFILER_UPDATE_WINDOW);
   display_update_window ();
-
-#ifdef USE_SDLMIXER
-  /* play music and sounds */
+  PROFILER_END (PROFILER_UPDATE_WINDOW);
+  frames_displayed++;
+  start = bench_phase_add (BENCH_UPDATE_WINDOW, start);
+#ifdef USE_SOUND
+  PROFILER_BEGIN (PROFILER_SOUND);
   sound_handle ();
+  PROFILER_END (PROFILER_SOUND);
 #endif
+  bench_phase_add (BENCH_SOUND, start);
+  if (loops_counter >= (Uint32) power_conf->bench_frames)
+    {
+      quit_game = TRUE;
+    }
 }
 
 /**
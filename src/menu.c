@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "config_file.h"
 #include "congratulations.h"
@@ -47,6 +48,7 @@
 #include "menu_sections.h"
 #include "meteors_phase.h"
 #include "options_panel.h"
+#include "prefetch.h"
 #include "satellite_protections.h"
 #include "scrolltext.h"
 #include "shockwave.h"
@@ -226,7 +228,7 @@ menu_item_selected (MENU_SELECTED item_num)
       /* disable scroll text */
       scrolltext_disable (SCROLL_PRESENT);
       menu_section_set (NO_SECTION_SELECTED);
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
       /* start music of the game */
       sound_music_play (MUSIC_GAME);
 #endif
@@ -364,9 +366,9 @@ menu_run (void)
 
       /* moving "TLK Games" logo sprite */
       /* "TLK Games" logo appearing? */
-      if (!tlk_logo_is_move && (rand () % 2500) == 500)
+      if (!tlk_logo_is_move && (game_rand () % 2500) == 500)
         {
-          if (rand () % 2)
+          if (game_rand () % 2)
             {
               tlk_logo_xcoord = 120;
             }
@@ -453,7 +455,7 @@ init_new_game (void)
 {
   LOG_DBG ("Initialize values before beging the game");
   /* initialize random generator */
-  srand (1);
+  game_rand_seed ((Uint32) power_conf->seed);
   texts_init ();
   energy_gauge_init ();
   /* close all options boxes (except spaceship repair)
@@ -481,6 +483,9 @@ init_new_game (void)
   gameover_enable = FALSE;
   /* level number (-1 start a new game, else 0 to 41) */
   num_level = -1;
+  /* the first level begins at the first frame of the game, its data
+   * are already loaded unless a previous game used them */
+  prefetch_new_game ();
   /* refresh spaceship's energy gauge */
   energy_gauge_spaceship_is_update = TRUE;
   /* refresh guardian's energy gauge  */
@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "config_file.h"
 #include "display.h"
@@ -917,6 +918,12 @@ high_score_save (void)
 #endif
   const char *filename = score_filenames[power_conf->difficulty];
 
+  /* the scores of the benchmark autopilot are not kept */
+  if (power_conf->bench_frames > 0)
+    {
+      return;
+    }
+
   /* allocate a temporary buffer */
   filedata = memory_allocation (SIZE_OF_SCORES_FILE);
   if (filedata == NULL)
@@ -1604,8 +1611,9 @@ order_run (void)
                       }
                     else
                       {
-                        order_delay_counter = (Sint16) (30 + rand () % 30);
-                        if ((rand () % 100) < 25)
+                        order_delay_counter =
+                          (Sint16) (30 + game_rand () % 30);
+                        if ((game_rand () % 100) < 25)
                           {
                             order_delay_counter += 20;
                           }
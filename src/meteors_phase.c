@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "config_file.h"
 #include "curve_phase.h"
@@ -38,6 +39,7 @@
 #include "images.h"
 #include "log_recorder.h"
 #include "meteors_phase.h"
+#include "prefetch.h"
 #include "spaceship.h"
 #include "starfield.h"
 #include "texts.h"
@@ -49,6 +51,8 @@ Sint32 num_of_meteors = 0;
 #define METEOR_MAXOF_TYPES 3
 
 static image meteor_images[METEOR_MAXOF_TYPES][METEOR_NUMOF_IMAGES];
+/** Meteors sprite data of the next level, loaded in advance */
+static image meteor_next_images[METEOR_MAXOF_TYPES][METEOR_NUMOF_IMAGES];
 static Sint32 meteor_delay_next = 0;
 static bool next_level_without_guardian (void);
 
@@ -109,7 +113,7 @@ meteors_handle (void)
     }
 
   /* size of the meteor: 0, 1 or 2 */
-  meteor_size = rand () % 3;
+  meteor_size = game_rand () % 3;
   switch (meteor_size)
     {
     case 0:
@@ -137,7 +141,7 @@ meteors_handle (void)
   /* set number of images of the metor sprite */
   foe->spr.numof_images = METEOR_NUMOF_IMAGES;
   /* set current image */
-  foe->spr.current_image = (Sint16) (rand () % METEOR_NUMOF_IMAGES);
+  foe->spr.current_image = (Sint16) (game_rand () % METEOR_NUMOF_IMAGES);
   /* clear counter delay before next image */
   foe->spr.anim_count = 0;
   /* set addresses of the images buffer */
@@ -156,7 +160,7 @@ meteors_handle (void)
   /* set x and y coordinates of the meteor  */
   foe->spr.xcoord =
     offscreen_startx +
-    (float) (rand () % (offscreen_width_visible - foe->spr.img[0]->w));
+    (float) (game_rand () % (offscreen_width_visible - foe->spr.img[0]->w));
   foe->spr.ycoord = (float) (offscreen_starty - 64);
   /* clear horizontal speed of the displacement */
   foe->x_speed = 0.0;
@@ -166,7 +170,7 @@ meteors_handle (void)
   foe->timelife = 210;
 
   /* set animation direction */
-  if (rand () % 2)
+  if (game_rand () % 2)
     {
       /* reverse animation direction */
       foe->sens_anim = -1;
@@ -276,6 +280,8 @@ meteors_finished (void)
             }
           /* enable the curve phase */
           curve_enable_level ();
+          /* the data of the next level are loaded during this one */
+          prefetch_level (num_level + 1);
           courbe.activity = TRUE;
           grid.is_enable = FALSE;
           meteor_activity = FALSE;
@@ -291,23 +297,8 @@ meteors_finished (void)
 void
 meteors_images_free (void)
 {
-  Sint32 i, j;
-  for (i = 0; i < (METEOR_MAXOF_TYPES); i++)
-    {
-      for (j = 0; j < METEOR_NUMOF_IMAGES; j++)
-        {
-          if (meteor_images[i][j].img != NULL)
-            {
-              free_memory (meteor_images[i][j].img);
-              meteor_images[i][j].img = NULL;
-            }
-          if (meteor_images[i][j].compress != NULL)
-            {
-              free_memory (meteor_images[i][j].compress);
-              meteor_images[i][j].compress = NULL;
-            }
-        }
-    }
+  images_free (&meteor_images[0][0], METEOR_MAXOF_TYPES,
+               METEOR_NUMOF_IMAGES, METEOR_NUMOF_IMAGES);
 }
 
 /**
@@ -318,27 +309,44 @@ meteors_images_free (void)
 bool
 meteors_load (Sint32 num_meteor)
 {
-  char *file, *data;
   meteors_images_free ();
   if (num_meteor > MAX_NUM_OF_LEVELS || num_meteor < 0)
     {
       num_meteor = 0;
     }
-  file =
-    loadfile_num ("graphics/sprites/meteors/meteor_%02d.spr", num_meteor);
-  if (file == NULL)
-    {
-      return FALSE;
-    }
-  data =
-    images_read (&meteor_images[0][0], METEOR_MAXOF_TYPES,
-                 METEOR_NUMOF_IMAGES, file, METEOR_NUMOF_IMAGES);
-  free_memory (file);
-  if (data == NULL)
+  if (prefetch_take (PREFETCH_METEORS, num_meteor))
     {
-      return FALSE;
+      memcpy (meteor_images, meteor_next_images, sizeof (meteor_images));
+      memset (meteor_next_images, 0, sizeof (meteor_next_images));
+      return TRUE;
     }
-  return TRUE;
+  return image_load_num ("graphics/sprites/meteors/meteor_%02d.spr",
+                         num_meteor, &meteor_images[0][0],
+                         METEOR_MAXOF_TYPES, METEOR_NUMOF_IMAGES);
+}
+
+/**
+ * Load meteors sprite data of the next level, called by the thread
+ * of prefetch.c
+ * @param num_meteor Meteors level number from 0 to 41
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+meteors_prefetch (Sint32 num_meteor)
+{
+  return image_load_num ("graphics/sprites/meteors/meteor_%02d.spr",
+                         num_meteor, &meteor_next_images[0][0],
+                         METEOR_MAXOF_TYPES, METEOR_NUMOF_IMAGES);
+}
+
+/**
+ * Release meteors sprite data of the next level which were not used
+ */
+void
+meteors_prefetch_discard (void)
+{
+  images_free (&meteor_next_images[0][0], METEOR_MAXOF_TYPES,
+               METEOR_NUMOF_IMAGES, METEOR_NUMOF_IMAGES);
 }
 
 
@@ -440,6 +448,8 @@ next_level_without_guardian (void)
         }
       /* enable the curve level file loaded previously */
       curve_enable_level ();
+      /* the data of the next level are loaded during this one */
+      prefetch_level (num_level + 1);
       /* grid phase enable */
       courbe.activity = TRUE;
       grid.is_enable = FALSE;
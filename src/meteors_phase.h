@@ -34,6 +34,8 @@ extern "C"
   bool meteors_once_init (void);
   void meteors_free (void);
   bool meteors_load (Sint32 meteor_num);
+  bool meteors_prefetch (Sint32 meteor_num);
+  void meteors_prefetch_discard (void);
 #ifdef PNG_EXPORT_ENABLE
   bool meteors_extract (void);
 #endif
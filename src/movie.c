@@ -33,27 +33,66 @@
 #include "display.h"
 #include "log_recorder.h"
 #include "movie.h"
+#include "movie_codec.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/** Number of frames of the ring: the frame displayed and the frames
+ * decoded in advance */
+#define MOVIE_RING_SIZE 4
+/** Number of frames skipped by the left and right keys: 2 seconds */
+#define MOVIE_SEEK_STEP 56
 
 /** Wich movie si played: 1=intro or 2=congratulation */
 Uint32 movie_playing_switch = MOVIE_INTRODUCTION;
 /** Pointer to the buffer for the current animation movie */
 unsigned char *movie_buffer = NULL;
-static unsigned char *image2 = NULL;
-static unsigned char *icmpr = NULL;
-static unsigned char *smage1 = NULL;
-static unsigned char *smage2 = NULL;
-static unsigned char *scmpr = NULL;
-/** Pointer to the filedata of the movie in memory */
-static unsigned char *movie_filedata = NULL;
-/* pointer to the colormap in the file */
+/** Frames and chunk of the file, allocated together */
+static unsigned char *movie_memory = NULL;
+/** Ring of the frames, the frame n is in movie_ring[n % MOVIE_RING_SIZE] */
+static unsigned char *movie_ring[MOVIE_RING_SIZE];
+/** Black frame: the frame 0 and the previous frame of the keyframes */
+static unsigned char *movie_black = NULL;
+/** Movie file being read */
+static FILE *movie_file = NULL;
+/** Header of the movie file */
+static movie_header movie_info;
+/** Compressed frames read from the movie file */
+static movie_stream movie_frames;
+/** Offsets of the frames of an indexed movie, NULL otherwise */
+static Uint32 *movie_offsets = NULL;
+/** Number of the frame displayed */
 static Sint32 movie_counter = 0;
-static Sint32 images = 0;
+/** Number of the last frame decoded */
+static Sint32 movie_decoded = 0;
+/** TRUE if the movie file is truncated or corrupt */
+static bool movie_failed = FALSE;
+/** TRUE while the left or right key is held down */
+static bool movie_seek_key = FALSE;
+
+#ifdef HAVE_PTHREAD_H
+static pthread_t movie_thread;
+/** Protect the counters of the frames and the following variables */
+static pthread_mutex_t movie_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Signaled when a frame is decoded, when a frame is displayed and
+ * when the thread must quit */
+static pthread_cond_t movie_cond = PTHREAD_COND_INITIALIZER;
+/** TRUE if the thread must quit */
+static bool movie_quit = FALSE;
+/** TRUE if the thread is running */
+static bool movie_running = FALSE;
+#endif
 
-static bool movie_initialize (const char *filename);
-static bool movie_load (const char *filename);
+static bool movie_initialize (const char *indexed, const char *filename);
+static bool movie_load (const char *indexed, const char *filename);
 static bool movie_play (void);
-static unsigned char *decompress (unsigned char *, unsigned char *,
-                                  unsigned char *);
+static void movie_thread_start (void);
+static void movie_thread_stop (void);
+#ifdef HAVE_PTHREAD_H
+static void *movie_loop (void *arg);
+#endif
 
 /**
  * Play movie animation compressed
@@ -68,7 +107,7 @@ movie_player (void)
       /* introduction movie */
     case MOVIE_INTRODUCTION:
       filename = "graphics/movie_introduction.gca";
-      if (movie_initialize (filename))
+      if (movie_initialize ("graphics/movie_introduction.gci", filename))
         {
           movie_playing_switch = MOVIE_PLAYED_CURRENTLY;
         }
@@ -82,7 +121,7 @@ movie_player (void)
       /* congratulation movie */
     case MOVIE_CONGRATULATIONS:
       filename = "graphics/movie_congratulation.gca";
-      if (movie_initialize (filename))
+      if (movie_initialize ("graphics/movie_congratulation.gci", filename))
         {
           movie_playing_switch = MOVIE_PLAYED_CURRENTLY;
         }
@@ -96,8 +135,24 @@ movie_player (void)
       /* play movie animation compressed */
     case MOVIE_PLAYED_CURRENTLY:
       {
-        if (!movie_play () || key_code_down > 0 || fire_button_down
-            || mouse_b > 1)
+        /* the left and right keys move backward or forward in the
+         * movie, the other keys stop it */
+        if (keys_down[K_LEFT] || keys_down[K_RIGHT])
+          {
+            if (!movie_seek_key)
+              {
+                movie_seek (movie_counter + (keys_down[K_LEFT] ?
+                                             -MOVIE_SEEK_STEP :
+                                             MOVIE_SEEK_STEP));
+              }
+            movie_seek_key = TRUE;
+          }
+        else
+          {
+            movie_seek_key = FALSE;
+          }
+        if (!movie_play () || (key_code_down > 0 && !movie_seek_key)
+            || fire_button_down || mouse_b > 1)
           {
             movie_free ();
             movie_playing_switch = MOVIE_NOT_PLAYED;
@@ -110,75 +165,108 @@ movie_player (void)
 
 /**
  * Initialize an animation file, allocate buffers and create offscreen
- * @param filename: the file which should be loaded.
+ * @param indexed The indexed file which is loaded if it exists
+ * @param filename The file which is loaded otherwise
  * @return boolean value on success or failure
  */
 static bool
-movie_initialize (const char *filename)
+movie_initialize (const char *indexed, const char *filename)
 {
-  Sint32 i = 0;
-  smage1 = smage2 = scmpr = NULL;
-  smage1 = ((unsigned char *) memory_allocation (64000));
-  if (smage1 == NULL)
-    {
-      LOG_ERR ("not enough memory to allocate 'smage1'");
-      return FALSE;
-    }
-  smage2 = ((unsigned char *) memory_allocation (64000));
-  if (smage1 == NULL)
-    {
-      LOG_ERR ("not enough memory to allocate 'smage2'");
-      return FALSE;
-    }
-  movie_filedata = ((unsigned char *) memory_allocation ((1024 * 1024 * 4)));
-  if (movie_filedata == NULL)
+  Uint32 i;
+  movie_free ();
+  movie_memory =
+    (unsigned char *) memory_allocation ((MOVIE_RING_SIZE + 1) *
+                                         MOVIE_FRAME_SIZE +
+                                         MOVIE_CHUNK_SIZE);
+  if (movie_memory == NULL)
     {
-      LOG_ERR ("not enough memory to allocate 'movie_filedata'");
+      LOG_ERR ("not enough memory to allocate the frames of the movie");
       return FALSE;
     }
-  for (i = 0; i < 64000; i++)
+  for (i = 0; i < MOVIE_RING_SIZE; i++)
     {
-      smage1[i] = 0;
-      smage2[i] = 0;
+      movie_ring[i] = movie_memory + i * MOVIE_FRAME_SIZE;
     }
-  if (!movie_load (filename))
+  movie_black = movie_memory + MOVIE_RING_SIZE * MOVIE_FRAME_SIZE;
+  if (!movie_load (indexed, filename))
     {
       LOG_ERR ("movie_load(%s) failed!", filename);
       return FALSE;
     }
-  movie_buffer = smage1;
-  image2 = smage2;
-  icmpr = scmpr;
+  movie_buffer = movie_black;
   movie_counter = 0;
+  movie_decoded = 0;
+  movie_failed = FALSE;
+  movie_seek_key = FALSE;
   if (!create_movie_offscreen ())
     {
       LOG_ERR ("create_movie_buffer() failed!");
       return FALSE;
     }
+  movie_thread_start ();
   return TRUE;
 }
 
+/**
+ * Start the thread which decodes the frames in advance
+ */
+static void
+movie_thread_start (void)
+{
+#ifdef HAVE_PTHREAD_H
+  movie_quit = FALSE;
+  if (pthread_create (&movie_thread, NULL, movie_loop, NULL) != 0)
+    {
+      /* the frames will be decoded when they are displayed */
+      LOG_ERR ("pthread_create() failed");
+      return;
+    }
+  movie_running = TRUE;
+#endif
+}
+
+/**
+ * Stop the thread which decodes the frames in advance
+ */
+static void
+movie_thread_stop (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (movie_running)
+    {
+      pthread_mutex_lock (&movie_mutex);
+      movie_quit = TRUE;
+      pthread_cond_broadcast (&movie_cond);
+      pthread_mutex_unlock (&movie_mutex);
+      pthread_join (movie_thread, NULL);
+      movie_running = FALSE;
+    }
+#endif
+}
+
 /**
  * Deallocates the memory used by the movie player
  */
 void
 movie_free (void)
 {
-  if (smage1 != NULL)
+  movie_thread_stop ();
+  if (movie_file != NULL)
     {
-      free_memory ((char *) smage1);
-      smage1 = NULL;
+      fclose (movie_file);
+      movie_file = NULL;
     }
-  if (smage2 != NULL)
+  if (movie_offsets != NULL)
     {
-      free_memory ((char *) smage2);
-      smage2 = NULL;
+      free_memory ((char *) movie_offsets);
+      movie_offsets = NULL;
     }
-  if (movie_filedata != NULL)
+  if (movie_memory != NULL)
     {
-      free_memory ((char *) movie_filedata);
-      movie_filedata = NULL;
+      free_memory ((char *) movie_memory);
+      movie_memory = NULL;
     }
+  movie_buffer = NULL;
   if (pal16PlayAnim != NULL)
     {
       free_memory ((char *) pal16PlayAnim);
@@ -193,25 +281,65 @@ movie_free (void)
 }
 
 /**
- * Load an animation file and convert colors palette
- * @param filename: the file which should be loaded.
+ * Open an animation file, read its header and convert colors palette.
+ * The compressed frames are read by chunks while they are decoded
+ * @param indexed The indexed file which is loaded if it exists
+ * @param filename The file which is loaded otherwise
  * @return boolean value on success or failure
  */
 static bool
-movie_load (const char *filename)
+movie_load (const char *indexed, const char *filename)
 {
-  Sint32 i, *ptr32;
-  unsigned char *_p8, *_p, *_pPal, *pcxpal;
-  if (!loadfile_into_buffer (filename, (char *) movie_filedata))
+  Sint32 i;
+  unsigned char *_p, *_pPal;
+  unsigned char *pcxpal = movie_info.palette;
+  char *pathname = locate_data_file (indexed);
+  if (pathname != NULL)
+    {
+      filename = indexed;
+    }
+  else
     {
+      pathname = locate_data_file (filename);
+      if (pathname == NULL)
+        {
+          LOG_ERR ("can't locate file: '%s'", filename);
+          return FALSE;
+        }
+    }
+  movie_file = fopen_data (pathname, "rb");
+  free_memory (pathname);
+  if (movie_file == NULL)
+    {
+      return FALSE;
+    }
+  if (!movie_header_read (movie_file, &movie_info))
+    {
+      LOG_ERR ("can't read the header of \"%s\"", filename);
       return FALSE;
     }
-  ptr32 = (Sint32 *) movie_filedata;
-  images = little_endian_to_int (ptr32++);
-  _p8 = (unsigned char *) ptr32;
-  pcxpal = _p8;
-  scmpr = _p8 + 768;
-  if (bytes_per_pixel == 2)
+  if (movie_info.keyframes > 0)
+    {
+      movie_offsets =
+        (Uint32 *) memory_allocation ((movie_info.numof_frames + 1) *
+                                      sizeof (Uint32));
+      if (movie_offsets == NULL)
+        {
+          LOG_ERR ("not enough memory to allocate the index of the movie");
+          return FALSE;
+        }
+      if (!movie_index_read (movie_file, &movie_info, movie_offsets))
+        {
+          LOG_ERR ("can't read the index of \"%s\"", filename);
+          return FALSE;
+        }
+    }
+  movie_stream_init (&movie_frames, movie_file,
+                     movie_memory + (MOVIE_RING_SIZE + 1) * MOVIE_FRAME_SIZE,
+                     movie_info.data_offset);
+  /* the palettes are in the format of the window, the game can be
+   * drawn with 8-bit indexes */
+  if (window_bytes_per_pixel == 2)
     {
       if (pal16PlayAnim == NULL)
         {
@@ -224,7 +352,7 @@ movie_load (const char *filename)
         }
       convert_palette_24_to_16 (pcxpal, pal16PlayAnim);
     }
-  if (bytes_per_pixel > 2)
+  if (window_bytes_per_pixel > 2)
     {
       if (pal32PlayAnim == NULL)
         {
@@ -277,136 +405,172 @@ movie_load (const char *filename)
   return TRUE;
 }
 
-/*
- * Play a movie
- * @return TRUE if the movie is finished
+/**
+ * Decode the frame which follows the last one decoded
+ * @return TRUE if it completed successfully or FALSE otherwise
  */
 static bool
-movie_play (void)
+movie_decode_next (void)
 {
-  /* images = 64 + 16 + 2 + 1 + 1 */
-  unsigned char *tmp;
-  movie_counter++;
-  if (movie_counter == images - 1)
-    {
-      return FALSE;
-    }
-  icmpr = decompress (icmpr, movie_buffer, image2);
-  tmp = movie_buffer;
-  movie_buffer = image2;
-  image2 = tmp;
-  return TRUE;
+  Sint32 num = movie_decoded + 1;
+  return movie_decode (&movie_frames,
+                       movie_is_keyframe (&movie_info, num) ? movie_black :
+                       movie_ring[(num - 1) % MOVIE_RING_SIZE],
+                       movie_ring[num % MOVIE_RING_SIZE]);
 }
 
-/*
- *
+#ifdef HAVE_PTHREAD_H
+/**
+ * Main function of the thread: decode the frames in advance, as long
+ * as the ring has a free frame
+ * @param arg Unused
+ * @return Always NULL
  */
-static unsigned char *
-decompress (unsigned char *wsc, unsigned char *im1, unsigned char *im2)
+static void *
+movie_loop (void *arg)
 {
-  Sint32 i, j, mode;
-  Uint32 wr;
-  unsigned char *idec;
-  unsigned char *wdec;
-  unsigned char c;
-  unsigned char color;
-  Sint32 length = 0;
-  Sint32 retour = 0;
-  Sint32 position = 0;
-  i = 0;
-  idec = im2;
-  while (i < 64000)
-    {
-      mode = 0;
-      /* read a byte */
-      c = *wsc++;
-      if (c == 255)
-        {
-          color = *wsc++;
-          *idec++ = color;
-          i++;
-          mode = 0;
-        }
-      else if ((c & 0xc0) == 0)
-        {
-          wr = 0;
-          wr = c << 16;
-          wr += (*wsc++) << 8;
-          wr += *wsc++;
-          length = wr & 63;
-          position = (wr >> 6) & 65535;
-          mode = 1;
-        }
-      else if ((c & 0xc0) == 0x40)
+  bool result;
+  (void) arg;
+  pthread_mutex_lock (&movie_mutex);
+  for (;;)
+    {
+      while (!movie_quit && !movie_failed
+             && (movie_decoded >= movie_info.numof_frames
+                 || movie_decoded - movie_counter >= MOVIE_RING_SIZE - 1))
         {
-          wr = 0;
-          wr = c << 24;
-          wr += (*wsc++) << 16;
-          wr += (*wsc++) << 8;
-          wr += *wsc++;
-          length = wr & 16383;
-          position = (wr >> 14) & 65535;
-          mode = 1;
+          pthread_cond_wait (&movie_cond, &movie_mutex);
         }
-      else if ((c & 0xe0) == 0x80)
+      if (movie_quit)
         {
-          wr = 0;
-          wr = c << 8;
-          wr += *wsc++;
-          length = wr & 63;
-          retour = (wr >> 6) & 255;
-          mode = 2;
+          break;
         }
-      else if ((c & 0xe0) == 0xa0)
+      pthread_mutex_unlock (&movie_mutex);
+      result = movie_decode_next ();
+      pthread_mutex_lock (&movie_mutex);
+      if (result)
         {
-          wr = 0;
-          wr = c << 16;
-          wr += (*wsc++) << 8;
-          wr += *wsc++;
-          length = wr & 255;
-          retour = (wr >> 8) & 8191;
-          mode = 2;
+          movie_decoded++;
         }
-      else if ((c & 0xe0) == 0xc0)
+      else
         {
-          wr = 0;
-          wr = c << 24;
-          wr += (*wsc++) << 16;
-          wr += (*wsc++) << 8;
-          wr += *wsc++;
-          length = wr & 8191;
-          position = (wr >> 13) & 65535;
-          mode = 3;
+          movie_failed = TRUE;
         }
-      if (i + length > 64000)
+      pthread_cond_broadcast (&movie_cond);
+    }
+  pthread_mutex_unlock (&movie_mutex);
+  return NULL;
+}
+#endif
+
+/*
+ * Play a movie
+ * @return TRUE if the movie is finished
+ */
+static bool
+movie_play (void)
+{
+  bool result = TRUE;
+  if (movie_counter >= movie_info.numof_frames)
+    {
+      return FALSE;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (movie_running)
+    {
+      /* the frame was decoded in advance, unless the thread is late */
+      pthread_mutex_lock (&movie_mutex);
+      movie_counter++;
+      while (movie_decoded < movie_counter && !movie_failed)
         {
-          length = 64000 - i;
+          pthread_cond_wait (&movie_cond, &movie_mutex);
         }
-      if (mode == 1)
+      result = movie_decoded >= movie_counter;
+      /* the previous frame of the ring is now free */
+      pthread_cond_broadcast (&movie_cond);
+      pthread_mutex_unlock (&movie_mutex);
+    }
+  else
+#endif
+    {
+      movie_counter++;
+      result = movie_decode_next ();
+      if (result)
         {
-          for (j = 0; j < length; j++)
-            {
-              *idec++ = im1[position + j];
-            }
-          i += length;
+          movie_decoded++;
         }
-      else if (mode == 2)
+    }
+  if (!result)
+    {
+      LOG_ERR ("the frame %i of the movie can't be decoded", movie_counter);
+      return FALSE;
+    }
+  movie_buffer = movie_ring[movie_counter % MOVIE_RING_SIZE];
+  return TRUE;
+}
+
+/**
+ * Move to a frame of the movie. The frames of an indexed movie are
+ * decoded from the previous keyframe, the frames of a movie without
+ * index are decoded from the current frame or from the beginning
+ * @param num Number of the frame, from 0 to the number of frames
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+movie_seek (Sint32 num)
+{
+  Sint32 first;
+  Uint32 offset;
+  bool result = TRUE;
+  if (movie_memory == NULL)
+    {
+      return FALSE;
+    }
+  if (num < 0)
+    {
+      num = 0;
+    }
+  if (num > movie_info.numof_frames)
+    {
+      num = movie_info.numof_frames;
+    }
+  movie_thread_stop ();
+  if (movie_offsets != NULL && num > 0)
+    {
+      first = num - (num - 1) % movie_info.keyframes;
+    }
+  else
+    {
+      first = 1;
+    }
+  /* the frames between the keyframe and the last frame decoded
+   * are not decoded again */
+  if (movie_failed || movie_decoded >= num || movie_decoded < first - 1)
+    {
+      movie_failed = FALSE;
+      movie_decoded = first - 1;
+      offset = movie_info.data_offset;
+      if (movie_offsets != NULL)
         {
-          wdec = idec - retour;
-          for (j = 0; j < length; j++)
-            {
-              *idec++ = *wdec++;
-            }
-          i += length;
+          offset = movie_offsets[first - 1];
         }
-      else if (mode == 3)
+      result = movie_stream_seek (&movie_frames, offset);
+    }
+  while (result && movie_decoded < num)
+    {
+      result = movie_decode_next ();
+      if (result)
         {
-          for (j = 0; j < length; j++)
-            {
-              *idec++ = im2[position + j];
-            }
-          i += length;
+          movie_decoded++;
         }
     }
-  return wsc;
+  movie_failed = !result;
+  movie_counter = num;
+  movie_buffer =
+    num == 0 ? movie_black : movie_ring[movie_counter % MOVIE_RING_SIZE];
+  movie_thread_start ();
+  if (!result)
+    {
+      LOG_ERR ("the frame %i of the movie can't be decoded", num);
+    }
+  return result;
 }
@@ -41,6 +41,7 @@ extern "C"
   } MOVIE_ENUM;
 
   bool movie_player (void);
+  bool movie_seek (Sint32 num);
   void movie_free (void);
   extern Uint32 movie_playing_switch;
   /** Pointer to the buffer for the current animation movie */
@@ -0,0 +1,343 @@
+/**
+ * @file movie_codec.c
+ * @brief Read the headers and decode the frames of the movies, shared
+ *        by the player and the movie_transcode tool
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "movie_codec.h"
+#include <string.h>
+
+/** Size of the header of the ".gca" files: images and palette */
+#define MOVIE_GCA_HEADER_SIZE (4 + MOVIE_PALETTE_SIZE)
+/** Size of the header of the ".gci" files: magic, frames, keyframes
+ * and palette, the offsets of the frames follow */
+#define MOVIE_GCI_HEADER_SIZE (4 + 4 + 4 + MOVIE_PALETTE_SIZE)
+/** Maximum number of frames of an indexed movie */
+#define MOVIE_FRAMES_MAXOF 65536
+
+/**
+ * Read a little-endian 32-bit integer
+ * @param mem Pointer to the four bytes
+ * @return The value
+ */
+static Uint32
+movie_read_int (const unsigned char *mem)
+{
+  return (Uint32) mem[0] | ((Uint32) mem[1] << 8) | ((Uint32) mem[2] << 16)
+    | ((Uint32) mem[3] << 24);
+}
+
+/**
+ * Read the header of a ".gca" or ".gci" movie, the file must be at
+ * its beginning. The offsets of the frames of an indexed movie follow
+ * the header and must be read by movie_index_read()
+ * @param file The movie file
+ * @param header Pointer to the header to fill
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+movie_header_read (FILE * file, movie_header * header)
+{
+  unsigned char buffer[MOVIE_GCI_HEADER_SIZE];
+  if (fread (buffer, MOVIE_GCA_HEADER_SIZE, 1, file) != 1)
+    {
+      return FALSE;
+    }
+  if (memcmp (buffer, MOVIE_INDEX_MAGIC, 4) != 0)
+    {
+      /* images = 64 + 16 + 2 + 1 + 1, the last two are not played */
+      header->numof_frames = (Sint32) movie_read_int (buffer) - 2;
+      header->keyframes = 0;
+      header->data_offset = MOVIE_GCA_HEADER_SIZE;
+      memcpy (header->palette, buffer + 4, MOVIE_PALETTE_SIZE);
+      return header->numof_frames >= 0;
+    }
+  if (fread (buffer + MOVIE_GCA_HEADER_SIZE,
+             MOVIE_GCI_HEADER_SIZE - MOVIE_GCA_HEADER_SIZE, 1, file) != 1)
+    {
+      return FALSE;
+    }
+  header->numof_frames = (Sint32) movie_read_int (buffer + 4);
+  header->keyframes = movie_read_int (buffer + 8);
+  if (header->numof_frames < 0 || header->numof_frames > MOVIE_FRAMES_MAXOF
+      || header->keyframes == 0)
+    {
+      return FALSE;
+    }
+  header->data_offset =
+    MOVIE_GCI_HEADER_SIZE + 4 * (header->numof_frames + 1);
+  memcpy (header->palette, buffer + 12, MOVIE_PALETTE_SIZE);
+  return TRUE;
+}
+
+/**
+ * Read the offsets of the frames of an indexed movie, which follow
+ * its header
+ * @param file The movie file
+ * @param header The header read by movie_header_read()
+ * @param offsets Array of numof_frames + 1 integers which receives the
+ *        offset of each frame, from the frame 1, and the offset of the
+ *        end of the last frame
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+movie_index_read (FILE * file, const movie_header * header,
+                  Uint32 * offsets)
+{
+  Sint32 i;
+  Sint32 numof = header->numof_frames + 1;
+  unsigned char *mem = (unsigned char *) offsets;
+  if (fread (offsets, 4, numof, file) != (size_t) numof)
+    {
+      return FALSE;
+    }
+  for (i = 0; i < numof; i++)
+    {
+      offsets[i] = movie_read_int (mem + i * 4);
+      if (offsets[i] < (i == 0 ? header->data_offset : offsets[i - 1]))
+        {
+          return FALSE;
+        }
+    }
+  return offsets[0] == header->data_offset;
+}
+
+/**
+ * Check if a frame is decoded from a black frame instead of the
+ * previous frame, the frame 1 follows the black frame 0
+ * @param header The header of the movie
+ * @param num Number of the frame, from 1
+ * @return TRUE if the frame is a keyframe
+ */
+bool
+movie_is_keyframe (const movie_header * header, Sint32 num)
+{
+  return num == 1 || (header->keyframes > 0
+                      && (num - 1) % header->keyframes == 0);
+}
+
+/**
+ * Initialize the reading of the frames
+ * @param stream The stream to initialize
+ * @param file The movie file
+ * @param chunk Buffer of MOVIE_CHUNK_SIZE bytes
+ * @param offset Current offset in the file
+ */
+void
+movie_stream_init (movie_stream * stream, FILE * file, unsigned char *chunk,
+                   Uint32 offset)
+{
+  stream->file = file;
+  stream->chunk = chunk;
+  stream->cur = stream->end = chunk;
+  stream->offset = offset;
+}
+
+/**
+ * Move to a frame of the movie file
+ * @param stream The stream
+ * @param offset Offset in the file of the frame
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+movie_stream_seek (movie_stream * stream, Uint32 offset)
+{
+  stream->cur = stream->end = stream->chunk;
+  if (fseek (stream->file, (long) offset, SEEK_SET) != 0)
+    {
+      return FALSE;
+    }
+  stream->offset = offset;
+  return TRUE;
+}
+
+/**
+ * Return the offset in the file of the next byte to decode
+ * @param stream The stream
+ * @return The offset of the next frame after a frame is decoded
+ */
+Uint32
+movie_stream_tell (const movie_stream * stream)
+{
+  return stream->offset - (Uint32) (stream->end - stream->cur);
+}
+
+/**
+ * Read the next chunk of the movie file, the bytes which were not
+ * decoded are moved to the beginning of the chunk
+ * @param stream The stream
+ * @return TRUE if some bytes remain to be decoded
+ */
+static bool
+movie_stream_read (movie_stream * stream)
+{
+  size_t size;
+  size_t remain = stream->end - stream->cur;
+  memmove (stream->chunk, stream->cur, remain);
+  stream->cur = stream->chunk;
+  stream->end = stream->chunk + remain;
+  size = fread (stream->end, 1, MOVIE_CHUNK_SIZE - remain, stream->file);
+  stream->offset += (Uint32) size;
+  stream->end += size;
+  return remain + size > 0;
+}
+
+/**
+ * Decode a frame, the codes copy bytes of the previous frame or of
+ * the frame being decoded
+ * @param stream The stream of the compressed frames
+ * @param im1 The previous frame, or a black frame for a keyframe
+ * @param im2 The frame to decode
+ * @return TRUE if it completed successfully or FALSE if the file is
+ *         truncated or corrupt
+ */
+bool
+movie_decode (movie_stream * stream, const unsigned char *im1,
+              unsigned char *im2)
+{
+  Sint32 i, j, mode;
+  Uint32 wr;
+  unsigned char *idec;
+  unsigned char *wdec;
+  unsigned char *wsc = stream->cur;
+  unsigned char c;
+  unsigned char color;
+  Sint32 length = 0;
+  Sint32 retour = 0;
+  Sint32 position = 0;
+  i = 0;
+  idec = im2;
+  while (i < MOVIE_FRAME_SIZE)
+    {
+      /* a code is never split between two chunks */
+      if (stream->end - wsc < MOVIE_CODE_MAXSIZE)
+        {
+          stream->cur = wsc;
+          if (!movie_stream_read (stream))
+            {
+              return FALSE;
+            }
+          wsc = stream->cur;
+        }
+      mode = 0;
+      /* read a byte */
+      c = *wsc++;
+      if (c == 255)
+        {
+          color = *wsc++;
+          *idec++ = color;
+          i++;
+          mode = 0;
+        }
+      else if ((c & 0xc0) == 0)
+        {
+          wr = 0;
+          wr = c << 16;
+          wr += (*wsc++) << 8;
+          wr += *wsc++;
+          length = wr & 63;
+          position = (wr >> 6) & 65535;
+          mode = 1;
+        }
+      else if ((c & 0xc0) == 0x40)
+        {
+          wr = 0;
+          wr = c << 24;
+          wr += (*wsc++) << 16;
+          wr += (*wsc++) << 8;
+          wr += *wsc++;
+          length = wr & 16383;
+          position = (wr >> 14) & 65535;
+          mode = 1;
+        }
+      else if ((c & 0xe0) == 0x80)
+        {
+          wr = 0;
+          wr = c << 8;
+          wr += *wsc++;
+          length = wr & 63;
+          retour = (wr >> 6) & 255;
+          mode = 2;
+        }
+      else if ((c & 0xe0) == 0xa0)
+        {
+          wr = 0;
+          wr = c << 16;
+          wr += (*wsc++) << 8;
+          wr += *wsc++;
+          length = wr & 255;
+          retour = (wr >> 8) & 8191;
+          mode = 2;
+        }
+      else if ((c & 0xe0) == 0xc0)
+        {
+          wr = 0;
+          wr = c << 24;
+          wr += (*wsc++) << 16;
+          wr += (*wsc++) << 8;
+          wr += *wsc++;
+          length = wr & 8191;
+          position = (wr >> 13) & 65535;
+          mode = 3;
+        }
+      if (i + length > MOVIE_FRAME_SIZE)
+        {
+          length = MOVIE_FRAME_SIZE - i;
+        }
+      if ((mode == 1 && position + length > MOVIE_FRAME_SIZE)
+          || (mode == 2 && retour > i)
+          || (mode == 3 && position + length > MOVIE_FRAME_SIZE))
+        {
+          return FALSE;
+        }
+      if (mode == 1)
+        {
+          for (j = 0; j < length; j++)
+            {
+              *idec++ = im1[position + j];
+            }
+          i += length;
+        }
+      else if (mode == 2)
+        {
+          wdec = idec - retour;
+          for (j = 0; j < length; j++)
+            {
+              *idec++ = *wdec++;
+            }
+          i += length;
+        }
+      else if (mode == 3)
+        {
+          for (j = 0; j < length; j++)
+            {
+              *idec++ = im2[position + j];
+            }
+          i += length;
+        }
+    }
+  stream->cur = wsc;
+  return TRUE;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file movie_codec.h
+ * @brief Read the headers and decode the frames of the movies, shared
+ *        by the player and the movie_transcode tool
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __MOVIE_CODEC__
+#define __MOVIE_CODEC__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Size of a frame of the movies: 320x200 8-bit indexes */
+#define MOVIE_FRAME_SIZE 64000
+/** Size of the chunks read from the movie files */
+#define MOVIE_CHUNK_SIZE 16384
+/** Maximum size of a code of the compressed frames */
+#define MOVIE_CODE_MAXSIZE 4
+/** Size of the palette: 256 RGB colors */
+#define MOVIE_PALETTE_SIZE 768
+/** First bytes of the indexed movies (".gci" files) */
+#define MOVIE_INDEX_MAGIC "GCI1"
+/** Default interval between two keyframes of the indexed movies */
+#define MOVIE_KEYFRAMES_INTERVAL 28
+
+  /**
+   * Header of a movie. A ".gca" file begins with the number of images
+   * and the palette, then the frames follow, each frame is decoded
+   * from the previous one. A ".gci" file begins with the magic, the
+   * number of frames, the interval between the keyframes and the
+   * palette, followed by the offsets of the frames. A keyframe is
+   * decoded from a black frame, the seek doesn't need the previous
+   * frames. All the values are little-endian 32-bit integers
+   */
+  typedef struct movie_header
+  {
+    /** Number of frames played, numbered from 1 */
+    Sint32 numof_frames;
+    /** Interval between two keyframes, 0 if the movie has no index */
+    Uint32 keyframes;
+    /** Offset in the file of the first frame */
+    Uint32 data_offset;
+    /** RGB palette of the frames */
+    unsigned char palette[MOVIE_PALETTE_SIZE];
+  }
+  movie_header;
+
+  /** Compressed frames read by chunks from a movie file */
+  typedef struct movie_stream
+  {
+    FILE *file;
+    /** Buffer of MOVIE_CHUNK_SIZE bytes */
+    unsigned char *chunk;
+    /** Next byte to decode */
+    unsigned char *cur;
+    /** End of the bytes read */
+    unsigned char *end;
+    /** Offset in the file of the end of the bytes read */
+    Uint32 offset;
+  }
+  movie_stream;
+
+  bool movie_header_read (FILE * file, movie_header * header);
+  bool movie_index_read (FILE * file, const movie_header * header,
+                         Uint32 * offsets);
+  bool movie_is_keyframe (const movie_header * header, Sint32 num);
+  void movie_stream_init (movie_stream * stream, FILE * file,
+                          unsigned char *chunk, Uint32 offset);
+  bool movie_stream_seek (movie_stream * stream, Uint32 offset);
+  Uint32 movie_stream_tell (const movie_stream * stream);
+  bool movie_decode (movie_stream * stream, const unsigned char *im1,
+                     unsigned char *im2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,602 @@
+/**
+ * @file movie_transcode.c
+ * @brief Offline tool which converts a ".gca" movie into an indexed
+ *        ".gci" movie with keyframes, and extracts frames of a movie
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "movie_codec.h"
+#include <string.h>
+
+/* the tool has its own main(), even with SDL */
+#ifdef main
+#undef main
+#endif
+
+/** Width and height of the frames */
+#define TRANSCODE_WIDTH 320
+#define TRANSCODE_HEIGHT 200
+/** Maximum number of positions compared to find a match */
+#define TRANSCODE_CHAIN_MAXOF 256
+/** Maximum size of the codes of a keyframe: one literal per pixel */
+#define TRANSCODE_CODES_MAXSIZE (MOVIE_FRAME_SIZE * 2)
+
+/** Buffers of the tool */
+static unsigned char *chunk = NULL;
+static unsigned char *black = NULL;
+static unsigned char *frames[2] = { NULL, NULL };
+static unsigned char *codes = NULL;
+/** Most recent position of each pair of pixels in the keyframe */
+static Sint32 *hash_heads = NULL;
+/** Previous position of the same pair of pixels */
+static Sint32 *hash_chains = NULL;
+
+/**
+ * Allocate the buffers of the tool
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+transcode_alloc (void)
+{
+  Uint32 i;
+  /* a chunk for each of the two movies compared */
+  chunk = (unsigned char *) malloc (2 * MOVIE_CHUNK_SIZE);
+  black = (unsigned char *) calloc (1, MOVIE_FRAME_SIZE);
+  for (i = 0; i < 2; i++)
+    {
+      frames[i] = (unsigned char *) calloc (1, MOVIE_FRAME_SIZE);
+    }
+  codes = (unsigned char *) malloc (TRANSCODE_CODES_MAXSIZE);
+  hash_heads = (Sint32 *) malloc (65536 * sizeof (Sint32));
+  hash_chains = (Sint32 *) malloc (MOVIE_FRAME_SIZE * sizeof (Sint32));
+  if (chunk == NULL || black == NULL || frames[0] == NULL
+      || frames[1] == NULL || codes == NULL || hash_heads == NULL
+      || hash_chains == NULL)
+    {
+      fprintf (stderr, "not enough memory\n");
+      return FALSE;
+    }
+  return TRUE;
+}
+
+/**
+ * Release the buffers of the tool
+ */
+static void
+transcode_free (void)
+{
+  free (chunk);
+  free (black);
+  free (frames[0]);
+  free (frames[1]);
+  free (codes);
+  free (hash_heads);
+  free (hash_chains);
+}
+
+/**
+ * Write a little-endian 32-bit integer
+ * @param mem Pointer to the four bytes
+ * @param value The value
+ */
+static void
+transcode_write_int (unsigned char *mem, Uint32 value)
+{
+  mem[0] = value & 0xff;
+  mem[1] = (value >> 8) & 0xff;
+  mem[2] = (value >> 16) & 0xff;
+  mem[3] = (value >> 24) & 0xff;
+}
+
+/**
+ * Compress a keyframe without the previous frame: the pixels are
+ * literals or copies of pixels already decoded in the same frame
+ * @param frame The pixels of the frame
+ * @return The size of the codes written in the buffer 'codes'
+ */
+static Uint32
+transcode_keyframe (const unsigned char *frame)
+{
+  Sint32 i, j, pos, len, best_pos, best_len, maxlen, retour, count;
+  Uint32 key, wr;
+  unsigned char *out = codes;
+  for (i = 0; i < 65536; i++)
+    {
+      hash_heads[i] = -1;
+    }
+  i = 0;
+  while (i < MOVIE_FRAME_SIZE)
+    {
+      best_len = 0;
+      best_pos = 0;
+      maxlen = MOVIE_FRAME_SIZE - i;
+      if (maxlen > 8191)
+        {
+          maxlen = 8191;
+        }
+      if (maxlen >= 2)
+        {
+          /* the most recent positions are compared first, the copies
+           * may overlap the pixels being decoded */
+          key = frame[i] | (frame[i + 1] << 8);
+          count = 0;
+          for (pos = hash_heads[key];
+               pos >= 0 && count < TRANSCODE_CHAIN_MAXOF;
+               pos = hash_chains[pos], count++)
+            {
+              len = 0;
+              while (len < maxlen && frame[pos + len] == frame[i + len])
+                {
+                  len++;
+                }
+              if (len > best_len)
+                {
+                  best_len = len;
+                  best_pos = pos;
+                  if (len == maxlen)
+                    {
+                      break;
+                    }
+                }
+            }
+        }
+      if (best_len < 2)
+        {
+          *out++ = 255;
+          *out++ = frame[i];
+          best_len = 1;
+        }
+      else
+        {
+          retour = i - best_pos;
+          if (retour < 128 && best_len < 64)
+            {
+              wr = (0x80 << 8) | (retour << 6) | best_len;
+              *out++ = (wr >> 8) & 0xff;
+              *out++ = wr & 0xff;
+            }
+          else if (retour < 8192 && best_len < 256)
+            {
+              wr = (0xa0 << 16) | (retour << 8) | best_len;
+              *out++ = (wr >> 16) & 0xff;
+              *out++ = (wr >> 8) & 0xff;
+              *out++ = wr & 0xff;
+            }
+          else
+            {
+              wr = (0xc0U << 24) | ((Uint32) best_pos << 13) | best_len;
+              *out++ = (wr >> 24) & 0xff;
+              *out++ = (wr >> 16) & 0xff;
+              *out++ = (wr >> 8) & 0xff;
+              *out++ = wr & 0xff;
+            }
+        }
+      for (j = 0; j < best_len; j++, i++)
+        {
+          if (i + 1 < MOVIE_FRAME_SIZE)
+            {
+              key = frame[i] | (frame[i + 1] << 8);
+              hash_chains[i] = hash_heads[key];
+              hash_heads[key] = i;
+            }
+        }
+    }
+  return (Uint32) (out - codes);
+}
+
+/**
+ * Copy the codes of a frame from the source movie
+ * @param in The source movie, at the beginning of the frame
+ * @param out The indexed movie
+ * @param size Size of the codes of the frame
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+transcode_copy (FILE * in, FILE * out, Uint32 size)
+{
+  Uint32 len;
+  while (size > 0)
+    {
+      len = size < TRANSCODE_CODES_MAXSIZE ? size : TRANSCODE_CODES_MAXSIZE;
+      if (fread (codes, 1, len, in) != len
+          || fwrite (codes, 1, len, out) != len)
+        {
+          return FALSE;
+        }
+      size -= len;
+    }
+  return TRUE;
+}
+
+/**
+ * Open a movie and read its header
+ * @param filename The movie file
+ * @param header Pointer to the header to fill
+ * @return The file or NULL if it failed
+ */
+static FILE *
+transcode_open (const char *filename, movie_header * header)
+{
+  FILE *file = fopen (filename, "rb");
+  if (file == NULL)
+    {
+      fprintf (stderr, "can't open \"%s\"\n", filename);
+      return NULL;
+    }
+  if (!movie_header_read (file, header))
+    {
+      fprintf (stderr, "\"%s\" is not a movie\n", filename);
+      fclose (file);
+      return NULL;
+    }
+  return file;
+}
+
+/**
+ * Convert a ".gca" movie into an indexed movie: the keyframes are
+ * compressed again without the previous frame, the codes of the
+ * other frames are copied
+ * @param source The ".gca" movie
+ * @param dest The ".gci" movie to write
+ * @param keyframes Interval between two keyframes
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+transcode (const char *source, const char *dest, Uint32 keyframes)
+{
+  Sint32 num;
+  Uint32 start, size, keysize = 0, *offsets;
+  unsigned char header_buffer[12 + MOVIE_PALETTE_SIZE];
+  unsigned char *index;
+  movie_header header;
+  movie_stream stream;
+  bool result = TRUE;
+  FILE *out, *copy;
+  FILE *in = transcode_open (source, &header);
+  if (in == NULL)
+    {
+      return FALSE;
+    }
+  if (header.keyframes > 0)
+    {
+      fprintf (stderr, "\"%s\" is already indexed\n", source);
+      fclose (in);
+      return FALSE;
+    }
+  /* the codes of the frames are copied from a second handle */
+  start = header.data_offset;
+  copy = fopen (source, "rb");
+  out = fopen (dest, "wb");
+  offsets = (Uint32 *) malloc ((header.numof_frames + 1) * sizeof (Uint32));
+  if (copy == NULL || out == NULL || offsets == NULL
+      || fseek (copy, (long) start, SEEK_SET) != 0)
+    {
+      fprintf (stderr, "can't open \"%s\" or \"%s\"\n", source, dest);
+      if (copy != NULL)
+        {
+          fclose (copy);
+        }
+      if (out != NULL)
+        {
+          fclose (out);
+        }
+      free (offsets);
+      fclose (in);
+      return FALSE;
+    }
+
+  /* header, the index is written when the frames are written */
+  memcpy (header_buffer, MOVIE_INDEX_MAGIC, 4);
+  transcode_write_int (header_buffer + 4, header.numof_frames);
+  transcode_write_int (header_buffer + 8, keyframes);
+  memcpy (header_buffer + 12, header.palette, MOVIE_PALETTE_SIZE);
+  header.keyframes = keyframes;
+  header.data_offset = sizeof (header_buffer) + 4 * (header.numof_frames + 1);
+  if (fwrite (header_buffer, sizeof (header_buffer), 1, out) != 1
+      || fseek (out, (long) header.data_offset, SEEK_SET) != 0)
+    {
+      result = FALSE;
+    }
+
+  movie_stream_init (&stream, in, chunk, start);
+  offsets[0] = header.data_offset;
+  for (num = 1; result && num <= header.numof_frames; num++)
+    {
+      if (!movie_decode (&stream, frames[(num - 1) & 1], frames[num & 1]))
+        {
+          fprintf (stderr, "the frame %i of \"%s\" can't be decoded\n", num,
+                   source);
+          result = FALSE;
+          break;
+        }
+      size = movie_stream_tell (&stream) - start;
+      start += size;
+      if (movie_is_keyframe (&header, num))
+        {
+          /* the codes read are replaced by the keyframe */
+          if (fseek (copy, (long) size, SEEK_CUR) != 0)
+            {
+              result = FALSE;
+              break;
+            }
+          size = transcode_keyframe (frames[num & 1]);
+          keysize += size;
+          if (fwrite (codes, 1, size, out) != size)
+            {
+              result = FALSE;
+              break;
+            }
+        }
+      else if (!transcode_copy (copy, out, size))
+        {
+          result = FALSE;
+          break;
+        }
+      offsets[num] = offsets[num - 1] + size;
+    }
+
+  /* index of the frames */
+  if (result)
+    {
+      index = (unsigned char *) offsets;
+      for (num = 0; num <= header.numof_frames; num++)
+        {
+          transcode_write_int (index + num * 4, offsets[num]);
+        }
+      if (fseek (out, (long) sizeof (header_buffer), SEEK_SET) != 0
+          || fwrite (index, 4, header.numof_frames + 1,
+                     out) != (size_t) (header.numof_frames + 1))
+        {
+          result = FALSE;
+        }
+    }
+  if (fclose (out) != 0)
+    {
+      result = FALSE;
+    }
+  if (!result)
+    {
+      fprintf (stderr, "can't write \"%s\"\n", dest);
+    }
+  else
+    {
+      printf ("%s: %i frames, %i keyframes (%i bytes), %i bytes\n", dest,
+              header.numof_frames,
+              (header.numof_frames + keyframes - 1) / keyframes, keysize,
+              offsets[header.numof_frames]);
+    }
+  fclose (copy);
+  fclose (in);
+  free (offsets);
+  return result;
+}
+
+/**
+ * Compare all the frames of two movies
+ * @param source The first movie
+ * @param dest The second movie
+ * @return TRUE if the frames are identical or FALSE otherwise
+ */
+static bool
+transcode_verify (const char *source, const char *dest)
+{
+  Sint32 num;
+  Uint32 i, j, *offsets = NULL;
+  movie_header headers[2];
+  movie_stream streams[2];
+  FILE *files[2];
+  unsigned char *previous[2];
+  unsigned char *pixels[2] = { frames[0], frames[1] };
+  bool result = TRUE;
+  /* the previous frames are kept in the 'codes' buffer */
+  previous[0] = codes;
+  previous[1] = codes + MOVIE_FRAME_SIZE;
+  files[0] = transcode_open (source, &headers[0]);
+  files[1] = transcode_open (dest, &headers[1]);
+  if (files[0] == NULL || files[1] == NULL
+      || headers[0].numof_frames != headers[1].numof_frames)
+    {
+      result = FALSE;
+    }
+  for (i = 0; result && i < 2; i++)
+    {
+      if (headers[i].keyframes > 0)
+        {
+          offsets = (Uint32 *) malloc ((headers[i].numof_frames + 1) *
+                                       sizeof (Uint32));
+          result = offsets != NULL
+            && movie_index_read (files[i], &headers[i], offsets);
+          free (offsets);
+        }
+      movie_stream_init (&streams[i], files[i], chunk + i * MOVIE_CHUNK_SIZE,
+                         headers[i].data_offset);
+      memset (previous[i], 0, MOVIE_FRAME_SIZE);
+    }
+  for (num = 1; result && num <= headers[0].numof_frames; num++)
+    {
+      for (i = 0; result && i < 2; i++)
+        {
+          result =
+            movie_decode (&streams[i],
+                          movie_is_keyframe (&headers[i], num) ? black :
+                          previous[i], pixels[i]);
+          memcpy (previous[i], pixels[i], MOVIE_FRAME_SIZE);
+        }
+      for (j = 0; result && j < MOVIE_FRAME_SIZE; j++)
+        {
+          result = pixels[0][j] == pixels[1][j];
+        }
+      if (!result)
+        {
+          fprintf (stderr, "the frame %i differs\n", num);
+        }
+    }
+  for (i = 0; i < 2; i++)
+    {
+      if (files[i] != NULL)
+        {
+          fclose (files[i]);
+        }
+    }
+  return result;
+}
+
+/**
+ * Decode a frame of a movie and write it in a PPM image. The frames
+ * of an indexed movie are decoded from the previous keyframe
+ * @param filename The movie
+ * @param num Number of the frame, from 1
+ * @param image The PPM image to write
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+transcode_extract (const char *filename, Sint32 num, const char *image)
+{
+  Sint32 first, i;
+  Uint32 offset, *offsets = NULL;
+  unsigned char line[TRANSCODE_WIDTH * 3];
+  unsigned char *pixels = frames[num & 1];
+  movie_header header;
+  movie_stream stream;
+  bool result = TRUE;
+  FILE *out;
+  FILE *in = transcode_open (filename, &header);
+  if (in == NULL)
+    {
+      return FALSE;
+    }
+  if (num < 1 || num > header.numof_frames)
+    {
+      fprintf (stderr, "\"%s\" has %i frames\n", filename,
+               header.numof_frames);
+      fclose (in);
+      return FALSE;
+    }
+  first = 1;
+  offset = header.data_offset;
+  if (header.keyframes > 0)
+    {
+      offsets = (Uint32 *) malloc ((header.numof_frames + 1) *
+                                   sizeof (Uint32));
+      result = offsets != NULL && movie_index_read (in, &header, offsets);
+      if (result)
+        {
+          first = num - (num - 1) % header.keyframes;
+          offset = offsets[first - 1];
+        }
+      free (offsets);
+    }
+  movie_stream_init (&stream, in, chunk, header.data_offset);
+  result = result && movie_stream_seek (&stream, offset);
+  for (i = first; result && i <= num; i++)
+    {
+      result = movie_decode (&stream, movie_is_keyframe (&header, i) ?
+                             black : frames[(i - 1) & 1], frames[i & 1]);
+    }
+  fclose (in);
+  if (!result)
+    {
+      fprintf (stderr, "the frame %i of \"%s\" can't be decoded\n", num,
+               filename);
+      return FALSE;
+    }
+
+  /* 8-bit indexes to 24-bit pixels, line by line */
+  out = fopen (image, "wb");
+  if (out == NULL
+      || fprintf (out, "P6\n%i %i\n255\n", TRANSCODE_WIDTH,
+                  TRANSCODE_HEIGHT) < 0)
+    {
+      result = FALSE;
+    }
+  for (i = 0; result && i < MOVIE_FRAME_SIZE; i++)
+    {
+      memcpy (line + (i % TRANSCODE_WIDTH) * 3,
+              header.palette + pixels[i] * 3, 3);
+      if (i % TRANSCODE_WIDTH == TRANSCODE_WIDTH - 1)
+        {
+          result = fwrite (line, sizeof (line), 1, out) == 1;
+        }
+    }
+  if (out != NULL && fclose (out) != 0)
+    {
+      result = FALSE;
+    }
+  if (!result)
+    {
+      fprintf (stderr, "can't write \"%s\"\n", image);
+      return FALSE;
+    }
+  printf ("%s: frame %i, %i frames decoded\n", image, num, num - first + 1);
+  return TRUE;
+}
+
+/**
+ * Display the usage of the tool
+ */
+static void
+transcode_usage (void)
+{
+  printf ("usage: movie_transcode [-k interval] movie.gca movie.gci\n"
+          "       movie_transcode -x frame movie image.ppm\n"
+          "-k interval  interval between two keyframes (default %i)\n"
+          "-x frame     extract a frame, from 1, into a PPM image\n",
+          MOVIE_KEYFRAMES_INTERVAL);
+}
+
+int
+main (int argc, char **argv)
+{
+  Sint32 value = MOVIE_KEYFRAMES_INTERVAL;
+  bool extract = FALSE;
+  bool result;
+  if (argc == 5 && (strcmp (argv[1], "-k") == 0
+                    || strcmp (argv[1], "-x") == 0))
+    {
+      extract = strcmp (argv[1], "-x") == 0;
+      value = atoi (argv[2]);
+      argv += 2;
+      argc -= 2;
+    }
+  if (argc != 3 || (!extract && value < 1))
+    {
+      transcode_usage ();
+      return EXIT_FAILURE;
+    }
+  result = transcode_alloc ();
+  if (result)
+    {
+      if (extract)
+        {
+          result = transcode_extract (argv[1], value, argv[2]);
+        }
+      else
+        {
+          result = transcode (argv[1], argv[2], (Uint32) value)
+            && transcode_verify (argv[1], argv[2]);
+        }
+    }
+  transcode_free ();
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
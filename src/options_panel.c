@@ -28,6 +28,7 @@
 #include "powermanga.h"
 #include "config_file.h"
 #include "tools.h"
+#include "sprite_pack.h"
 #include "images.h"
 #include "display.h"
 #include "electrical_shock.h"
@@ -60,10 +61,8 @@ static bitmap multiplier_bmp[MULTIPLIERS_NUM_OF_IMAGES];
 option option_boxes[OPTIONS_MAX_OF_TYPES];
 /** Images data of the options box */
 static bitmap options[OPTIONS_MAX_OF_TYPES][OPTION_BOX_MAX_IMAGES];
-option_change_coord *options_refresh = NULL;
 /** Score are multiplied by 2 or 4 */
 Uint32 score_multiplier = 0;
-Sint32 opt_refresh_index = -1;
 /** Selected option has changed */
 bool option_change = FALSE;
 /** Tempo display for option selected */
@@ -99,8 +98,6 @@ static void option_clear (Sint32);
 static Uint32 score_multiplier_clear = 2;
 /** [Crtl] key or option button pressed */
 static bool option_button_pressed = FALSE;
-bool score_x2_refresh = FALSE;
-bool score_x4_refresh = FALSE;
 /** Option number to clear */
 static Sint32 old_option;
 static Sint32 cmpt_vbls_x2, cmpt_vbls_x4, aff_x2_rj, aff_x4_rj;
@@ -120,20 +117,6 @@ options_once_init (void)
       return FALSE;
     }
 
-  /* allocate fontes elements */
-  if (options_refresh == NULL)
-    {
-      options_refresh =
-        (option_change_coord *) memory_allocation (88 *
-                                                   sizeof
-                                                   (option_change_coord));
-      if (options_refresh == NULL)
-        {
-          LOG_ERR ("not enough memory to alloc %i bytes!",
-                   sizeof (option_change_coord));
-          return FALSE;
-        }
-    }
   for (i = 0; i < OPTIONS_MAX_OF_TYPES; i++)
     {
       /* delay between two images */
@@ -182,40 +165,78 @@ options_load (void)
   Uint32 size;
   Uint32 *repeats;
   bitmap *bmp;
+  sprites_file file;
 
   /* extract box options animations  bitmap images (387,761 bytes) */
-  if (!bitmap_load ("graphics/bitmap/options_panel_anims.spr",
-                    &options[0][0], OPTIONS_MAX_OF_TYPES,
-                    OPTION_BOX_MAX_IMAGES))
+  if (!sprites_file_open
+      (&file, "graphics/bitmap/options_panel_anims.spr", SPRITE_PACK_BITMAPS))
+    {
+      return FALSE;
+    }
+  if (!sprites_file_read_bitmaps
+      (&file, &options[0][0], OPTIONS_MAX_OF_TYPES, OPTION_BOX_MAX_IMAGES,
+       OPTION_BOX_MAX_IMAGES))
     {
+      sprites_file_close (&file);
       return FALSE;
     }
 
+  /* modifies the display offsets of box animations,
+   * the offsets of the sprite pack are already modified */
+  if (file.pack == NULL && !power_conf->extract_to_png)
+    {
+      for (i = 0; i < OPTIONS_MAX_OF_TYPES; i++)
+        {
+          for (j = 0; j < OPTION_BOX_MAX_IMAGES; j++)
+            {
+              bmp = &options[i][j];
+              repeats = (Uint32 *) bmp->compress;
+              size = bmp->nbr_data_comp >> 2;
+              do
+                {
+                  offset = *repeats;
+                  if (offset > (26 * bytes_per_pixel))
+                    {
+                      /* original width screen's 320 pixels */
+                      offset -= (320 * bytes_per_pixel);
+                      /* actual width screen's 64 pixels */
+                      offset += (OPTIONS_WIDTH * bytes_per_pixel);
+                    }
+                  *repeats = offset;
+                  repeats += 2;
+                }
+              while (--size > 0);
+            }
+        }
+    }
+  sprites_file_close (&file);
+
   /* extract score multipliers bitmap images (760 bytes) */
-  if (!bitmap_load
-      ("graphics/bitmap/scores_multiplier.spr", &multiplier_bmp[0], 1,
-       MULTIPLIERS_NUM_OF_IMAGES))
+  if (!sprites_file_open
+      (&file, "graphics/bitmap/scores_multiplier.spr", SPRITE_PACK_BITMAPS))
     {
       return FALSE;
     }
-
-  if (power_conf->extract_to_png)
+  if (!sprites_file_read_bitmaps
+      (&file, &multiplier_bmp[0], 1, MULTIPLIERS_NUM_OF_IMAGES,
+       MULTIPLIERS_NUM_OF_IMAGES))
     {
-      return TRUE;
+      sprites_file_close (&file);
+      return FALSE;
     }
 
-  /* modifies the display offsets of box animations */
-  for (i = 0; i < OPTIONS_MAX_OF_TYPES; i++)
+  /* modifies the display offsets of score multipliers */
+  if (file.pack == NULL && !power_conf->extract_to_png)
     {
-      for (j = 0; j < OPTION_BOX_MAX_IMAGES; j++)
+      for (j = 0; j < MULTIPLIERS_NUM_OF_IMAGES; j++)
         {
-          bmp = &options[i][j];
+          bmp = &multiplier_bmp[j];
           repeats = (Uint32 *) bmp->compress;
           size = bmp->nbr_data_comp >> 2;
           do
             {
               offset = *repeats;
-              if (offset > (26 * bytes_per_pixel))
+              if (offset > (16 * bytes_per_pixel))
                 {
                   /* original width screen's 320 pixels */
                   offset -= (320 * bytes_per_pixel);
@@ -228,28 +249,7 @@ options_load (void)
           while (--size > 0);
         }
     }
-
-  /* modifies the display offsets of score multipliers */
-  for (j = 0; j < MULTIPLIERS_NUM_OF_IMAGES; j++)
-    {
-      bmp = &multiplier_bmp[j];
-      repeats = (Uint32 *) bmp->compress;
-      size = bmp->nbr_data_comp >> 2;
-      do
-        {
-          offset = *repeats;
-          if (offset > (16 * bytes_per_pixel))
-            {
-              /* original width screen's 320 pixels */
-              offset -= (320 * bytes_per_pixel);
-              /* actual width screen's 64 pixels */
-              offset += (OPTIONS_WIDTH * bytes_per_pixel);
-            }
-          *repeats = offset;
-          repeats += 2;
-        }
-      while (--size > 0);
-    }
+  sprites_file_close (&file);
   return TRUE;
 }
 
@@ -324,11 +324,6 @@ options_free (void)
   bitmap_free (&options[0][0], OPTIONS_MAX_OF_TYPES, OPTION_BOX_MAX_IMAGES,
                OPTION_BOX_MAX_IMAGES);
   bitmap_free (&multiplier_bmp[0], 1, 5, 5);
-  if (options_refresh != NULL)
-    {
-      free_memory ((char *) options_refresh);
-      options_refresh = NULL;
-    }
   if (options_collision != NULL)
     {
       free_memory ((char *) options_collision);
@@ -632,13 +627,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_INC_SPEED, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -661,13 +656,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_REPAIR, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -685,13 +680,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_FRONT_FIRE1, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -708,13 +703,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_FRONT_FIRE2, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -731,13 +726,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_LEFT_FIRE1, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -754,13 +749,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_LEFT_FIRE2, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -778,13 +773,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_RIGHT_FIRE1, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -802,13 +797,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_RIGHT_FIRE2, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -826,13 +821,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_REAR_FIRE1, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -850,13 +845,13 @@ options_check_selected (void)
                 {
                   option_anim_init (OPTION_PANEL_REAR_FIRE2, TRUE);
                 }
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -962,13 +957,13 @@ options_check_selected (void)
                   ship->shot_rear_enhanced = 0;
                 }
               score_multiplier = 0;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_OPTION);
 #endif
             }
           else
             {
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
               sound_play (SOUND_SELECT_CLOSED_OPTION);
 #endif
             }
@@ -988,8 +983,9 @@ options_check_selected (void)
           /* clear X4 score multiplier */
           draw_bitmap_in_options (&multiplier_bmp[MULTIPLIER_CLEAR],
                                   SCORE_MULTIPLIER_XCOORD,
-                                  SCORE_MULTIPLIER_TROP_YCOORD);
-          score_x4_refresh = TRUE;
+                                  SCORE_MULTIPLIER_TROP_YCOORD,
+                                  SCORE_MULTIPLIER_WIDTH,
+                                  SCORE_MULTIPLIER_HEIGHT);
           score_multiplier_clear--;
         }
       if (score_multiplier_clear == 1)
@@ -997,8 +993,9 @@ options_check_selected (void)
           /* clear X2 score multiplier */
           draw_bitmap_in_options (&multiplier_bmp[MULTIPLIER_CLEAR],
                                   SCORE_MULTIPLIER_XCOORD,
-                                  SCORE_MULTIPLIER_BOTTOM_YCOORD);
-          score_x2_refresh = TRUE;
+                                  SCORE_MULTIPLIER_BOTTOM_YCOORD,
+                                  SCORE_MULTIPLIER_WIDTH,
+                                  SCORE_MULTIPLIER_HEIGHT);
           score_multiplier_clear--;
         }
       break;
@@ -1007,20 +1004,23 @@ options_check_selected (void)
     case 2:
       if (!(cmpt_vbls_x4 & 15))
         {
-          score_x4_refresh = TRUE;
           /* display in red */
           if (aff_x4_rj & 1)
             {
               draw_bitmap_in_options (&multiplier_bmp[MULTIPLIER_X4_RED],
                                       SCORE_MULTIPLIER_XCOORD,
-                                      SCORE_MULTIPLIER_TROP_YCOORD);
+                                      SCORE_MULTIPLIER_TROP_YCOORD,
+                                      SCORE_MULTIPLIER_WIDTH,
+                                      SCORE_MULTIPLIER_HEIGHT);
             }
           /* display in yellow */
           else
             {
               draw_bitmap_in_options (&multiplier_bmp[MULTIPLIER_X4_YELLOW],
                                       SCORE_MULTIPLIER_XCOORD,
-                                      SCORE_MULTIPLIER_TROP_YCOORD);
+                                      SCORE_MULTIPLIER_TROP_YCOORD,
+                                      SCORE_MULTIPLIER_WIDTH,
+                                      SCORE_MULTIPLIER_HEIGHT);
             }
           aff_x4_rj++;
         }
@@ -1030,20 +1030,23 @@ options_check_selected (void)
     case 1:
       if (!(cmpt_vbls_x2 & 15))
         {
-          score_x2_refresh = TRUE;
           /* display in red */
           if (aff_x2_rj & 1)
             {
               draw_bitmap_in_options (&multiplier_bmp[MULTIPLIER_X2_RED],
                                       SCORE_MULTIPLIER_XCOORD,
-                                      SCORE_MULTIPLIER_BOTTOM_YCOORD);
+                                      SCORE_MULTIPLIER_BOTTOM_YCOORD,
+                                      SCORE_MULTIPLIER_WIDTH,
+                                      SCORE_MULTIPLIER_HEIGHT);
             }
           /* display in yellow */
           else
             {
               draw_bitmap_in_options (&multiplier_bmp[MULTIPLIER_X2_YELLOW],
                                       SCORE_MULTIPLIER_XCOORD,
-                                      SCORE_MULTIPLIER_BOTTOM_YCOORD);
+                                      SCORE_MULTIPLIER_BOTTOM_YCOORD,
+                                      SCORE_MULTIPLIER_WIDTH,
+                                      SCORE_MULTIPLIER_HEIGHT);
             }
           aff_x2_rj++;
           /* clear X4 score multiplier */
@@ -1051,7 +1054,9 @@ options_check_selected (void)
             {
               draw_bitmap_in_options (&multiplier_bmp[0],
                                       SCORE_MULTIPLIER_XCOORD,
-                                      SCORE_MULTIPLIER_TROP_YCOORD);
+                                      SCORE_MULTIPLIER_TROP_YCOORD,
+                                      SCORE_MULTIPLIER_WIDTH,
+                                      SCORE_MULTIPLIER_HEIGHT);
             }
         }
       cmpt_vbls_x2++;
@@ -1092,9 +1097,7 @@ option_box_animation (Sint32 num_option)
   coord_y = options_positions[num_option][1];
 
   /* display option box image */
-  draw_bitmap_in_options (img, coord_x, coord_y);
-  options_refresh[++opt_refresh_index].coord_x = coord_x;
-  options_refresh[opt_refresh_index].coord_y = coord_y;
+  draw_bitmap_in_options (img, coord_x, coord_y, OPTION_SIZE, OPTION_SIZE);
 }
 
 /** 
@@ -1181,9 +1184,7 @@ option_clear (Sint32 num_option)
     }
   coord_x = options_positions[num_option][0];
   coord_y = options_positions[num_option][1];
-  draw_bitmap_in_options (img, coord_x, coord_y);
-  options_refresh[++opt_refresh_index].coord_x = coord_x;
-  options_refresh[opt_refresh_index].coord_y = coord_y;
+  draw_bitmap_in_options (img, coord_x, coord_y, OPTION_SIZE, OPTION_SIZE);
 }
 
 /** 
@@ -1216,9 +1217,7 @@ option_close_playanim (Sint32 num_option)
   coord_y = options_positions[num_option][1];
   draw_bitmap_in_options (&options[11]
                           [option_boxes[num_option].current_image], coord_x,
-                          coord_y);
-  options_refresh[++opt_refresh_index].coord_x = coord_x;
-  options_refresh[opt_refresh_index].coord_y = coord_y;
+                          coord_y, OPTION_SIZE, OPTION_SIZE);
 }
 
 /** 
@@ -1258,9 +1257,7 @@ option_open_playanim (Sint32 num_option)
   coord_y = options_positions[num_option][1];
   draw_bitmap_in_options (&options[num_ouverture]
                           [option_boxes[num_option].current_image], coord_x,
-                          coord_y);
-  options_refresh[++opt_refresh_index].coord_x = coord_x;
-  options_refresh[opt_refresh_index].coord_y = coord_y;
+                          coord_y, OPTION_SIZE, OPTION_SIZE);
 }
 
 /** 
@@ -1298,9 +1295,8 @@ option_selected_cursor (Sint32 num_option)
     {
       coord_x = options_positions[num_option][0];
       coord_y = options_positions[num_option][1];
-      draw_bitmap_in_options (&options[11][32], coord_x, coord_y);
-      options_refresh[++opt_refresh_index].coord_x = coord_x;
-      options_refresh[opt_refresh_index].coord_y = coord_y;
+      draw_bitmap_in_options (&options[11][32], coord_x, coord_y,
+                              OPTION_SIZE, OPTION_SIZE);
     }
 }
 
@@ -36,6 +36,8 @@ extern "C"
 #define SCORE_MULTIPLIER_XCOORD 41
 #define SCORE_MULTIPLIER_TROP_YCOORD 5
 #define SCORE_MULTIPLIER_BOTTOM_YCOORD 171
+#define SCORE_MULTIPLIER_WIDTH 14
+#define SCORE_MULTIPLIER_HEIGHT 8
 
   typedef enum
   {
@@ -83,19 +85,8 @@ extern "C"
   }
   option;
 
-  typedef struct option_change_coord
-  {
-    Sint32 coord_x;
-    Sint32 coord_y;
-  }
-  option_change_coord;
-
   extern bool option_change;
   extern option option_boxes[OPTIONS_MAX_OF_TYPES];
-  extern option_change_coord *options_refresh;
-  extern Sint32 opt_refresh_index;
-  extern bool score_x2_refresh;
-  extern bool score_x4_refresh;
   extern Uint32 score_multiplier;
 
 #ifdef __cplusplus
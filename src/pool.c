@@ -0,0 +1,236 @@
+/**
+ * @file pool.c
+ * @brief Fixed-size pool of elements with a free list and a chained
+ *        list of the enabled elements
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "arena.h"
+#include "log_recorder.h"
+#include "pool.h"
+
+/** Address of the 'next' pointer of an element */
+#define POOL_NEXT(pool, element) \
+  (*(char **) ((element) + (pool)->next_offset))
+/** Address of the 'previous' pointer of an element */
+#define POOL_PREVIOUS(pool, element) \
+  (*(char **) ((element) + (pool)->previous_offset))
+
+/**
+ * Initialize a pool over an array of elements allocated by the caller
+ * @param pool Pointer to the pool structure
+ * @param name Name of the elements, used in the error messages
+ * @param elements Array of the elements
+ * @param element_size Size of an element in bytes
+ * @param max_of_elements Number of elements of the array
+ * @param next_offset Offset of the 'next' pointer in an element
+ * @param previous_offset Offset of the 'previous' pointer in an element
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+pool_init (pool_struct * pool, const char *name, char *elements,
+           Uint32 element_size, Uint32 max_of_elements,
+           Uint32 next_offset, Uint32 previous_offset)
+{
+  pool->name = name;
+  pool->elements = elements;
+  pool->element_size = element_size;
+  pool->max_of_elements = max_of_elements;
+  pool->next_offset = next_offset;
+  pool->previous_offset = previous_offset;
+  if (pool->free_elements == NULL)
+    {
+      pool->free_elements =
+        (char **) arena_alloc (ARENA_PROCESS,
+                               max_of_elements * sizeof (char *));
+      if (pool->free_elements == NULL)
+        {
+          LOG_ERR ("not enough memory to allocate the '%s' free list",
+                   name);
+          return FALSE;
+        }
+    }
+  pool_reset (pool);
+  return TRUE;
+}
+
+/**
+ * Forget the free list and the elements of a pool. Nothing is
+ * released here: the free list belongs to the process arena,
+ * released by arenas_free(), and the array of the elements to
+ * the caller
+ * @param pool Pointer to the pool structure
+ */
+void
+pool_free (pool_struct * pool)
+{
+  pool->free_elements = NULL;
+  pool->elements = NULL;
+  pool->first = NULL;
+  pool->last = NULL;
+  pool->free_head = 0;
+  pool->numof_free = 0;
+  pool->numof_enabled = 0;
+}
+
+/**
+ * Disable all the elements of a pool
+ * @param pool Pointer to the pool structure
+ */
+void
+pool_reset (pool_struct * pool)
+{
+  Uint32 i;
+  for (i = 0; i < pool->max_of_elements; i++)
+    {
+      pool->free_elements[i] = pool->elements + i * pool->element_size;
+    }
+  pool->free_head = 0;
+  pool->numof_free = pool->max_of_elements;
+  pool->first = NULL;
+  pool->last = NULL;
+  pool->numof_enabled = 0;
+}
+
+/**
+ * Take a free element and append it to the chained list
+ * @param pool Pointer to the pool structure
+ * @return Pointer to the element, NULL if no element is available
+ */
+char *
+pool_get (pool_struct * pool)
+{
+  char *element;
+  if (pool->numof_free == 0)
+    {
+      return NULL;
+    }
+  element = pool->free_elements[pool->free_head];
+  if (++pool->free_head == pool->max_of_elements)
+    {
+      pool->free_head = 0;
+    }
+  pool->numof_free--;
+  POOL_NEXT (pool, element) = NULL;
+  if (pool->numof_enabled == 0)
+    {
+      pool->first = element;
+      POOL_PREVIOUS (pool, element) = NULL;
+    }
+  else
+    {
+      POOL_NEXT (pool, pool->last) = element;
+      POOL_PREVIOUS (pool, element) = pool->last;
+    }
+  pool->last = element;
+  pool->numof_enabled++;
+#ifdef UNDER_DEVELOPMENT
+  pool_check (pool);
+#endif
+  return element;
+}
+
+/**
+ * Remove an element from the chained list and queue it at the end of
+ * the free list. The 'next' pointer of the element is left untouched
+ * and the element is the last one to be given again, so that a loop
+ * over the chained list can go on after the removal
+ * @param pool Pointer to the pool structure
+ * @param element Pointer to the element to release
+ */
+void
+pool_release (pool_struct * pool, char *element)
+{
+  char *next = POOL_NEXT (pool, element);
+  char *previous = POOL_PREVIOUS (pool, element);
+  Uint32 index;
+  pool->numof_enabled--;
+  if (pool->first == element)
+    {
+      pool->first = next;
+    }
+  if (pool->last == element)
+    {
+      pool->last = previous;
+    }
+  if (previous != NULL)
+    {
+      POOL_NEXT (pool, previous) = next;
+    }
+  if (next != NULL)
+    {
+      POOL_PREVIOUS (pool, next) = previous;
+    }
+  index = pool->free_head + pool->numof_free++;
+  if (index >= pool->max_of_elements)
+    {
+      index -= pool->max_of_elements;
+    }
+  pool->free_elements[index] = element;
+}
+
+/**
+ * Check validity of the chained list of a pool
+ * @param pool Pointer to the pool structure
+ */
+#ifdef UNDER_DEVELOPMENT
+void
+pool_check (pool_struct * pool)
+{
+  char *element;
+  Sint32 count;
+  if (pool->numof_free + pool->numof_enabled != pool->max_of_elements)
+    {
+      LOG_ERR ("Counting of the %s free elements failed!"
+               "free=%i, enabled=%i", pool->name, pool->numof_free,
+               pool->numof_enabled);
+    }
+  count = 0;
+  for (element = pool->first;
+       element != NULL && count <= (Sint32) pool->max_of_elements;
+       element = POOL_NEXT (pool, element))
+    {
+      count++;
+    }
+  if (count != pool->numof_enabled)
+    {
+      LOG_ERR ("Counting of the %s next elements failed!"
+               "count=%i, enabled=%i", pool->name, count,
+               pool->numof_enabled);
+    }
+  count = 0;
+  for (element = pool->last;
+       element != NULL && count <= (Sint32) pool->max_of_elements;
+       element = POOL_PREVIOUS (pool, element))
+    {
+      count++;
+    }
+  if (count != pool->numof_enabled)
+    {
+      LOG_ERR ("Counting of the %s previous elements failed!"
+               "count=%i, enabled=%i", pool->name, count,
+               pool->numof_enabled);
+    }
+}
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file pool.h
+ * @brief Fixed-size pool of elements with a free list and a chained
+ *        list of the enabled elements
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __POOL__
+#define __POOL__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * The elements are chained by their own 'next' and 'previous'
+   * pointers, whose offsets are given to pool_init()
+   */
+  typedef struct pool_struct
+  {
+    /** Name of the elements, used in the error messages */
+    const char *name;
+    /** Array of the elements */
+    char *elements;
+    /** Size of an element in bytes */
+    Uint32 element_size;
+    /** Number of elements of the array */
+    Uint32 max_of_elements;
+    /** Offset of the 'next' pointer in an element */
+    Uint32 next_offset;
+    /** Offset of the 'previous' pointer in an element */
+    Uint32 previous_offset;
+    /** Circular queue of the free elements */
+    char **free_elements;
+    /** Index of the next free element to give in the queue */
+    Uint32 free_head;
+    /** Number of elements in the queue of free elements */
+    Uint32 numof_free;
+    /** First element of the chained list of the enabled elements */
+    char *first;
+    /** Last element of the chained list of the enabled elements */
+    char *last;
+    /** Number of enabled elements */
+    Sint32 numof_enabled;
+  } pool_struct;
+
+  bool pool_init (pool_struct * pool, const char *name, char *elements,
+                  Uint32 element_size, Uint32 max_of_elements,
+                  Uint32 next_offset, Uint32 previous_offset);
+  void pool_free (pool_struct * pool);
+  void pool_reset (pool_struct * pool);
+  char *pool_get (pool_struct * pool);
+  void pool_release (pool_struct * pool, char *element);
+#ifdef UNDER_DEVELOPMENT
+  void pool_check (pool_struct * pool);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -48,6 +48,7 @@
 #include "meteors_phase.h"
 #include "movie.h"
 #include "options_panel.h"
+#include "profiler.h"
 #include "satellite_protections.h"
 #include "scrolltext.h"
 #include "shockwave.h"
@@ -59,6 +60,9 @@
 #include "text_overlay.h"
 
 Sint32 global_counter;
+/** FALSE while a frame late is simulated: it won't be displayed, so
+ * the objects move but the game offscreen isn't drawn */
+bool offscreen_draw_enable = TRUE;
 /** Pause mode is enable */
 bool player_pause;
 /** TRUE if "PAUSE" string is currently displayed */
@@ -100,6 +104,7 @@ update_frame (void)
    * ("movie_congratulation.gca" and "movie_introduction.gca") */
   if (movie_playing_switch != MOVIE_NOT_PLAYED)
     {
+      PROFILER_BEGIN (PROFILER_MOVIE);
       if (!movie_player ())
         {
           LOG_ERR ("movie_player() failed!");
@@ -107,11 +112,17 @@ update_frame (void)
         }
       else
         {
+          PROFILER_END (PROFILER_MOVIE);
           return TRUE;
         }
     }
 
-  display_clear_offscreen ();
+  if (offscreen_draw_enable)
+    {
+      PROFILER_BEGIN (PROFILER_CLEAR_OFFSCREEN);
+      display_clear_offscreen ();
+      PROFILER_END (PROFILER_CLEAR_OFFSCREEN);
+    }
 
 #ifdef __EMSCRIPTEN__
   lock_surface_game ();
@@ -146,59 +157,86 @@ update_frame (void)
        * handle the phases of the game 
        */
       /* phase 2: grids (enemy wave like Space Invaders) */
+      PROFILER_BEGIN (PROFILER_GRID);
       grid_handle ();
+      PROFILER_END (PROFILER_GRID);
       /* phase 1: curves (little skirmish) */
+      PROFILER_BEGIN (PROFILER_CURVE);
       curve_phase ();
+      PROFILER_END (PROFILER_CURVE);
       /* phase 3: meteor storm */
+      PROFILER_BEGIN (PROFILER_METEORS);
       meteors_handle ();
+      PROFILER_END (PROFILER_METEORS);
     }
 
   /* draw the starfield background */
+  PROFILER_BEGIN (PROFILER_STARFIELD);
   starfield_handle ();
+  PROFILER_END (PROFILER_STARFIELD);
 
   /* handle bonus: green, red, yellow, blue and purple gems */
+  PROFILER_BEGIN (PROFILER_BONUS);
   bonus_handle ();
+  PROFILER_END (PROFILER_BONUS);
 
   /* handle protection satellites and extra gun of the player spaceship  */
   if (!gameover_enable && menu_section == NO_SECTION_SELECTED)
     {
       /* orbital protection satellites gravitate around player's spaceship */
+      PROFILER_BEGIN (PROFILER_SATELLITES);
       satellites_handle ();
+      PROFILER_END (PROFILER_SATELLITES);
       /* extra gun positioned on the sides */
+      PROFILER_BEGIN (PROFILER_GUNS);
       guns_handle ();
+      PROFILER_END (PROFILER_GUNS);
     }
 
   /* handle enemies */
   if (!is_congratulations_enabled)
     {
       /* handling of all the possible types of enemies */
+      PROFILER_BEGIN (PROFILER_ENEMIES);
       enemies_handle ();
+      PROFILER_END (PROFILER_ENEMIES);
     }
   else
     {
       /* congratulations, end of the game */
+      PROFILER_BEGIN (PROFILER_CONGRATULATIONS);
       congratulations ();
+      PROFILER_END (PROFILER_CONGRATULATIONS);
     }
 
   /* spaceship temporary invincibility  */
   spaceship_invincibility ();
 
   /* handle the powerful electrical shocks */
+  PROFILER_BEGIN (PROFILER_ELECTRICAL_SHOCK);
   electrical_shock ();
+  PROFILER_END (PROFILER_ELECTRICAL_SHOCK);
 
   /* draw the player's spaceship */
+  PROFILER_BEGIN (PROFILER_SPACESHIP);
   spaceship_draw ();
+  PROFILER_END (PROFILER_SPACESHIP);
 
   /* handle explosions */
+  PROFILER_BEGIN (PROFILER_EXPLOSIONS);
   explosions_handle ();
+  PROFILER_END (PROFILER_EXPLOSIONS);
 
   /* handle shots */
+  PROFILER_BEGIN (PROFILER_SHOTS);
   shots_handle ();
+  PROFILER_END (PROFILER_SHOTS);
 
   /* wait until all enemies are dead before jumping on next phase */
   if (num_of_enemies == 0 && !player_pause && menu_status == MENU_OFF
       && menu_section == NO_SECTION_SELECTED)
     {
+      PROFILER_BEGIN (PROFILER_PHASES_END);
       /* end of a guardian phase? */
       if (!guardian_finished ())
         {
@@ -215,6 +253,7 @@ update_frame (void)
           LOG_ERR ("meteors_finished failed!");
           return FALSE;
         }
+      PROFILER_END (PROFILER_PHASES_END);
     }
 
   /* display pixel mouse pointer */
@@ -226,13 +265,19 @@ update_frame (void)
 #endif
 
   /* draw powerful circular shock wave propagated by the player spaceship */
+  PROFILER_BEGIN (PROFILER_SHOCKWAVE);
   shockwave_draw ();
+  PROFILER_END (PROFILER_SHOCKWAVE);
 
   /* animations of the options box on the right options panel */
+  PROFILER_BEGIN (PROFILER_OPTIONS);
   option_execution ();
+  PROFILER_END (PROFILER_OPTIONS);
 
   /* handle high score table, game over, about and order sections */
+  PROFILER_BEGIN (PROFILER_MENU_SECTIONS);
   menu_sections_run ();
+  PROFILER_END (PROFILER_MENU_SECTIONS);
 
   /* display "PAUSE" chars sprites */
   if (is_pause_draw)
@@ -275,10 +320,14 @@ update_frame (void)
   text_level_draw ();
 
   /* display scrolltext in the main menu */
+  PROFILER_BEGIN (PROFILER_SCROLLTEXT);
   scrolltext_handle ();
+  PROFILER_END (PROFILER_SCROLLTEXT);
 
   /* handle the main menu of Powermanga */
+  PROFILER_BEGIN (PROFILER_MENU);
   menu_handle ();
+  PROFILER_END (PROFILER_MENU);
 
   /* [F1] spaceship_appears / [F2] spaceship disappears */
 #ifdef DEVELOPPEMENT
@@ -318,19 +367,25 @@ update_frame (void)
     }
 
   /* display text overlay (about, cheats menu and variables) */
+  PROFILER_BEGIN (PROFILER_TEXT_OVERLAY);
   text_overlay_draw ();
+  PROFILER_END (PROFILER_TEXT_OVERLAY);
 
   /* handle the loss and the regression of the spaceship or cause game over */
   spaceship_downgrading ();
 
   /* handle spaceship's energy level */
+  PROFILER_BEGIN (PROFILER_ENERGY_GAUGES);
   energy_gauge_spaceship_update ();
 
   /* handle guardian's energy level */
   energy_gauge_guardian_update ();
+  PROFILER_END (PROFILER_ENERGY_GAUGES);
 
   /* draw player's score into the top panel */
+  PROFILER_BEGIN (PROFILER_SCORE);
   text_draw_score ();
+  PROFILER_END (PROFILER_SCORE);
 
 #ifdef DEVELOPPEMENT
   if (keys_down[K_E] && keys_down[K_G])
@@ -386,6 +441,17 @@ update_frame (void)
   keys_down[K_F11] = FALSE;
 #endif
 
+  /* [F12] write the timings of the last frames */
+#ifdef USE_PROFILER
+  if (keys_down[K_F12])
+    {
+      profiler_export (power_conf->profile_file != NULL ?
+                       power_conf->profile_file :
+                       PROFILER_DEFAULT_FILENAME);
+    }
+  keys_down[K_F12] = FALSE;
+#endif
+
   /* control the speed of the spaceship */
   spaceship_speed_control ();
 
@@ -404,7 +470,9 @@ update_frame (void)
       && menu_section == NO_SECTION_SELECTED)
 #endif
     {
+      PROFILER_BEGIN (PROFILER_WEAPONS);
       spaceship_weapons ();
+      PROFILER_END (PROFILER_WEAPONS);
     }
 
 #ifdef __EMSCRIPTEN__
@@ -31,11 +31,17 @@
 #endif
 #define POWERMANGA_VERSION PACKAGE_STRING " 2015-09-09 "
 
-#if !defined(POWERMANGA_SDL) && !defined(POWERMANGA_X11)
+#if !defined(POWERMANGA_SDL) && !defined(POWERMANGA_X11) \
+  && !defined(POWERMANGA_HEADLESS)
 #define POWERMANGA_SDL
 #endif
 
-#if defined(POWERMANGA_X11)
+#if defined(POWERMANGA_HEADLESS)
+/** No window and no sound, frames are only drawn into the offscreens */
+#undef POWERMANGA_SDL
+#undef POWERMANGA_X11
+#undef USE_SDLMIXER
+#elif defined(POWERMANGA_X11)
 #undef POWERMANGA_SDL
 #else
 #if !defined(POWERMANGA_SDL)
@@ -58,6 +64,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 #ifdef _WIN32
 #ifndef _WIN32_WCE
@@ -74,9 +81,11 @@
 #include <unistd.h>
 #endif
 
-#ifdef __EMSCRIPTEN__
+#if defined(__EMSCRIPTEN__) || defined(POWERMANGA_HEADLESS)
 #include <string.h>
 #include <ctype.h>
+#endif
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
@@ -131,7 +140,7 @@
 
 #ifndef POWERMANGA_SDL
 
-/** Use X Window for display */
+/** Use X Window for display, the headless build uses the X11 keysyms too */
 #include <X11/keysym.h>
 #include <X11/keysymdef.h>
 typedef unsigned char Uint8;
@@ -140,6 +149,7 @@ typedef signed short Sint16;
 typedef unsigned short Uint16;
 typedef signed int Sint32;
 typedef unsigned int Uint32;
+typedef unsigned long long Uint64;
 
 /** Else use SDL */
 #else
@@ -168,6 +178,15 @@ typedef unsigned int Uint32;
 #undef USE_SDLMIXER
 #endif
 
+#ifdef USE_SOFTMIXER
+/** The sounds are mixed by the game, SDL_mixer isn't used */
+#undef USE_SDLMIXER
+#endif
+#if defined(USE_SDLMIXER) || defined(USE_SOFTMIXER)
+/** The sounds are played by SDL_mixer or by the software mixer */
+#define USE_SOUND
+#endif
+
 #ifdef USE_SDLMIXER
 #if defined(_WIN32_WCE) || defined(_WIN32)
 #include <SDL_thread.h>
@@ -238,6 +257,8 @@ extern "C"
   extern bool gameover_enable;
   extern Sint32 global_counter;
   extern Uint32 loops_counter;
+  extern Uint32 frames_displayed;
+  extern bool offscreen_draw_enable;
   extern bool player_pause;
   extern bool is_pause_draw;
   extern Sint32 player_score;
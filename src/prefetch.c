@@ -0,0 +1,354 @@
+/**
+ * @file prefetch.c
+ * @brief Load the sprites and the files of the next level in a thread
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "arena.h"
+#include "curve_phase.h"
+#include "images.h"
+#include "enemies.h"
+#include "grid_phase.h"
+#include "guardians.h"
+#include "log_recorder.h"
+#include "meteors_phase.h"
+#include "prefetch.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/** States of a slot */
+typedef enum
+{
+  /** Nothing requested or the data was taken */
+  PREFETCH_EMPTY,
+  /** Waiting for the thread */
+  PREFETCH_PENDING,
+  /** Loaded by the thread */
+  PREFETCH_LOADING,
+  /** Loaded, waiting for prefetch_take() */
+  PREFETCH_READY,
+  /** The thread failed to load the data */
+  PREFETCH_FAILED
+}
+PREFETCH_STATES;
+
+/** Data loaded in advance into a buffer of its module */
+typedef struct prefetch_slot
+{
+  /** Load the data into the buffer of the module */
+  bool (*load) (Sint32 num);
+  /** Release the data of the buffer which was not taken */
+  void (*discard) (void);
+  /** Number of the guardian or of the level */
+  Sint32 num;
+  /** PREFETCH_EMPTY, PREFETCH_PENDING, ... */
+  Uint32 state;
+} prefetch_slot;
+
+#if defined(HAVE_PTHREAD_H) && !defined(USE_MALLOC_WRAPPER)
+static prefetch_slot prefetch_slots[PREFETCH_NUMOF] = {
+  {guardian_prefetch, guardian_prefetch_discard, 0, PREFETCH_EMPTY},
+  {grid_prefetch, grid_prefetch_discard, 0, PREFETCH_EMPTY},
+  {curve_prefetch, curve_prefetch_discard, 0, PREFETCH_EMPTY},
+  {meteors_prefetch, meteors_prefetch_discard, 0, PREFETCH_EMPTY}
+};
+
+static pthread_t prefetch_thread;
+/** Protect the slots and the following variables */
+static pthread_mutex_t prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Signaled when a slot is requested or the thread must quit,
+ * and when a slot is loaded */
+static pthread_cond_t prefetch_cond = PTHREAD_COND_INITIALIZER;
+/** TRUE if the thread must quit */
+static bool prefetch_quit = FALSE;
+/** TRUE if the thread is running */
+static bool prefetch_running = FALSE;
+
+/**
+ * Return the first slot waiting for the thread, the mutex must be locked
+ * @return Pointer to the slot, or NULL if there is none
+ */
+static prefetch_slot *
+prefetch_pending (void)
+{
+  Uint32 i;
+  for (i = 0; i < PREFETCH_NUMOF; i++)
+    {
+      if (prefetch_slots[i].state == PREFETCH_PENDING)
+        {
+          return &prefetch_slots[i];
+        }
+    }
+  return NULL;
+}
+
+/**
+ * Main function of the thread: wait for a request and load its data
+ * @param arg Unused
+ * @return Always NULL
+ */
+static void *
+prefetch_loop (void *arg)
+{
+  Sint32 num;
+  bool result;
+  prefetch_slot *slot;
+  (void) arg;
+  pthread_mutex_lock (&prefetch_mutex);
+  for (;;)
+    {
+      while ((slot = prefetch_pending ()) == NULL && !prefetch_quit)
+        {
+          pthread_cond_wait (&prefetch_cond, &prefetch_mutex);
+        }
+      if (prefetch_quit)
+        {
+          break;
+        }
+      slot->state = PREFETCH_LOADING;
+      num = slot->num;
+      pthread_mutex_unlock (&prefetch_mutex);
+      result = slot->load (num);
+      pthread_mutex_lock (&prefetch_mutex);
+      slot->state = result ? PREFETCH_READY : PREFETCH_FAILED;
+      pthread_cond_broadcast (&prefetch_cond);
+    }
+  pthread_mutex_unlock (&prefetch_mutex);
+  return NULL;
+}
+
+/**
+ * Wait until the thread no longer loads the data of a slot, then
+ * release the data not taken, the mutex must be locked
+ * @param slot Pointer to the slot
+ */
+static void
+prefetch_reset (prefetch_slot * slot)
+{
+  while (slot->state == PREFETCH_LOADING)
+    {
+      pthread_cond_wait (&prefetch_cond, &prefetch_mutex);
+    }
+  if (slot->state == PREFETCH_READY)
+    {
+      slot->discard ();
+    }
+  slot->state = PREFETCH_EMPTY;
+}
+#endif
+
+/**
+ * Start the thread which loads the data in advance
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+prefetch_init (void)
+{
+#if defined(HAVE_PTHREAD_H) && !defined(USE_MALLOC_WRAPPER)
+  prefetch_free ();
+  prefetch_quit = FALSE;
+  if (pthread_create (&prefetch_thread, NULL, prefetch_loop, NULL) != 0)
+    {
+      /* the data will be loaded when needed */
+      LOG_ERR ("pthread_create() failed");
+      return TRUE;
+    }
+  prefetch_running = TRUE;
+#endif
+  return TRUE;
+}
+
+/**
+ * Stop the thread and release the data which were not taken
+ */
+void
+prefetch_free (void)
+{
+#if defined(HAVE_PTHREAD_H) && !defined(USE_MALLOC_WRAPPER)
+  Uint32 i;
+  if (!prefetch_running)
+    {
+      return;
+    }
+  pthread_mutex_lock (&prefetch_mutex);
+  for (i = 0; i < PREFETCH_NUMOF; i++)
+    {
+      prefetch_reset (&prefetch_slots[i]);
+    }
+  prefetch_quit = TRUE;
+  pthread_cond_broadcast (&prefetch_cond);
+  pthread_mutex_unlock (&prefetch_mutex);
+  pthread_join (prefetch_thread, NULL);
+  prefetch_running = FALSE;
+#endif
+}
+
+/**
+ * Ask the thread to load data, the request replaces the previous one
+ * of the same slot
+ * @param slot PREFETCH_GUARDIAN, PREFETCH_GRID, ...
+ * @param num Number of the guardian or of the level
+ */
+void
+prefetch_request (Uint32 slot, Sint32 num)
+{
+#if defined(HAVE_PTHREAD_H) && !defined(USE_MALLOC_WRAPPER)
+  prefetch_slot *pslot = &prefetch_slots[slot];
+  if (!prefetch_running)
+    {
+      return;
+    }
+  pthread_mutex_lock (&prefetch_mutex);
+  if (pslot->num != num || pslot->state == PREFETCH_FAILED)
+    {
+      prefetch_reset (pslot);
+    }
+  if (pslot->state == PREFETCH_EMPTY)
+    {
+      pslot->num = num;
+      pslot->state = PREFETCH_PENDING;
+      pthread_cond_broadcast (&prefetch_cond);
+    }
+  pthread_mutex_unlock (&prefetch_mutex);
+#else
+  (void) slot;
+  (void) num;
+#endif
+}
+
+/**
+ * Take the data loaded in advance, waiting for the thread if it
+ * is still loading them. The module moves them from its prefetch
+ * buffer to the data used by the game
+ * @param slot PREFETCH_GUARDIAN, PREFETCH_GRID, ...
+ * @param num Number of the guardian or of the level
+ * @return TRUE if the data are in the buffer of the module, FALSE if
+ *         they must be loaded now
+ */
+bool
+prefetch_take (Uint32 slot, Sint32 num)
+{
+#if defined(HAVE_PTHREAD_H) && !defined(USE_MALLOC_WRAPPER)
+  bool result = FALSE;
+  prefetch_slot *pslot = &prefetch_slots[slot];
+  if (!prefetch_running)
+    {
+      return FALSE;
+    }
+  pthread_mutex_lock (&prefetch_mutex);
+  while (pslot->state == PREFETCH_LOADING)
+    {
+      pthread_cond_wait (&prefetch_cond, &prefetch_mutex);
+    }
+  if (pslot->state == PREFETCH_READY && pslot->num == num)
+    {
+      pslot->state = PREFETCH_EMPTY;
+      result = TRUE;
+    }
+  else
+    {
+      prefetch_reset (pslot);
+    }
+  pthread_mutex_unlock (&prefetch_mutex);
+  return result;
+#else
+  (void) slot;
+  (void) num;
+  return FALSE;
+#endif
+}
+
+/**
+ * Release the level files of the previous levels, unless the thread
+ * loads or holds the files of the requested level
+ * @param level Level number
+ */
+static void
+prefetch_level_files_free (Sint32 level)
+{
+#if defined(HAVE_PTHREAD_H) && !defined(USE_MALLOC_WRAPPER)
+  Uint32 i;
+  bool unused = TRUE;
+  prefetch_slot *pslot;
+  if (prefetch_running)
+    {
+      pthread_mutex_lock (&prefetch_mutex);
+      for (i = PREFETCH_GRID; i <= PREFETCH_CURVES; i++)
+        {
+          pslot = &prefetch_slots[i];
+          if (pslot->num != level || pslot->state == PREFETCH_FAILED)
+            {
+              prefetch_reset (pslot);
+            }
+          if (pslot->state != PREFETCH_EMPTY)
+            {
+              unused = FALSE;
+            }
+        }
+      if (unused)
+        {
+          arena_reset (ARENA_LEVEL);
+        }
+      pthread_mutex_unlock (&prefetch_mutex);
+      return;
+    }
+#else
+  (void) level;
+#endif
+  arena_reset (ARENA_LEVEL);
+}
+
+/**
+ * Start loading the data of a level, as soon as the previous one begins
+ * @param level Level number, the level after the last one is 0
+ */
+void
+prefetch_level (Sint32 level)
+{
+  Sint32 guardian_num;
+  if (level > MAX_NUM_OF_LEVELS || level < 0)
+    {
+      level = 0;
+    }
+  prefetch_level_files_free (level);
+  guardian_num = guardian_of_level (level);
+  if (guardian_num > 0)
+    {
+      prefetch_request (PREFETCH_GUARDIAN, guardian_num);
+    }
+  prefetch_request (PREFETCH_GRID, level);
+  prefetch_request (PREFETCH_CURVES, level);
+  prefetch_request (PREFETCH_METEORS, level);
+}
+
+/**
+ * Start loading the data of the first level, while the menu is displayed
+ */
+void
+prefetch_new_game (void)
+{
+  prefetch_request (PREFETCH_GUARDIAN, 1);
+  prefetch_level (0);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file prefetch.h
+ * @brief Load the sprites and the files of the next level in a thread
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __PREFETCH__
+#define __PREFETCH__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /** Data loaded in advance, one of each at a time */
+  typedef enum
+  {
+    /** Sprites of a guardian, number from 1 to 14 */
+    PREFETCH_GUARDIAN,
+    /** Grid phase file of a level */
+    PREFETCH_GRID,
+    /** Curve phase file of a level */
+    PREFETCH_CURVES,
+    /** Sprites of the meteors of a level */
+    PREFETCH_METEORS,
+    PREFETCH_NUMOF
+  }
+  PREFETCH_ENUM;
+
+  bool prefetch_init (void);
+  void prefetch_free (void);
+  void prefetch_request (Uint32 slot, Sint32 num);
+  bool prefetch_take (Uint32 slot, Sint32 num);
+  void prefetch_level (Sint32 level);
+  void prefetch_new_game (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
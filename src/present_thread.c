@@ -0,0 +1,332 @@
+/**
+ * @file present_thread.c
+ * @brief Scale a frame in a thread while the next one is simulated
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "config_file.h"
+#include "display.h"
+#include "dirty_rects.h"
+#include "log_recorder.h"
+#include "present_thread.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/** Function of the display which scales a frame */
+static present_frame_func present_func = NULL;
+/** Frame given to the thread: the last offscreen of the game drawn
+ * and copies of the panels */
+static present_frame present_front;
+/** Offscreen of the game created by the display, given back to it
+ * when the thread is stopped */
+static char *present_game_offscreen = NULL;
+/** TRUE if the whole panels must be copied to the next frame */
+static bool present_copy_all = TRUE;
+
+#ifdef HAVE_PTHREAD_H
+static pthread_t present_thread;
+/** Protect the following variables */
+static pthread_mutex_t present_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Signaled when a frame is given or the thread must quit,
+ * and when the frame is done */
+static pthread_cond_t present_cond = PTHREAD_COND_INITIALIZER;
+/** TRUE while the thread scales the front frame */
+static bool present_pending = FALSE;
+/** TRUE if a frame was given since the last present_thread_wait() */
+static bool present_started = FALSE;
+/** TRUE if the thread must quit */
+static bool present_quit = FALSE;
+/** TRUE if the thread is running */
+static bool present_running = FALSE;
+
+/**
+ * Main function of the thread: wait for a frame and scale it
+ * @param arg Unused
+ * @return Always NULL
+ */
+static void *
+present_loop (void *arg)
+{
+  (void) arg;
+  pthread_mutex_lock (&present_mutex);
+  for (;;)
+    {
+      while (!present_pending && !present_quit)
+        {
+          pthread_cond_wait (&present_cond, &present_mutex);
+        }
+      if (present_quit)
+        {
+          break;
+        }
+      pthread_mutex_unlock (&present_mutex);
+      present_func (&present_front);
+      pthread_mutex_lock (&present_mutex);
+      present_pending = FALSE;
+      pthread_cond_broadcast (&present_cond);
+    }
+  pthread_mutex_unlock (&present_mutex);
+  return NULL;
+}
+#endif
+
+/**
+ * Allocate the second offscreen of the game and the copies of the
+ * panels, then start the thread. The offscreens must be created
+ * @param func Function of the display which scales a frame
+ * @return TRUE if the thread is started, FALSE if the frames will be
+ *         scaled by the main thread
+ */
+bool
+present_thread_init (present_frame_func func)
+{
+#ifdef HAVE_PTHREAD_H
+  present_thread_free ();
+  present_func = func;
+  present_front.game_offscreen =
+    memory_allocation (offscreen_width * offscreen_height * bytes_per_pixel);
+  present_front.scores_offscreen =
+    memory_allocation (score_offscreen_width * score_offscreen_height *
+                       bytes_per_pixel);
+  present_front.options_offscreen =
+    memory_allocation (OPTIONS_WIDTH * OPTIONS_HEIGHT * bytes_per_pixel);
+  if (present_front.game_offscreen == NULL
+      || present_front.scores_offscreen == NULL
+      || present_front.options_offscreen == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate the frame of the thread");
+      present_thread_free ();
+      return FALSE;
+    }
+  present_game_offscreen = game_offscreen;
+  present_copy_all = TRUE;
+  present_pending = FALSE;
+  present_started = FALSE;
+  present_quit = FALSE;
+  if (pthread_create (&present_thread, NULL, present_loop, NULL) != 0)
+    {
+      LOG_ERR ("pthread_create() failed");
+      present_thread_free ();
+      return FALSE;
+    }
+  present_running = TRUE;
+  LOG_INF ("frames scaled by a thread");
+  return TRUE;
+#else
+  (void) func;
+  return FALSE;
+#endif
+}
+
+/**
+ * Stop the thread, give back its offscreen of the game to the display
+ * and release the copies
+ */
+void
+present_thread_free (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (present_running)
+    {
+      pthread_mutex_lock (&present_mutex);
+      while (present_pending)
+        {
+          pthread_cond_wait (&present_cond, &present_mutex);
+        }
+      present_quit = TRUE;
+      pthread_cond_broadcast (&present_cond);
+      pthread_mutex_unlock (&present_mutex);
+      pthread_join (present_thread, NULL);
+      present_running = FALSE;
+    }
+#endif
+  if (present_game_offscreen != NULL)
+    {
+      /* the two offscreens can be swapped */
+      if (present_front.game_offscreen == present_game_offscreen)
+        {
+          present_front.game_offscreen = game_offscreen;
+        }
+      game_offscreen = present_game_offscreen;
+      present_game_offscreen = NULL;
+    }
+  if (present_front.game_offscreen != NULL)
+    {
+      free_memory (present_front.game_offscreen);
+      present_front.game_offscreen = NULL;
+    }
+  if (present_front.scores_offscreen != NULL)
+    {
+      free_memory (present_front.scores_offscreen);
+      present_front.scores_offscreen = NULL;
+    }
+  if (present_front.options_offscreen != NULL)
+    {
+      free_memory (present_front.options_offscreen);
+      present_front.options_offscreen = NULL;
+    }
+}
+
+/**
+ * Check if the frames are scaled by the thread
+ * @return TRUE if the thread is running
+ */
+bool
+present_thread_enabled (void)
+{
+#ifdef HAVE_PTHREAD_H
+  return present_running;
+#else
+  return FALSE;
+#endif
+}
+
+/**
+ * Wait until the thread has finished to scale the previous frame,
+ * the window can then be updated
+ * @return TRUE if a frame was scaled since the last call
+ */
+bool
+present_thread_wait (void)
+{
+#ifdef HAVE_PTHREAD_H
+  bool started;
+  if (!present_running)
+    {
+      return FALSE;
+    }
+  pthread_mutex_lock (&present_mutex);
+  while (present_pending)
+    {
+      pthread_cond_wait (&present_cond, &present_mutex);
+    }
+  started = present_started;
+  present_started = FALSE;
+  pthread_mutex_unlock (&present_mutex);
+  return started;
+#else
+  return FALSE;
+#endif
+}
+
+/**
+ * Copy a modified area of a panel into the copy of the thread
+ * @param rect Area of the panel, in the copy
+ * @param data Unused
+ */
+static void
+copy_dirty_rect (dirty_rect * rect, void *data)
+{
+  Sint32 y;
+  Uint32 size = rect->w * bytes_per_pixel;
+  char *dest = rect->pixels;
+  char *source;
+  (void) data;
+  if (rect->panel == DIRTY_SCORE_PANEL)
+    {
+      source = scores_offscreen + (dest - present_front.scores_offscreen);
+    }
+  else
+    {
+      source = options_offscreen + (dest - present_front.options_offscreen);
+    }
+  for (y = 0; y < rect->h; y++)
+    {
+      memcpy (dest, source, size);
+      dest += rect->pitch;
+      source += rect->pitch;
+    }
+}
+
+/**
+ * Give the frame just drawn to the thread, which scales it while the
+ * next one is drawn into the other offscreen, the modified areas of
+ * the panels and the full update flag are moved to the thread.
+ * present_thread_wait() must have been called before
+ */
+void
+present_thread_start (void)
+{
+#ifdef HAVE_PTHREAD_H
+  char *offscreen;
+  dirty_rects_list copied;
+  if (!present_running)
+    {
+      return;
+    }
+
+  /* swap the offscreens of the game, all its visible area is
+   * drawn again at each frame */
+  offscreen = present_front.game_offscreen;
+  present_front.game_offscreen = game_offscreen;
+  game_offscreen = offscreen;
+
+  /* update the copies of the panels */
+  dirty_rects_take (&present_front.dirty);
+  present_front.update_all = update_all;
+  update_all = FALSE;
+  if (present_front.update_all || present_copy_all)
+    {
+      memcpy (present_front.scores_offscreen, scores_offscreen,
+              score_offscreen_width * score_offscreen_height *
+              bytes_per_pixel);
+      memcpy (present_front.options_offscreen, options_offscreen,
+              OPTIONS_WIDTH * OPTIONS_HEIGHT * bytes_per_pixel);
+      present_front.update_all = TRUE;
+      present_copy_all = FALSE;
+    }
+  else
+    {
+      /* the list is emptied by the flush, copy it first */
+      copied = present_front.dirty;
+      dirty_rects_list_flush (&copied, present_front.scores_offscreen,
+                              present_front.options_offscreen,
+                              copy_dirty_rect, NULL);
+    }
+
+  pthread_mutex_lock (&present_mutex);
+  present_pending = TRUE;
+  present_started = TRUE;
+  pthread_cond_broadcast (&present_cond);
+  pthread_mutex_unlock (&present_mutex);
+#endif
+}
+
+/**
+ * Describe the frame just drawn, to scale it with the main thread
+ * @param frame Pointer to the frame which receives the offscreens,
+ *              the modified areas of the panels and the full update
+ *              flag are moved into it
+ */
+void
+present_frame_current (present_frame * frame)
+{
+  frame->game_offscreen = game_offscreen;
+  frame->scores_offscreen = scores_offscreen;
+  frame->options_offscreen = options_offscreen;
+  frame->update_all = update_all;
+  update_all = FALSE;
+  dirty_rects_take (&frame->dirty);
+}
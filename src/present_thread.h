@@ -0,0 +1,66 @@
+/**
+ * @file present_thread.h
+ * @brief Scale a frame in a thread while the next one is simulated
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __PRESENT_THREAD__
+#define __PRESENT_THREAD__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /** A frame to display */
+  typedef struct present_frame
+  {
+    /** Offscreen of the game, 512x440 */
+    char *game_offscreen;
+    /** Pixels of the score panel */
+    char *scores_offscreen;
+    /** Pixels of the option panel */
+    char *options_offscreen;
+    /** TRUE if the whole panels must be displayed */
+    bool update_all;
+    /** Modified areas of the panels, if update_all is FALSE */
+    dirty_rects_list dirty;
+  } present_frame;
+
+  /**
+   * Function of the display which scales a frame into the window,
+   * without updating the window
+   * @param frame The frame to display
+   */
+  typedef void (*present_frame_func) (present_frame * frame);
+
+  bool present_thread_init (present_frame_func func);
+  void present_thread_free (void);
+  bool present_thread_enabled (void);
+  bool present_thread_wait (void);
+  void present_thread_start (void);
+  void present_frame_current (present_frame * frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ * @file profiler.c
+ * @brief Time spent in the phases of the last frames, exported to
+ *        Chrome trace JSON or CSV
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "log_recorder.h"
+#include "profiler.h"
+#ifdef USE_PROFILER
+
+/** Names of the phases, used in the exported files */
+static const char *profiler_zone_names[PROFILER_ZONES_NUMOF] = {
+  "update_frame",
+  "handle_events",
+  "update_window",
+  "sound_handle",
+  "movie_player",
+  "clear_offscreen",
+  "grid_handle",
+  "curve_phase",
+  "meteors_handle",
+  "starfield_handle",
+  "bonus_handle",
+  "satellites_handle",
+  "guns_handle",
+  "enemies_handle",
+  "congratulations",
+  "electrical_shock",
+  "spaceship_draw",
+  "explosions_handle",
+  "shots_handle",
+  "phases_end",
+  "shockwave_draw",
+  "option_execution",
+  "menu_sections_run",
+  "scrolltext_handle",
+  "menu_handle",
+  "text_overlay_draw",
+  "energy_gauge_update",
+  "text_draw_score",
+  "spaceship_weapons"
+};
+
+/** One timed phase */
+typedef struct profiler_event
+{
+  /** Beginning in microseconds */
+  Uint64 start;
+  /** Duration in microseconds */
+  Uint32 duration;
+  /** PROFILER_ZONES */
+  Uint32 zone;
+} profiler_event;
+
+/** The timed phases of one iteration of the main loop */
+typedef struct profiler_frame_struct
+{
+  /** Value of loops_counter */
+  Uint32 number;
+  /** Duration of the whole iteration, 0 if not finished */
+  Uint32 duration;
+  Uint64 start;
+  Uint32 numof_events;
+  profiler_event events[PROFILER_EVENTS_MAXOF];
+} profiler_frame_struct;
+
+/** Ring buffer of the last frames */
+static profiler_frame_struct profiler_frames[PROFILER_FRAMES_MAXOF];
+/** Index of the current frame in the ring buffer */
+static Uint32 profiler_current = 0;
+/** Number of frames in the ring buffer */
+static Uint32 profiler_numof_frames = 0;
+/** Time at which each phase began */
+static Uint64 profiler_zone_start[PROFILER_ZONES_NUMOF];
+
+/**
+ * Begin a new frame, called at each iteration of the main loop.
+ * The oldest frame is overwritten when the ring buffer is full
+ */
+void
+profiler_frame (void)
+{
+  Uint64 now = get_ticks_usec ();
+  profiler_frame_struct *frame;
+  if (profiler_numof_frames > 0)
+    {
+      frame = &profiler_frames[profiler_current];
+      frame->duration = (Uint32) (now - frame->start);
+      profiler_current = (profiler_current + 1) % PROFILER_FRAMES_MAXOF;
+    }
+  if (profiler_numof_frames < PROFILER_FRAMES_MAXOF)
+    {
+      profiler_numof_frames++;
+    }
+  frame = &profiler_frames[profiler_current];
+  frame->number = loops_counter;
+  frame->duration = 0;
+  frame->start = now;
+  frame->numof_events = 0;
+}
+
+/**
+ * Start to time a phase
+ * @param zone The phase which begins
+ */
+void
+profiler_begin (PROFILER_ZONES zone)
+{
+  profiler_zone_start[zone] = get_ticks_usec ();
+}
+
+/**
+ * Stop to time a phase and store it in the current frame
+ * @param zone The phase which ends
+ */
+void
+profiler_end (PROFILER_ZONES zone)
+{
+  profiler_frame_struct *frame;
+  profiler_event *event;
+  if (profiler_numof_frames == 0)
+    {
+      return;
+    }
+  frame = &profiler_frames[profiler_current];
+  if (frame->numof_events >= PROFILER_EVENTS_MAXOF)
+    {
+      return;
+    }
+  event = &frame->events[frame->numof_events++];
+  event->start = profiler_zone_start[zone];
+  event->duration = (Uint32) (get_ticks_usec () - event->start);
+  event->zone = zone;
+}
+
+/**
+ * Write the frames of the ring buffer, the oldest first
+ * @param out The file
+ * @param is_csv TRUE for CSV, FALSE for Chrome trace JSON
+ */
+static void
+profiler_write (FILE * out, bool is_csv)
+{
+  Uint32 i, j, index;
+  Uint64 origin;
+  bool is_first = TRUE;
+  profiler_frame_struct *frame;
+  profiler_event *event;
+  index =
+    (profiler_current + PROFILER_FRAMES_MAXOF + 1 -
+     profiler_numof_frames) % PROFILER_FRAMES_MAXOF;
+  origin = profiler_frames[index].start;
+  if (is_csv)
+    {
+      fprintf (out, "frame,phase,start_us,duration_us\n");
+    }
+  else
+    {
+      fprintf (out, "{\"traceEvents\":[\n");
+    }
+  for (i = 0; i < profiler_numof_frames; i++)
+    {
+      frame = &profiler_frames[index];
+      index = (index + 1) % PROFILER_FRAMES_MAXOF;
+      if (frame->duration > 0)
+        {
+          if (is_csv)
+            {
+              fprintf (out, "%u,frame,%u,%u\n", frame->number,
+                       (Uint32) (frame->start - origin), frame->duration);
+            }
+          else
+            {
+              fprintf (out, "%s{\"name\":\"frame\",\"ph\":\"X\","
+                       "\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":1,"
+                       "\"args\":{\"frame\":%u}}",
+                       is_first ? "" : ",\n",
+                       (Uint32) (frame->start - origin), frame->duration,
+                       frame->number);
+              is_first = FALSE;
+            }
+        }
+      for (j = 0; j < frame->numof_events; j++)
+        {
+          event = &frame->events[j];
+          if (is_csv)
+            {
+              fprintf (out, "%u,%s,%u,%u\n", frame->number,
+                       profiler_zone_names[event->zone],
+                       (Uint32) (event->start - origin), event->duration);
+            }
+          else
+            {
+              fprintf (out, "%s{\"name\":\"%s\",\"ph\":\"X\","
+                       "\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":1}",
+                       is_first ? "" : ",\n",
+                       profiler_zone_names[event->zone],
+                       (Uint32) (event->start - origin), event->duration);
+              is_first = FALSE;
+            }
+        }
+    }
+  if (!is_csv)
+    {
+      fprintf (out, "\n]}\n");
+    }
+}
+
+/**
+ * Export the timings of the last frames, in CSV if the filename
+ * ends with ".csv", otherwise in the Chrome trace format
+ * (chrome://tracing or ui.perfetto.dev)
+ * @param filename The file to write
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+profiler_export (const char *filename)
+{
+  FILE *out;
+  size_t length;
+  bool is_csv;
+  if (profiler_numof_frames == 0)
+    {
+      return TRUE;
+    }
+  length = strlen (filename);
+  is_csv = length > 4 && !strcmp (filename + length - 4, ".csv");
+  out = fopen_data (filename, "w");
+  if (out == NULL)
+    {
+      return FALSE;
+    }
+  profiler_write (out, is_csv);
+  fclose (out);
+  LOG_INF ("timings of the last %u frames written to %s",
+           profiler_numof_frames, filename);
+  return TRUE;
+}
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file profiler.h
+ * @brief Time spent in the phases of the last frames, exported to
+ *        Chrome trace JSON or CSV
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __PROFILER__
+#define __PROFILER__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef USE_PROFILER
+
+/** Number of frames kept in the ring buffer */
+#define PROFILER_FRAMES_MAXOF 512
+/** Maximum number of timed phases in one frame */
+#define PROFILER_EVENTS_MAXOF 32
+/** File written by [F12] when "--profile" is not given */
+#define PROFILER_DEFAULT_FILENAME "powermanga-profile.json"
+
+  /** Timed phases of the main loop and of update_frame() */
+  typedef enum
+  {
+    PROFILER_UPDATE_FRAME,
+    PROFILER_HANDLE_EVENTS,
+    PROFILER_UPDATE_WINDOW,
+    PROFILER_SOUND,
+    PROFILER_MOVIE,
+    PROFILER_CLEAR_OFFSCREEN,
+    PROFILER_GRID,
+    PROFILER_CURVE,
+    PROFILER_METEORS,
+    PROFILER_STARFIELD,
+    PROFILER_BONUS,
+    PROFILER_SATELLITES,
+    PROFILER_GUNS,
+    PROFILER_ENEMIES,
+    PROFILER_CONGRATULATIONS,
+    PROFILER_ELECTRICAL_SHOCK,
+    PROFILER_SPACESHIP,
+    PROFILER_EXPLOSIONS,
+    PROFILER_SHOTS,
+    PROFILER_PHASES_END,
+    PROFILER_SHOCKWAVE,
+    PROFILER_OPTIONS,
+    PROFILER_MENU_SECTIONS,
+    PROFILER_SCROLLTEXT,
+    PROFILER_MENU,
+    PROFILER_TEXT_OVERLAY,
+    PROFILER_ENERGY_GAUGES,
+    PROFILER_SCORE,
+    PROFILER_WEAPONS,
+    PROFILER_ZONES_NUMOF
+  } PROFILER_ZONES;
+
+  void profiler_frame (void);
+  void profiler_begin (PROFILER_ZONES zone);
+  void profiler_end (PROFILER_ZONES zone);
+  bool profiler_export (const char *filename);
+
+#define PROFILER_FRAME() profiler_frame ()
+#define PROFILER_BEGIN(zone) profiler_begin (zone)
+#define PROFILER_END(zone) profiler_end (zone)
+
+#else
+
+#define PROFILER_FRAME() ((void) 0)
+#define PROFILER_BEGIN(zone) ((void) 0)
+#define PROFILER_END(zone) ((void) 0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,6 +30,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
 #include "images.h"
 #include "enemies.h"
 #include "bonus.h"
@@ -128,8 +129,8 @@ satellites_once_init (void)
   if (satellites == NULL)
     {
       satellites =
-        (satellite_struct *) memory_allocation (SATELLITES_MAXOF *
-                                                sizeof (satellite_struct));
+        (satellite_struct *) arena_alloc (ARENA_PROCESS, SATELLITES_MAXOF *
+                                          sizeof (satellite_struct));
       if (satellites == NULL)
         {
           LOG_ERR ("not enough memory to allocate 'satellites'");
@@ -140,8 +141,9 @@ satellites_once_init (void)
   if (satellite_circle_x == NULL)
     {
       satellite_circle_x =
-        (Sint16 *) memory_allocation (SATELLITE_NUMOF_POINTS_CIRCLE * 2 *
-                                      sizeof (Sint16));
+        (Sint16 *) arena_alloc (ARENA_PROCESS,
+                                SATELLITE_NUMOF_POINTS_CIRCLE * 2 *
+                                sizeof (Sint16));
       if (satellite_circle_x == NULL)
         {
           LOG_ERR ("not enough memory to allocate 'satellite_circle_x'");
@@ -226,17 +228,9 @@ satellites_free (void)
   LOG_DBG ("deallocates the memory used by the bitmap and structure");
   images_free (&satellites_images[0][0], SATELLITES_NUMOF_TYPES,
                SATELLITES_NUMOF_IMAGES, SATELLITES_NUMOF_IMAGES);
-  if (satellites != NULL)
-    {
-      free_memory ((char *) satellites);
-      satellites = NULL;
-    }
-  if (satellite_circle_x != NULL)
-    {
-      free_memory ((char *) satellite_circle_x);
-      satellite_circle_x = NULL;
-      satellite_circle_y = NULL;
-    }
+  satellites = NULL;
+  satellite_circle_x = NULL;
+  satellite_circle_y = NULL;
 }
 
 /** 
@@ -810,7 +804,7 @@ satellites_shot_collisions (Sint32 x1, Sint32 y1, shot_struct * projectile)
             {
               /* decrease energy level of satellite */
               sat->energy_level =
-                (Sint16) (sat->energy_level - projectile->spr.pow_of_dest);
+                (Sint16) (sat->energy_level - projectile->pow_of_dest);
 
               /* check if satellite is destroyed */
               if (sat->energy_level <= 0)
@@ -826,8 +820,8 @@ satellites_shot_collisions (Sint32 x1, Sint32 y1, shot_struct * projectile)
                   sat->is_mask = TRUE;
                 }
               /* add a little explosion */
-              explosion_add ((float) projectile->spr.xcoord,
-                             (float) projectile->spr.ycoord, 0.35f,
+              explosion_add ((float) shots_xcoord[projectile->index],
+                             (float) shots_ycoord[projectile->index], 0.35f,
                              EXPLOSION_SMALL, 0);
               return TRUE;
             }
@@ -1465,3 +1465,149 @@ void scale2x4_32_mmx(scale2x_uint32* dst0, scale2x_uint32* dst1, scale2x_uint32*
 
 #endif
 
+
+/***************************************************************************/
+/* Scale2x SSE2 and AVX2 implementation */
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+
+#include <immintrin.h>
+
+/*
+ * Apply the Scale2x effect at a single pixel of a row, with the left and
+ * right neighbours clamped at the row edges.
+ * It gives the same result as scale2x_*_def_border() and it's used for the
+ * pixels which don't fill a whole vector.
+ */
+#define SCALE2X_BORDER_PIXEL(dst, src0, src1, src2, i, count) \
+	do { \
+		unsigned l = (i) > 0 ? (i) - 1 : 0; \
+		unsigned r = (i) + 1 < (count) ? (i) + 1 : (count) - 1; \
+		if (src0[i] != src2[i] && src1[l] != src1[r]) { \
+			dst[2 * (i)] = src1[l] == src0[i] ? src0[i] : src1[i]; \
+			dst[2 * (i) + 1] = src1[r] == src0[i] ? src0[i] : src1[i]; \
+		} else { \
+			dst[2 * (i)] = src1[i]; \
+			dst[2 * (i) + 1] = src1[i]; \
+		} \
+	} while (0)
+
+/* interleave the two halves of the AVX2 vectors in the right order */
+#define SCALE2X_LANES_SSE2(lo, hi)
+#define SCALE2X_LANES_AVX2(lo, hi) \
+	do { \
+		__m256i tmp = _mm256_permute2x128_si256(lo, hi, 0x20); \
+		hi = _mm256_permute2x128_si256(lo, hi, 0x31); \
+		lo = tmp; \
+	} while (0)
+
+/*
+ * Apply the Scale2x effect at a single row.
+ * This function must be called only by the other scale2x functions.
+ * Each vector computes n pixels with the same rule of the C implementation
+ * but without branches:
+ *
+ *      x = B == H || D == F
+ *      a = !x && D == B ? B : E
+ *      b = !x && F == B ? B : E
+ *
+ * The first pixel, the last one and the remaining pixels are computed
+ * one by one.
+ */
+#define SCALE2X_SIMD_BORDER(func, type, isa, vec, n, load, store, cmpeq, vand, vandnot, vor, unpacklo, unpackhi, lanes) \
+__attribute__((target(isa))) \
+static void func(type* dst, const type* src0, const type* src1, const type* src2, unsigned count) \
+{ \
+	unsigned i; \
+	assert(count >= 2); \
+	SCALE2X_BORDER_PIXEL(dst, src0, src1, src2, 0, count); \
+	for (i = 1; i + (n) + 1 <= count; i += (n)) { \
+		vec B = load((const vec*)(src0 + i)); \
+		vec H = load((const vec*)(src2 + i)); \
+		vec D = load((const vec*)(src1 + i - 1)); \
+		vec E = load((const vec*)(src1 + i)); \
+		vec F = load((const vec*)(src1 + i + 1)); \
+		vec x = vor(cmpeq(B, H), cmpeq(D, F)); \
+		vec ma = vandnot(x, cmpeq(D, B)); \
+		vec mb = vandnot(x, cmpeq(F, B)); \
+		vec a = vor(vand(ma, B), vandnot(ma, E)); \
+		vec b = vor(vand(mb, B), vandnot(mb, E)); \
+		vec lo = unpacklo(a, b); \
+		vec hi = unpackhi(a, b); \
+		lanes(lo, hi); \
+		store((vec*)(dst + 2 * i), lo); \
+		store((vec*)(dst + 2 * i + (n)), hi); \
+	} \
+	for (; i < count; ++i) \
+		SCALE2X_BORDER_PIXEL(dst, src0, src1, src2, i, count); \
+}
+
+SCALE2X_SIMD_BORDER(scale2x_16_sse2_border, scale2x_uint16, "sse2", __m128i, 8,
+	_mm_loadu_si128, _mm_storeu_si128, _mm_cmpeq_epi16, _mm_and_si128, _mm_andnot_si128, _mm_or_si128,
+	_mm_unpacklo_epi16, _mm_unpackhi_epi16, SCALE2X_LANES_SSE2)
+SCALE2X_SIMD_BORDER(scale2x_32_sse2_border, scale2x_uint32, "sse2", __m128i, 4,
+	_mm_loadu_si128, _mm_storeu_si128, _mm_cmpeq_epi32, _mm_and_si128, _mm_andnot_si128, _mm_or_si128,
+	_mm_unpacklo_epi32, _mm_unpackhi_epi32, SCALE2X_LANES_SSE2)
+SCALE2X_SIMD_BORDER(scale2x_16_avx2_border, scale2x_uint16, "avx2", __m256i, 16,
+	_mm256_loadu_si256, _mm256_storeu_si256, _mm256_cmpeq_epi16, _mm256_and_si256, _mm256_andnot_si256, _mm256_or_si256,
+	_mm256_unpacklo_epi16, _mm256_unpackhi_epi16, SCALE2X_LANES_AVX2)
+SCALE2X_SIMD_BORDER(scale2x_32_avx2_border, scale2x_uint32, "avx2", __m256i, 8,
+	_mm256_loadu_si256, _mm256_storeu_si256, _mm256_cmpeq_epi32, _mm256_and_si256, _mm256_andnot_si256, _mm256_or_si256,
+	_mm256_unpacklo_epi32, _mm256_unpackhi_epi32, SCALE2X_LANES_AVX2)
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_def() but it uses the SSE2
+ * instruction set. The result is identical.
+ * The CPU must support SSE2.
+ * \param src0 Pointer at the first pixel of the previous row.
+ * \param src1 Pointer at the first pixel of the current row.
+ * \param src2 Pointer at the first pixel of the next row.
+ * \param count Length in pixels of the src0, src1 and src2 rows.
+ * It must be at least 2.
+ * \param dst0 First destination row, double length in pixels.
+ * \param dst1 Second destination row, double length in pixels.
+ */
+void scale2x_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_16_sse2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 32 bits.
+ * This function operates like scale2x_32_def() but it uses the SSE2
+ * instruction set. The result is identical.
+ * The CPU must support SSE2.
+ */
+void scale2x_32_sse2(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_sse2_border(dst0, src0, src1, src2, count);
+	scale2x_32_sse2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_def() but it uses the AVX2
+ * instruction set. The result is identical.
+ * The CPU must support AVX2.
+ */
+void scale2x_16_avx2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count)
+{
+	scale2x_16_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_16_avx2_border(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 32 bits.
+ * This function operates like scale2x_32_def() but it uses the AVX2
+ * instruction set. The result is identical.
+ * The CPU must support AVX2.
+ */
+void scale2x_32_avx2(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count)
+{
+	scale2x_32_avx2_border(dst0, src0, src1, src2, count);
+	scale2x_32_avx2_border(dst1, src2, src1, src0, count);
+}
+
+#endif
@@ -708,3 +708,252 @@ void scale3x_32_def(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32*
 #endif
 }
 
+
+/***************************************************************************/
+/* Scale3x SSE2 and AVX2 implementation */
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+
+#include <immintrin.h>
+
+/*
+ * Apply the Scale3x effect at a single pixel of a row, with the left and
+ * right neighbours clamped at the row edges.
+ * They give the same result as scale3x_*_def_border() and
+ * scale3x_*_def_center() and they're used for the pixels which don't fill
+ * a whole vector.
+ */
+#define SCALE3X_BORDER_PIXEL(dst, src0, src1, src2, i, count) \
+	do { \
+		unsigned l = (i) > 0 ? (i) - 1 : 0; \
+		unsigned r = (i) + 1 < (count) ? (i) + 1 : (count) - 1; \
+		if (src0[i] != src2[i] && src1[l] != src1[r]) { \
+			dst[3 * (i)] = src1[l] == src0[i] ? src1[l] : src1[i]; \
+			dst[3 * (i) + 1] = (src1[l] == src0[i] && src1[i] != src0[r]) || (src1[r] == src0[i] && src1[i] != src0[l]) ? src0[i] : src1[i]; \
+			dst[3 * (i) + 2] = src1[r] == src0[i] ? src1[r] : src1[i]; \
+		} else { \
+			dst[3 * (i)] = src1[i]; \
+			dst[3 * (i) + 1] = src1[i]; \
+			dst[3 * (i) + 2] = src1[i]; \
+		} \
+	} while (0)
+
+#define SCALE3X_CENTER_PIXEL(dst, src0, src1, src2, i, count) \
+	do { \
+		unsigned l = (i) > 0 ? (i) - 1 : 0; \
+		unsigned r = (i) + 1 < (count) ? (i) + 1 : (count) - 1; \
+		if (src0[i] != src2[i] && src1[l] != src1[r]) { \
+			dst[3 * (i)] = (src1[l] == src0[i] && src1[i] != src2[l]) || (src1[l] == src2[i] && src1[i] != src0[l]) ? src1[l] : src1[i]; \
+			dst[3 * (i) + 1] = src1[i]; \
+			dst[3 * (i) + 2] = (src1[r] == src0[i] && src1[i] != src2[r]) || (src1[r] == src2[i] && src1[i] != src0[r]) ? src1[r] : src1[i]; \
+		} else { \
+			dst[3 * (i)] = src1[i]; \
+			dst[3 * (i) + 1] = src1[i]; \
+			dst[3 * (i) + 2] = src1[i]; \
+		} \
+	} while (0)
+
+/*
+ * Store the pixels of three vectors of 4 pixels of 32 bits interleaved:
+ * a0 b0 c0 a1 b1 c1 a2 b2 c2 a3 b3 c3.
+ */
+__attribute__((target("sse2")))
+static inline void scale3x_32_sse2_store(scale3x_uint32* dst, __m128i a, __m128i b, __m128i c)
+{
+	__m128i a1 = _mm_srli_si128(a, 4); /* a1 a2 a3 0 */
+	__m128i ab = _mm_unpacklo_epi32(a, b); /* a0 b0 a1 b1 */
+	__m128i ca = _mm_unpacklo_epi32(c, a1); /* c0 a1 c1 a2 */
+	__m128i bc = _mm_unpacklo_epi32(_mm_srli_si128(b, 4), _mm_srli_si128(c, 4)); /* b1 c1 b2 c2 */
+	__m128i ab2 = _mm_unpackhi_epi32(a, b); /* a2 b2 a3 b3 */
+	__m128i ca2 = _mm_unpackhi_epi32(c, a1); /* c2 a3 c3 0 */
+	__m128i bc2 = _mm_unpackhi_epi32(b, c); /* b2 c2 b3 c3 */
+
+	_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi64(ab, ca));
+	_mm_storeu_si128((__m128i*)(dst + 4), _mm_unpacklo_epi64(bc, ab2));
+	_mm_storeu_si128((__m128i*)(dst + 8), _mm_castpd_si128(_mm_move_sd(_mm_castsi128_pd(bc2), _mm_castsi128_pd(ca2))));
+}
+
+/*
+ * Store the pixels of three vectors of 8 pixels of 16 bits interleaved.
+ * The pixels are sign extended to 32 bits, interleaved like
+ * scale3x_32_sse2_store() does, and packed again without saturation.
+ */
+__attribute__((target("sse2")))
+static inline void scale3x_16_sse2_store(scale3x_uint16* dst, __m128i a, __m128i b, __m128i c)
+{
+	scale3x_uint32 tmp[24] __attribute__((aligned(16)));
+	__m128i* p = (__m128i*)tmp;
+
+	scale3x_32_sse2_store(tmp, _mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16), _mm_srai_epi32(_mm_unpacklo_epi16(b, b), 16), _mm_srai_epi32(_mm_unpacklo_epi16(c, c), 16));
+	scale3x_32_sse2_store(tmp + 12, _mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16), _mm_srai_epi32(_mm_unpackhi_epi16(b, b), 16), _mm_srai_epi32(_mm_unpackhi_epi16(c, c), 16));
+
+	_mm_storeu_si128((__m128i*)dst, _mm_packs_epi32(_mm_load_si128(p), _mm_load_si128(p + 1)));
+	_mm_storeu_si128((__m128i*)(dst + 8), _mm_packs_epi32(_mm_load_si128(p + 2), _mm_load_si128(p + 3)));
+	_mm_storeu_si128((__m128i*)(dst + 16), _mm_packs_epi32(_mm_load_si128(p + 4), _mm_load_si128(p + 5)));
+}
+
+/* the AVX2 vectors are stored as two SSE2 vectors */
+#define SCALE3X_32_AVX2_STORE(dst, a, b, c) \
+	do { \
+		scale3x_32_sse2_store(dst, _mm256_castsi256_si128(a), _mm256_castsi256_si128(b), _mm256_castsi256_si128(c)); \
+		scale3x_32_sse2_store(dst + 12, _mm256_extracti128_si256(a, 1), _mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(c, 1)); \
+	} while (0)
+#define SCALE3X_16_AVX2_STORE(dst, a, b, c) \
+	do { \
+		scale3x_16_sse2_store(dst, _mm256_castsi256_si128(a), _mm256_castsi256_si128(b), _mm256_castsi256_si128(c)); \
+		scale3x_16_sse2_store(dst + 24, _mm256_extracti128_si256(a, 1), _mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(c, 1)); \
+	} while (0)
+
+/*
+ * Apply the Scale3x effect at a single row.
+ * This function must be called only by the other scale3x functions.
+ * Each vector computes n pixels with the same rule of the C implementation
+ * but without branches:
+ *
+ *      x = B == H || D == F
+ *      a = !x && D == B ? D : E
+ *      b = !x && ((D == B && E != C) || (F == B && E != A)) ? B : E
+ *      c = !x && F == B ? F : E
+ *
+ * The first pixel, the last one and the remaining pixels are computed
+ * one by one.
+ */
+#define SCALE3X_SIMD_BORDER(func, type, isa, vec, n, load, store3, cmpeq, vand, vandnot, vor) \
+__attribute__((target(isa))) \
+static void func(type* dst, const type* src0, const type* src1, const type* src2, unsigned count) \
+{ \
+	unsigned i; \
+	assert(count >= 2); \
+	SCALE3X_BORDER_PIXEL(dst, src0, src1, src2, 0, count); \
+	for (i = 1; i + (n) + 1 <= count; i += (n)) { \
+		vec A = load((const vec*)(src0 + i - 1)); \
+		vec B = load((const vec*)(src0 + i)); \
+		vec C = load((const vec*)(src0 + i + 1)); \
+		vec H = load((const vec*)(src2 + i)); \
+		vec D = load((const vec*)(src1 + i - 1)); \
+		vec E = load((const vec*)(src1 + i)); \
+		vec F = load((const vec*)(src1 + i + 1)); \
+		vec x = vor(cmpeq(B, H), cmpeq(D, F)); \
+		vec db = cmpeq(D, B); \
+		vec fb = cmpeq(F, B); \
+		vec ma = vandnot(x, db); \
+		vec mb = vandnot(x, vor(vandnot(cmpeq(E, C), db), vandnot(cmpeq(E, A), fb))); \
+		vec mc = vandnot(x, fb); \
+		store3(dst + 3 * i, vor(vand(ma, D), vandnot(ma, E)), vor(vand(mb, B), vandnot(mb, E)), vor(vand(mc, F), vandnot(mc, E))); \
+	} \
+	for (; i < count; ++i) \
+		SCALE3X_BORDER_PIXEL(dst, src0, src1, src2, i, count); \
+}
+
+/*
+ * Same as SCALE3X_SIMD_BORDER() for the central row:
+ *
+ *      x = B == H || D == F
+ *      a = !x && ((D == B && E != G) || (D == H && E != A)) ? D : E
+ *      b = E
+ *      c = !x && ((F == B && E != I) || (F == H && E != C)) ? F : E
+ */
+#define SCALE3X_SIMD_CENTER(func, type, isa, vec, n, load, store3, cmpeq, vand, vandnot, vor) \
+__attribute__((target(isa))) \
+static void func(type* dst, const type* src0, const type* src1, const type* src2, unsigned count) \
+{ \
+	unsigned i; \
+	assert(count >= 2); \
+	SCALE3X_CENTER_PIXEL(dst, src0, src1, src2, 0, count); \
+	for (i = 1; i + (n) + 1 <= count; i += (n)) { \
+		vec A = load((const vec*)(src0 + i - 1)); \
+		vec B = load((const vec*)(src0 + i)); \
+		vec C = load((const vec*)(src0 + i + 1)); \
+		vec G = load((const vec*)(src2 + i - 1)); \
+		vec H = load((const vec*)(src2 + i)); \
+		vec I = load((const vec*)(src2 + i + 1)); \
+		vec D = load((const vec*)(src1 + i - 1)); \
+		vec E = load((const vec*)(src1 + i)); \
+		vec F = load((const vec*)(src1 + i + 1)); \
+		vec x = vor(cmpeq(B, H), cmpeq(D, F)); \
+		vec ma = vandnot(x, vor(vandnot(cmpeq(E, G), cmpeq(D, B)), vandnot(cmpeq(E, A), cmpeq(D, H)))); \
+		vec mc = vandnot(x, vor(vandnot(cmpeq(E, I), cmpeq(F, B)), vandnot(cmpeq(E, C), cmpeq(F, H)))); \
+		store3(dst + 3 * i, vor(vand(ma, D), vandnot(ma, E)), E, vor(vand(mc, F), vandnot(mc, E))); \
+	} \
+	for (; i < count; ++i) \
+		SCALE3X_CENTER_PIXEL(dst, src0, src1, src2, i, count); \
+}
+
+SCALE3X_SIMD_BORDER(scale3x_16_sse2_border, scale3x_uint16, "sse2", __m128i, 8,
+	_mm_loadu_si128, scale3x_16_sse2_store, _mm_cmpeq_epi16, _mm_and_si128, _mm_andnot_si128, _mm_or_si128)
+SCALE3X_SIMD_CENTER(scale3x_16_sse2_center, scale3x_uint16, "sse2", __m128i, 8,
+	_mm_loadu_si128, scale3x_16_sse2_store, _mm_cmpeq_epi16, _mm_and_si128, _mm_andnot_si128, _mm_or_si128)
+SCALE3X_SIMD_BORDER(scale3x_32_sse2_border, scale3x_uint32, "sse2", __m128i, 4,
+	_mm_loadu_si128, scale3x_32_sse2_store, _mm_cmpeq_epi32, _mm_and_si128, _mm_andnot_si128, _mm_or_si128)
+SCALE3X_SIMD_CENTER(scale3x_32_sse2_center, scale3x_uint32, "sse2", __m128i, 4,
+	_mm_loadu_si128, scale3x_32_sse2_store, _mm_cmpeq_epi32, _mm_and_si128, _mm_andnot_si128, _mm_or_si128)
+SCALE3X_SIMD_BORDER(scale3x_16_avx2_border, scale3x_uint16, "avx2", __m256i, 16,
+	_mm256_loadu_si256, SCALE3X_16_AVX2_STORE, _mm256_cmpeq_epi16, _mm256_and_si256, _mm256_andnot_si256, _mm256_or_si256)
+SCALE3X_SIMD_CENTER(scale3x_16_avx2_center, scale3x_uint16, "avx2", __m256i, 16,
+	_mm256_loadu_si256, SCALE3X_16_AVX2_STORE, _mm256_cmpeq_epi16, _mm256_and_si256, _mm256_andnot_si256, _mm256_or_si256)
+SCALE3X_SIMD_BORDER(scale3x_32_avx2_border, scale3x_uint32, "avx2", __m256i, 8,
+	_mm256_loadu_si256, SCALE3X_32_AVX2_STORE, _mm256_cmpeq_epi32, _mm256_and_si256, _mm256_andnot_si256, _mm256_or_si256)
+SCALE3X_SIMD_CENTER(scale3x_32_avx2_center, scale3x_uint32, "avx2", __m256i, 8,
+	_mm256_loadu_si256, SCALE3X_32_AVX2_STORE, _mm256_cmpeq_epi32, _mm256_and_si256, _mm256_andnot_si256, _mm256_or_si256)
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_16_def() but it uses the SSE2
+ * instruction set. The result is identical.
+ * The CPU must support SSE2.
+ * \param src0 Pointer at the first pixel of the previous row.
+ * \param src1 Pointer at the first pixel of the current row.
+ * \param src2 Pointer at the first pixel of the next row.
+ * \param count Length in pixels of the src0, src1 and src2 rows.
+ * It must be at least 2.
+ * \param dst0 First destination row, triple length in pixels.
+ * \param dst1 Second destination row, triple length in pixels.
+ * \param dst2 Third destination row, triple length in pixels.
+ */
+void scale3x_16_sse2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count)
+{
+	scale3x_16_sse2_border(dst0, src0, src1, src2, count);
+	scale3x_16_sse2_center(dst1, src0, src1, src2, count);
+	scale3x_16_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 32 bits.
+ * This function operates like scale3x_32_def() but it uses the SSE2
+ * instruction set. The result is identical.
+ * The CPU must support SSE2.
+ */
+void scale3x_32_sse2(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count)
+{
+	scale3x_32_sse2_border(dst0, src0, src1, src2, count);
+	scale3x_32_sse2_center(dst1, src0, src1, src2, count);
+	scale3x_32_sse2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_16_def() but it uses the AVX2
+ * instruction set. The result is identical.
+ * The CPU must support AVX2.
+ */
+void scale3x_16_avx2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count)
+{
+	scale3x_16_avx2_border(dst0, src0, src1, src2, count);
+	scale3x_16_avx2_center(dst1, src0, src1, src2, count);
+	scale3x_16_avx2_border(dst2, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 32 bits.
+ * This function operates like scale3x_32_def() but it uses the AVX2
+ * instruction set. The result is identical.
+ * The CPU must support AVX2.
+ */
+void scale3x_32_avx2(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count)
+{
+	scale3x_32_avx2_border(dst0, src0, src1, src2, count);
+	scale3x_32_avx2_center(dst1, src0, src1, src2, count);
+	scale3x_32_avx2_border(dst2, src2, src1, src0, count);
+}
+
+#endif
@@ -39,6 +39,7 @@
 
 #include "scale2x.h"
 #include "scale3x.h"
+#include "scalebit.h"
 
 #if HAVE_ALLOCA_H
 #include <alloca.h>
@@ -50,6 +51,87 @@
 #define SSDST(bits, num) (scale2x_uint##bits *)dst##num
 #define SSSRC(bits, num) (const scale2x_uint##bits *)src##num
 
+/**
+ * Implementation used by the scale functions, one of SCALE_KERNEL_*.
+ */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+static unsigned scale_current_kernel = SCALE_KERNEL_MMX;
+#else
+static unsigned scale_current_kernel = SCALE_KERNEL_DEF;
+#endif
+
+static const char* scale_kernel_names[SCALE_KERNEL_NUMOF] = {
+	"def",
+	"mmx",
+	"sse2",
+	"avx2"
+};
+
+/**
+ * Select the implementation used by the scale functions.
+ * It must not be called while a bitmap is being scaled.
+ * \param kernel One of SCALE_KERNEL_*.
+ * \return
+ *   - -1 if the implementation isn't supported by the CPU.
+ *   - 0 on success.
+ */
+int scale_kernel_set(unsigned kernel)
+{
+	switch (kernel) {
+	case SCALE_KERNEL_DEF :
+		break;
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	case SCALE_KERNEL_MMX :
+		if (!__builtin_cpu_supports("mmx"))
+			return -1;
+		break;
+	case SCALE_KERNEL_SSE2 :
+		if (!__builtin_cpu_supports("sse2"))
+			return -1;
+		break;
+	case SCALE_KERNEL_AVX2 :
+		if (!__builtin_cpu_supports("avx2"))
+			return -1;
+		break;
+#endif
+	default:
+		return -1;
+	}
+
+	scale_current_kernel = kernel;
+
+	return 0;
+}
+
+/**
+ * Select the fastest implementation supported by the CPU.
+ */
+void scale_kernel_init(void)
+{
+	unsigned kernel = SCALE_KERNEL_NUMOF;
+
+	while (kernel > 0 && scale_kernel_set(kernel - 1) != 0)
+		--kernel;
+}
+
+/**
+ * Return the implementation used by the scale functions.
+ * \return One of SCALE_KERNEL_*.
+ */
+unsigned scale_kernel_get(void)
+{
+	return scale_current_kernel;
+}
+
+/**
+ * Return the name of an implementation.
+ * \param kernel One of SCALE_KERNEL_*.
+ */
+const char* scale_kernel_name(unsigned kernel)
+{
+	return kernel < SCALE_KERNEL_NUMOF ? scale_kernel_names[kernel] : "";
+}
+
 /**
  * Apply the Scale2x effect on a group of rows. Used internally.
  */
@@ -57,9 +139,28 @@ static inline void stage_scale2x(void* dst0, void* dst1, const void* src0, const
 {
 	switch (pixel) {
 #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
-		case 1 : scale2x_8_mmx(SSDST(8,0), SSDST(8,1), SSSRC(8,0), SSSRC(8,1), SSSRC(8,2), pixel_per_row); break;
-		case 2 : scale2x_16_mmx(SSDST(16,0), SSDST(16,1), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
-		case 4 : scale2x_32_mmx(SSDST(32,0), SSDST(32,1), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+		case 1 :
+			if (scale_current_kernel != SCALE_KERNEL_DEF)
+				scale2x_8_mmx(SSDST(8,0), SSDST(8,1), SSSRC(8,0), SSSRC(8,1), SSSRC(8,2), pixel_per_row);
+			else
+				scale2x_8_def(SSDST(8,0), SSDST(8,1), SSSRC(8,0), SSSRC(8,1), SSSRC(8,2), pixel_per_row);
+			break;
+		case 2 :
+			switch (scale_current_kernel) {
+				case SCALE_KERNEL_AVX2 : scale2x_16_avx2(SSDST(16,0), SSDST(16,1), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
+				case SCALE_KERNEL_SSE2 : scale2x_16_sse2(SSDST(16,0), SSDST(16,1), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
+				case SCALE_KERNEL_MMX : scale2x_16_mmx(SSDST(16,0), SSDST(16,1), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
+				default : scale2x_16_def(SSDST(16,0), SSDST(16,1), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
+			}
+			break;
+		case 4 :
+			switch (scale_current_kernel) {
+				case SCALE_KERNEL_AVX2 : scale2x_32_avx2(SSDST(32,0), SSDST(32,1), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+				case SCALE_KERNEL_SSE2 : scale2x_32_sse2(SSDST(32,0), SSDST(32,1), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+				case SCALE_KERNEL_MMX : scale2x_32_mmx(SSDST(32,0), SSDST(32,1), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+				default : scale2x_32_def(SSDST(32,0), SSDST(32,1), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+			}
+			break;
 #else
 		case 1 : scale2x_8_def(SSDST(8,0), SSDST(8,1), SSSRC(8,0), SSSRC(8,1), SSSRC(8,2), pixel_per_row); break;
 		case 2 : scale2x_16_def(SSDST(16,0), SSDST(16,1), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
@@ -111,8 +212,25 @@ static inline void stage_scale3x(void* dst0, void* dst1, void* dst2, const void*
 {
 	switch (pixel) {
 		case 1 : scale3x_8_def(SSDST(8,0), SSDST(8,1), SSDST(8,2), SSSRC(8,0), SSSRC(8,1), SSSRC(8,2), pixel_per_row); break;
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+		case 2 :
+			switch (scale_current_kernel) {
+				case SCALE_KERNEL_AVX2 : scale3x_16_avx2(SSDST(16,0), SSDST(16,1), SSDST(16,2), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
+				case SCALE_KERNEL_SSE2 : scale3x_16_sse2(SSDST(16,0), SSDST(16,1), SSDST(16,2), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
+				default : scale3x_16_def(SSDST(16,0), SSDST(16,1), SSDST(16,2), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
+			}
+			break;
+		case 4 :
+			switch (scale_current_kernel) {
+				case SCALE_KERNEL_AVX2 : scale3x_32_avx2(SSDST(32,0), SSDST(32,1), SSDST(32,2), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+				case SCALE_KERNEL_SSE2 : scale3x_32_sse2(SSDST(32,0), SSDST(32,1), SSDST(32,2), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+				default : scale3x_32_def(SSDST(32,0), SSDST(32,1), SSDST(32,2), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+			}
+			break;
+#else
 		case 2 : scale3x_16_def(SSDST(16,0), SSDST(16,1), SSDST(16,2), SSSRC(16,0), SSSRC(16,1), SSSRC(16,2), pixel_per_row); break;
 		case 4 : scale3x_32_def(SSDST(32,0), SSDST(32,1), SSDST(32,2), SSSRC(32,0), SSSRC(32,1), SSSRC(32,2), pixel_per_row); break;
+#endif
 	}
 }
 
@@ -509,3 +627,88 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+
+/**
+ * Apply the Scale effect on a band of rows of a bitmap.
+ * The destination rows are exactly the ones computed by ::scale() for the
+ * same source rows, the bands of a bitmap can then be scaled concurrently.
+ * \note With the Scale4x effect a buffer bitmap is also required. This bitmap
+ * must have at least an horizontal size in bytes of 2*width*pixel,
+ * and a vertical size of 2*(count+2) rows. It is ignored by the other effects.
+ * \param scale Scale factor. 2, 203 (fox 2x3), 204 (for 2x4), 3 or 4.
+ * \param void_dst Pointer at the first pixel of the destination bitmap.
+ * \param dst_slice Size in bytes of a destination bitmap row.
+ * \param void_mid Pointer at the first pixel of the buffer bitmap.
+ * \param mid_slice Size in bytes of a buffer bitmap row.
+ * \param void_src Pointer at the first pixel of the source bitmap.
+ * \param src_slice Size in bytes of a source bitmap row.
+ * \param pixel Bytes per pixel of the source and destination bitmap.
+ * \param width Horizontal size in pixels of the source bitmap.
+ * \param height Vertical size in pixels of the source bitmap.
+ * \param first First source row of the band.
+ * \param count Number of source rows of the band.
+ */
+void scale_rows(unsigned scale, void* void_dst, unsigned dst_slice, void* void_mid, unsigned mid_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned first, unsigned count)
+{
+	unsigned char* dst = (unsigned char*)void_dst;
+	unsigned char* mid = (unsigned char*)void_mid;
+	const unsigned char* src = (const unsigned char*)void_src;
+	unsigned y, up, down, lo, hi;
+
+	assert(height >= 2 && first + count <= height);
+
+	switch (scale) {
+	case 202 :
+	case 2 :
+		for (y = first; y < first + count; ++y) {
+			up = y > 0 ? y - 1 : 0;
+			down = y + 1 < height ? y + 1 : height - 1;
+			stage_scale2x(SCDST(2 * y), SCDST(2 * y + 1), SCSRC(up), SCSRC(y), SCSRC(down), pixel, width);
+		}
+		break;
+	case 203 :
+		for (y = first; y < first + count; ++y) {
+			up = y > 0 ? y - 1 : 0;
+			down = y + 1 < height ? y + 1 : height - 1;
+			stage_scale2x3(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), SCSRC(up), SCSRC(y), SCSRC(down), pixel, width);
+		}
+		break;
+	case 204 :
+		for (y = first; y < first + count; ++y) {
+			up = y > 0 ? y - 1 : 0;
+			down = y + 1 < height ? y + 1 : height - 1;
+			stage_scale2x4(SCDST(4 * y), SCDST(4 * y + 1), SCDST(4 * y + 2), SCDST(4 * y + 3), SCSRC(up), SCSRC(y), SCSRC(down), pixel, width);
+		}
+		break;
+	case 303 :
+	case 3 :
+		for (y = first; y < first + count; ++y) {
+			up = y > 0 ? y - 1 : 0;
+			down = y + 1 < height ? y + 1 : height - 1;
+			stage_scale3x(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), SCSRC(up), SCSRC(y), SCSRC(down), pixel, width);
+		}
+		break;
+	case 404 :
+	case 4 :
+		/* the Scale2x rows of the band and of its two neighbour rows */
+		lo = first > 0 ? first - 1 : 0;
+		hi = first + count < height ? first + count : height - 1;
+		for (y = lo; y <= hi; ++y) {
+			up = y > 0 ? y - 1 : 0;
+			down = y + 1 < height ? y + 1 : height - 1;
+			stage_scale2x(mid + (2 * (y - lo)) * mid_slice, mid + (2 * (y - lo) + 1) * mid_slice, SCSRC(up), SCSRC(y), SCSRC(down), pixel, width);
+		}
+#define SCBAND(i) (mid + ((i) - 2 * lo) * mid_slice)
+		for (y = first; y < first + count; ++y) {
+			up = y > 0 ? 2 * y - 1 : 0;
+			down = y + 1 < height ? 2 * y + 2 : 2 * height - 1;
+			stage_scale4x(SCDST(4 * y), SCDST(4 * y + 1), SCDST(4 * y + 2), SCDST(4 * y + 3), SCBAND(up), SCBAND(2 * y), SCBAND(2 * y + 1), SCBAND(down), pixel, width);
+		}
+#undef SCBAND
+		break;
+	}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	scale2x_mmx_emms();
+#endif
+}
@@ -36,8 +36,26 @@
 #ifndef __SCALEBIT_H
 #define __SCALEBIT_H
 
+/**
+ * Implementations of the Scale2x and Scale3x effects.
+ * The MMX one is used only by Scale2x, the SSE2 and AVX2 ones only
+ * with the pixels of 16 and 32 bits, the C one otherwise.
+ */
+enum {
+	SCALE_KERNEL_DEF,
+	SCALE_KERNEL_MMX,
+	SCALE_KERNEL_SSE2,
+	SCALE_KERNEL_AVX2,
+	SCALE_KERNEL_NUMOF
+};
+
+int scale_kernel_set(unsigned kernel);
+void scale_kernel_init(void);
+unsigned scale_kernel_get(void);
+const char* scale_kernel_name(unsigned kernel);
 int scale_precondition(unsigned scale, unsigned pixel, unsigned width, unsigned height);
 void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height);
+void scale_rows(unsigned scale, void* void_dst, unsigned dst_slice, void* void_mid, unsigned mid_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned first, unsigned count);
 
 #endif
 
@@ -30,6 +30,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "config_file.h"
 #include "log_recorder.h"
 #ifdef SHAREWARE_VERSION
@@ -385,7 +386,7 @@ script_recurs (char *ptr, Sint32 x1, Sint32 y1, Sint32 x2, Sint32 y2,
       y = y1;
       c1 = (ptr[x1 + y1 * sizex] & 255);
       c2 = (ptr[x2 + y1 * sizex] & 255);
-      c = (c1 + c2) / 2 + rand () % dx - dx / 2;
+      c = (c1 + c2) / 2 + game_rand () % dx - dx / 2;
       if (c < 0)
         {
           c = 0;
@@ -402,7 +403,7 @@ script_recurs (char *ptr, Sint32 x1, Sint32 y1, Sint32 x2, Sint32 y2,
       y = y2;
       c1 = (ptr[x1 + y2 * sizex] & 255);
       c2 = (ptr[x2 + y2 * sizex] & 255);
-      c = (c1 + c2) / 2 + rand () % dx - dx / 2;
+      c = (c1 + c2) / 2 + game_rand () % dx - dx / 2;
       if (c < 0)
         c = 0;
       if (c > 255)
@@ -417,7 +418,7 @@ script_recurs (char *ptr, Sint32 x1, Sint32 y1, Sint32 x2, Sint32 y2,
       y = (y1 + y2) / 2;
       c1 = (ptr[x1 + y1 * sizex] & 255);
       c2 = (ptr[x1 + y2 * sizex] & 255);
-      c = (c1 + c2) / 2 + rand () % dy - dy / 2;
+      c = (c1 + c2) / 2 + game_rand () % dy - dy / 2;
       if (c < 0)
         c = 0;
       if (c > 255)
@@ -428,7 +429,7 @@ script_recurs (char *ptr, Sint32 x1, Sint32 y1, Sint32 x2, Sint32 y2,
       y = (y1 + y2) / 2;
       c1 = (ptr[x2 + y1 * sizex] & 255);
       c2 = (ptr[x2 + y2 * sizex] & 255);
-      c = (c1 + c2) / 2 + rand () % dy - dy / 2;
+      c = (c1 + c2) / 2 + game_rand () % dy - dy / 2;
       if (c < 0)
         {
           c = 0;
@@ -447,7 +448,7 @@ script_recurs (char *ptr, Sint32 x1, Sint32 y1, Sint32 x2, Sint32 y2,
       c2 = (ptr[x2 + y1 * sizex] & 255);
       c3 = (ptr[x1 + y2 * sizex] & 255);
       c4 = (ptr[x2 + y2 * sizex] & 255);
-      c = (c1 + c2 + c3 + c4) / 4 + rand () % d - d / 2;
+      c = (c1 + c2 + c3 + c4) / 4 + game_rand () % d - d / 2;
       if (c < 0)
         {
           c = 0;
@@ -496,7 +497,7 @@ script_recursx (char *ptr, Sint32 x1, Sint32 x2, Sint32 y, Sint32 sizex,
       x = (x1 + x2) / 2;
       c1 = (ptr[x1 + y * sizex] & 255);
       c2 = (ptr[x2 + y * sizex] & 255);
-      c = (c1 + c2) / 2 + rand () % dx - dx / 2;
+      c = (c1 + c2) / 2 + game_rand () % dx - dx / 2;
       if (c < 0)
         {
           c = 0;
@@ -540,7 +541,7 @@ script_recursy (char *ptr, Sint32 y1, Sint32 y2, Sint32 x, Sint32 sizex,
       y = (y1 + y2) / 2;
       c1 = (ptr[x + y1 * sizex] & 255);
       c2 = (ptr[x + y2 * sizex] & 255);
-      c = (c1 + c2) / 2 + rand () % dy - dy / 2;
+      c = (c1 + c2) / 2 + game_rand () % dy - dy / 2;
       if (c < 0)
         c = 0;
       if (c > 255)
@@ -677,8 +678,8 @@ script_add_bitmap_section (FILE * f, char *name, struct Page *page)
               ptr[n1 + n2 * (lx + 1)] = 0;
             }
         }
-      ptr[0] = 128 + rand () % 127;
-      ptr[lx] = 128 + rand () % 127;
+      ptr[0] = 128 + game_rand () % 127;
+      ptr[lx] = 128 + game_rand () % 127;
       ptr[(lx + 1) * (ly) + 0] = ptr[lx];
       script_recursx (ptr, 0, lx, 0, lx + 1, ly + 1);
       script_recursy (ptr, 0, ly, 0, lx + 1, ly + 1);
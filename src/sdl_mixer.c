@@ -34,10 +34,9 @@
 #include "menu_sections.h"
 #ifdef USE_SDLMIXER
 #include "sdl_mixer.h"
+#include "sound_queue.h"
 
 static Mix_Music *music_chunk = NULL;
-/** List of flags of requested sounds */
-bool sounds_play[SOUND_NUMOF];
 static bool music_enabled = TRUE;
 /** Module number loaded in memory */
 static Sint32 module_num_loaded = -1;
@@ -115,6 +114,38 @@ static const char *musics_filenames[] = {
 /** Internal format of the waves sounds */
 static Mix_Chunk *sounds_chunck[SOUND_NUMOF];
 static bool sound_load_module (Sint32 module_num);
+
+/**
+ * Play a sound on a channel, called by the thread of the sound queue
+ * @param channel Index of the channel
+ * @param sound Index of the sound
+ * @param pan Horizontal position: 0 (left) to 255 (right)
+ */
+static void
+sound_channel_play (Uint32 channel, Uint32 sound, Uint32 pan)
+{
+  /* the sounds in the middle of the screen keep their volume */
+  Uint8 left = pan <= SOUND_PAN_CENTER ? 255 : (255 - pan) * 2;
+  Uint8 right = pan >= SOUND_PAN_CENTER ? 255 : pan * 2;
+  Mix_SetPanning (channel, left, right);
+  if (Mix_PlayChannel (channel, sounds_chunck[sound], 0) == -1)
+    {
+      /*
+         LOG_DBG ("Mix_PlayChannel return %s", Mix_GetError ());
+       */
+    }
+}
+
+/**
+ * Check if a channel plays, called by the thread of the sound queue
+ * @param channel Index of the channel
+ * @return TRUE if a sound is played on the channel
+ */
+static bool
+sound_channel_playing (Uint32 channel)
+{
+  return Mix_Playing (channel) != 0;
+}
 /** 
  * First initializations of SDL_mixer and load waves sounds files 
  * @return TRUE if successful
@@ -195,6 +226,10 @@ sound_once_init (void)
       /* calculate the size in bytes of the waves samples */
       sound_samples_len += sample->alen;
     }
+  /* the sounds are played by a thread, the game never waits for the
+   * mixer */
+  sound_queue_init (sound_channel_play, sound_channel_playing, NULL,
+                    MAX_OF_CHANNELS, TRUE);
   LOG_INF ("sound has been successfully initialized");
   return TRUE;
 }
@@ -321,7 +356,6 @@ sound_volume_ctrl (void)
 void
 sound_handle (void)
 {
-  Uint32 i;
   if (power_conf->nosound)
     {
       return;
@@ -346,19 +380,8 @@ sound_handle (void)
           Mix_VolumeMusic (music_volume);
         }
     }
-  for (i = 0; i < SOUND_NUMOF; i++)
-    {
-      if (sounds_play[i])
-        {
-          if (Mix_PlayChannel (-1, sounds_chunck[i], 0) == -1)
-            {
-              /*
-                 LOG_DBG ("Mix_PlayChannel return %s", Mix_GetError ());
-               */
-            }
-          sounds_play[i] = FALSE;
-        }
-    }
+  /* play the sounds requested during the frame */
+  sound_queue_flush (1);
 
   /* [CTRL] + [S] released */
   if (start_stop_music && !keys_down[K_CTRL] && !keys_down[K_S])
@@ -406,6 +429,7 @@ sound_free (void)
     {
       return;
     }
+  sound_queue_free ();
   sound_free_current_music ();
   for (i = 0; i < SOUND_NUMOF; i++)
     {
@@ -419,18 +443,4 @@ sound_free (void)
   Mix_CloseAudio ();
   SDL_Quit ();
 }
-
-/**
- * Request to play sound effect
- * @param sound_nu Sound number
- */
-void
-sound_play (Uint32 sound_nu)
-{
-  if (!gameover_enable && !player_pause && menu_section == NO_SECTION_SELECTED
-      && menu_status == MENU_OFF)
-    {
-      sounds_play[sound_nu] = TRUE;
-    }
-}
 #endif
@@ -31,7 +31,7 @@ extern "C"
 {
 #endif
 
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
 #define MAX_OF_CHANNELS 16
 
   bool sound_once_init (void);
@@ -39,6 +39,7 @@ extern "C"
   bool sound_music_play (Sint32);
   void sound_free (void);
   void sound_play (Uint32);
+  void sound_play_at (Uint32 sound_nu, Sint32 xcoord);
 
   /** List of musics used by the game */
   typedef enum
@@ -89,7 +90,6 @@ extern "C"
   SOUNDS_INDEXES;
 
   extern Uint32 sound_samples_len;
-  extern bool sounds_play[SOUND_NUMOF];
 
 #ifdef __cplusplus
 }
@@ -29,6 +29,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
 #include "assembler.h"
 #include "images.h"
 #include "config_file.h"
@@ -107,8 +108,9 @@ shockwave_once_init (void)
   if (shockwave == NULL)
     {
       shockwave =
-        (shockwave_struct *) memory_allocation (MAX_NUMOF_SHOCKWAVES *
-                                                sizeof (shockwave_struct));
+        (shockwave_struct *) arena_alloc (ARENA_PROCESS,
+                                          MAX_NUMOF_SHOCKWAVES *
+                                          sizeof (shockwave_struct));
       if (shockwave == NULL)
         {
           LOG_ERR ("shockwave out of memory");
@@ -118,7 +120,8 @@ shockwave_once_init (void)
   if (shockwave_right_buffer == NULL)
     {
       shockwave_right_buffer =
-        (Sint32 *) memory_allocation (offscreen_height * sizeof (Sint32));
+        (Sint32 *) arena_alloc (ARENA_PROCESS,
+                                offscreen_height * sizeof (Sint32));
       if (shockwave_right_buffer == NULL)
         {
           LOG_ERR ("shockwave_right_buffer out of memory");
@@ -129,7 +132,8 @@ shockwave_once_init (void)
   if (shockwave_left_buffer == NULL)
     {
       shockwave_left_buffer =
-        (Sint32 *) memory_allocation (offscreen_height * sizeof (Sint32));
+        (Sint32 *) arena_alloc (ARENA_PROCESS,
+                                offscreen_height * sizeof (Sint32));
       if (shockwave_left_buffer == NULL)
         {
           LOG_ERR ("shockwave_left_buffer out of memory");
@@ -141,9 +145,9 @@ shockwave_once_init (void)
   if (shockwave_ring_x == NULL)
     {
       shockwave_ring_x =
-        (Sint16 *) memory_allocation (NUMOF_RINGS_SHOCKWAVE *
-                                      NUMOF_POINTS_SHOCKWAVE * 2 *
-                                      sizeof (Sint16));
+        (Sint16 *) arena_alloc (ARENA_PROCESS, NUMOF_RINGS_SHOCKWAVE *
+                                NUMOF_POINTS_SHOCKWAVE * 2 *
+                                sizeof (Sint16));
       if (shockwave_ring_x == NULL)
         {
           LOG_ERR ("'shockwave_ring_x' out of memory");
@@ -215,27 +219,11 @@ void
 shockwave_free (void)
 {
   LOG_DBG ("deallocates the memory used by the shockwaves");
-  if (shockwave != NULL)
-    {
-      free_memory ((char *) shockwave);
-      shockwave = NULL;
-    }
-  if (shockwave_right_buffer != NULL)
-    {
-      free_memory ((char *) shockwave_right_buffer);
-      shockwave_right_buffer = NULL;
-    }
-  if (shockwave_left_buffer != NULL)
-    {
-      free_memory ((char *) shockwave_left_buffer);
-      shockwave_left_buffer = NULL;
-    }
-  if (shockwave_ring_x != NULL)
-    {
-      free_memory ((char *) shockwave_ring_x);
-      shockwave_ring_x = NULL;
-      shockwave_ring_y = NULL;
-    }
+  shockwave = NULL;
+  shockwave_right_buffer = NULL;
+  shockwave_left_buffer = NULL;
+  shockwave_ring_x = NULL;
+  shockwave_ring_y = NULL;
 }
 
 /**
@@ -357,7 +345,7 @@ shockwave_add (void)
   shock->center_y =
     (Sint32) (ship->spr.ycoord +
               ship->spr.img[ship->spr.current_image]->y_gc);
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_CIRCULAR_SHOCK);
 #endif
 }
@@ -589,6 +577,10 @@ draw_polygon (char *addr, Sint32 * pcoords, Sint32 numofpts, Uint32 color)
   Sint32 numofpixels;
   char *drawaddr;
   char *linestart;
+  if (!offscreen_draw_enable)
+    {
+      return;
+    }
   switch (bytes_per_pixel)
     {
     case 2:
@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
 #include "images.h"
 #include "curve_phase.h"
 #include "display.h"
@@ -43,6 +44,7 @@
 #include "menu.h"
 #include "menu_sections.h"
 #include "options_panel.h"
+#include "pool.h"
 #include "satellite_protections.h"
 #include "sdl_mixer.h"
 #include "spaceship.h"
@@ -52,9 +54,16 @@ Sint32 num_of_shots = 0;
 image fire[SHOT_MAX_OF_TYPE][SHOT_NUMOF_IMAGES];
 /** Data structures of all shots */
 static shot_struct *shots;
-static shot_struct *shot_first = NULL;
-static shot_struct *shot_last = NULL;
-/** List of the shots indexes on the shots data structures */
+/** Free list and chained list of the shots */
+static pool_struct shots_pool;
+/** Coordinates of the shots, indexed by shot_struct.index */
+float shots_xcoord[MAX_OF_SHOTS];
+float shots_ycoord[MAX_OF_SHOTS];
+/** Displacement of the linear shots at each frame, null for the others */
+static float shots_xspeed[MAX_OF_SHOTS];
+static float shots_yspeed[MAX_OF_SHOTS];
+/** One past the highest index of the enabled shots */
+static Uint32 shots_high = 0;
 static bool shot_moving (shot_struct * bullet);
 static bool shot_display (shot_struct * bullet);
 static void shot_delete (shot_struct * bullet);
@@ -81,14 +90,21 @@ shots_once_init (void)
   if (shots == NULL)
     {
       shots =
-        (shot_struct *) memory_allocation (MAX_OF_SHOTS *
-                                           sizeof (shot_struct));
+        (shot_struct *) arena_alloc (ARENA_PROCESS, MAX_OF_SHOTS *
+                                     sizeof (shot_struct));
       if (shots == NULL)
         {
           LOG_ERR ("not enough memory to allocate 'shots'");
           return FALSE;
         }
     }
+  if (!pool_init
+      (&shots_pool, "shot", (char *) shots, sizeof (shot_struct),
+       MAX_OF_SHOTS, offsetof (shot_struct, next),
+       offsetof (shot_struct, previous)))
+    {
+      return FALSE;
+    }
 
   shots_init ();
   return TRUE;
@@ -146,11 +162,8 @@ shots_extract (void)
 void
 shots_free (void)
 {
-  if (shots != NULL)
-    {
-      free_memory ((char *) shots);
-      shots = NULL;
-    }
+  pool_free (&shots_pool);
+  shots = NULL;
   images_free (&fire[0][0], SHOT_MAX_OF_TYPE, SHOT_NUMOF_IMAGES,
                SHOT_NUMOF_IMAGES);
 }
@@ -168,9 +181,83 @@ shots_init (void)
   for (i = 0; i < MAX_OF_SHOTS; i++)
     {
       bullet = &shots[i];
+      bullet->index = i;
       bullet->is_enabled = FALSE;
+      shots_xspeed[i] = 0.0f;
+      shots_yspeed[i] = 0.0f;
     }
+  pool_reset (&shots_pool);
   num_of_shots = 0;
+  shots_high = 0;
+}
+
+/**
+ * Move all the linear shots in one pass over the parallel arrays,
+ * up to the highest enabled shot. The displacement of the disabled
+ * or not linear shots is null, the homing and curve shots are moved
+ * one by one by shot_moving()
+ */
+static void
+shots_linear_move (void)
+{
+  Uint32 i;
+  for (i = 0; i < shots_high; i++)
+    {
+      shots_xcoord[i] += shots_xspeed[i];
+      shots_ycoord[i] += shots_yspeed[i];
+    }
+}
+
+/**
+ * Check if a shot is visible, otherwise disable it or keep it
+ * a while if it has a calculated trajectory
+ * @param bullet Pointer to a shot structure
+ * @return TRUE if the shot is visible, otherwise FALSE
+ */
+static bool
+shot_clip (shot_struct * bullet)
+{
+  float *xcoord = &shots_xcoord[bullet->index];
+  float *ycoord = &shots_ycoord[bullet->index];
+  if ((Sint16) (*xcoord + bullet->img[0].h - 1) >= offscreen_startx
+      && (Sint16) (*ycoord + bullet->img[0].w - 1) >= offscreen_starty
+      && (Sint16) * ycoord <= offscreen_starty + offscreen_height_visible
+      && (Sint16) * xcoord <= offscreen_startx + offscreen_width_visible)
+    {
+      return TRUE;
+    }
+
+  /* linear-trajectory: disable shot */
+  if (bullet->trajectory == 0)
+    {
+      shot_delete (bullet);
+    }
+  else
+    {
+      if ((Sint16) (*xcoord) < (offscreen_clipsize - 32)
+          || (Sint16) (*ycoord) < (offscreen_clipsize - 32)
+          || (Sint16) * ycoord >
+          (offscreen_clipsize + offscreen_height_visible + 32)
+          || (Sint16) * xcoord >
+          (offscreen_clipsize + offscreen_width_visible + 32))
+        {
+          shot_delete (bullet);
+        }
+      /* shot not visible */
+      else
+        {
+          /* trajectory calculated (missile homing head) */
+          if (bullet->trajectory == 1)
+            {
+              /* change x and y coordinates */
+              *xcoord += bullet->img[bullet->img_old_angle].x_gc;
+              *ycoord += bullet->img[bullet->img_old_angle].y_gc;
+              /* decrement lifetime */
+              bullet->timelife--;
+            }
+        }
+    }
+  return FALSE;
 }
 
 /** 
@@ -179,102 +266,56 @@ shots_init (void)
 void
 shots_handle (void)
 {
-  Sint32 i;
-  shot_struct *bullet = shot_first;
-  if (bullet == NULL)
+  shot_struct *bullet, *next;
+  bool is_moving;
+  if (shots_pool.first == NULL)
     {
       return;
     }
-  for (i = 0; i < num_of_shots; i++, bullet = bullet->next)
-    {
-#ifdef UNDER_DEVELOPMENT
-      if (bullet == NULL && i < (num_of_shots - 1))
-        {
-          LOG_ERR ("shot->next is null %i/%i", i, num_of_shots);
-          break;
-        }
-#endif
+  is_moving = !player_pause && menu_status == MENU_OFF && menu_section == 0;
 
+  /* first pass: move the shots */
+  if (is_moving)
+    {
+      shots_linear_move ();
+    }
+  for (bullet = (shot_struct *) shots_pool.first; bullet != NULL;
+       bullet = next)
+    {
+      next = bullet->next;
       /* shot disable */
       if (bullet->timelife == 0)
         {
           shot_delete (bullet);
           continue;
         }
-
-      /* moving a shot */
-      if (!player_pause && menu_status == MENU_OFF && menu_section == 0)
+      /* the linear shots have already been moved */
+      if (is_moving && bullet->trajectory != 0 && !shot_moving (bullet))
         {
-          if (!shot_moving (bullet))
-            {
-              shot_delete (bullet);
-              continue;
-            }
+          shot_delete (bullet);
         }
+    }
 
-      /* clip a shot sprite */
-      if ((Sint16)
-          (bullet->spr.xcoord + bullet->spr.img[0]->h -
-           1) < offscreen_startx
-          || (Sint16) (bullet->spr.ycoord +
-                       bullet->spr.img[0]->w - 1) <
-          offscreen_starty
-          || (Sint16) bullet->spr.ycoord >
-          offscreen_starty + offscreen_height_visible
-          || (Sint16) bullet->spr.xcoord >
-          offscreen_startx + offscreen_width_visible)
+  /* second pass: clip and draw the shots, and test the collisions */
+  enemies_cells_update ();
+  for (bullet = (shot_struct *) shots_pool.first; bullet != NULL;
+       bullet = next)
+    {
+      next = bullet->next;
+      if (!shot_clip (bullet))
         {
-
-          /* linear-trajectory: disable shot */
-          if (bullet->spr.trajectory == 0)
-            {
-              shot_delete (bullet);
-            }
-          else
-            {
-              if ((Sint16) (bullet->spr.xcoord) <
-                  (offscreen_clipsize - 32)
-                  || (Sint16) (bullet->spr.ycoord) <
-                  (offscreen_clipsize - 32)
-                  || (Sint16) bullet->spr.ycoord >
-                  (offscreen_clipsize + offscreen_height_visible + 32)
-                  || (Sint16) bullet->spr.xcoord >
-                  (offscreen_clipsize + offscreen_width_visible + 32))
-                {
-                  shot_delete (bullet);
-                  i--;
-                }
-              /* shot not visible */
-              else
-                {
-                  /* trajectory calculated (missile homing head) */
-                  if (bullet->spr.trajectory == 1)
-                    {
-                      /* change x and y coordinates */
-                      bullet->spr.xcoord +=
-                        bullet->spr.img[bullet->img_old_angle]->x_gc;
-                      bullet->spr.ycoord +=
-                        bullet->spr.img[bullet->img_old_angle]->y_gc;
-                      /* decrement lifetime */
-                      bullet->timelife--;
-                    }
-                }
-            }
           continue;
         }
-      else
+      if (!shot_display (bullet))
         {
-          if (!shot_display (bullet))
-            {
-              shot_delete (bullet);
-              continue;
-            }
+          shot_delete (bullet);
         }
     }
 }
 
 /** 
- * Moving all shots, from enemies and player's starship 
+ * Moving a shot with a calculated trajectory or following a curve,
+ * the linear shots are moved by shots_linear_move()
  * @return if FALSE then disable the shot
  */
 static bool
@@ -283,61 +324,40 @@ shot_moving (shot_struct * bullet)
   Uint32 i;
   float a;
   enemy *foe;
-  sprite *spr = &bullet->spr;
+  image *foe_img;
+  float *xcoord = &shots_xcoord[bullet->index];
+  float *ycoord = &shots_ycoord[bullet->index];
+  image *bullet_img = &bullet->img[bullet->img_old_angle];
 
-  switch (spr->trajectory)
+  switch (bullet->trajectory)
     {
-      /* linear-trajectory */
-    case 0:
-      {
-        spr->xcoord += depix[(Sint16) spr->speed][bullet->img_angle];
-        spr->ycoord += depiy[(Sint16) spr->speed][bullet->img_angle];
-      }
-      break;
-
       /* trajectory calculated (missile homing head) */
     case 1:
       {
         foe = enemy_get_first ();
         if (foe != NULL)
           {
-            a = calc_target_angle ((Sint16)
-                                   (spr->xcoord +
-                                    spr->img[bullet->img_old_angle]->x_gc),
-                                   (Sint16) (spr->ycoord +
-                                             spr->img[bullet->
-                                                      img_old_angle]->y_gc),
-                                   (Sint16) (foe->spr.xcoord +
-                                             foe->spr.img[foe->
-                                                          spr.current_image]->x_gc),
+            foe_img = foe->spr.img[foe->spr.current_image];
+            a = calc_target_angle ((Sint16) (*xcoord + bullet_img->x_gc),
+                                   (Sint16) (*ycoord + bullet_img->y_gc),
+                                   (Sint16) (foe->spr.xcoord + foe_img->x_gc),
                                    (Sint16) (foe->spr.ycoord +
-                                             foe->spr.img[foe->
-                                                          spr.current_image]->y_gc));
-            bullet->angle =
-              get_new_angle (bullet->angle, a, bullet->velocity);
+                                             foe_img->y_gc));
           }
         else
           {
-            a = calc_target_angle ((Sint16)
-                                   (spr->xcoord +
-                                    spr->img[bullet->img_old_angle]->x_gc),
-                                   (Sint16) (spr->ycoord +
-                                             spr->img[bullet->
-                                                      img_old_angle]->y_gc),
+            a = calc_target_angle ((Sint16) (*xcoord + bullet_img->x_gc),
+                                   (Sint16) (*ycoord + bullet_img->y_gc),
                                    256, 0);
-            bullet->angle =
-              get_new_angle (bullet->angle, a, bullet->velocity);
           }
-        /* change x coordinate */
-        spr->xcoord =
-          shot_x_move (bullet->angle,
-                       spr->speed,
-                       spr->xcoord - spr->img[bullet->img_old_angle]->x_gc);
-        /* change y coordinate */
-        spr->ycoord =
-          shot_y_move (bullet->angle,
-                       spr->speed,
-                       spr->ycoord - spr->img[bullet->img_old_angle]->y_gc);
+        bullet->angle = get_new_angle (bullet->angle, a, bullet->velocity);
+        /* change x and y coordinates */
+        *xcoord =
+          shot_x_move (bullet->angle, bullet->speed,
+                       *xcoord - bullet_img->x_gc);
+        *ycoord =
+          shot_y_move (bullet->angle, bullet->speed,
+                       *ycoord - bullet_img->y_gc);
       }
       break;
 
@@ -356,10 +376,10 @@ shot_moving (shot_struct * bullet)
                 return FALSE;
               }
             /* change x and y coordinates */
-            spr->xcoord +=
+            *xcoord +=
               (float) initial_curve[bullet->curve_num].delta_x[bullet->
                                                                curve_index];
-            spr->ycoord +=
+            *ycoord +=
               (float) initial_curve[bullet->curve_num].delta_y[bullet->
                                                                curve_index];
           }
@@ -377,8 +397,11 @@ static bool
 shot_display (shot_struct * bullet)
 {
   Sint32 k, tmp_tsts_x, tmp_tsts_y;
+  image *bullet_img;
+  float *xcoord = &shots_xcoord[bullet->index];
+  float *ycoord = &shots_ycoord[bullet->index];
 
-  switch (bullet->spr.trajectory)
+  switch (bullet->trajectory)
     {
 
       /* 
@@ -391,34 +414,32 @@ shot_display (shot_struct * bullet)
         if (bullet->is_blinking)
           {
             /* increase animation delay counter */
-            bullet->spr.anim_count++;
-            if (bullet->spr.anim_count >= bullet->spr.anim_speed)
+            bullet->anim_count++;
+            if (bullet->anim_count >= bullet->anim_speed)
               {
                 /* clear counter */
-                bullet->spr.anim_count = 0;
+                bullet->anim_count = 0;
                 /* next image */
-                bullet->spr.current_image++;
-                if (bullet->spr.current_image >= bullet->spr.numof_images)
+                bullet->current_image++;
+                if (bullet->current_image >= bullet->numof_images)
                   {
                     /* first image */
-                    bullet->spr.current_image = 0;
+                    bullet->current_image = 0;
                   }
               }
             /* display shot sprite */
-            draw_sprite (bullet->spr.img[bullet->spr.current_image],
-                         (Uint32) bullet->spr.xcoord,
-                         (Uint32) bullet->spr.ycoord);
+            draw_sprite (&bullet->img[bullet->current_image],
+                         (Uint32) * xcoord, (Uint32) * ycoord);
           }
         else
           {
             /* the sprite is not animated */
-            draw_sprite (bullet->spr.img[bullet->img_angle],
-                         (Uint32) bullet->spr.xcoord,
-                         (Uint32) bullet->spr.ycoord);
+            draw_sprite (&bullet->img[bullet->img_angle],
+                         (Uint32) * xcoord, (Uint32) * ycoord);
           }
 
         /* fixed trajectory: collisions spaceship shots and enemies */
-        if (bullet->spr.type == FRIEND)
+        if (bullet->type == FRIEND)
           {
             if (!shot_enemies_collisions (bullet))
               {
@@ -433,23 +454,17 @@ shot_display (shot_struct * bullet)
           {
             if (!gameover_enable)
               {
+                bullet_img = &bullet->img[bullet->img_angle];
                 /* for each collision point of the shot */
-                for (k = 0;
-                     k <
-                     bullet->spr.img[bullet->
-                                     img_angle]->numof_collisions_points; k++)
+                for (k = 0; k < bullet_img->numof_collisions_points; k++)
                   {
                     /* coordinates of the collision point of the shot */
                     tmp_tsts_x =
-                      (Sint16) bullet->spr.xcoord +
-                      bullet->spr.img[bullet->
-                                      img_angle]->collisions_points[k]
-                      [XCOORD];
+                      (Sint16) * xcoord +
+                      bullet_img->collisions_points[k][XCOORD];
                     tmp_tsts_y =
-                      (Sint16) bullet->spr.ycoord +
-                      bullet->spr.img[bullet->
-                                      img_angle]->collisions_points[k]
-                      [YCOORD];
+                      (Sint16) * ycoord +
+                      bullet_img->collisions_points[k][YCOORD];
                     /* for each collision zone of the spaceship */
                     if (spaceship_shot_collision
                         (tmp_tsts_x, tmp_tsts_y, bullet))
@@ -493,19 +508,18 @@ shot_display (shot_struct * bullet)
         /* avoid negative indexes */
         bullet->img_angle = (Sint16) abs (bullet->img_angle);
         /* avoid a shot angle higher than the number of images */
-        if (bullet->img_angle >= bullet->spr.numof_images)
+        if (bullet->img_angle >= bullet->numof_images)
           {
-            bullet->img_angle = (Sint16) (bullet->spr.numof_images - 1);
+            bullet->img_angle = (Sint16) (bullet->numof_images - 1);
           }
         /* save current angle for the calculation of the next angle */
         bullet->img_old_angle = bullet->img_angle;
         /* draw the shot sprite */
-        draw_sprite (bullet->spr.img[bullet->img_angle],
-                     (Uint32) bullet->spr.xcoord,
-                     (Uint32) bullet->spr.ycoord);
+        draw_sprite (&bullet->img[bullet->img_angle],
+                     (Uint32) * xcoord, (Uint32) * ycoord);
 
         /* trajectory calculated: collisions spaceship shots and enemies */
-        if (bullet->spr.type == FRIEND)
+        if (bullet->type == FRIEND)
           {
             if (!shot_enemies_collisions (bullet))
               {
@@ -515,10 +529,8 @@ shot_display (shot_struct * bullet)
         if (!player_pause && menu_status == MENU_OFF)
           {
             /* update x and y coordinates */
-            bullet->spr.xcoord +=
-              bullet->spr.img[bullet->img_old_angle]->x_gc;
-            bullet->spr.ycoord +=
-              bullet->spr.img[bullet->img_old_angle]->y_gc;
+            *xcoord += bullet->img[bullet->img_old_angle].x_gc;
+            *ycoord += bullet->img[bullet->img_old_angle].y_gc;
           }
       }
       break;
@@ -543,7 +555,6 @@ shot_struct *
 shot_guardian_add (const enemy * const guard, Uint32 cannon, Sint16 power,
                    float speed)
 {
-  Sint32 i;
   shot_struct *bullet;
   /* verify if it is possible to add a new shot to the list */
   if (num_of_shots > (MAX_OF_SHOTS - 2))
@@ -558,34 +569,30 @@ shot_guardian_add (const enemy * const guard, Uint32 cannon, Sint16 power,
       return NULL;
     }
   bullet->is_blinking = TRUE;
-  bullet->spr.type = ENEMY;
-  bullet->spr.trajectory = FALSE;
-  bullet->spr.numof_images = 32;
+  bullet->type = ENEMY;
+  bullet->trajectory = FALSE;
+  bullet->numof_images = 32;
   /* set power of the destruction */
-  bullet->spr.pow_of_dest = power;
-  for (i = 0; i < bullet->spr.numof_images; i++)
-    {
-      bullet->spr.img[i] = (image *) & fire[TIR1P3E][i];
-    }
-  bullet->spr.energy_level = bullet->spr.pow_of_dest;
-  bullet->spr.current_image = 0;
-  bullet->spr.anim_speed = 1;
-  bullet->spr.anim_count = 0;
+  bullet->pow_of_dest = power;
+  bullet->img = &fire[TIR1P3E][0];
+  bullet->current_image = 0;
+  bullet->anim_speed = 1;
+  bullet->anim_count = 0;
   bullet->img_angle =
     guard->spr.img[guard->spr.current_image]->cannons_angles[cannon];
   bullet->img_old_angle = bullet->img_angle;
-  bullet->spr.xcoord =
+  shots_xcoord[bullet->index] =
     guard->spr.xcoord +
     guard->spr.img[guard->spr.current_image]->cannons_coords[cannon][XCOORD] -
-    bullet->spr.img[bullet->img_angle]->x_gc;
-  bullet->spr.ycoord =
+    bullet->img[bullet->img_angle].x_gc;
+  shots_ycoord[bullet->index] =
     guard->spr.ycoord +
     guard->spr.img[guard->spr.current_image]->cannons_coords[cannon][YCOORD] -
-    bullet->spr.img[bullet->img_angle]->y_gc;
+    bullet->img[bullet->img_angle].y_gc;
   bullet->timelife = 400;
   bullet->angle = (float) (PI_BY_16 * bullet->img_angle);
   /* set speed of the displacement */
-  bullet->spr.speed = speed;
+  shot_linear_speed_set (bullet, speed);
   return bullet;
 }
 
@@ -597,7 +604,6 @@ shot_guardian_add (const enemy * const guard, Uint32 cannon, Sint16 power,
 void
 shot_enemy_add (const enemy * const foe, Sint32 k)
 {
-  Sint32 j;
   shot_struct *bullet;
 
   /* verify if it is possible to add a new shot to the list */
@@ -612,17 +618,18 @@ shot_enemy_add (const enemy * const foe, Sint32 k)
     {
       return;
     }
-#ifdef USE_SDLMIXER
-  sound_play (SOUND_ENEMY_FIRE_1 + (global_counter & 1));
+#ifdef USE_SOUND
+  sound_play_at (SOUND_ENEMY_FIRE_1 + (global_counter & 1),
+                 (Sint32) foe->spr.xcoord);
 #endif
   /* animated sprite (flicker shot) */
   bullet->is_blinking = TRUE;
   /* indicate that is ennemy sprite */
-  bullet->spr.type = ENEMY;
+  bullet->type = ENEMY;
   /* fixed trajectory */
-  bullet->spr.trajectory = FALSE;
+  bullet->trajectory = FALSE;
   /* set number of images of the sprite */
-  bullet->spr.numof_images = 32;
+  bullet->numof_images = 32;
   /* check type of enemy to set the power of the destruction */
   switch (foe->type)
     {
@@ -631,141 +638,81 @@ shot_enemy_add (const enemy * const foe, Sint32 k)
       /* quibouly is used by guardian 7 */
     case QUIBOULY:
       /* set power of the destruction */
-      bullet->spr.pow_of_dest = 2;
+      bullet->pow_of_dest = 2;
       /* set addresses of the sprites images buffer */
-      for (j = 0; j < bullet->spr.numof_images; j++)
-        {
-          /* shot 2 force 1 */
-          bullet->spr.img[j] = (image *) & fire[TIR1P1E][j];
-        }
+      /* shot 2 force 1 */
+      bullet->img = &fire[TIR1P1E][0];
       break;
       /* size of the enemy sprite as 32x32 pixels or lonely foe */
     default:
       /* set power of the destruction */
-      bullet->spr.pow_of_dest = 4;
+      bullet->pow_of_dest = 4;
       /* set addresses of the sprites images buffer */
-      for (j = 0; j < bullet->spr.numof_images; j++)
-        {
-          /* shot 2 force 2 */
-          bullet->spr.img[j] = (image *) & fire[TIR1P2E][j];
-        }
+      /* shot 2 force 2 */
+      bullet->img = &fire[TIR1P2E][0];
       break;
     }
-  bullet->spr.energy_level = bullet->spr.pow_of_dest;
   /* set current image */
-  bullet->spr.current_image = 0;
+  bullet->current_image = 0;
   /* value of delay between two images */
-  bullet->spr.anim_speed = 1;
+  bullet->anim_speed = 1;
   /* counter of delay between two images */
-  bullet->spr.anim_count = 0;
+  bullet->anim_count = 0;
   bullet->img_angle = foe->spr.img[foe->spr.current_image]->cannons_angles[k];
   bullet->img_old_angle = bullet->img_angle;
   /* set x and y coordinates */
-  bullet->spr.xcoord =
+  shots_xcoord[bullet->index] =
     foe->spr.xcoord +
     foe->spr.img[foe->spr.current_image]->cannons_coords[k][XCOORD] -
-    bullet->spr.img[bullet->img_angle]->x_gc;
-  bullet->spr.ycoord =
+    bullet->img[bullet->img_angle].x_gc;
+  shots_ycoord[bullet->index] =
     foe->spr.ycoord +
     foe->spr.img[foe->spr.current_image]->cannons_coords[k][YCOORD] -
-    bullet->spr.img[bullet->img_angle]->y_gc;
+    bullet->img[bullet->img_angle].y_gc;
   bullet->timelife = 400;
   /* set angle of the projectile */
   bullet->angle = PI_BY_16 * bullet->img_angle;
   /* set speed of the displacement */
-  bullet->spr.speed = 1.0f + (float) num_level / 20.0f;
+  shot_linear_speed_set (bullet, 1.0f + (float) num_level / 20.0f);
 }
 
-/**
- * Check validty of shots chained list
+/** 
+ * Return a free shot element 
+ * @return Pointer to a shot structure 
  */
-#ifdef UNDER_DEVELOPMENT
-static void
-shot_check_chained_list (void)
+shot_struct *
+shot_get (void)
 {
-  Uint32 i;
-  shot_struct *bullet;
-  Sint32 count = 0;
-  for (i = 0; i < MAX_OF_SHOTS; i++)
-    {
-      bullet = &shots[i];
-      if (bullet->is_enabled)
-        {
-          count++;
-        }
-    }
-  if (count != num_of_shots)
-    {
-      LOG_ERR ("Counting of the enabled elements failed!"
-               "count=%i, num_of_shots=%i", count, num_of_shots);
-    }
-  count = 0;
-  bullet = shot_first;
-  do
-    {
-      count++;
-      bullet = bullet->next;
-    }
-  while (bullet != NULL && count <= (MAX_OF_SHOTS + 1));
-  if (count != num_of_shots)
-    {
-      LOG_ERR ("Counting of the next elements failed!"
-               "count=%i, num_of_shots=%i", count, num_of_shots);
-    }
-  count = 0;
-  bullet = shot_last;
-  do
+  shot_struct *bullet = (shot_struct *) pool_get (&shots_pool);
+  if (bullet == NULL)
     {
-      count++;
-      bullet = bullet->previous;
+      LOG_ERR ("no more element shot is available");
+      return NULL;
     }
-  while (bullet != NULL && count <= (MAX_OF_SHOTS + 1));
-  if (count != num_of_shots)
+  bullet->is_enabled = TRUE;
+  num_of_shots = shots_pool.numof_enabled;
+  if (bullet->index >= shots_high)
     {
-      LOG_ERR ("Counting of the previous elements failed!"
-               "count=%i, num_of_shots=%i", count, num_of_shots);
+      shots_high = bullet->index + 1;
     }
+  return bullet;
 }
-#endif
 
-/** 
- * Return a free shot element 
- * @return Pointer to a shot structure 
+/**
+ * Set the speed of a shot with a linear trajectory, the shot will
+ * be moved in the direction of its current image
+ * @param bullet Pointer to a shot structure
+ * @param speed Speed of the displacement
  */
-shot_struct *
-shot_get (void)
+void
+shot_linear_speed_set (shot_struct * bullet, float speed)
 {
-  Uint32 i;
-  shot_struct *bullet;
-  for (i = 0; i < MAX_OF_SHOTS; i++)
-    {
-      bullet = &shots[i];
-      if (bullet->is_enabled)
-        {
-          continue;
-        }
-      bullet->is_enabled = TRUE;
-      bullet->next = NULL;
-      if (num_of_shots == 0)
-        {
-          shot_first = bullet;
-          shot_last = bullet;
-          shot_last->previous = NULL;
-        }
-      else
-        {
-          shot_last->next = bullet;
-          bullet->previous = shot_last;
-          shot_last = bullet;
-        }
-      num_of_shots++;
-#ifdef UNDER_DEVELOPMENT
-      shot_check_chained_list ();
-#endif
-      return bullet;
-    }
-  LOG_ERR ("no more element shot is available");
-  return NULL;
+  bullet->trajectory = 0;
+  bullet->speed = speed;
+  shots_xspeed[bullet->index] =
+    depix[(Sint16) bullet->speed][bullet->img_angle];
+  shots_yspeed[bullet->index] =
+    depiy[(Sint16) bullet->speed][bullet->img_angle];
 }
 
 /** 
@@ -776,22 +723,13 @@ static void
 shot_delete (shot_struct * bullet)
 {
   bullet->is_enabled = FALSE;
-  num_of_shots--;
-  if (shot_first == bullet)
+  shots_xspeed[bullet->index] = 0.0f;
+  shots_yspeed[bullet->index] = 0.0f;
+  pool_release (&shots_pool, (char *) bullet);
+  num_of_shots = shots_pool.numof_enabled;
+  while (shots_high > 0 && !shots[shots_high - 1].is_enabled)
     {
-      shot_first = bullet->next;
-    }
-  if (shot_last == bullet)
-    {
-      shot_last = bullet->previous;
-    }
-  if (bullet->previous != NULL)
-    {
-      bullet->previous->next = bullet->next;
-    }
-  if (bullet->next != NULL)
-    {
-      bullet->next->previous = bullet->previous;
+      shots_high--;
     }
 }
 
@@ -804,7 +742,6 @@ shot_delete (shot_struct * bullet)
 void
 shot_satellite_add (Sint32 xcoord, Sint32 ycoord, Sint16 img_angle)
 {
-  Sint32 i;
   shot_struct *bullet;
   bullet = shot_get ();
   if (bullet == NULL)
@@ -814,39 +751,34 @@ shot_satellite_add (Sint32 xcoord, Sint32 ycoord, Sint16 img_angle)
   /* animated sprite (flicker shot) */
   bullet->is_blinking = TRUE;
   /* indicate that is friend sprite */
-  bullet->spr.type = FRIEND;
+  bullet->type = FRIEND;
   /* fixed trajectory */
-  bullet->spr.trajectory = 0;
+  bullet->trajectory = 0;
   /* set number of images of the sprite */
-  bullet->spr.numof_images = 32;
+  bullet->numof_images = 32;
   /* set power of the destruction */
-  bullet->spr.pow_of_dest = 1;
+  bullet->pow_of_dest = 1;
   /* set addresses of the images buffer */
-  for (i = 0; i < bullet->spr.numof_images; i++)
-    {
-      /* shot 1 force 2 */
-      bullet->spr.img[i] = (image *) & fire[V1TN1][i];
-    }
-  /* set energy level of the sprite */
-  bullet->spr.energy_level = bullet->spr.pow_of_dest;
+  /* shot 1 force 2 */
+  bullet->img = &fire[V1TN1][0];
   /* set current image */
-  bullet->spr.current_image = 0;
+  bullet->current_image = 0;
   /* value of delay between two images */
-  bullet->spr.anim_speed = 4;
+  bullet->anim_speed = 4;
   /* counter of delay between two images */
-  bullet->spr.anim_count = 0;
+  bullet->anim_count = 0;
   bullet->img_angle = img_angle;
   bullet->img_old_angle = bullet->img_angle;
   /* set x and y coordinates */
-  bullet->spr.xcoord =
-    (float) (xcoord - bullet->spr.img[bullet->img_angle]->x_gc);
-  bullet->spr.ycoord =
-    (float) (ycoord - bullet->spr.img[bullet->img_angle]->y_gc);
+  shots_xcoord[bullet->index] =
+    (float) (xcoord - bullet->img[bullet->img_angle].x_gc);
+  shots_ycoord[bullet->index] =
+    (float) (ycoord - bullet->img[bullet->img_angle].y_gc);
   bullet->timelife = 400;
   /* set angle of the projectile */
   bullet->angle = PI_BY_16 * bullet->img_angle;
   /* set speed of the displacement */
-  bullet->spr.speed = 9.0;
+  shot_linear_speed_set (bullet, 9.0f);
 }
 
 /**
@@ -861,8 +793,6 @@ static shot_struct *
 shot_spaceship_add (Sint16 damage, Sint16 anim_speed,
                     Sint32 image_num, Sint16 angle, Sint32 cannon_pos)
 {
-  Sint32 j;
-  sprite *spr;
   shot_struct *bullet;
   spaceship_struct *ship = spaceship_get ();
   bullet = shot_get ();
@@ -870,39 +800,33 @@ shot_spaceship_add (Sint16 damage, Sint16 anim_speed,
     {
       return NULL;
     }
-  spr = &bullet->spr;
   /* animated sprite (flicker shot) */
   bullet->is_blinking = TRUE;
   /* indicate that is friend sprite */
-  spr->type = FRIEND;
+  bullet->type = FRIEND;
   /* damage done by the shot */
-  spr->pow_of_dest = damage;
-  /* life energy level */
-  spr->energy_level = spr->pow_of_dest;
+  bullet->pow_of_dest = damage;
   /* set number of images of the sprite */
-  spr->numof_images = 32;
+  bullet->numof_images = 32;
   /* delay before next image */
-  spr->anim_speed = anim_speed;
+  bullet->anim_speed = anim_speed;
   /* counter delay before next image */
-  spr->anim_count = 0;
-  /* set addresses of the sprites images buffer */
-  for (j = 0; j < spr->numof_images; j++)
-    {
-      spr->img[j] = (image *) & fire[image_num][j];
-    }
+  bullet->anim_count = 0;
+  /* set address of the sprites images buffer */
+  bullet->img = &fire[image_num][0];
   bullet->img_angle = angle;
   bullet->img_old_angle = bullet->img_angle;
   /* set x and y coordinates */
-  spr->xcoord =
+  shots_xcoord[bullet->index] =
     ship->spr.xcoord +
     ship->spr.img[ship->spr.
                   current_image]->cannons_coords[cannon_pos][XCOORD] -
-    spr->img[bullet->img_angle]->x_gc;
-  spr->ycoord =
+    bullet->img[bullet->img_angle].x_gc;
+  shots_ycoord[bullet->index] =
     ship->spr.ycoord +
     ship->spr.img[ship->spr.
                   current_image]->cannons_coords[cannon_pos][YCOORD] -
-    spr->img[bullet->img_angle]->y_gc;
+    bullet->img[bullet->img_angle].y_gc;
   bullet->timelife = 500;
   return bullet;
 }
@@ -928,8 +852,7 @@ shot_linear_spaceship_add (Sint16 damage, Sint16 anim_speed, Sint32 image_num,
       return;
     }
   /* linear trajectory */
-  bullet->spr.trajectory = 0;
-  bullet->spr.speed = speed;
+  shot_linear_speed_set (bullet, speed);
 }
 
 /**
@@ -951,8 +874,8 @@ shot_calulated_spaceship_add (Sint16 damage, Sint32 image_num, Sint16 angle,
       return;
     }
   /* trajectory calculated */
-  bullet->spr.trajectory = 1;
-  bullet->spr.speed = 4.0;
+  bullet->trajectory = 1;
+  bullet->speed = 4.0;
   bullet->angle = shot_angle;
   bullet->velocity = 0.04f;
 }
@@ -979,7 +902,7 @@ shot_curve_spaceship_add (Sint16 damage, Sint16 anim_speed, Sint32 image_num,
       return;
     }
   /* shot trajectory follow a curve */
-  bullet->spr.trajectory = 2;
+  bullet->trajectory = 2;
   /* set curve number used */
   bullet->curve_num = curve_num;
   /* clear index on the precalculated curve */
@@ -994,46 +917,44 @@ shot_curve_spaceship_add (Sint16 damage, Sint16 anim_speed, Sint32 image_num,
 static bool
 shot_enemies_collisions (shot_struct * bullet)
 {
-  Sint32 i, j, k, x1, y1, x2, y2;
+  Sint32 j, k, x1, y1, x2, y2, xshot, yshot;
+  Uint32 i, numof_foes;
   image *foe_img, *bullet_img;
-  enemy *foe;
-  bullet_img = bullet->spr.img[bullet->img_angle];
-
-  foe = enemy_get_first ();
-  if (foe == NULL)
-    {
-      return TRUE;
-    }
+  enemy *foe, **foes;
+  bullet_img = &bullet->img[bullet->img_angle];
+  xshot = (Sint32) shots_xcoord[bullet->index];
+  yshot = (Sint32) shots_ycoord[bullet->index];
 
-  /* for each enemy */
-  for (i = 0; i < num_of_enemies; i++, foe = foe->next)
+  /* for each collision point of the shot */
+  for (j = 0; j < bullet_img->numof_collisions_points; j++)
     {
-#ifdef UNDER_DEVELOPMENT
-      if (foe == NULL && i < (num_of_enemies - 1))
-        {
-          LOG_ERR ("foe->next is null %i/%i", i, num_of_enemies);
-          break;
-        }
-#endif
+      x1 = xshot + bullet_img->collisions_points[j][XCOORD];
+      y1 = yshot + bullet_img->collisions_points[j][YCOORD];
 
-      /* ignore collision, if enemy's not visible, dead, or guardian appearing */
-      if (!foe->visible || foe->dead ||
-          (guardian->is_appearing
-           && foe->displacement == DISPLACEMENT_GUARDIAN))
+      /* for each enemy close to the point */
+      foes = enemies_cells_get (x1, y1, &numof_foes);
+      for (i = 0; i < numof_foes; i++)
         {
-          continue;
-        }
-      foe_img = foe->spr.img[foe->spr.current_image];
-
-      /* for each collision point of the shot */
-      for (j = 0; j < bullet_img->numof_collisions_points; j++)
-        {
-          x1 =
-            (Sint32) bullet->spr.xcoord +
-            bullet_img->collisions_points[j][XCOORD];
-          y1 =
-            (Sint32) bullet->spr.ycoord +
-            bullet_img->collisions_points[j][YCOORD];
+          foe = foes[i];
+          /* ignore collision, if enemy's not visible, dead,
+           * or guardian appearing */
+          if (!foe->visible || foe->dead ||
+              (guardian->is_appearing
+               && foe->displacement == DISPLACEMENT_GUARDIAN))
+            {
+              continue;
+            }
+          foe_img = foe->spr.img[foe->spr.current_image];
+          x2 = (Sint32) foe->spr.xcoord;
+          y2 = (Sint32) foe->spr.ycoord;
+          /* reject the enemy if the bounding boxes do not overlap */
+          if (xshot + bullet_img->points_left >= x2 + foe_img->zones_right
+              || xshot + bullet_img->points_right <= x2 + foe_img->zones_left
+              || yshot + bullet_img->points_top >= y2 + foe_img->zones_bottom
+              || yshot + bullet_img->points_bottom <= y2 + foe_img->zones_top)
+            {
+              continue;
+            }
 
           /* for each collision zone of the enemy */
           for (k = 0; k < foe_img->numof_collisions_zones; k++)
@@ -1057,7 +978,7 @@ shot_enemies_collisions (shot_struct * bullet)
 
               /* decrease in the level of energy  */
               foe->spr.energy_level =
-                (Sint16) (foe->spr.energy_level - bullet->spr.pow_of_dest);
+                (Sint16) (foe->spr.energy_level - bullet->pow_of_dest);
 
               /* enemy destroyed */
               if (foe->spr.energy_level <= 0)
@@ -1113,8 +1034,9 @@ shot_enemies_collisions (shot_struct * bullet)
                       foe->fire_rate_count = foe->fire_rate_count >> 1;
                     }
                 }
-              explosion_add (bullet->spr.xcoord,
-                             bullet->spr.ycoord, 0.35f, EXPLOSION_SMALL, 0);
+              explosion_add (shots_xcoord[bullet->index],
+                             shots_ycoord[bullet->index], 0.35f,
+                             EXPLOSION_SMALL, 0);
               /* remove the shot which has just touched the enemy */
               return FALSE;
             }
@@ -44,16 +44,39 @@ extern "C"
   }
   SHOT_TYPEOF;
 
+  /**
+   * The coordinates and the displacement of the shots are stored apart
+   * in the parallel arrays 'shots_xcoord' and 'shots_ycoord', indexed
+   * by 'index', so that the linear shots are moved in one tight loop
+   */
   typedef struct shot_struct
   {
-    /** Sprite structure */
-    sprite spr;
+    /** Index of the shot in the parallel arrays */
+    Uint32 index;
+    /** Images of the shot, one per angle (fire[type][0]) */
+    image *img;
+    /** FRIEND or ENEMY */
+    Sint16 type;
+    /** 0: linear, 1: calculated (homing head), 2: follow a curve */
+    Sint16 trajectory;
+    /** Damage caused by the shot */
+    Sint16 pow_of_dest;
+    /** Number of images of the sprite */
+    Sint16 numof_images;
+    /** Current image index of a flicker shot */
+    Sint16 current_image;
+    /** Value of delay between two images */
+    Sint16 anim_speed;
+    /** Counter of delay between two images */
+    Sint16 anim_count;
     /** Index of progression */
     Sint32 curve_index;
     /** Curve number used */
     Sint16 curve_num;
     /** Time of life */
     Sint16 timelife;
+    /** Speed of the displacement */
+    float speed;
     /** Angle of the projectile */
     float angle;
     /**  Rotation speed */
@@ -88,6 +111,7 @@ extern "C"
   void shot_curve_spaceship_add (Sint16 damage, Sint16 anim_speed,
                                  Sint32 image_num, Sint16 angle,
                                  Sint32 cannon_pos, Sint16 curve_num);
+  void shot_linear_speed_set (shot_struct * bullet, float speed);
   float shot_x_move (float angle, float speed, float xcoord);
   float shot_y_move (float angle, float speed, float ycoord);
 #ifdef PNG_EXPORT_ENABLE
@@ -95,6 +119,8 @@ extern "C"
 #endif
 
   extern Sint32 num_of_shots;
+  extern float shots_xcoord[MAX_OF_SHOTS];
+  extern float shots_ycoord[MAX_OF_SHOTS];
 
 /* 
  * index of the fires images in the table of the fires (fire[][]) 
@@ -0,0 +1,671 @@
+/**
+ * @file soft_mixer.c
+ * @brief Mix the sounds without SDL_mixer, to a WAV file or to
+ *        nothing, used by the headless builds
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "config_file.h"
+#include "log_recorder.h"
+#include <string.h>
+#ifdef USE_SOFTMIXER
+#include "sdl_mixer.h"
+#include "sound_queue.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/** Sample rate of the mixed sounds, the rate of the waves of sounds/ */
+#define SOFTMIXER_RATE 22050
+/** Number of samples mixed for each frame of the game, 70 per second */
+#define SOFTMIXER_FRAME_SAMPLES 315
+/** Number of stereo samples of the ring buffer, a power of 2 */
+#define SOFTMIXER_RING_SIZE 8192
+/** Number of stereo samples written at once to the output */
+#define SOFTMIXER_BLOCK_SIZE 2048
+/** Size in bytes of the header of a WAV file */
+#define SOFTMIXER_WAV_HEADER_SIZE 44
+
+/** A wave decoded to 16-bit mono samples */
+typedef struct softmixer_sound
+{
+  Sint16 *pcm;
+  /** Number of samples */
+  Uint32 length;
+} softmixer_sound;
+
+/** A channel of the mixer */
+typedef struct softmixer_voice
+{
+  /** Samples of the sound played, NULL if the channel is free */
+  const Sint16 *pcm;
+  /** Number of samples of the sound */
+  Uint32 length;
+  /** Index of the next sample to mix */
+  Uint32 position;
+  /** Volumes of both sides, 256 is the volume of the wave */
+  Sint16 left;
+  Sint16 right;
+} softmixer_voice;
+
+/** Size in bytes of the waves samples */
+Uint32 sound_samples_len = 0;
+/** TRUE if the waves are decoded and the queue is initialized */
+static bool softmixer_enabled = FALSE;
+/** Filenames of the waves sounds */
+static const char *sounds_filenames[SOUND_NUMOF] = {
+  "sounds/sound_upgrade_spaceship.wav",
+  "sounds/sound_downgrade_spaceship.wav",
+  "sounds/sound_select_option.wav",
+  "sounds/sound_select_closed_option.wav",
+  "sounds/sound_purple_gem.wav",
+  "sounds/sound_yellow_gem.wav",
+  "sounds/sound_green_gem.wav",
+  "sounds/sound_red_gem.wav",
+  "sounds/sound_lonely_foe.wav",
+  "sounds/sound_circular_shock.wav",
+  "sounds/sound_spaceship_fire.wav",
+  "sounds/sound_guardian_fire_2.wav",
+  "sounds/sound_big_explosion_1.wav",
+  "sounds/sound_big_explosion_2.wav",
+  "sounds/sound_big_explosion_3.wav",
+  "sounds/sound_big_explosion_4.wav",
+  "sounds/sound_medium_explosion_1.wav",
+  "sounds/sound_medium_explosion_2.wav",
+  "sounds/sound_medium_explosion_3.wav",
+  "sounds/sound_medium_explosion_4.wav",
+  "sounds/sound_small_explosion_1.wav",
+  "sounds/sound_small_explosion_2.wav",
+  "sounds/sound_small_explosion_3.wav",
+  "sounds/sound_small_explosion_4.wav",
+  "sounds/sound_enemy_fire_1.wav",
+  "sounds/sound_enemy_fire_2.wav",
+  "sounds/sound_guardian_fire_1.wav",
+  "sounds/sound_guardian_fire_3.wav"
+};
+
+static softmixer_sound softmixer_sounds[SOUND_NUMOF];
+static softmixer_voice softmixer_voices[MAX_OF_CHANNELS];
+/** Sums of the voices of a frame, 8 bits more than the output */
+static Sint32 softmixer_left[SOFTMIXER_FRAME_SAMPLES];
+static Sint32 softmixer_right[SOFTMIXER_FRAME_SAMPLES];
+/** Stereo samples of the last frame mixed */
+static Sint16 softmixer_frame[SOFTMIXER_FRAME_SAMPLES * 2];
+/** Stereo samples mixed and not yet written to the output */
+static Sint16 softmixer_ring[SOFTMIXER_RING_SIZE * 2];
+static Uint32 softmixer_ring_head = 0;
+static Uint32 softmixer_ring_tail = 0;
+/** Block of samples converted to little-endian */
+static unsigned char softmixer_block[SOFTMIXER_BLOCK_SIZE * 4];
+/** WAV file which receives the samples, NULL to discard them */
+static FILE *softmixer_output = NULL;
+/** Size in bytes of the samples written to the WAV file */
+static Uint32 softmixer_output_len = 0;
+/** Value of loops_counter at the last call of sound_handle() */
+static Uint32 softmixer_loops = 0;
+/** Statistics written when the mixer is released */
+static Uint32 softmixer_frames_mixed = 0;
+static Uint32 softmixer_samples_written = 0;
+static Uint32 softmixer_voices_max = 0;
+
+/**
+ * Read a little-endian 16-bit integer
+ * @param mem Pointer to the integer
+ * @return The integer
+ */
+static Uint32
+softmixer_read16 (const unsigned char *mem)
+{
+  return (Uint32) mem[0] | ((Uint32) mem[1] << 8);
+}
+
+/**
+ * Read a little-endian 32-bit integer
+ * @param mem Pointer to the integer
+ * @return The integer
+ */
+static Uint32
+softmixer_read32 (const unsigned char *mem)
+{
+  return softmixer_read16 (mem) | (softmixer_read16 (mem + 2) << 16);
+}
+
+/**
+ * Write a little-endian 16-bit integer
+ * @param mem Pointer to the integer
+ * @param value The integer
+ */
+static void
+softmixer_write16 (unsigned char *mem, Uint32 value)
+{
+  mem[0] = (unsigned char) value;
+  mem[1] = (unsigned char) (value >> 8);
+}
+
+/**
+ * Write a little-endian 32-bit integer
+ * @param mem Pointer to the integer
+ * @param value The integer
+ */
+static void
+softmixer_write32 (unsigned char *mem, Uint32 value)
+{
+  softmixer_write16 (mem, value);
+  softmixer_write16 (mem + 2, value >> 16);
+}
+
+/**
+ * Load a PCM wave and convert it once to 16-bit mono samples at the
+ * rate of the mixer
+ * @param filename Filename of the wave
+ * @param sound Pointer to the sound which receives the samples
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+softmixer_wave_load (const char *filename, softmixer_sound * sound)
+{
+  Uint32 i, j, size, chunk_len, numof, frame_size, pos;
+  Uint32 format = 0, channels = 0, rate = 0, bits = 0, data_len = 0;
+  Sint32 sum;
+  const unsigned char *cur, *end, *data = NULL;
+  char *file = loadfile (filename, &size);
+  if (file == NULL)
+    {
+      return FALSE;
+    }
+  cur = (const unsigned char *) file;
+  end = cur + size;
+  if (size < 12 || memcmp (cur, "RIFF", 4) != 0
+      || memcmp (cur + 8, "WAVE", 4) != 0)
+    {
+      LOG_ERR ("%s is not a WAV file", filename);
+      free_memory (file);
+      return FALSE;
+    }
+
+  /* find the format and the samples */
+  cur += 12;
+  while (end - cur >= 8)
+    {
+      chunk_len = softmixer_read32 (cur + 4);
+      if (chunk_len > (Uint32) (end - cur - 8))
+        {
+          /* truncated file, keep the samples read */
+          chunk_len = (Uint32) (end - cur - 8);
+        }
+      if (memcmp (cur, "fmt ", 4) == 0 && chunk_len >= 16)
+        {
+          format = softmixer_read16 (cur + 8);
+          channels = softmixer_read16 (cur + 10);
+          rate = softmixer_read32 (cur + 12);
+          bits = softmixer_read16 (cur + 22);
+        }
+      else if (memcmp (cur, "data", 4) == 0)
+        {
+          data = cur + 8;
+          data_len = chunk_len;
+        }
+      if (chunk_len + (chunk_len & 1) >= (Uint32) (end - cur - 8))
+        {
+          break;
+        }
+      cur += 8 + chunk_len + (chunk_len & 1);
+    }
+  if (format != 1 || channels < 1 || channels > 2 || rate == 0
+      || (bits != 8 && bits != 16) || data == NULL)
+    {
+      LOG_ERR ("%s: only the 8 or 16-bit PCM waves are supported",
+               filename);
+      free_memory (file);
+      return FALSE;
+    }
+
+  /* average the channels and resample to the nearest sample */
+  frame_size = channels * bits / 8;
+  numof = data_len / frame_size;
+  sound->length = (Uint32) ((Uint64) numof * SOFTMIXER_RATE / rate);
+  if (sound->length == 0)
+    {
+      LOG_ERR ("%s: the wave has no samples", filename);
+      free_memory (file);
+      return FALSE;
+    }
+  sound->pcm =
+    (Sint16 *) memory_allocation (sound->length * sizeof (Sint16));
+  if (sound->pcm == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes",
+               (Uint32) (sound->length * sizeof (Sint16)));
+      free_memory (file);
+      return FALSE;
+    }
+  for (i = 0; i < sound->length; i++)
+    {
+      pos = (Uint32) ((Uint64) i * rate / SOFTMIXER_RATE) * frame_size;
+      sum = 0;
+      for (j = 0; j < channels; j++)
+        {
+          if (bits == 8)
+            {
+              sum += ((Sint32) data[pos + j] - 128) * 256;
+            }
+          else
+            {
+              sum += (Sint16) softmixer_read16 (data + pos + j * 2);
+            }
+        }
+      sound->pcm[i] = (Sint16) (sum / (Sint32) channels);
+    }
+  free_memory (file);
+  sound_samples_len += sound->length * sizeof (Sint16);
+  return TRUE;
+}
+
+/**
+ * Write the header of the WAV file, with the size of the samples
+ * already written
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+softmixer_output_header (void)
+{
+  unsigned char header[SOFTMIXER_WAV_HEADER_SIZE];
+  memcpy (header, "RIFF", 4);
+  softmixer_write32 (header + 4,
+                     SOFTMIXER_WAV_HEADER_SIZE - 8 + softmixer_output_len);
+  memcpy (header + 8, "WAVEfmt ", 8);
+  softmixer_write32 (header + 16, 16);
+  /* PCM, stereo, 16-bit */
+  softmixer_write16 (header + 20, 1);
+  softmixer_write16 (header + 22, 2);
+  softmixer_write32 (header + 24, SOFTMIXER_RATE);
+  softmixer_write32 (header + 28, SOFTMIXER_RATE * 4);
+  softmixer_write16 (header + 32, 4);
+  softmixer_write16 (header + 34, 16);
+  memcpy (header + 36, "data", 4);
+  softmixer_write32 (header + 40, softmixer_output_len);
+  return fwrite (header, SOFTMIXER_WAV_HEADER_SIZE, 1, softmixer_output) == 1;
+}
+
+/**
+ * Close the WAV file, the samples are then discarded
+ */
+static void
+softmixer_output_close (void)
+{
+  if (softmixer_output == NULL)
+    {
+      return;
+    }
+  if (fseek (softmixer_output, 0, SEEK_SET) != 0
+      || !softmixer_output_header ())
+    {
+      LOG_ERR ("can't write the header of %s", power_conf->sound_output);
+    }
+  fclose (softmixer_output);
+  softmixer_output = NULL;
+}
+
+/**
+ * Write the samples of the ring buffer to the output
+ * @param all FALSE to write only whole blocks, TRUE to write all
+ *        the samples at the end
+ */
+static void
+softmixer_output_write (bool all)
+{
+  Uint32 i, numof;
+  Sint16 *samples;
+  for (;;)
+    {
+      numof = softmixer_ring_head - softmixer_ring_tail;
+      if (numof > SOFTMIXER_BLOCK_SIZE)
+        {
+          numof = SOFTMIXER_BLOCK_SIZE;
+        }
+      if (numof == 0 || (numof < SOFTMIXER_BLOCK_SIZE && !all))
+        {
+          break;
+        }
+      /* the blocks begin at a multiple of their size, they never
+       * wrap around the ring */
+      samples =
+        softmixer_ring + (softmixer_ring_tail & (SOFTMIXER_RING_SIZE - 1)) * 2;
+      if (softmixer_output != NULL)
+        {
+          for (i = 0; i < numof * 2; i++)
+            {
+              softmixer_write16 (softmixer_block + i * 2,
+                                 (Uint16) samples[i]);
+            }
+          if (fwrite (softmixer_block, numof * 4, 1, softmixer_output) != 1)
+            {
+              LOG_ERR ("can't write to %s, the sounds are discarded",
+                       power_conf->sound_output);
+              softmixer_output_close ();
+            }
+          else
+            {
+              softmixer_output_len += numof * 4;
+            }
+        }
+      softmixer_ring_tail += numof;
+      softmixer_samples_written += numof;
+    }
+}
+
+/**
+ * Add the samples of a voice to the sums of the frame
+ * @param voice The voice
+ * @param numof Number of samples to mix
+ */
+static void
+softmixer_voice_mix (softmixer_voice * voice, Uint32 numof)
+{
+  Uint32 i = 0;
+  Sint32 sample;
+  const Sint16 *pcm = voice->pcm + voice->position;
+#ifdef __SSE2__
+  __m128i samples, lo, hi;
+  __m128i *sums;
+  __m128i left = _mm_set1_epi16 (voice->left);
+  __m128i right = _mm_set1_epi16 (voice->right);
+  for (; i + 8 <= numof; i += 8)
+    {
+      /* 8 products of 32 bits from their low and high halves */
+      samples = _mm_loadu_si128 ((const __m128i *) (pcm + i));
+      lo = _mm_mullo_epi16 (samples, left);
+      hi = _mm_mulhi_epi16 (samples, left);
+      sums = (__m128i *) (softmixer_left + i);
+      _mm_storeu_si128 (sums, _mm_add_epi32 (_mm_loadu_si128 (sums),
+                                             _mm_unpacklo_epi16 (lo, hi)));
+      _mm_storeu_si128 (sums + 1,
+                        _mm_add_epi32 (_mm_loadu_si128 (sums + 1),
+                                       _mm_unpackhi_epi16 (lo, hi)));
+      lo = _mm_mullo_epi16 (samples, right);
+      hi = _mm_mulhi_epi16 (samples, right);
+      sums = (__m128i *) (softmixer_right + i);
+      _mm_storeu_si128 (sums, _mm_add_epi32 (_mm_loadu_si128 (sums),
+                                             _mm_unpacklo_epi16 (lo, hi)));
+      _mm_storeu_si128 (sums + 1,
+                        _mm_add_epi32 (_mm_loadu_si128 (sums + 1),
+                                       _mm_unpackhi_epi16 (lo, hi)));
+    }
+#endif
+  for (; i < numof; i++)
+    {
+      sample = pcm[i];
+      softmixer_left[i] += sample * voice->left;
+      softmixer_right[i] += sample * voice->right;
+    }
+  voice->position += numof;
+}
+
+/**
+ * Convert a sum of the voices to a 16-bit sample
+ * @param sum The sum
+ * @return The sample, saturated
+ */
+static Sint16
+softmixer_saturate (Sint32 sum)
+{
+  sum >>= 8;
+  return (Sint16) (sum < -32768 ? -32768 : sum > 32767 ? 32767 : sum);
+}
+
+/**
+ * Convert the sums of the voices to interleaved stereo samples
+ */
+static void
+softmixer_frame_pack (void)
+{
+  Uint32 i = 0;
+#ifdef __SSE2__
+  __m128i left, right;
+  for (; i + 8 <= SOFTMIXER_FRAME_SAMPLES; i += 8)
+    {
+      left = _mm_packs_epi32 (_mm_srai_epi32
+                              (_mm_loadu_si128
+                               ((const __m128i *) (softmixer_left + i)), 8),
+                              _mm_srai_epi32 (_mm_loadu_si128
+                                              ((const __m128i *)
+                                               (softmixer_left + i + 4)), 8));
+      right = _mm_packs_epi32 (_mm_srai_epi32
+                               (_mm_loadu_si128
+                                ((const __m128i *) (softmixer_right + i)), 8),
+                               _mm_srai_epi32 (_mm_loadu_si128
+                                               ((const __m128i *)
+                                                (softmixer_right + i + 4)),
+                                               8));
+      _mm_storeu_si128 ((__m128i *) (softmixer_frame + i * 2),
+                        _mm_unpacklo_epi16 (left, right));
+      _mm_storeu_si128 ((__m128i *) (softmixer_frame + i * 2 + 8),
+                        _mm_unpackhi_epi16 (left, right));
+    }
+#endif
+  for (; i < SOFTMIXER_FRAME_SAMPLES; i++)
+    {
+      softmixer_frame[i * 2] = softmixer_saturate (softmixer_left[i]);
+      softmixer_frame[i * 2 + 1] = softmixer_saturate (softmixer_right[i]);
+    }
+}
+
+/**
+ * Mix the voices for one frame of the game into the ring buffer,
+ * called by the thread of the sound queue
+ */
+static void
+softmixer_mix (void)
+{
+  Uint32 i, numof, first, voices = 0;
+  softmixer_voice *voice;
+  memset (softmixer_left, 0, sizeof (softmixer_left));
+  memset (softmixer_right, 0, sizeof (softmixer_right));
+  for (i = 0; i < MAX_OF_CHANNELS; i++)
+    {
+      voice = &softmixer_voices[i];
+      if (voice->pcm == NULL)
+        {
+          continue;
+        }
+      numof = voice->length - voice->position;
+      if (numof > SOFTMIXER_FRAME_SAMPLES)
+        {
+          numof = SOFTMIXER_FRAME_SAMPLES;
+        }
+      softmixer_voice_mix (voice, numof);
+      if (voice->position >= voice->length)
+        {
+          voice->pcm = NULL;
+        }
+      voices++;
+    }
+  if (voices > softmixer_voices_max)
+    {
+      softmixer_voices_max = voices;
+    }
+  softmixer_frame_pack ();
+
+  /* the output is late: the oldest samples are lost */
+  if (softmixer_ring_head - softmixer_ring_tail >
+      SOFTMIXER_RING_SIZE - SOFTMIXER_FRAME_SAMPLES)
+    {
+      softmixer_output_write (TRUE);
+    }
+  first = softmixer_ring_head & (SOFTMIXER_RING_SIZE - 1);
+  numof = SOFTMIXER_RING_SIZE - first;
+  if (numof > SOFTMIXER_FRAME_SAMPLES)
+    {
+      numof = SOFTMIXER_FRAME_SAMPLES;
+    }
+  memcpy (softmixer_ring + first * 2, softmixer_frame,
+          numof * 2 * sizeof (Sint16));
+  memcpy (softmixer_ring, softmixer_frame + numof * 2,
+          (SOFTMIXER_FRAME_SAMPLES - numof) * 2 * sizeof (Sint16));
+  softmixer_ring_head += SOFTMIXER_FRAME_SAMPLES;
+  softmixer_frames_mixed++;
+  softmixer_output_write (FALSE);
+}
+
+/**
+ * Play a sound on a channel, called by the thread of the sound queue
+ * @param channel Index of the channel
+ * @param sound Index of the sound
+ * @param pan Horizontal position: 0 (left) to 255 (right)
+ */
+static void
+softmixer_channel_play (Uint32 channel, Uint32 sound, Uint32 pan)
+{
+  softmixer_voice *voice = &softmixer_voices[channel];
+  voice->pcm = softmixer_sounds[sound].pcm;
+  voice->length = softmixer_sounds[sound].length;
+  voice->position = 0;
+  /* the same panning as SDL_mixer, the nearest side keeps the
+   * volume of the wave */
+  voice->left = (Sint16) (pan <= SOUND_PAN_CENTER ? 256 : (255 - pan) * 2);
+  voice->right = (Sint16) (pan >= SOUND_PAN_CENTER ? 256 : pan * 2);
+}
+
+/**
+ * Check if a channel plays, called by the thread of the sound queue
+ * @param channel Index of the channel
+ * @return TRUE if a sound is played on the channel
+ */
+static bool
+softmixer_channel_playing (Uint32 channel)
+{
+  return softmixer_voices[channel].pcm != NULL;
+}
+
+/**
+ * Decode the waves sounds files and open the output
+ * @return TRUE if successful
+ */
+bool
+sound_once_init (void)
+{
+  Uint32 i;
+  if (power_conf->nosound)
+    {
+      LOG_INF ("sound has been disabled");
+      return TRUE;
+    }
+  sound_samples_len = 0;
+  for (i = 0; i < SOUND_NUMOF; i++)
+    {
+      if (!softmixer_wave_load (sounds_filenames[i], &softmixer_sounds[i]))
+        {
+          return FALSE;
+        }
+    }
+  for (i = 0; i < MAX_OF_CHANNELS; i++)
+    {
+      softmixer_voices[i].pcm = NULL;
+    }
+  softmixer_ring_head = softmixer_ring_tail = 0;
+  softmixer_output_len = 0;
+  softmixer_frames_mixed = softmixer_samples_written = 0;
+  softmixer_voices_max = 0;
+  if (power_conf->sound_output != NULL)
+    {
+      softmixer_output = fopen_data (power_conf->sound_output, "wb");
+      if (softmixer_output == NULL)
+        {
+          return FALSE;
+        }
+      /* the sizes are written when the file is closed */
+      if (!softmixer_output_header ())
+        {
+          LOG_ERR ("can't write to %s", power_conf->sound_output);
+          softmixer_output_close ();
+          return FALSE;
+        }
+    }
+  softmixer_loops = loops_counter;
+  /* the benchmark mixes with the game thread, to measure the mixer */
+  sound_queue_init (softmixer_channel_play, softmixer_channel_playing,
+                    softmixer_mix, MAX_OF_CHANNELS,
+                    power_conf->bench_frames == 0);
+  softmixer_enabled = TRUE;
+  LOG_INF ("sound has been successfully initialized, %i bytes of waves",
+           sound_samples_len);
+  return TRUE;
+}
+
+/**
+ * The musics modules are not decoded by the software mixer
+ * @param module_num Music module number
+ * @return Always TRUE
+ */
+bool
+sound_music_play (Sint32 module_num)
+{
+  (void) module_num;
+  return TRUE;
+}
+
+/**
+ * Mix the sounds requested since the last call, one frame of samples
+ * for each frame of the game
+ */
+void
+sound_handle (void)
+{
+  Uint32 frames;
+  if (!softmixer_enabled)
+    {
+      return;
+    }
+  frames = loops_counter - softmixer_loops;
+  softmixer_loops = loops_counter;
+  sound_queue_flush (frames);
+}
+
+/**
+ * Stop the mixer, write the last samples and release the waves
+ */
+void
+sound_free (void)
+{
+  Uint32 i;
+  if (softmixer_enabled)
+    {
+      sound_queue_free ();
+      softmixer_output_write (TRUE);
+      LOG_INF ("%i frames mixed, %i samples written, up to %i voices"
+               " at once", softmixer_frames_mixed, softmixer_samples_written,
+               softmixer_voices_max);
+      softmixer_output_close ();
+      softmixer_enabled = FALSE;
+    }
+  for (i = 0; i < SOUND_NUMOF; i++)
+    {
+      if (softmixer_sounds[i].pcm != NULL)
+        {
+          free_memory ((char *) softmixer_sounds[i].pcm);
+          softmixer_sounds[i].pcm = NULL;
+        }
+    }
+}
+#endif
@@ -0,0 +1,452 @@
+/**
+ * @file sound_queue.c
+ * @brief Queue of the sounds requested by the game, played by an
+ *        audio thread on the channels of the mixer
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "config_file.h"
+#include "display.h"
+#include "log_recorder.h"
+#include "menu.h"
+#include "menu_sections.h"
+#include <string.h>
+#ifdef USE_SOUND
+#include "sdl_mixer.h"
+#include "sound_queue.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+/* the game thread writes the head of the queue and the audio thread
+ * writes its tail, without lock */
+#define SOUND_QUEUE_LOAD(ptr) __atomic_load_n (ptr, __ATOMIC_ACQUIRE)
+#define SOUND_QUEUE_STORE(ptr, value) \
+  __atomic_store_n (ptr, value, __ATOMIC_RELEASE)
+#else
+#define SOUND_QUEUE_LOAD(ptr) (*(ptr))
+#define SOUND_QUEUE_STORE(ptr, value) (*(ptr) = (value))
+#endif
+
+/** Priority of a sound and maximum number of channels which play it */
+typedef struct sound_policy
+{
+  Uint8 priority;
+  Uint8 voices;
+} sound_policy;
+
+/** Priorities and voices of the sounds: the explosions and the shots of
+ * the enemies can be heard many times in the same frame */
+static const sound_policy sound_policies[SOUND_NUMOF] = {
+  /* SOUND_UPGRADE_SPACESHIP, SOUND_DOWNGRADE_SPACESHIP */
+  {3, 1}, {3, 1},
+  /* SOUND_SELECT_OPTION, SOUND_SELECT_CLOSED_OPTION */
+  {3, 1}, {3, 1},
+  /* SOUND_PURPLE_GEM, SOUND_YELLOW_GEM, SOUND_GREEN_GEM, SOUND_RED_GEM */
+  {3, 1}, {3, 1}, {3, 1}, {3, 1},
+  /* SOUND_LONELY_FOE, SOUND_CIRCULAR_SHOCK */
+  {2, 1}, {3, 1},
+  /* SOUND_SPACESHIP_FIRE, SOUND_GUARDIAN_FIRE_2 */
+  {2, 2}, {2, 2},
+  /* SOUND_BIG_EXPLOSION_1 to 4 */
+  {2, 2}, {2, 2}, {2, 2}, {2, 2},
+  /* SOUND_MEDIUM_EXPLOSION_1 to 4 */
+  {1, 1}, {1, 1}, {1, 1}, {1, 1},
+  /* SOUND_SMALL_EXPLOSION_1 to 4 */
+  {0, 1}, {0, 1}, {0, 1}, {0, 1},
+  /* SOUND_ENEMY_FIRE_1, SOUND_ENEMY_FIRE_2 */
+  {0, 2}, {0, 2},
+  /* SOUND_GUARDIAN_FIRE_1, SOUND_GUARDIAN_FIRE_3 */
+  {2, 2}, {2, 2}
+};
+
+/** A channel of the mixer */
+typedef struct sound_voice
+{
+  /** Index of the sound played, -1 if the channel is free */
+  Sint32 sound;
+  Uint32 priority;
+  /** Number of the sound started on the channel, the oldest sounds
+   * are stopped first */
+  Uint32 age;
+} sound_voice;
+
+/** Ring of the sounds requested */
+static sound_event sound_events[SOUND_QUEUE_SIZE];
+/** Number of sounds pushed by the game thread */
+static Uint32 sound_head = 0;
+/** Number of sounds taken by the audio thread */
+static Uint32 sound_tail = 0;
+/** Functions of the mixer */
+static sound_play_func sound_channel_play = NULL;
+static sound_playing_func sound_channel_playing = NULL;
+static sound_mix_func sound_mix = NULL;
+/** Channels of the mixer, used by the audio thread only */
+static sound_voice sound_voices[MAX_OF_CHANNELS];
+static Uint32 sound_numof_voices = 0;
+static Uint32 sound_age = 0;
+/** Number of sounds started, of sounds started on a channel which
+ * was playing, of sounds not played because all the channels play
+ * more important sounds, and of sounds lost because the queue was
+ * full */
+static Uint32 sound_started = 0;
+static Uint32 sound_stolen = 0;
+static Uint32 sound_rejected = 0;
+static Uint32 sound_dropped = 0;
+/** Number of ends of frames not pushed because the queue was full */
+static Uint32 sound_frames_late = 0;
+
+#ifdef HAVE_PTHREAD_H
+static pthread_t sound_thread;
+/** Protect the following variables */
+static pthread_mutex_t sound_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Signaled when a frame is pushed or the thread must quit */
+static pthread_cond_t sound_cond = PTHREAD_COND_INITIALIZER;
+/** TRUE if a frame was pushed since the thread has emptied the queue */
+static bool sound_pending = FALSE;
+/** TRUE if the thread must quit */
+static bool sound_quit = FALSE;
+/** TRUE if the thread is running */
+static bool sound_running = FALSE;
+#endif
+
+/**
+ * Choose a channel and play a sound. A sound which is played too
+ * many times stops its oldest channel, else a free channel is used,
+ * else the oldest channel of lowest priority is stopped if its
+ * priority isn't higher
+ * @param event The sound requested
+ */
+static void
+sound_voice_start (const sound_event * event)
+{
+  Uint32 i;
+  Sint32 channel = -1, oldest = -1, victim = -1, unused = -1;
+  Uint32 count = 0;
+  sound_voice *voice;
+  for (i = 0; i < sound_numof_voices; i++)
+    {
+      voice = &sound_voices[i];
+      if (voice->sound >= 0 && !sound_channel_playing (i))
+        {
+          voice->sound = -1;
+        }
+      if (voice->sound < 0)
+        {
+          if (unused < 0)
+            {
+              unused = i;
+            }
+          continue;
+        }
+      if (voice->sound == event->sound)
+        {
+          count++;
+          if (oldest < 0 || voice->age < sound_voices[oldest].age)
+            {
+              oldest = i;
+            }
+        }
+      if (victim < 0 || voice->priority < sound_voices[victim].priority
+          || (voice->priority == sound_voices[victim].priority
+              && voice->age < sound_voices[victim].age))
+        {
+          victim = i;
+        }
+    }
+  if (count >= sound_policies[event->sound].voices)
+    {
+      channel = oldest;
+      sound_stolen++;
+    }
+  else if (unused >= 0)
+    {
+      channel = unused;
+    }
+  else if (victim >= 0 && sound_voices[victim].priority <= event->priority)
+    {
+      channel = victim;
+      sound_stolen++;
+    }
+  else
+    {
+      sound_rejected++;
+      return;
+    }
+  voice = &sound_voices[channel];
+  voice->sound = event->sound;
+  voice->priority = event->priority;
+  voice->age = sound_age++;
+  sound_channel_play (channel, event->sound, event->pan);
+  sound_started++;
+}
+
+/**
+ * Play the sounds of the queue, a sound requested many times in the
+ * same frame is started once. The mixer is called at the end of each
+ * frame
+ */
+static void
+sound_queue_process (void)
+{
+  static bool started[SOUND_NUMOF];
+  Uint32 i;
+  sound_event *event;
+  Uint32 tail = sound_tail;
+  Uint32 head = SOUND_QUEUE_LOAD (&sound_head);
+  while (tail != head)
+    {
+      event = &sound_events[tail & (SOUND_QUEUE_SIZE - 1)];
+      if (event->sound == SOUND_QUEUE_FRAME)
+        {
+          for (i = 0; sound_mix != NULL && i < event->pan; i++)
+            {
+              sound_mix ();
+            }
+          memset (started, 0, sizeof (started));
+        }
+      else if (!started[event->sound])
+        {
+          started[event->sound] = TRUE;
+          sound_voice_start (event);
+        }
+      tail++;
+    }
+  SOUND_QUEUE_STORE (&sound_tail, tail);
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * Main function of the thread: wait for sounds and play them
+ * @param arg Unused
+ * @return Always NULL
+ */
+static void *
+sound_loop (void *arg)
+{
+  (void) arg;
+  pthread_mutex_lock (&sound_mutex);
+  for (;;)
+    {
+      while (!sound_pending && !sound_quit)
+        {
+          pthread_cond_wait (&sound_cond, &sound_mutex);
+        }
+      if (sound_quit)
+        {
+          break;
+        }
+      sound_pending = FALSE;
+      pthread_mutex_unlock (&sound_mutex);
+      sound_queue_process ();
+      pthread_mutex_lock (&sound_mutex);
+    }
+  pthread_mutex_unlock (&sound_mutex);
+  return NULL;
+}
+#endif
+
+/**
+ * Empty the queue and start the audio thread
+ * @param play Function of the mixer which plays a sound on a channel
+ * @param playing Function of the mixer which checks a channel
+ * @param mix Function of the mixer called at the end of each frame,
+ *        or NULL
+ * @param numof_channels Number of channels of the mixer
+ * @param threaded FALSE to play the sounds with the main thread
+ * @return TRUE if the thread is started, FALSE if the sounds will be
+ *         played by the main thread
+ */
+bool
+sound_queue_init (sound_play_func play, sound_playing_func playing,
+                  sound_mix_func mix, Uint32 numof_channels, bool threaded)
+{
+  Uint32 i;
+  sound_queue_free ();
+  sound_channel_play = play;
+  sound_channel_playing = playing;
+  sound_mix = mix;
+  sound_numof_voices =
+    numof_channels < MAX_OF_CHANNELS ? numof_channels : MAX_OF_CHANNELS;
+  for (i = 0; i < MAX_OF_CHANNELS; i++)
+    {
+      sound_voices[i].sound = -1;
+    }
+  sound_head = sound_tail = 0;
+  sound_age = 0;
+  sound_started = sound_stolen = sound_rejected = sound_dropped = 0;
+  sound_frames_late = 0;
+  if (!threaded)
+    {
+      return FALSE;
+    }
+#ifdef HAVE_PTHREAD_H
+  sound_pending = FALSE;
+  sound_quit = FALSE;
+  if (pthread_create (&sound_thread, NULL, sound_loop, NULL) != 0)
+    {
+      LOG_ERR ("pthread_create() failed");
+      return FALSE;
+    }
+  sound_running = TRUE;
+  LOG_INF ("sounds played by a thread");
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/**
+ * Stop the audio thread, the sounds of the queue are not played
+ * unless the mixer has a mix function: the frames are then mixed
+ * to the end
+ */
+void
+sound_queue_free (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (sound_running)
+    {
+      pthread_mutex_lock (&sound_mutex);
+      sound_quit = TRUE;
+      pthread_cond_broadcast (&sound_cond);
+      pthread_mutex_unlock (&sound_mutex);
+      pthread_join (sound_thread, NULL);
+      sound_running = FALSE;
+    }
+#endif
+  if (sound_mix != NULL)
+    {
+      sound_queue_process ();
+    }
+  if (sound_channel_play != NULL)
+    {
+      LOG_INF ("%i sounds started, %i stopped a channel, %i rejected,"
+               " %i lost", sound_started, sound_stolen, sound_rejected,
+               sound_dropped);
+    }
+  sound_channel_play = NULL;
+  sound_channel_playing = NULL;
+  sound_mix = NULL;
+}
+
+/**
+ * Request a sound, called by the game thread. It never waits: the
+ * sound is lost if the queue is full
+ * @param sound Index of the sound
+ * @param pan Horizontal position: 0 (left) to 255 (right)
+ */
+void
+sound_queue_push (Uint32 sound, Uint32 pan)
+{
+  sound_event *event;
+  Uint32 head = sound_head;
+  if (sound_channel_play == NULL || sound >= SOUND_NUMOF)
+    {
+      return;
+    }
+  if (head - SOUND_QUEUE_LOAD (&sound_tail) >=
+      SOUND_QUEUE_SIZE - SOUND_QUEUE_RESERVED)
+    {
+      sound_dropped++;
+      return;
+    }
+  event = &sound_events[head & (SOUND_QUEUE_SIZE - 1)];
+  event->sound = (Uint16) sound;
+  event->pan = (Uint8) (pan > 255 ? 255 : pan);
+  event->priority = sound_policies[sound].priority;
+  SOUND_QUEUE_STORE (&sound_head, head + 1);
+}
+
+/**
+ * End the frames and give the sounds requested during the frames to
+ * the audio thread, called after each display by the game thread
+ * @param numof_frames Number of frames of the game since the last call
+ */
+void
+sound_queue_flush (Uint32 numof_frames)
+{
+  sound_event *event;
+  Uint32 head = sound_head;
+  if (sound_channel_play == NULL)
+    {
+      return;
+    }
+  sound_frames_late += numof_frames;
+  if (sound_frames_late > 255)
+    {
+      sound_frames_late = 255;
+    }
+  /* if the queue is full, the frames are ended with the next ones */
+  if (head - SOUND_QUEUE_LOAD (&sound_tail) < SOUND_QUEUE_SIZE)
+    {
+      event = &sound_events[head & (SOUND_QUEUE_SIZE - 1)];
+      event->sound = SOUND_QUEUE_FRAME;
+      event->pan = (Uint8) sound_frames_late;
+      event->priority = 0;
+      sound_frames_late = 0;
+      SOUND_QUEUE_STORE (&sound_head, head + 1);
+    }
+#ifdef HAVE_PTHREAD_H
+  if (sound_running)
+    {
+      pthread_mutex_lock (&sound_mutex);
+      sound_pending = TRUE;
+      pthread_cond_signal (&sound_cond);
+      pthread_mutex_unlock (&sound_mutex);
+      return;
+    }
+#endif
+  sound_queue_process ();
+}
+
+/**
+ * Request to play sound effect in the middle of the screen
+ * @param sound_nu Sound number
+ */
+void
+sound_play (Uint32 sound_nu)
+{
+  if (!gameover_enable && !player_pause && menu_section == NO_SECTION_SELECTED
+      && menu_status == MENU_OFF)
+    {
+      sound_queue_push (sound_nu, SOUND_PAN_CENTER);
+    }
+}
+
+/**
+ * Request to play sound effect at a position of the screen
+ * @param sound_nu Sound number
+ * @param xcoord X-coordinate in the offscreen of the game
+ */
+void
+sound_play_at (Uint32 sound_nu, Sint32 xcoord)
+{
+  Sint32 pan =
+    (xcoord - offscreen_clipsize) * 255 / offscreen_width_visible;
+  if (!gameover_enable && !player_pause && menu_section == NO_SECTION_SELECTED
+      && menu_status == MENU_OFF)
+    {
+      sound_queue_push (sound_nu, pan < 0 ? 0 : (Uint32) pan);
+    }
+}
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file sound_queue.h
+ * @brief Queue of the sounds requested by the game, played by an
+ *        audio thread on the channels of the mixer
+ * @created 2026-10-17
+ * @date 2026-10-17
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __SOUND_QUEUE__
+#define __SOUND_QUEUE__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Maximum number of sounds requested between two frames, must be a
+ * power of 2 */
+#define SOUND_QUEUE_SIZE 64
+/** Number of entries of the queue kept for the ends of the frames */
+#define SOUND_QUEUE_RESERVED 8
+/** Index of the event which ends a frame of the game */
+#define SOUND_QUEUE_FRAME 0xffff
+/** Position of a sound in the middle of the screen, from 0 (left)
+ * to 255 (right) */
+#define SOUND_PAN_CENTER 128
+
+  /** A sound requested by the game, or the end of a frame */
+  typedef struct sound_event
+  {
+    /** Index of the sound, SOUND_UPGRADE_SPACESHIP to SOUND_NUMOF - 1,
+     * or SOUND_QUEUE_FRAME */
+    Uint16 sound;
+    /** Horizontal position: 0 (left) to 255 (right), or the number of
+     * frames ended */
+    Uint8 pan;
+    /** The sounds of lower priority are stopped first when all the
+     * channels are used */
+    Uint8 priority;
+  }
+  sound_event;
+
+  /**
+   * Function of the mixer which plays a sound on a channel, the sound
+   * previously played on the channel is stopped
+   * @param channel Index of the channel
+   * @param sound Index of the sound
+   * @param pan Horizontal position: 0 (left) to 255 (right)
+   */
+  typedef void (*sound_play_func) (Uint32 channel, Uint32 sound, Uint32 pan);
+  /**
+   * Function of the mixer which checks if a channel still plays
+   * @param channel Index of the channel
+   * @return TRUE if a sound is played on the channel
+   */
+  typedef bool (*sound_playing_func) (Uint32 channel);
+  /**
+   * Function of the mixer called at the end of each frame of the game,
+   * after the sounds of the frame are started
+   */
+  typedef void (*sound_mix_func) (void);
+
+  bool sound_queue_init (sound_play_func play, sound_playing_func playing,
+                         sound_mix_func mix, Uint32 numof_channels,
+                         bool threaded);
+  void sound_queue_free (void);
+  void sound_queue_push (Uint32 sound, Uint32 pan);
+  void sound_queue_flush (Uint32 numof_frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
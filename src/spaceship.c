@@ -27,6 +27,7 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "game_rand.h"
 #include "images.h"
 #include "display.h"
 #include "electrical_shock.h"
@@ -272,11 +273,11 @@ spaceship_invincibility (void)
   /* add a star in the explosions list */
   coordx =
     (Sint32) ship->spr.xcoord +
-    (Sint32) (((Sint32) rand () %
+    (Sint32) (((Sint32) game_rand () %
                (ship->spr.img[ship->spr.current_image]->w + 16))) - 16;
   coordy =
     (Sint32) ship->spr.ycoord +
-    (Sint32) (((Sint32) rand () %
+    (Sint32) (((Sint32) game_rand () %
                (ship->spr.img[ship->spr.current_image]->h + 16))) - 8;
   if (coordx >= offscreen_clipsize
       && coordx <= (offscreen_clipsize + offscreen_width_visible)
@@ -406,7 +407,7 @@ spaceship_gameover (void)
   ship->gems_count = 0;
   /* clear keyboard flags */
   clear_keymap ();
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   /* play introduction music */
   sound_music_play (MUSIC_INTRO);
 #endif
@@ -429,7 +430,7 @@ spaceship_downgrading (void)
   if (ship->type != SPACESHIP_TYPE_1)
     {
       ship->type--;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
       sound_play (SOUND_DOWNGRADE_SPACESHIP);
 #endif
       /* change of spaceship */
@@ -603,7 +604,7 @@ spaceship_upgrading (void)
   ship->type++;
   /* notice that spaceship change */
   ship->has_just_upgraded = TRUE;
-#ifdef USE_SDLMIXER
+#ifdef USE_SOUND
   sound_play (SOUND_UPGRADE_SPACESHIP);
 #endif
   ship->invincibility_delay = SPACESHIP_INVINCIBILITY_TIME;
@@ -655,6 +656,19 @@ spaceship_enemy_collision (enemy * foe, float speed_x, float speed_y)
   ship_img = ship->spr.img[ship->spr.current_image];
   foe_img = foe->spr.img[foe->spr.current_image];
 
+  /* reject the enemy if the bounding boxes do not overlap */
+  x1 = (Sint32) ship->spr.xcoord;
+  y1 = (Sint32) ship->spr.ycoord;
+  x2 = (Sint32) foe->spr.xcoord;
+  y2 = (Sint32) foe->spr.ycoord;
+  if (x1 + ship_img->points_left >= x2 + foe_img->zones_right
+      || x1 + ship_img->points_right <= x2 + foe_img->zones_left
+      || y1 + ship_img->points_top >= y2 + foe_img->zones_bottom
+      || y1 + ship_img->points_bottom <= y2 + foe_img->zones_top)
+    {
+      return FALSE;
+    }
+
   /* for each collision point of the spaceship */
   for (i = 0; i < ship_img->numof_collisions_points; i++)
     {
@@ -769,7 +783,7 @@ spaceship_shot_collision (Sint32 x1, Sint32 y1, shot_struct * bullet)
             }
           /* decrease energy level of spaceship */
           ship->spr.energy_level =
-            (Sint16) (ship->spr.energy_level - bullet->spr.pow_of_dest);
+            (Sint16) (ship->spr.energy_level - bullet->pow_of_dest);
         }
       /* update spaceship's energy gauge */
       energy_gauge_spaceship_is_update = TRUE;
@@ -783,8 +797,8 @@ spaceship_shot_collision (Sint32 x1, Sint32 y1, shot_struct * bullet)
           /* spaceship not destroyed, display white mask */
           ship->is_white_mask_displayed = TRUE;
         }
-      explosion_add (bullet->spr.xcoord, bullet->spr.ycoord, 0.35f,
-                     EXPLOSION_SMALL, 0);
+      explosion_add (shots_xcoord[bullet->index],
+                     shots_ycoord[bullet->index], 0.35f, EXPLOSION_SMALL, 0);
       /* remove the shot which has just touched the enemy */
       return TRUE;
     }
@@ -80,8 +80,8 @@ spacheship_basic_shot (void)
   /* set time delay before spaceship can again shot */
   ship->fire_rate = 50 - (ship->type * 5 + 5);
   ship->fire_rate_enhanced = ship->fire_rate >> 1;
-#ifdef USE_SDLMIXER
-  sound_play (SOUND_SPACESHIP_FIRE);
+#ifdef USE_SOUND
+  sound_play_at (SOUND_SPACESHIP_FIRE, (Sint32) ship->spr.xcoord);
 #endif
   /* check the current spaceship used */
   switch (ship->type)
@@ -0,0 +1,719 @@
+/**
+ * @file sprite_pack.c
+ * @brief Sprite packs: the "*.spr" files already converted for the
+ *        pixel format of the display, mapped in memory and used in place
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "config_file.h"
+#include "display.h"
+#include "log_recorder.h"
+#include "sprite_pack.h"
+#include <string.h>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/** Packs opened since the start, they stay mapped until the end
+ * because the images point into them */
+static sprite_pack *sprite_packs = NULL;
+/** Number of sprite files read from their pack */
+static Uint32 sprite_packs_opened = 0;
+/** Number of sprite files converted, then packed */
+static Uint32 sprite_packs_built = 0;
+#ifdef HAVE_PTHREAD_H
+/** Protect the list of packs and the counters, the sprite files are
+ * loaded by several threads and in advance by prefetch.c */
+static pthread_mutex_t sprite_packs_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**
+ * Check if the sprite packs can be used. The sprites exported to PNG
+ * are not modified after their loading, they are not packed
+ * @return TRUE if the sprite packs are used
+ */
+bool
+sprite_pack_enabled (void)
+{
+#if defined(_WIN32_WCE)
+  return FALSE;
+#else
+  return power_conf->sprite_packs && !power_conf->extract_to_png
+    && configfile_get_dir () != NULL;
+#endif
+}
+
+/**
+ * Round up an offset to the alignment of the data of the packs
+ * @param offset An offset in bytes
+ * @return The offset aligned
+ */
+static Uint32
+sprite_pack_align (Uint32 offset)
+{
+  return (offset + SPRITE_PACK_ALIGN - 1) & ~(SPRITE_PACK_ALIGN - 1);
+}
+
+/**
+ * Calculate the key of the pixel format of the display: a hash
+ * (FNV-1a) of the colors of the palette converted by read_pixels()
+ * @return The hash, 0 for 8-bit pixels which are never converted
+ */
+static Uint32
+sprite_pack_format (void)
+{
+  Uint32 i, size;
+  Uint32 hash = 2166136261U;
+  unsigned char *colors;
+  switch (bytes_per_pixel)
+    {
+    case 2:
+      colors = (unsigned char *) pal16;
+      size = 256 * sizeof (Uint16);
+      break;
+    case 3:
+    case 4:
+      colors = (unsigned char *) pal32;
+      size = 256 * sizeof (Uint32);
+      break;
+    default:
+      return 0;
+    }
+  for (i = 0; i < size; i++)
+    {
+      hash = (hash ^ colors[i]) * 16777619U;
+    }
+  return hash;
+}
+
+/**
+ * Get the size and the modification time of a "*.spr" file
+ * @param filename Name of the file relative to the data directory
+ * @param size Pointer which receives the size in bytes
+ * @param mtime Pointer which receives the modification time
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+static bool
+sprite_pack_source (const char *filename, Uint64 * size, Uint64 * mtime)
+{
+#if defined(_WIN32_WCE)
+  return FALSE;
+#else
+#ifdef WIN32
+  struct _stat s;
+#else
+  struct stat s;
+#endif
+  Sint32 result;
+  char *pathname = locate_data_file (filename);
+  if (pathname == NULL)
+    {
+      return FALSE;
+    }
+#ifdef WIN32
+  result = _stat (pathname, &s);
+#else
+  result = stat (pathname, &s);
+#endif
+  free_memory (pathname);
+  if (result != 0)
+    {
+      return FALSE;
+    }
+  *size = (Uint64) s.st_size;
+  *mtime = (Uint64) s.st_mtime;
+  return TRUE;
+#endif
+}
+
+/**
+ * Build the name of the pack of a "*.spr" file, located in the
+ * configuration directory. The slashes are replaced by underscores,
+ * the depth and the key of the pixel format are appended, then the
+ * packs of several displays are kept: "graphics/sprite.spr" =>
+ * "~/.config/tlk-games/sprite-packs/graphics_sprite-2-8e3a0f1c.spk"
+ * @param filename Name of the "*.spr" file relative to the data directory
+ * @param format Key of the pixel format
+ * @return Pointer to a malloc'd buffer containing the pathname
+ */
+static char *
+sprite_pack_pathname (const char *filename, Uint32 format)
+{
+  Uint32 i, j, length;
+  char *pathname;
+  const char *dir = configfile_get_dir ();
+  length =
+    strlen (dir) + 1 + strlen (SPRITE_PACK_DIR) + 1 + strlen (filename) +
+    16;
+  pathname = memory_allocation (length);
+  if (pathname == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes", length);
+      return NULL;
+    }
+  sprintf (pathname, "%s/%s/", dir, SPRITE_PACK_DIR);
+  j = strlen (pathname);
+  for (i = 0; filename[i] != 0; i++, j++)
+    {
+      pathname[j] = filename[i] == '/' ? '_' : filename[i];
+    }
+  pathname[j] = 0;
+  length = strlen (filename);
+  if (length > 4 && !strcmp (filename + length - 4, ".spr"))
+    {
+      j -= 4;
+    }
+  sprintf (pathname + j, "-%i-%08x.spk", bytes_per_pixel, format);
+  return pathname;
+}
+
+/**
+ * Map a pack file in memory, or load it where mmap() is missing
+ * @param pathname Pathname of the pack file
+ * @param size Pointer which receives the size of the file in bytes
+ * @param mapped Pointer which receives TRUE if the file is mapped
+ * @return Pointer to the file data, or NULL if the pack doesn't exist
+ */
+static char *
+sprite_pack_map (const char *pathname, Uint32 * size, bool * mapped)
+{
+#if defined(_WIN32_WCE)
+  return NULL;
+#elif defined(_WIN32)
+  struct _stat s;
+  if (_stat (pathname, &s) != 0)
+    {
+      return NULL;
+    }
+  *mapped = FALSE;
+  return load_absolute_file (pathname, size);
+#else
+  struct stat s;
+  void *addr;
+  Sint32 fd = open (pathname, O_RDONLY);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+  if (fstat (fd, &s) != 0 || s.st_size < (off_t) sizeof (sprite_pack_header))
+    {
+      close (fd);
+      return NULL;
+    }
+  addr = mmap (NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (addr == MAP_FAILED)
+    {
+      LOG_ERR ("mmap(%s) failed: %s", pathname, strerror (errno));
+      return NULL;
+    }
+  *size = (Uint32) s.st_size;
+  *mapped = TRUE;
+  return (char *) addr;
+#endif
+}
+
+/**
+ * Release a pack file mapped or loaded by sprite_pack_map()
+ * @param addr Pointer to the file data
+ * @param size Size of the file in bytes
+ * @param mapped TRUE if the file is mapped
+ */
+static void
+sprite_pack_unmap (char *addr, Uint32 size, bool mapped)
+{
+#if !defined(_WIN32)
+  if (mapped)
+    {
+      munmap (addr, size);
+      return;
+    }
+#endif
+  free_memory (addr);
+}
+
+/**
+ * Check that a pack was built by this version of the game on the same
+ * kind of machine for the same pixel format, from the current "*.spr"
+ * file, and is complete.
+ * The records are not checked, a pack is only written by the game
+ * @param header The header of the pack
+ * @param size Size of the pack file in bytes
+ * @param kind SPRITE_PACK_IMAGES or SPRITE_PACK_BITMAPS
+ * @param record_size Expected size of a record in bytes
+ * @param format Key of the pixel format of the display
+ * @param source_size Size of the "*.spr" file
+ * @param source_mtime Modification time of the "*.spr" file
+ * @return TRUE if the pack can be used
+ */
+static bool
+sprite_pack_check (sprite_pack_header * header, Uint32 size, Uint32 kind,
+                   Uint32 record_size, Uint32 format, Uint64 source_size,
+                   Uint64 source_mtime)
+{
+  return !memcmp (header->magic, "PMSP", 4)
+    && header->version == SPRITE_PACK_VERSION
+    && header->byte_order == SPRITE_PACK_BYTE_ORDER
+    && header->kind == kind
+    && header->bytes_per_pixel == bytes_per_pixel
+    && header->format == format
+    && header->record_size == record_size
+    && header->size == size
+    && header->source_size == source_size
+    && header->source_mtime == source_mtime
+    && header->records_offset >= sizeof (sprite_pack_header)
+    && (Uint64) header->records_offset +
+    (Uint64) header->numof_records * record_size <= header->data_offset
+    && header->data_offset <= size;
+}
+
+/**
+ * Find or map the pack of a "*.spr" file, the list of packs must be
+ * locked
+ * @param filename Name of the "*.spr" file relative to the data directory
+ * @param kind SPRITE_PACK_IMAGES or SPRITE_PACK_BITMAPS
+ * @param record_size Size of a record in bytes
+ * @return Pointer to the pack, or NULL if there is no pack up to date
+ */
+static sprite_pack *
+sprite_pack_find (const char *filename, Uint32 kind, Uint32 record_size)
+{
+  Uint64 source_size, source_mtime;
+  Uint32 size, format;
+  bool mapped;
+  char *addr, *pathname;
+  sprite_pack_header *header;
+  sprite_pack *pack;
+
+  /* already opened, the meteors are loaded again at each level */
+  for (pack = sprite_packs; pack != NULL; pack = pack->next)
+    {
+      if (!strcmp (pack->filename, filename))
+        {
+          header = (sprite_pack_header *) pack->addr;
+          if (header->kind != kind || header->record_size != record_size)
+            {
+              return NULL;
+            }
+          sprite_packs_opened++;
+          return pack;
+        }
+    }
+
+  if (!sprite_pack_source (filename, &source_size, &source_mtime))
+    {
+      return NULL;
+    }
+  format = sprite_pack_format ();
+  pathname = sprite_pack_pathname (filename, format);
+  if (pathname == NULL)
+    {
+      return NULL;
+    }
+  addr = sprite_pack_map (pathname, &size, &mapped);
+  free_memory (pathname);
+  if (addr == NULL)
+    {
+      return NULL;
+    }
+  header = (sprite_pack_header *) addr;
+  if (!sprite_pack_check
+      (header, size, kind, record_size, format, source_size, source_mtime))
+    {
+      LOG_INF ("the sprite pack of %s is out of date", filename);
+      sprite_pack_unmap (addr, size, mapped);
+      return NULL;
+    }
+
+  pack = (sprite_pack *) memory_allocation (sizeof (sprite_pack));
+  if (pack == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes",
+               (Uint32) sizeof (sprite_pack));
+      sprite_pack_unmap (addr, size, mapped);
+      return NULL;
+    }
+  pack->filename = string_duplicate (filename);
+  if (pack->filename == NULL)
+    {
+      free_memory ((char *) pack);
+      sprite_pack_unmap (addr, size, mapped);
+      return NULL;
+    }
+  pack->addr = addr;
+  pack->size = size;
+  pack->mapped = mapped;
+  pack->records = addr + header->records_offset;
+  pack->numof_records = header->numof_records;
+  pack->data = addr + header->data_offset;
+  pack->next = sprite_packs;
+  sprite_packs = pack;
+  sprite_packs_opened++;
+  LOG_DBG ("the sprite pack of %s was opened", filename);
+  return pack;
+}
+
+/**
+ * Open the pack of a "*.spr" file
+ * @param filename Name of the "*.spr" file relative to the data directory
+ * @param kind SPRITE_PACK_IMAGES or SPRITE_PACK_BITMAPS
+ * @param record_size Size of a record in bytes
+ * @return Pointer to the pack, or NULL if there is no pack up to date,
+ *         then the "*.spr" file must be read
+ */
+sprite_pack *
+sprite_pack_open (const char *filename, Uint32 kind, Uint32 record_size)
+{
+  sprite_pack *pack;
+  if (!sprite_pack_enabled ())
+    {
+      return NULL;
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&sprite_packs_mutex);
+#endif
+  pack = sprite_pack_find (filename, kind, record_size);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&sprite_packs_mutex);
+#endif
+  return pack;
+}
+
+/**
+ * Check if a pixels buffer or a compress table points into a pack,
+ * it must not be released
+ * @param addr Pointer to the pixels or the compress table
+ * @return TRUE if the pointer is located in a pack
+ */
+bool
+sprite_pack_contains (const char *addr)
+{
+  bool result = FALSE;
+  sprite_pack *pack;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&sprite_packs_mutex);
+#endif
+  for (pack = sprite_packs; pack != NULL; pack = pack->next)
+    {
+      if (addr >= pack->addr && addr < pack->addr + pack->size)
+        {
+          result = TRUE;
+          break;
+        }
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&sprite_packs_mutex);
+#endif
+  return result;
+}
+
+/**
+ * Release all the packs, once the images are released
+ */
+void
+sprite_packs_free (void)
+{
+  sprite_pack *pack;
+  while (sprite_packs != NULL)
+    {
+      pack = sprite_packs;
+      sprite_packs = pack->next;
+      sprite_pack_unmap (pack->addr, pack->size, pack->mapped);
+      free_memory (pack->filename);
+      free_memory ((char *) pack);
+    }
+}
+
+/**
+ * Give the number of sprite files read from their pack and the number
+ * of sprite files converted then packed, since the start
+ * @param opened Pointer which receives the number of packs read
+ * @param built Pointer which receives the number of packs built
+ */
+void
+sprite_packs_counters (Uint32 * opened, Uint32 * built)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&sprite_packs_mutex);
+#endif
+  *opened = sprite_packs_opened;
+  *built = sprite_packs_built;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&sprite_packs_mutex);
+#endif
+}
+
+/**
+ * Start to build the pack of a "*.spr" file which is read
+ * @param filename Name of the "*.spr" file relative to the data directory
+ * @param kind SPRITE_PACK_IMAGES or SPRITE_PACK_BITMAPS
+ * @param record_size Size of a record in bytes
+ * @return Pointer to the builder, or NULL if the packs are not used
+ */
+sprite_pack_builder *
+sprite_pack_builder_new (const char *filename, Uint32 kind,
+                         Uint32 record_size)
+{
+  sprite_pack_builder *builder;
+  if (!sprite_pack_enabled ())
+    {
+      return NULL;
+    }
+  builder =
+    (sprite_pack_builder *) memory_allocation (sizeof (sprite_pack_builder));
+  if (builder == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes",
+               (Uint32) sizeof (sprite_pack_builder));
+      return NULL;
+    }
+  if (!sprite_pack_source
+      (filename, &builder->header.source_size,
+       &builder->header.source_mtime))
+    {
+      free_memory ((char *) builder);
+      return NULL;
+    }
+  builder->filename = string_duplicate (filename);
+  if (builder->filename == NULL)
+    {
+      free_memory ((char *) builder);
+      return NULL;
+    }
+  memcpy (builder->header.magic, "PMSP", 4);
+  builder->header.version = SPRITE_PACK_VERSION;
+  builder->header.byte_order = SPRITE_PACK_BYTE_ORDER;
+  builder->header.kind = kind;
+  builder->header.bytes_per_pixel = bytes_per_pixel;
+  builder->header.format = sprite_pack_format ();
+  builder->header.record_size = record_size;
+  return builder;
+}
+
+/**
+ * Append data to a buffer of a builder, the buffer grows as needed
+ * @param buffer Pointer to the buffer
+ * @param size Pointer to the size of the buffer in bytes
+ * @param used Pointer to the number of bytes used in the buffer
+ * @param data The data to append
+ * @param datasize Size of the data in bytes
+ * @param align Alignment of the data in bytes, a power of two
+ * @return Offset of the data in the buffer, or -1 if an error occurred
+ */
+static Sint32
+sprite_pack_append (char **buffer, Uint32 * size, Uint32 * used,
+                    const char *data, Uint32 datasize, Uint32 align)
+{
+  Uint32 offset, newsize;
+  char *newbuffer;
+  offset = (*used + align - 1) & ~(align - 1);
+  if (offset + datasize > *size)
+    {
+      newsize = *size * 2;
+      if (newsize < offset + datasize)
+        {
+          newsize = offset + datasize;
+        }
+      if (newsize < 65536)
+        {
+          newsize = 65536;
+        }
+      newbuffer = memory_allocation (newsize);
+      if (newbuffer == NULL)
+        {
+          LOG_ERR ("not enough memory to allocate %i bytes", newsize);
+          return -1;
+        }
+      if (*buffer != NULL)
+        {
+          memcpy (newbuffer, *buffer, *used);
+          free_memory (*buffer);
+        }
+      *buffer = newbuffer;
+      *size = newsize;
+    }
+  if (datasize > 0)
+    {
+      memcpy (*buffer + offset, data, datasize);
+    }
+  *used = offset + datasize;
+  return (Sint32) offset;
+}
+
+/**
+ * Add the pixels or the compress table of a record to a pack
+ * @param builder The pack being built
+ * @param data The pixels or the compress table
+ * @param size Size of the data in bytes
+ * @param offset Pointer field of the record which receives the offset
+ *               of the data in the pack
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+sprite_pack_add_data (sprite_pack_builder * builder, const char *data,
+                      Uint32 size, char **offset)
+{
+  Sint32 result =
+    sprite_pack_append (&builder->data, &builder->data_size,
+                        &builder->data_used, data, size, SPRITE_PACK_ALIGN);
+  if (result < 0)
+    {
+      return FALSE;
+    }
+  *offset = (char *) (size_t) result;
+  return TRUE;
+}
+
+/**
+ * Add a record to a pack, once its pointers hold offsets
+ * @param builder The pack being built
+ * @param record An 'image' or 'bitmap' structure
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+sprite_pack_add_record (sprite_pack_builder * builder, const void *record)
+{
+  if (sprite_pack_append
+      (&builder->records, &builder->records_size, &builder->records_used,
+       (const char *) record, builder->header.record_size, 1) < 0)
+    {
+      return FALSE;
+    }
+  builder->header.numof_records++;
+  return TRUE;
+}
+
+/**
+ * Write a pack into the configuration directory. It is written under
+ * a temporary name then renamed, another instance of the game never
+ * maps a partial pack
+ * @param builder The pack being built
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+sprite_pack_builder_write (sprite_pack_builder * builder)
+{
+  Uint32 length;
+  bool result;
+  char *buffer, *pathname, *tmpname;
+  sprite_pack_header *header = &builder->header;
+  header->records_offset = sprite_pack_align (sizeof (sprite_pack_header));
+  header->data_offset =
+    sprite_pack_align (header->records_offset + builder->records_used);
+  /* padding after the data: the pointers of the empty compress tables
+   * remain inside the pack */
+  header->size =
+    header->data_offset + sprite_pack_align (builder->data_used + 1);
+  buffer = memory_allocation (header->size);
+  if (buffer == NULL)
+    {
+      LOG_ERR ("not enough memory to allocate %i bytes", header->size);
+      return FALSE;
+    }
+  memcpy (buffer, header, sizeof (sprite_pack_header));
+  if (builder->records_used > 0)
+    {
+      memcpy (buffer + header->records_offset, builder->records,
+              builder->records_used);
+    }
+  if (builder->data_used > 0)
+    {
+      memcpy (buffer + header->data_offset, builder->data,
+              builder->data_used);
+    }
+
+  pathname = sprite_pack_pathname (builder->filename, header->format);
+  if (pathname == NULL)
+    {
+      free_memory (buffer);
+      return FALSE;
+    }
+  /* create the directory of the packs */
+  *strrchr (pathname, '/') = 0;
+  result = create_dir (pathname);
+  pathname[strlen (pathname)] = '/';
+  length = strlen (pathname) + 5;
+  tmpname = memory_allocation (length);
+  if (!result || tmpname == NULL)
+    {
+      free_memory (buffer);
+      free_memory (pathname);
+      if (tmpname != NULL)
+        {
+          free_memory (tmpname);
+        }
+      return FALSE;
+    }
+  sprintf (tmpname, "%s.tmp", pathname);
+  result = file_write (tmpname, buffer, header->size);
+  free_memory (buffer);
+  if (result)
+    {
+#ifdef WIN32
+      remove (pathname);
+#endif
+      if (rename (tmpname, pathname) != 0)
+        {
+          LOG_ERR ("rename(%s) failed", tmpname);
+          remove (tmpname);
+          result = FALSE;
+        }
+      else
+        {
+#ifdef HAVE_PTHREAD_H
+          pthread_mutex_lock (&sprite_packs_mutex);
+#endif
+          sprite_packs_built++;
+#ifdef HAVE_PTHREAD_H
+          pthread_mutex_unlock (&sprite_packs_mutex);
+#endif
+          LOG_INF ("sprite pack %s was written", pathname);
+        }
+    }
+  free_memory (tmpname);
+  free_memory (pathname);
+  return result;
+}
+
+/**
+ * Release a pack being built
+ * @param builder The pack being built
+ */
+void
+sprite_pack_builder_free (sprite_pack_builder * builder)
+{
+  if (builder->records != NULL)
+    {
+      free_memory (builder->records);
+    }
+  if (builder->data != NULL)
+    {
+      free_memory (builder->data);
+    }
+  free_memory (builder->filename);
+  free_memory ((char *) builder);
+}
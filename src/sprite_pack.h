@@ -0,0 +1,148 @@
+/**
+ * @file sprite_pack.h
+ * @brief Sprite packs: the "*.spr" files already converted for the
+ *        pixel format of the display, mapped in memory and used in place
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __SPRITE_PACK__
+#define __SPRITE_PACK__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Incremented each time the layout of the packs changes */
+#define SPRITE_PACK_VERSION 2
+/** Written in the byte order of the machine which built the pack */
+#define SPRITE_PACK_BYTE_ORDER 0x01020304
+/** Alignment of the records and of the data blocks in bytes */
+#define SPRITE_PACK_ALIGN 16
+/** Subdirectory of the configuration directory holding the packs */
+#define SPRITE_PACK_DIR "sprite-packs"
+
+  /** Type of the records of a pack */
+  typedef enum
+  {
+    /** 'image' structures */
+    SPRITE_PACK_IMAGES,
+    /** 'bitmap' structures */
+    SPRITE_PACK_BITMAPS
+  }
+  SPRITE_PACK_KIND;
+
+  /** Beginning of a pack file, followed by the records, then by the
+   * pixels and the compress tables */
+  typedef struct sprite_pack_header
+  {
+    /** "PMSP" */
+    char magic[4];
+    /** SPRITE_PACK_VERSION */
+    Uint32 version;
+    /** SPRITE_PACK_BYTE_ORDER */
+    Uint32 byte_order;
+    /** SPRITE_PACK_IMAGES or SPRITE_PACK_BITMAPS */
+    Uint32 kind;
+    /** Depth of the converted pixels, 1 to 4 bytes */
+    Uint32 bytes_per_pixel;
+    /** Hash of the colors of the palette converted to the pixel
+     * format of the display, 0 for 8-bit pixels */
+    Uint32 format;
+    /** Size of a record in bytes, sizeof (image) or sizeof (bitmap) */
+    Uint32 record_size;
+    /** Number of records */
+    Uint32 numof_records;
+    /** Offset of the first record */
+    Uint32 records_offset;
+    /** Offset of the pixels and compress tables, the pointers of the
+     * records hold offsets relative to it */
+    Uint32 data_offset;
+    /** Size of the pack file in bytes */
+    Uint32 size;
+    /** Size and modification time of the "*.spr" file, the pack is
+     * rebuilt when they change */
+    Uint64 source_size;
+    Uint64 source_mtime;
+  }
+  sprite_pack_header;
+
+  /** A pack mapped in memory */
+  typedef struct sprite_pack
+  {
+    /** Name of the "*.spr" file */
+    char *filename;
+    /** Whole pack file */
+    char *addr;
+    /** Size of the pack file in bytes */
+    Uint32 size;
+    /** TRUE if mapped with mmap(), FALSE if read into memory */
+    bool mapped;
+    /** First record */
+    char *records;
+    /** Number of records */
+    Uint32 numof_records;
+    /** Base of the offsets held by the records */
+    char *data;
+    /** Next opened pack */
+    struct sprite_pack *next;
+  }
+  sprite_pack;
+
+  /** A pack being built while a "*.spr" file is read */
+  typedef struct sprite_pack_builder
+  {
+    /** Header written at the beginning of the pack */
+    sprite_pack_header header;
+    /** Name of the "*.spr" file */
+    char *filename;
+    /** Records added so far */
+    char *records;
+    Uint32 records_size;
+    Uint32 records_used;
+    /** Pixels and compress tables added so far */
+    char *data;
+    Uint32 data_size;
+    Uint32 data_used;
+  }
+  sprite_pack_builder;
+
+  bool sprite_pack_enabled (void);
+  sprite_pack *sprite_pack_open (const char *filename, Uint32 kind,
+                                 Uint32 record_size);
+  bool sprite_pack_contains (const char *addr);
+  void sprite_packs_free (void);
+  void sprite_packs_counters (Uint32 * opened, Uint32 * built);
+  sprite_pack_builder *sprite_pack_builder_new (const char *filename,
+                                                Uint32 kind,
+                                                Uint32 record_size);
+  bool sprite_pack_add_data (sprite_pack_builder * builder,
+                             const char *data, Uint32 size, char **offset);
+  bool sprite_pack_add_record (sprite_pack_builder * builder,
+                               const void *record);
+  bool sprite_pack_builder_write (sprite_pack_builder * builder);
+  void sprite_pack_builder_free (sprite_pack_builder * builder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
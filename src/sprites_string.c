@@ -1101,7 +1101,8 @@ sprite_string_draw (sprite_string_struct * sprite_str)
         {
         case FONT_DRAW_TOP_PANEL:
           draw_bitmap_in_score (img, sprite_char->coord_x,
-                                sprite_char->coord_y);
+                                sprite_char->coord_y, sprite_char->font_size,
+                                sprite_char->font_size);
           break;
         default:
           draw_bitmap (img, sprite_char->coord_x, sprite_char->coord_y);
@@ -1496,6 +1497,28 @@ sprites_string_key_up (Uint32 code, Uint32 sym)
     }
 }
 
+/**
+ * Return the code of the key currently down
+ * @param code Pointer to the code, 0 if no key is down
+ * @param sym Pointer to the symbol
+ */
+void
+sprites_string_get_key (Uint32 * code, Uint32 * sym)
+{
+  *code = keycode_down;
+  *sym = keysym_down;
+}
+
+/**
+ * Return the code of the joystick button currently down
+ * @return A joystick code, 0 if no button is down
+ */
+Uint32
+sprites_string_get_joy (void)
+{
+  return joy_code_down;
+}
+
 /**
  * Set the cursor position 
  * @param sprite_str Pointer to a sprites string structure
@@ -201,6 +201,8 @@ extern "C"
   void sprites_string_clr_joy (Uint32 code);
   void sprites_string_key_down (Uint32 code, Uint32 sym);
   void sprites_string_key_up (Uint32 code, Uint32 sym);
+  void sprites_string_get_key (Uint32 * code, Uint32 * sym);
+  Uint32 sprites_string_get_joy (void);
   void sprites_string_set_cursor_pos (sprite_string_struct * sprite_str,
                                       Sint32 cursor_pos);
 
@@ -28,6 +28,8 @@
 #include "config.h"
 #include "powermanga.h"
 #include "tools.h"
+#include "arena.h"
+#include "game_rand.h"
 #include "images.h"
 #include "display.h"
 #include "electrical_shock.h"
@@ -83,8 +85,8 @@ starfield_once_init (void)
   if (stars == NULL)
     {
       stars =
-        (star_structure *) memory_allocation (NUMOF_STARS *
-                                              sizeof (star_structure));
+        (star_structure *) arena_alloc (ARENA_PROCESS, NUMOF_STARS *
+                                        sizeof (star_structure));
       if (stars == NULL)
         {
           LOG_ERR ("'stars' out of memory");
@@ -206,14 +208,14 @@ starfield_init (void)
   for (i = 0; i < NUMOF_STARS_BY_TYPE; i++)
     {
       stars[i + 48].coor_x =
-        (float) (rand () % offscreen_width_visible + offscreen_clipsize);
-      stars[i + 48].coor_y = (float) (rand () % 10 + i * 15);
+        (float) (game_rand () % offscreen_width_visible + offscreen_clipsize);
+      stars[i + 48].coor_y = (float) (game_rand () % 10 + i * 15);
       stars[i + 48].speed =
-        (float) ((float) (rand () % 8 / (float) 100.0 + 0.8));
+        (float) ((float) (game_rand () % 8 / (float) 100.0 + 0.8));
       stars[i + 48].img = (image *) & star_field[STAR_BIG][j];
       stars[i + 48].type = STAR_BIG;
       stars[i + 48].next_image_pause = 16;
-      stars[i + 48].next_image_pause_cnt = (rand () * 8) / RAND_MAX;
+      stars[i + 48].next_image_pause_cnt = game_rand () % 8;
       j++;
       if (j == STAR_NUMOF_IMAGES)
         {
@@ -226,14 +228,14 @@ starfield_init (void)
   for (i = 0; i < NUMOF_STARS_BY_TYPE; i++)
     {
       stars[i + 24].coor_x =
-        (float) (rand () % offscreen_width_visible + offscreen_clipsize);
-      stars[i + 24].coor_y = (float) (rand () % 10 + i * 15);
+        (float) (game_rand () % offscreen_width_visible + offscreen_clipsize);
+      stars[i + 24].coor_y = (float) (game_rand () % 10 + i * 15);
       stars[i + 24].speed =
-        (float) ((float) (rand () % 4 / (float) 100.0 + 0.4));
+        (float) ((float) (game_rand () % 4 / (float) 100.0 + 0.4));
       stars[i + 24].img = (image *) & star_field[STAR_MIDDLE][j];
       stars[i + 24].type = STAR_MIDDLE;
       stars[i + 24].next_image_pause = 16;
-      stars[i + 24].next_image_pause_cnt = (rand () * 8) / RAND_MAX;
+      stars[i + 24].next_image_pause_cnt = game_rand () % 8;
       j++;
       if (j == STAR_NUMOF_IMAGES)
         {
@@ -245,13 +247,14 @@ starfield_init (void)
   for (i = 0; i < NUMOF_STARS_BY_TYPE; i++)
     {
       stars[i].coor_x =
-        (float) (rand () % offscreen_width_visible + offscreen_clipsize);
-      stars[i].coor_y = (float) (rand () % 10 + i * 15);
-      stars[i].speed = (float) ((float) (rand () % 2 / (float) 100.0 + 0.2));
+        (float) (game_rand () % offscreen_width_visible + offscreen_clipsize);
+      stars[i].coor_y = (float) (game_rand () % 10 + i * 15);
+      stars[i].speed =
+        (float) ((float) (game_rand () % 2 / (float) 100.0 + 0.2));
       stars[i].img = (image *) & star_field[STAR_LITTLE][j];
       stars[i].type = STAR_LITTLE;
       stars[i].next_image_pause = 8;
-      stars[i].next_image_pause_cnt = (rand () * 8) / RAND_MAX;
+      stars[i].next_image_pause_cnt = game_rand () % 8;
       j++;
       if (j == STAR_NUMOF_IMAGES)
         {
@@ -268,11 +271,7 @@ starfield_free (void)
 {
   images_free (&star_field[0][0], TYPE_OF_STARS, STAR_NUMOF_IMAGES,
                STAR_NUMOF_IMAGES);
-  if (stars != NULL)
-    {
-      free_memory ((char *) stars);
-      stars = NULL;
-    }
+  stars = NULL;
 }
 
 /** 
@@ -297,7 +296,7 @@ starfield_handle (void)
           if ((star->coor_y) >= offscreen_height - offscreen_clipsize)
             {
               star->coor_x =
-                (float) (rand () % offscreen_width_visible +
+                (float) (game_rand () % offscreen_width_visible +
                          offscreen_clipsize);
               star->coor_y = (float) (offscreen_clipsize - star->img->h);
 
@@ -306,7 +305,7 @@ starfield_handle (void)
           if (!(star->next_image_pause_cnt &= (star->next_image_pause - 1)))
             {
               star->img =
-                (image *) & star_field[star->type][rand () %
+                (image *) & star_field[star->type][game_rand () %
                                                    STAR_NUMOF_IMAGES];
             }
           draw_sprite (star->img, (Sint32) star->coor_x,
@@ -322,7 +321,7 @@ starfield_handle (void)
           if ((star->coor_y + star->img->h) <= offscreen_clipsize)
             {
               star->coor_x =
-                (float) (rand () % offscreen_width_visible +
+                (float) (game_rand () % offscreen_width_visible +
                          offscreen_clipsize);
               star->coor_y = (float) (offscreen_height - offscreen_clipsize);
             }
@@ -330,7 +329,7 @@ starfield_handle (void)
           if (!(star->next_image_pause_cnt &= (star->next_image_pause - 1)))
             {
               star->img =
-                (image *) & star_field[star->type][rand () %
+                (image *) & star_field[star->type][game_rand () %
                                                    STAR_NUMOF_IMAGES];
             }
           draw_sprite (star->img, (Sint32) star->coor_x,
@@ -765,6 +765,10 @@ draw_text (Sint32 xcoord, Sint32 ycoord, const char *string)
 {
   Uint32 offset;
   unsigned char *source, *screen, *dest, c;
+  if (!offscreen_draw_enable)
+    {
+      return;
+    }
   screen = (unsigned char *)
     (game_offscreen +
      ((offscreen_starty + ycoord) * offscreen_width +
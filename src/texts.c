@@ -49,8 +49,6 @@ Sint32 player_score;
 static Sint32 old_player_score;
 /** Level number: from 0 to 41 */
 Sint32 num_level = -1;
-/** If TRUE refresh player's score points */
-bool is_player_score_displayed = FALSE;
 
 static bool texts_load (void);
 
@@ -277,8 +275,6 @@ text_draw_score (void)
   if (text_score->at_least_one_char_changed || is_updated)
     {
       sprite_string_draw (text_score);
-      /* refresh player's score into the top panel */
-      is_player_score_displayed = TRUE;
     }
 }
 
@@ -43,8 +43,6 @@ extern "C"
   void texts_init (void);
   bool text_level_move (Sint32 level_nu);
 
-  extern bool is_player_score_displayed;
-
 #ifdef __cplusplus
 }
 #endif
@@ -27,8 +27,14 @@
 #include "powermanga.h"
 #include "log_recorder.h"
 #include "tools.h"
+#include "arena.h"
 #include "config_file.h"
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
 
 #if defined (USE_MALLOC_WRAPPER)
 /**
@@ -42,8 +48,18 @@ typedef struct
   Sint32 size;
 }
 mem_struct;
+/**
+ * Header placed before each memory zone, it gives its index in the
+ * memory table so that a zone is released without searching it
+ */
+typedef union
+{
+  Uint32 index;
+  /** Keep the alignment of malloc() for the zone which follows */
+  double align[2];
+}
+mem_header;
 mem_struct *memory_list_base = NULL;
-mem_struct *memory_list = NULL;
 /** Size of memory table */
 static Uint32 memory_list_size;
 /** Maximum number of memory zones being able to be allocated */
@@ -54,14 +70,17 @@ Uint32 mem_numof_zones;
 Uint32 mem_total_size;
 /** Maximum number of memory zones reached */
 static Uint32 mem_maxreached_zones;
+/** Maximum of memory size allocated in bytes */
+Uint32 mem_maxreached_size;
 #endif
 Uint32 loops_counter;
+/** Number of frames displayed, lower than loops_counter when the
+ * frames late are simulated without being displayed */
+Uint32 frames_displayed;
 #ifdef POWERMANGA_SDL
 static Uint32 time_begin;
-static Uint32 ticks_previous;
 #else
 static struct timeval time_begin;
-static struct timeval ticks_previous;
 #endif
 static Uint16 little_endian_to_ushort (Uint16 * _pMem);
 /** Prefixe where the data files are localised */
@@ -96,6 +115,7 @@ memory_init (Uint32 numofzones)
   /* maximum number of memory zones being able to be allocated */
   mem_maxnumof_zones = numofzones;
   mem_maxreached_zones = 0;
+  mem_maxreached_size = 0;
   memory_list_size = mem_maxnumof_zones * sizeof (mem_struct);
   mem_total_size = memory_list_size;
   memory_list_base = (mem_struct *) malloc (memory_list_size);
@@ -104,7 +124,6 @@ memory_init (Uint32 numofzones)
       LOG_ERR ("malloc() failed");
       return FALSE;
     }
-  memory_list = memory_list_base;
 
   /* clear memory table */
   memlst = memory_list_base;
@@ -120,13 +139,14 @@ memory_init (Uint32 numofzones)
 /**
  * Allocate memory, malloc() wrapper
  * @param memsize Size in bytes to alloc
- * @return Pointer to the allocated memory or NULL if an error occurred
+ * @return Pointer to the zeroed memory or NULL if an error occurred
  */
 char *
 memory_allocation (Uint32 memsize)
 {
   char *addr = NULL;
 #if defined (USE_MALLOC_WRAPPER)
+  mem_struct *memlist;
   if (mem_numof_zones >= mem_maxnumof_zones)
     {
       LOG_ERR (" table overflow; size request %i bytes;"
@@ -134,30 +154,38 @@ memory_allocation (Uint32 memsize)
                memsize, mem_total_size, mem_numof_zones);
       return NULL;
     }
+  addr = (char *) calloc (1, sizeof (mem_header) + memsize);
+#else
+  /* calloc() skips clearing the pages which come zeroed from the system */
+  addr = (char *) calloc (1, memsize);
 #endif
-  addr = (char *) malloc (memsize);
   if (addr == NULL)
     {
 #if defined (USE_MALLOC_WRAPPER)
-      LOG_ERR ("malloc() return NULL; size request %i bytes;"
+      LOG_ERR ("calloc() return NULL; size request %i bytes;"
                " total allocate: %i in %i zones",
                memsize, mem_total_size, mem_numof_zones);
 #else
-      LOG_ERR ("malloc() return NULL; size request %i bytes", memsize);
+      LOG_ERR ("calloc() return NULL; size request %i bytes", memsize);
 #endif
       return NULL;
     }
-  memset (addr, 0, sizeof (char) * memsize);
 #if defined (USE_MALLOC_WRAPPER)
+  ((mem_header *) addr)->index = mem_numof_zones;
+  addr += sizeof (mem_header);
   mem_total_size += memsize;
-  memory_list->addr = addr;
-  memory_list->size = memsize;
-  memory_list += 1;
+  memlist = memory_list_base + mem_numof_zones;
+  memlist->addr = addr;
+  memlist->size = memsize;
   mem_numof_zones++;
   if (mem_numof_zones > mem_maxreached_zones)
     {
       mem_maxreached_zones = mem_numof_zones;
     }
+  if (mem_total_size > mem_maxreached_size)
+    {
+      mem_maxreached_size = mem_total_size;
+    }
 #endif
   return addr;
 }
@@ -171,8 +199,8 @@ free_memory (char *addr)
 {
 #if defined (USE_MALLOC_WRAPPER)
   mem_struct *memlist;
-  mem_struct *memlist_src;
-  Uint32 i;
+  mem_struct *memlist_last;
+  mem_header *header;
 #endif
   if (addr == NULL)
     {
@@ -180,35 +208,28 @@ free_memory (char *addr)
       return;
     }
 #if defined (USE_MALLOC_WRAPPER)
-  memlist = memory_list_base;
-  for (i = 0; i < mem_numof_zones; i++, memlist++)
-    {
-      /* search address */
-      if (memlist->addr == addr)
-        {
-          free (addr);
-          memlist_src = memlist + 1;
-          mem_total_size -= memlist->size;
-          mem_numof_zones--;
-          memory_list--;
-          while (i < mem_numof_zones)
-            {
-              memlist->addr = memlist_src->addr;
-              memlist->size = memlist_src->size;
-              i++;
-              memlist++;
-              memlist_src++;
-            }
-          memlist->addr = NULL;
-          memlist->size = 0;
-          addr = NULL;
-          break;
-        }
-    }
-  if (addr != NULL)
+  header = (mem_header *) (addr - sizeof (mem_header));
+  if (header->index >= mem_numof_zones
+      || memory_list_base[header->index].addr != addr)
     {
       LOG_ERR ("can't release the address %p", addr);
+      return;
     }
+  /* the last zone of the table takes the place of the released one */
+  memlist = memory_list_base + header->index;
+  memlist_last = memory_list_base + mem_numof_zones - 1;
+  mem_total_size -= memlist->size;
+  mem_numof_zones--;
+  if (memlist != memlist_last)
+    {
+      memlist->addr = memlist_last->addr;
+      memlist->size = memlist_last->size;
+      ((mem_header *) (memlist->addr - sizeof (mem_header)))->index =
+        header->index;
+    }
+  memlist_last->addr = NULL;
+  memlist_last->size = 0;
+  free (header);
 #else
   free (addr);
 #endif
@@ -236,7 +257,7 @@ memory_releases_all (void)
           if (addr != NULL)
             {
               LOG_WARN ("-> free(%p); size=%i", memlist->addr, memlist->size);
-              free (addr);
+              free (addr - sizeof (mem_header));
               memlist->addr = NULL;
               memlist->size = 0;
             }
@@ -864,13 +885,16 @@ get_file_size (FILE * fstream)
 }
 
 /**
- * Allocate memory and load a file there
+ * Allocate memory, in an arena or not, and load a file there
  * @param filename the file which should be loaded
  * @param fsize pointer on the size of file which will be loaded
+ * @param lifetime ARENA_PROCESS, ARENA_LEVEL, or ARENAS_NUMOF
+ *        to allocate the buffer with memory_allocation()
  * @return file data buffer pointer
  */
-char *
-load_absolute_file (const char *const filename, Uint32 * const filesize)
+static char *
+load_absolute_file_in (const char *const filename, Uint32 * const filesize,
+                       Uint32 lifetime)
 {
   size_t fsize;
   FILE *fstream;
@@ -897,7 +921,14 @@ load_absolute_file (const char *const filename, Uint32 * const filesize)
       LOG_ERR ("file %s is empty!", filename);
       return NULL;
     }
-  buffer = memory_allocation (fsize);
+  if (lifetime < ARENAS_NUMOF)
+    {
+      buffer = arena_alloc (lifetime, fsize);
+    }
+  else
+    {
+      buffer = memory_allocation (fsize);
+    }
   if (buffer == NULL)
     {
       LOG_ERR ("not enough memory to allocate %i bytes!",
@@ -907,7 +938,11 @@ load_absolute_file (const char *const filename, Uint32 * const filesize)
     }
   if (fread (buffer, sizeof (char), fsize, fstream) != fsize)
     {
-      free_memory (buffer);
+      /* a block of an arena is released with the whole arena */
+      if (lifetime >= ARENAS_NUMOF)
+        {
+          free_memory (buffer);
+        }
 #if defined(_WIN32_WCE)
       LOG_ERR ("can't read file \"%s\"", filename);
 #else
@@ -921,6 +956,58 @@ load_absolute_file (const char *const filename, Uint32 * const filesize)
   return buffer;
 }
 
+/**
+ * Allocate memory and load a file there
+ * @param filename the file which should be loaded
+ * @param fsize pointer on the size of file which will be loaded
+ * @return file data buffer pointer
+ */
+char *
+load_absolute_file (const char *const filename, Uint32 * const filesize)
+{
+  return load_absolute_file_in (filename, filesize, ARENAS_NUMOF);
+}
+
+/**
+ * Load a file (filename with a number) in a block of an arena, the
+ * block is released with the whole arena
+ * @param lifetime ARENA_PROCESS or ARENA_LEVEL
+ * @param filename Filename specified by path
+ * @param num Interger to convert in string
+ * @return Pointer to the file data
+ */
+char *
+arena_loadfile_num (Uint32 lifetime, const char *const filename, Sint32 num)
+{
+  Uint32 fsize;
+  char *data, *fname, *pathname;
+  if (filename == NULL || strlen (filename) == 0)
+    {
+      LOG_ERR ("filename is a NULL string");
+      return NULL;
+    }
+  fname = memory_allocation (strlen (filename) + 1);
+  if (fname == NULL)
+    {
+      LOG_ERR ("filename: \"%s\"; num: %i; "
+               "not enough memory to allocate %i bytes",
+               filename, num, (Uint32) (strlen (filename) + 1));
+      return NULL;
+    }
+  sprintf (fname, filename, num);
+  pathname = locate_data_file (fname);
+  if (pathname == NULL)
+    {
+      LOG_ERR ("can't locate file %s", fname);
+      free_memory (fname);
+      return NULL;
+    }
+  data = load_absolute_file_in (pathname, &fsize, lifetime);
+  free_memory (pathname);
+  free_memory (fname);
+  return data;
+}
+
 /**
  * Load a file in memory buffer already allocated
  * @param filename the file which should be loaded
@@ -1033,12 +1120,11 @@ fps_init (void)
 {
 #ifdef POWERMANGA_SDL
   time_begin = SDL_GetTicks ();
-  ticks_previous = SDL_GetTicks ();
 #else
   gettimeofday (&time_begin, NULL);
-  gettimeofday (&ticks_previous, NULL);
 #endif
   loops_counter = 0;
+  frames_displayed = 0;
 }
 
 /**
@@ -1053,9 +1139,10 @@ fps_print (void)
   Sint32 time_end;
   time_end = SDL_GetTicks ();
   duration = time_end - time_begin;
-  fps = (1000.0 * loops_counter) / duration;
-  LOG_INF ("number of loops: %i; running time: %li; frames per seconde: %g",
-           loops_counter, duration, fps);
+  fps = (1000.0 * frames_displayed) / duration;
+  LOG_INF ("number of loops: %i; frames displayed: %i; running time: %li;"
+           " frames per seconde: %g", loops_counter, frames_displayed,
+           duration, fps);
 #else
   struct utsname kernel;
   struct stat statmem;
@@ -1076,7 +1163,7 @@ fps_print (void)
     (time_end.tv_sec - time_begin.tv_sec) * 1000 + (time_end.tv_usec -
                                                     time_begin.tv_usec) /
     1000;
-  fps = (1000.0 * loops_counter) / duration;
+  fps = (1000.0 * frames_displayed) / duration;
 
   /* Linux kernel version */
   if (uname (&kernel) < 0)
@@ -1124,81 +1211,83 @@ fps_print (void)
   LOG_INF ("operating system : %s %s", os_name, os_vers);
   LOG_INF ("processor        : %s at %s Mhz with %.0f RAM", cpu, freq, mem);
   LOG_INF ("number of loops  : %i", loops_counter);
+  LOG_INF ("frames displayed : %i", frames_displayed);
   LOG_INF ("running time     : %li", duration);
   LOG_INF ("frames per second: %g", fps);
 #endif
 }
 
 /**
- * Sleep for a time interval
- * @input delay
- * @return
+ * Return a monotonic time with a microsecond resolution
+ * @return Time in microseconds from an arbitrary starting point
  */
-Sint32
-wait_next_frame (Sint32 delay, Sint32 max)
+Uint64
+get_ticks_usec (void)
 {
-#ifdef POWERMANGA_SDL
-  if (delay > max)
-    {
-      delay = max;
-    }
-#ifndef __EMSCRIPTEN__
-  if (delay > 0)
-    {
-      /* Emscripten: must remove all SDL_Delay */
-      SDL_Delay (delay);
-    }
-#endif
-  return (delay > 0 ? delay : 0);
+#if defined(_WIN32)
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  if (frequency.QuadPart == 0)
+    {
+      QueryPerformanceFrequency (&frequency);
+    }
+  QueryPerformanceCounter (&counter);
+  return (Uint64) (counter.QuadPart * 1000000 / frequency.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (Uint64) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
 #else
-  struct timeval temps;
-  if (delay > max)
-    {
-      delay = max;
-    }
-  if (delay > 0)
-    {
-      temps.tv_usec = delay % (unsigned long) 1000000;
-      temps.tv_sec = delay / (unsigned long) 1000000;
-      select (0, NULL, NULL, NULL, &temps);
-    }
-  return (delay > 0 ? delay : 0);
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return (Uint64) tv.tv_sec * 1000000 + tv.tv_usec;
 #endif
 }
 
-#ifdef POWERMANGA_SDL
 /**
- * Calculate diffence between 2 times
- * @return difference
+ * Return the peak of memory used by the process
+ * @return Maximum resident set size in kilobytes or 0 if unknown
  */
-Sint32
-get_time_difference ()
+Uint32
+get_peak_memory_kb (void)
 {
-  Sint32 diff;
-  Uint32 current_ticks;
-  current_ticks = SDL_GetTicks ();
-  diff = current_ticks - ticks_previous;
-  ticks_previous = current_ticks;
-  return diff;
-}
+#if defined(_WIN32)
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) != 0)
+    {
+      LOG_ERR ("getrusage() failed: %s", strerror (errno));
+      return 0;
+    }
+#if defined(__APPLE__)
+  /* ru_maxrss is given in bytes under Mac OS X */
+  return (Uint32) (usage.ru_maxrss / 1024);
 #else
+  return (Uint32) usage.ru_maxrss;
+#endif
+#endif
+}
+
 /**
- * Calculate diffence between 2 times
- * @return difference
+ * Sleep for a time interval
+ * @param delay Time to wait in microseconds
  */
-Sint32
-get_time_difference ()
+void
+wait_usec (Uint32 delay)
 {
-  struct timeval current_ticks;
-  Sint32 diff;
-  gettimeofday (&current_ticks, NULL);
-  diff =
-    (1000000 * (current_ticks.tv_sec - ticks_previous.tv_sec)) +
-    (current_ticks.tv_usec - ticks_previous.tv_usec);
-  ticks_previous = current_ticks;
-  return diff;
-}
+#ifdef POWERMANGA_SDL
+#ifndef __EMSCRIPTEN__
+  /* Emscripten: must remove all SDL_Delay */
+  SDL_Delay ((delay + 999) / 1000);
 #endif
+#else
+  struct timeval temps;
+  temps.tv_usec = delay % (unsigned long) 1000000;
+  temps.tv_sec = delay / (unsigned long) 1000000;
+  select (0, NULL, NULL, NULL, &temps);
+#endif
+}
 
 /**
  * Check if a value is null, signed or unsigned
@@ -1315,7 +1404,7 @@ alloc_precalulate_sinus (void)
   if (precalc_sin128 == NULL)
     {
       i = 128 * sizeof (float) * 2;
-      precalc_sin128 = (float *) memory_allocation (i);
+      precalc_sin128 = (float *) arena_alloc (ARENA_PROCESS, i);
       if (precalc_sin128 == NULL)
         {
           LOG_ERR ("not enough memory to allocate %i bytes", i);
@@ -1335,7 +1424,7 @@ alloc_precalulate_sinus (void)
   if (precalc_sin == NULL)
     {
       i = 32 * sizeof (float) * 2;
-      precalc_sin = (float *) memory_allocation (i);
+      precalc_sin = (float *) arena_alloc (ARENA_PROCESS, i);
       if (precalc_sin == NULL)
         {
           LOG_ERR ("not enough memory to allocate %i bytes", i);
@@ -1386,23 +1475,16 @@ alloc_precalulate_sinus (void)
 }
 
 /**
- * Release precalculded sinus and cosinus curves
+ * Forget the precalculated sinus and cosinus curves. The tables
+ * belong to the process arena, they are released by arenas_free()
  */
 void
 free_precalulate_sinus (void)
 {
-  if (precalc_sin != NULL)
-    {
-      free_memory ((char *) precalc_sin);
-      precalc_sin = NULL;
-      precalc_cos = NULL;
-    }
-  if (precalc_sin128 != NULL)
-    {
-      free_memory ((char *) precalc_sin128);
-      precalc_sin128 = NULL;
-      precalc_cos128 = NULL;
-    }
+  precalc_sin = NULL;
+  precalc_cos = NULL;
+  precalc_sin128 = NULL;
+  precalc_cos128 = NULL;
 }
 
 /**
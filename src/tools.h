@@ -75,13 +75,16 @@ extern "C"
   char *loadfile (const char *const filename, Uint32 * const size);
   size_t get_file_size (FILE * fstream);
   char *load_absolute_file (const char *const filename, Uint32 * const fsize);
+  char *arena_loadfile_num (Uint32 lifetime, const char *const filename,
+                            Sint32 num);
   bool loadfile_into_buffer (const char *const filename, char *const buffer);
   bool file_write (const char *filename, const char *filedata,
                    const size_t filesize);
   void fps_init (void);
   void fps_print (void);
-  Sint32 wait_next_frame (Sint32 delay, Sint32 max);
-  Sint32 get_time_difference (void);
+  void wait_usec (Uint32 delay);
+  Uint64 get_ticks_usec (void);
+  Uint32 get_peak_memory_kb (void);
   Sint16 sign (float);
   float calc_target_angle (Sint16 pxs, Sint16 pys, Sint16 pxd, Sint16 pyd);
   float get_new_angle (float old_angle, float new_angle, float agilite);
@@ -103,6 +106,7 @@ extern "C"
 #if defined (USE_MALLOC_WRAPPER)
   extern Uint32 mem_numof_zones;
   extern Uint32 mem_total_size;
+  extern Uint32 mem_maxreached_size;
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,373 @@
+/**
+ * @file workers.c
+ * @brief Persistent pool of threads used to share a task between
+ *        the processors
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#include "config.h"
+#include "powermanga.h"
+#include "tools.h"
+#include "log_recorder.h"
+#include "workers.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/** Number of threads which execute the jobs, the calling thread
+ * included */
+static Uint32 workers_numof = 1;
+
+/** State of a task run by workers_run_graph() */
+typedef struct workers_graph
+{
+  const workers_node *nodes;
+  Uint32 numof_nodes;
+  /** Bitmasks of the jobs started and of the jobs done */
+  Uint32 started;
+  Uint32 done;
+  /** TRUE if a job failed, the jobs not started yet are cancelled */
+  bool failed;
+#ifdef HAVE_PTHREAD_H
+  /** Protect all the previous variables */
+  pthread_mutex_t mutex;
+  /** Signaled each time a job is done */
+  pthread_cond_t cond;
+#endif
+}
+workers_graph;
+
+#ifdef HAVE_PTHREAD_H
+/** Threads created by workers_init() */
+static pthread_t workers_threads[WORKERS_MAXOF];
+/** Protect all the following variables */
+static pthread_mutex_t workers_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Signaled when a new task is available or the threads must quit */
+static pthread_cond_t workers_start = PTHREAD_COND_INITIALIZER;
+/** Signaled when the last job of a task is done */
+static pthread_cond_t workers_done = PTHREAD_COND_INITIALIZER;
+/** Current task */
+static workers_job_func workers_job = NULL;
+static void *workers_data = NULL;
+/** Number of jobs of the current task */
+static Uint32 workers_numof_jobs = 0;
+/** Index of the next job to execute */
+static Uint32 workers_next_job = 0;
+/** Number of jobs done */
+static Uint32 workers_numof_done = 0;
+/** Incremented for each new task */
+static Uint32 workers_generation = 0;
+/** TRUE if the threads must quit */
+static bool workers_quit = FALSE;
+
+/**
+ * Execute the jobs of the current task until there is no more,
+ * the mutex must be locked
+ */
+static void
+workers_execute (void)
+{
+  Uint32 job;
+  while (workers_next_job < workers_numof_jobs)
+    {
+      job = workers_next_job++;
+      pthread_mutex_unlock (&workers_mutex);
+      workers_job (workers_data, job);
+      pthread_mutex_lock (&workers_mutex);
+      if (++workers_numof_done == workers_numof_jobs)
+        {
+          pthread_cond_signal (&workers_done);
+        }
+    }
+}
+
+/**
+ * Main function of a thread: wait for a task and execute its jobs
+ * @param arg Unused
+ * @return Always NULL
+ */
+static void *
+workers_loop (void *arg)
+{
+  Uint32 generation = 0;
+  (void) arg;
+  pthread_mutex_lock (&workers_mutex);
+  for (;;)
+    {
+      while (!workers_quit && generation == workers_generation)
+        {
+          pthread_cond_wait (&workers_start, &workers_mutex);
+        }
+      if (workers_quit)
+        {
+          break;
+        }
+      generation = workers_generation;
+      workers_execute ();
+    }
+  pthread_mutex_unlock (&workers_mutex);
+  return NULL;
+}
+#endif
+
+/**
+ * Create the threads
+ * @param numof_threads Number of threads, the calling thread included,
+ *                      or 0 to use one thread per processor
+ * @return TRUE if it completed successfully or FALSE otherwise
+ */
+bool
+workers_init (Sint32 numof_threads)
+{
+#ifdef HAVE_PTHREAD_H
+  Uint32 i;
+  workers_free ();
+#if defined(_SC_NPROCESSORS_ONLN)
+  if (numof_threads <= 0)
+    {
+      numof_threads = (Sint32) sysconf (_SC_NPROCESSORS_ONLN);
+    }
+#endif
+  if (numof_threads < 1)
+    {
+      numof_threads = 1;
+    }
+  if (numof_threads > WORKERS_MAXOF)
+    {
+      numof_threads = WORKERS_MAXOF;
+    }
+  workers_quit = FALSE;
+  for (i = 1; i < (Uint32) numof_threads; i++)
+    {
+      if (pthread_create (&workers_threads[i], NULL, workers_loop, NULL)
+          != 0)
+        {
+          LOG_ERR ("pthread_create() failed");
+          break;
+        }
+      workers_numof = i + 1;
+    }
+  LOG_INF ("%i thread(s) used", workers_numof);
+  return TRUE;
+#else
+  (void) numof_threads;
+  workers_numof = 1;
+  return TRUE;
+#endif
+}
+
+/**
+ * Stop and release the threads
+ */
+void
+workers_free (void)
+{
+#ifdef HAVE_PTHREAD_H
+  Uint32 i;
+  if (workers_numof <= 1)
+    {
+      return;
+    }
+  pthread_mutex_lock (&workers_mutex);
+  workers_quit = TRUE;
+  pthread_cond_broadcast (&workers_start);
+  pthread_mutex_unlock (&workers_mutex);
+  for (i = 1; i < workers_numof; i++)
+    {
+      pthread_join (workers_threads[i], NULL);
+    }
+#endif
+  workers_numof = 1;
+}
+
+/**
+ * Return the number of threads which execute the jobs
+ * @return Number of threads, the calling thread included
+ */
+Uint32
+workers_count (void)
+{
+  return workers_numof;
+}
+
+/**
+ * Execute all the jobs of a task and wait for their completion,
+ * the calling thread executes jobs too
+ * @param job Function which executes one job
+ * @param data Data given to the function
+ * @param numof_jobs Number of jobs
+ */
+void
+workers_run (workers_job_func job, void *data, Uint32 numof_jobs)
+{
+  Uint32 i;
+#ifdef HAVE_PTHREAD_H
+  if (workers_numof > 1 && numof_jobs > 1)
+    {
+      pthread_mutex_lock (&workers_mutex);
+      workers_job = job;
+      workers_data = data;
+      workers_numof_jobs = numof_jobs;
+      workers_next_job = 0;
+      workers_numof_done = 0;
+      workers_generation++;
+      pthread_cond_broadcast (&workers_start);
+      workers_execute ();
+      while (workers_numof_done < workers_numof_jobs)
+        {
+          pthread_cond_wait (&workers_done, &workers_mutex);
+        }
+      pthread_mutex_unlock (&workers_mutex);
+      return;
+    }
+#endif
+  for (i = 0; i < numof_jobs; i++)
+    {
+      job (data, i);
+    }
+}
+
+/**
+ * Return the first job of a graph which is not started and whose
+ * dependencies are done, the graph must be locked
+ * @param graph The graph of jobs
+ * @return Index of the job, or -1 if no job is ready
+ */
+static Sint32
+workers_graph_next (workers_graph * graph)
+{
+  Uint32 i;
+  for (i = 0; i < graph->numof_nodes; i++)
+    {
+      if (!(graph->started & (1U << i))
+          && (graph->nodes[i].depends & ~graph->done) == 0)
+        {
+          return (Sint32) i;
+        }
+    }
+  return -1;
+}
+
+/**
+ * Execute the ready jobs of a graph until they are all started,
+ * each thread runs this function once
+ * @param data Pointer to the graph of jobs
+ * @param job Unused
+ */
+static void
+workers_graph_execute (void *data, Uint32 job)
+{
+  Sint32 i;
+  Uint32 all;
+  bool result;
+  workers_graph *graph = (workers_graph *) data;
+  (void) job;
+  all = graph->numof_nodes < 32 ?
+    (1U << graph->numof_nodes) - 1 : 0xffffffff;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&graph->mutex);
+#endif
+  while (!graph->failed && graph->started != all)
+    {
+      i = workers_graph_next (graph);
+      if (i < 0)
+        {
+          /* the jobs left wait for jobs running in other threads */
+#ifdef HAVE_PTHREAD_H
+          pthread_cond_wait (&graph->cond, &graph->mutex);
+#endif
+          continue;
+        }
+      graph->started |= 1U << i;
+#ifdef HAVE_PTHREAD_H
+      pthread_mutex_unlock (&graph->mutex);
+#endif
+      result = graph->nodes[i].func ();
+#ifdef HAVE_PTHREAD_H
+      pthread_mutex_lock (&graph->mutex);
+#endif
+      if (!result)
+        {
+          LOG_ERR ("%s failed", graph->nodes[i].name);
+          graph->failed = TRUE;
+        }
+      graph->done |= 1U << i;
+#ifdef HAVE_PTHREAD_H
+      pthread_cond_broadcast (&graph->cond);
+#endif
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&graph->mutex);
+#endif
+}
+
+/**
+ * Execute jobs which depend on each other and wait for their
+ * completion, a job starts as soon as its dependencies are done and
+ * the first jobs of the list are started first. The jobs must not
+ * call workers_run()
+ * @param nodes List of the jobs
+ * @param numof_nodes Number of jobs, at most WORKERS_NODES_MAXOF
+ * @return TRUE if all the jobs completed successfully or FALSE otherwise
+ */
+bool
+workers_run_graph (const workers_node * nodes, Uint32 numof_nodes)
+{
+  Uint32 i, numof_threads;
+  workers_graph graph;
+  if (numof_nodes > WORKERS_NODES_MAXOF)
+    {
+      LOG_ERR ("%i jobs, maximum is %i", numof_nodes, WORKERS_NODES_MAXOF);
+      return FALSE;
+    }
+  /* a job may depend only on the previous ones, so that there is
+   * always a job ready or running */
+  for (i = 0; i < numof_nodes; i++)
+    {
+      if ((nodes[i].depends >> i) != 0)
+        {
+          LOG_ERR ("%s depends on a next job", nodes[i].name);
+          return FALSE;
+        }
+    }
+  graph.nodes = nodes;
+  graph.numof_nodes = numof_nodes;
+  graph.started = 0;
+  graph.done = 0;
+  graph.failed = FALSE;
+#if defined (USE_MALLOC_WRAPPER)
+  /* the list of the memory zones is not thread safe */
+  numof_threads = 1;
+#else
+  numof_threads = workers_numof;
+#endif
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init (&graph.mutex, NULL);
+  pthread_cond_init (&graph.cond, NULL);
+#endif
+  workers_run (workers_graph_execute, &graph, numof_threads);
+#ifdef HAVE_PTHREAD_H
+  pthread_cond_destroy (&graph.cond);
+  pthread_mutex_destroy (&graph.mutex);
+#endif
+  return !graph.failed;
+}
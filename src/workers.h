@@ -0,0 +1,70 @@
+/**
+ * @file workers.h
+ * @brief Persistent pool of threads used to share a task between
+ *        the processors
+ * @created 2026-10-16
+ * @date 2026-10-16
+ */
+/*
+ * copyright (c) 1998-2015 TLK Games all rights reserved
+ *
+ * Powermanga is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Powermanga is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA  02110-1301, USA.
+ */
+#ifndef __WORKERS__
+#define __WORKERS__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Maximum number of threads, the calling thread included */
+#define WORKERS_MAXOF 16
+
+  /**
+   * Function which executes one job of a task
+   * @param data Data of the task
+   * @param job Index of the job, from 0 to the number of jobs - 1
+   */
+  typedef void (*workers_job_func) (void *data, Uint32 job);
+
+/** Maximum number of jobs of a task run by workers_run_graph() */
+#define WORKERS_NODES_MAXOF 32
+
+  /** Job which can start only when other jobs are done */
+  typedef struct workers_node
+  {
+    /** Name of the job, for the error messages */
+    const char *name;
+    /** Function which executes the job, returns FALSE if it failed */
+    bool (*func) (void);
+    /** Bitmask of the indexes of the jobs which must be done before,
+     * they must all precede the job in the list */
+    Uint32 depends;
+  }
+  workers_node;
+
+  bool workers_init (Sint32 numof_threads);
+  void workers_free (void);
+  Uint32 workers_count (void);
+  void workers_run (workers_job_func job, void *data, Uint32 numof_jobs);
+  bool workers_run_graph (const workers_node * nodes, Uint32 numof_nodes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif